@@ -0,0 +1,170 @@
+//========================================================================================
+//  
+//  ChartATEMeasurer.cpp
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#include "IllustratorSDK.h"
+#include "ChartATEMeasurer.h"
+#include "ChartsSuites.h"
+#include "SDKErrors.h"
+#include "AITextFrame.h"
+#include "IText.h"
+
+namespace {
+
+// Silences the undo context while the scratch text is created, edited or disposed of,
+// and restores it before any chart art is touched
+class SilentScope {
+public:
+	SilentScope() : fWasSilent(false)
+	{
+		if (sAIUndo->IsSilent(&fWasSilent) != kNoErr) {
+			fWasSilent = false;
+		}
+		sAIUndo->SetSilent(true);
+	}
+	~SilentScope() { sAIUndo->SetSilent(fWasSilent); }
+
+private:
+	AIBoolean fWasSilent;
+};
+
+// "ATE" and the version of the scratch text setup
+const uint64_t kATEMeasurerIdentity = 0x41544501;
+
+} // namespace
+
+/*
+*/
+uint64_t ChartATEMeasurer::GetIdentity() const
+{
+	return kATEMeasurerIdentity;
+}
+
+/*
+*/
+ChartTextExtent ChartATEMeasurer::Measure(const std::string& fontName, double fontSize, const std::string& text)
+{
+	ChartTextExtent extent = ChartTextMeasurer::Measure(fontName, fontSize, text);
+	if (text.empty()) {
+		return extent;
+	}
+
+	Pass pass(*this);
+	SilentScope silent;
+	ASErr result = kNoErr;
+
+	try {
+		AIArtHandle frame = nullptr;
+		result = this->GetScratchText(&frame);
+		aisdk::check_ai_error(result);
+
+		// Replace the previous measurement's text, then size the whole story
+		TextRangeRef range = nullptr;
+		result = sAITextFrame->GetATETextRange(frame, &range);
+		aisdk::check_ai_error(result);
+		ATE::ITextRange previous(range);
+		previous.Remove();
+		previous.InsertAfter(ai::UnicodeString::FromUTF8(text).as_ASUnicode().c_str());
+
+		result = sAITextFrame->GetATETextRange(frame, &range);
+		aisdk::check_ai_error(result);
+		ATE::ITextRange textRange(range);
+		ATE::ICharFeatures charFeatures;
+		charFeatures.SetFontSize((AIReal)fontSize);
+		textRange.SetLocalCharFeatures(charFeatures);
+
+		// The text sits on a baseline at the origin, so the frame's top is its ascent
+		AIRealRect bounds;
+		result = sAIArt->GetArtBounds(frame, &bounds);
+		aisdk::check_ai_error(result);
+
+		extent.width = bounds.right - bounds.left;
+		extent.height = bounds.top;
+	}
+	catch (ai::Error&) {
+		// Keep the estimate
+	}
+
+	return extent;
+}
+
+/*
+*/
+void ChartATEMeasurer::BeginPass()
+{
+	fPassDepth++;
+}
+
+/*
+*/
+void ChartATEMeasurer::EndPass()
+{
+	if (--fPassDepth > 0 || !fScratch) {
+		return;
+	}
+
+	SilentScope silent;
+	sAIArt->DisposeArt(fScratch);
+	fScratch = nullptr;
+}
+
+/*
+*/
+ASErr ChartATEMeasurer::GetScratchText(AIArtHandle* frame)
+{
+	ASErr result = kNoErr;
+	try {
+		if (!fScratch) {
+			AIRealPoint origin;
+			origin.h = 0;
+			origin.v = 0;
+			AIArtHandle scratch = nullptr;
+			result = sAITextFrame->NewPointText(kPlaceAboveAll, nullptr, kHorizontalTextOrientation, origin, &scratch);
+			if (result == kNoErr) {
+				result = sAIArt->SetArtUserAttr(scratch, kArtHidden, kArtHidden);
+				if (result != kNoErr) {
+					sAIArt->DisposeArt(scratch);
+				}
+			}
+			aisdk::check_ai_error(result);
+			fScratch = scratch;
+		}
+		*frame = fScratch;
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+	return result;
+}
+
+/*
+*/
+void ChartATEMeasurer::GetDefaultFont(std::string& fontName, double& fontSize)
+{
+	ATE::ICharFeatures defaultCharFeatures;
+
+	bool isAssigned = false;
+	AIReal defaultFontSize = defaultCharFeatures.GetFontSize(&isAssigned);
+	if (isAssigned) {
+		fontSize = defaultFontSize;
+	}
+
+	isAssigned = false;
+	ATE::IFont font = defaultCharFeatures.GetFont(&isAssigned);
+	AIFontKey fontKey = nullptr;
+	if (isAssigned && !font.IsNull() && sAIFont->FontFromFontRef(font.GetRef(), &fontKey) == kNoErr) {
+		char name[256] = {0};
+		if (sAIFont->GetFullFontName(fontKey, name, (short)sizeof(name)) == kNoErr) {
+			fontName = name;
+		}
+	}
+}
@@ -0,0 +1,93 @@
+//========================================================================================
+//  
+//  ChartATEMeasurer.h
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#ifndef __ChartATEMeasurer_h__
+#define __ChartATEMeasurer_h__
+
+#include "IllustratorSDK.h"
+#include "ChartLayout.h"
+#include <string>
+
+/** Measures label text through the text engine.
+
+	Each measurement sets the text in a hidden scratch point text with the document's
+	default character features, as chart labels are, and reads the composed frame's
+	bounds. Measurements share the scratch text for the length of a measure pass, which
+	disposes of it at its end. Each edit of the scratch text is made with the undo context
+	silenced and its silence restored straight after, so measuring adds nothing to the
+	undo history while chart art made in the same pass stays undoable. That is still expensive, so the
+	plug-in always measures through a ChartTextMetricsCache. Falls back to the estimate
+	of the base class if the text cannot be set.
+*/
+class ChartATEMeasurer : public ChartTextMeasurer
+{
+public:
+	/** Scope of a measure pass. Passes nest; the outermost one disposes of the scratch
+		text when it ends. A measurement made
+		outside any pass is a pass of its own.
+	*/
+	class Pass
+	{
+	public:
+		explicit Pass(ChartATEMeasurer& measurer) : fMeasurer(measurer) { fMeasurer.BeginPass(); }
+		~Pass() { fMeasurer.EndPass(); }
+
+	private:
+		Pass(const Pass&);
+		Pass& operator=(const Pass&);
+
+		ChartATEMeasurer& fMeasurer;
+	};
+
+	ChartATEMeasurer() : fScratch(nullptr), fPassDepth(0) {}
+
+	/** Measures text in the document's default font.
+		@param fontName IN the default font's name, as returned by GetDefaultFont; it keys
+			cached extents and does not change the font text is set in.
+		@param fontSize IN the point size to set the text at.
+		@param text IN UTF-8 text.
+		@return the advance width and the height above the baseline.
+	*/
+	ChartTextExtent Measure(const std::string& fontName, double fontSize, const std::string& text) override;
+
+	/** Identifies text engine measurements, apart from the estimate's, in layout keys.
+		@return the identity; change it whenever text is set differently for measuring.
+	*/
+	uint64_t GetIdentity() const override;
+
+	/** Gets the font and size chart labels are set in: the document's default
+		character features.
+		@param fontName OUT the font's full name, left unchanged if unassigned.
+		@param fontSize OUT the font size, left unchanged if unassigned.
+	*/
+	static void GetDefaultFont(std::string& fontName, double& fontSize);
+
+private:
+	void BeginPass();
+	void EndPass();
+
+	/** Gets the pass's scratch text, creating it hidden on the pass's first measurement.
+		Call with the undo context silenced.
+	*/
+	ASErr GetScratchText(AIArtHandle* frame);
+
+	/** Point text measurements are set in, or nullptr before the first of a pass.
+	*/
+	AIArtHandle fScratch;
+
+	/** Passes begun and not yet ended.
+	*/
+	ai::int32 fPassDepth;
+};
+
+#endif // __ChartATEMeasurer_h__
@@ -0,0 +1,172 @@
+//========================================================================================
+//  
+//  ChartArc.cpp
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#include "ChartArc.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace {
+
+constexpr double kTwoPi = 6.283185307179586476925;
+
+// Entries of the unit circle table per full turn; a power of two, so an angle's entry
+// is found with a mask
+constexpr size_t kTableSize = 256;
+
+// Pieces per full turn the error table covers; a quarter turn is the longest piece
+constexpr int kMinPiecesPerTurn = 4;
+constexpr int kMaxPiecesPerTurn = 64;
+
+// Sine and cosine of |x| <= pi/4 by their Taylor series, to double precision. Only
+// evaluated at compile time, to build the tables.
+constexpr double TaylorSin(double x)
+{
+	double term = x;
+	double sum = x;
+	for (int n = 1; n < 12; n++) {
+		term *= -x * x / ((2 * n) * (2 * n + 1));
+		sum += term;
+	}
+	return sum;
+}
+
+constexpr double TaylorCos(double x)
+{
+	double term = 1;
+	double sum = 1;
+	for (int n = 1; n < 12; n++) {
+		term *= -x * x / ((2 * n - 1) * (2 * n));
+		sum += term;
+	}
+	return sum;
+}
+
+// Direction of table entry index: the series is only summed within an eighth of a turn,
+// and the rest of the circle follows by symmetry
+constexpr ChartUnitVector MakeTableEntry(size_t index)
+{
+	const size_t quarter = kTableSize / 4;
+	const size_t step = index % quarter;
+
+	ChartUnitVector v = {0, 0};
+	if (step <= quarter / 2) {
+		const double x = step * kTwoPi / kTableSize;
+		v = {TaylorCos(x), TaylorSin(x)};
+	}
+	else {
+		const double x = (quarter - step) * kTwoPi / kTableSize;
+		v = {TaylorSin(x), TaylorCos(x)};
+	}
+
+	switch (index / quarter) {
+		case 1: return {-v.s, v.c};
+		case 2: return {-v.c, -v.s};
+		case 3: return {v.s, -v.c};
+		default: return v;
+	}
+}
+
+struct UnitCircleTable {
+	ChartUnitVector entries[kTableSize];
+
+	constexpr UnitCircleTable() : entries()
+	{
+		for (size_t i = 0; i < kTableSize; i++) {
+			entries[i] = MakeTableEntry(i);
+		}
+	}
+};
+
+// Largest radial distance from the unit circle of a piece spanning sweep radians, with
+// handles of 4/3 tan(sweep / 4): 2 sin^6(sweep / 4) / (27 cos^2(sweep / 4))
+constexpr double MakePieceError(int piecesPerTurn)
+{
+	const double x = kTwoPi / piecesPerTurn / 4;
+	const double s = TaylorSin(x);
+	const double c = TaylorCos(x);
+	return 2 * (s * s * s) * (s * s * s) / (27 * c * c);
+}
+
+struct PieceErrorTable {
+	double errors[kMaxPiecesPerTurn - kMinPiecesPerTurn + 1];
+
+	constexpr PieceErrorTable() : errors()
+	{
+		for (int n = kMinPiecesPerTurn; n <= kMaxPiecesPerTurn; n++) {
+			errors[n - kMinPiecesPerTurn] = MakePieceError(n);
+		}
+	}
+};
+
+constexpr UnitCircleTable kUnitCircle;
+constexpr PieceErrorTable kPieceErrors;
+
+} // namespace
+
+/*
+*/
+ChartUnitVector ChartArc::GetUnitVector(double angle)
+{
+	// The nearest table entry below angle, and the rest of less than one entry's step
+	const double steps = angle * (kTableSize / kTwoPi);
+	const double whole = std::floor(steps);
+	const double r = (steps - whole) * (kTwoPi / kTableSize);
+	const ChartUnitVector& entry = kUnitCircle.entries[(size_t)((int64_t)whole & (int64_t)(kTableSize - 1))];
+
+	// The rest is under 0.025 radians, where these few terms are exact to double precision
+	const double r2 = r * r;
+	const double sr = r * (1 - r2 / 6 * (1 - r2 / 20 * (1 - r2 / 42)));
+	const double cr = 1 - r2 / 2 * (1 - r2 / 12 * (1 - r2 / 30 * (1 - r2 / 56)));
+
+	ChartUnitVector v;
+	v.c = entry.c * cr - entry.s * sr;
+	v.s = entry.s * cr + entry.c * sr;
+	return v;
+}
+
+/*
+*/
+int ChartArc::GetPieceCount(double sweep, double radius, double tolerance)
+{
+	int piecesPerTurn = kMinPiecesPerTurn;
+	if (radius > 0 && tolerance > 0) {
+		// Errors fall as pieces shorten; take the fewest pieces per turn within tolerance
+		const double allowed = tolerance / radius;
+		const double* begin = kPieceErrors.errors;
+		const double* end = begin + (kMaxPiecesPerTurn - kMinPiecesPerTurn + 1);
+		const double* found = std::lower_bound(begin, end, allowed, [](double error, double limit) { return error > limit; });
+		piecesPerTurn = found == end ? kMaxPiecesPerTurn : kMinPiecesPerTurn + (int)(found - begin);
+	}
+
+	const double pieces = std::fabs(sweep) / kTwoPi * piecesPerTurn;
+	return std::max(1, (int)std::ceil(pieces - 1e-9));
+}
+
+/*
+*/
+double ChartArc::GetHandleLength(double sweep)
+{
+	// tan(x / 2) = sin x / (1 + cos x), which holds its precision for small pieces
+	const ChartUnitVector half = GetUnitVector(sweep / 2);
+	return 4.0 / 3.0 * half.s / (1 + half.c);
+}
+
+/*
+*/
+double ChartArc::GetPieceError(int piecesPerTurn)
+{
+	piecesPerTurn = std::max(kMinPiecesPerTurn, std::min(kMaxPiecesPerTurn, piecesPerTurn));
+	return kPieceErrors.errors[piecesPerTurn - kMinPiecesPerTurn];
+}
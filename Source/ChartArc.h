@@ -0,0 +1,48 @@
+//========================================================================================
+//  
+//  ChartArc.h
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#ifndef __ChartArc_h__
+#define __ChartArc_h__
+
+// Circular arcs as cubic Bezier pieces, without trigonometry at run time. Points on the
+// unit circle come from a table built at compile time and are corrected between its
+// entries by short polynomials, and an arc is cut into the fewest pieces that keep it
+// within a tolerance of the true circle. Free of Illustrator SDK types, like the layout.
+
+// A direction: the cosine and sine of an angle
+struct ChartUnitVector {
+	double c, s;
+};
+
+// Default largest distance between an arc and its Bezier pieces, in points
+const double kChartArcTolerance = 0.01;
+
+class ChartArc {
+public:
+	// The direction of angle, in radians counterclockwise from the positive h axis
+	static ChartUnitVector GetUnitVector(double angle);
+
+	// The number of Bezier pieces for an arc of sweep radians at radius: the fewest that
+	// keep within tolerance of the circle, and at least one per quarter turn
+	static int GetPieceCount(double sweep, double radius, double tolerance = kChartArcTolerance);
+
+	// Handle length of one piece of sweep radians on the unit circle, 4/3 tan(sweep / 4),
+	// which puts the piece's midpoint on the circle; negative for a clockwise piece
+	static double GetHandleLength(double sweep);
+
+	// Largest distance from the unit circle of one piece spanning a full turn divided by
+	// piecesPerTurn, for piecesPerTurn from 4 to 64
+	static double GetPieceError(int piecesPerTurn);
+};
+
+#endif // __ChartArc_h__
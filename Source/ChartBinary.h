@@ -0,0 +1,114 @@
+//========================================================================================
+//  
+//  ChartBinary.h
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#ifndef __ChartBinary_h__
+#define __ChartBinary_h__
+
+// Helpers for the compact binary forms charts persist (datasets, cached layouts).
+// Values are written in native byte order; every format carries a magic number.
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Appends values to a byte buffer
+class ChartBinaryWriter {
+public:
+	explicit ChartBinaryWriter(std::vector<uint8_t>& out) : fOut(out) {}
+
+	void Write(const void* data, size_t size)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		fOut.insert(fOut.end(), bytes, bytes + size);
+	}
+
+	void WriteU8(uint8_t value) { fOut.push_back(value); }
+	void WriteU32(uint32_t value) { Write(&value, sizeof(value)); }
+	void WriteU64(uint64_t value) { Write(&value, sizeof(value)); }
+	void WriteDouble(double value) { Write(&value, sizeof(value)); }
+
+	void WriteString(const std::string& value)
+	{
+		WriteU32((uint32_t)value.size());
+		Write(value.data(), value.size());
+	}
+
+private:
+	std::vector<uint8_t>& fOut;
+};
+
+// Bounds-checked reader over a byte buffer
+class ChartBinaryReader {
+public:
+	ChartBinaryReader(const uint8_t* data, size_t size) : fData(data), fSize(size), fOffset(0) {}
+
+	bool Read(void* value, size_t size)
+	{
+		if (fSize - fOffset < size) return false;
+		memcpy(value, fData + fOffset, size);
+		fOffset += size;
+		return true;
+	}
+
+	bool ReadU8(uint8_t& value) { return Read(&value, sizeof(value)); }
+	bool ReadU32(uint32_t& value) { return Read(&value, sizeof(value)); }
+	bool ReadU64(uint64_t& value) { return Read(&value, sizeof(value)); }
+	bool ReadDouble(double& value) { return Read(&value, sizeof(value)); }
+
+	bool ReadString(std::string& value)
+	{
+		uint32_t length = 0;
+		if (!ReadU32(length) || fSize - fOffset < length) return false;
+		value.assign(reinterpret_cast<const char*>(fData + fOffset), length);
+		fOffset += length;
+		return true;
+	}
+
+	// Guards element counts read from untrusted data before resizing containers
+	bool CanHold(uint32_t count, size_t elementSize) const { return (size_t)count <= (fSize - fOffset) / elementSize; }
+
+	bool AtEnd() const { return fOffset == fSize; }
+
+private:
+	const uint8_t* fData;
+	size_t fSize;
+	size_t fOffset;
+};
+
+// 64-bit FNV-1a, usable incrementally
+class ChartHasher {
+public:
+	ChartHasher() : fHash(1469598103934665603ULL) {}
+
+	void Add(const void* data, size_t size)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; i++) {
+			fHash ^= bytes[i];
+			fHash *= 1099511628211ULL;
+		}
+	}
+
+	void AddU64(uint64_t value) { Add(&value, sizeof(value)); }
+	void AddDouble(double value) { Add(&value, sizeof(value)); }
+	void AddString(const std::string& value) { AddU64(value.size()); Add(value.data(), value.size()); }
+
+	// Never 0, so callers can use 0 for "not computed"
+	uint64_t Get() const { return fHash != 0 ? fHash : 1; }
+
+private:
+	uint64_t fHash;
+};
+
+#endif // __ChartBinary_h__
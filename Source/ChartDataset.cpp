@@ -0,0 +1,397 @@
+//========================================================================================
+//  
+//  ChartDataset.cpp
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#include "ChartDataset.h"
+#include "ChartBinary.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <unordered_map>
+
+namespace {
+
+const uint32_t kDatasetMagic = 0x31534443;	// "CDS1"
+
+// Splits one CSV record starting at pos; handles quoted fields and doubled quotes
+bool NextRecord(const std::string& text, size_t& pos, std::vector<std::string>& fields)
+{
+	fields.clear();
+	if (pos >= text.size()) return false;
+
+	std::string field;
+	bool quoted = false;
+	while (pos < text.size()) {
+		char c = text[pos++];
+		if (quoted) {
+			if (c == '"') {
+				if (pos < text.size() && text[pos] == '"') {
+					field += '"';
+					pos++;
+				}
+				else {
+					quoted = false;
+				}
+			}
+			else {
+				field += c;
+			}
+		}
+		else if (c == '"') {
+			quoted = true;
+		}
+		else if (c == ',') {
+			fields.push_back(field);
+			field.clear();
+		}
+		else if (c == '\n' || c == '\r') {
+			if (c == '\r' && pos < text.size() && text[pos] == '\n') pos++;
+			break;
+		}
+		else {
+			field += c;
+		}
+	}
+	fields.push_back(field);
+	return true;
+}
+
+bool ParseNumber(const std::string& text, double& value)
+{
+	if (text.empty()) {
+		value = std::numeric_limits<double>::quiet_NaN();
+		return true;
+	}
+	char* end = nullptr;
+	value = strtod(text.c_str(), &end);
+	while (end && (*end == ' ' || *end == '\t')) end++;
+	return end && *end == '\0' && end != text.c_str();
+}
+
+} // namespace
+
+/*
+*/
+std::string ChartColumn::Label(size_t row) const
+{
+	if (kind == kText) {
+		return row < texts.size() ? texts[row] : std::string();
+	}
+	if (row >= numbers.size() || std::isnan(numbers[row])) {
+		return std::string();
+	}
+	char buffer[32];
+	snprintf(buffer, sizeof(buffer), "%g", numbers[row]);
+	return buffer;
+}
+
+/*
+*/
+size_t ChartSeriesView::CategoryCount() const
+{
+	size_t count = categories ? categories->Size() : 0;
+	for (const ChartColumn* column : series) {
+		count = count > column->Size() ? count : column->Size();
+	}
+	return count;
+}
+
+/*
+*/
+std::string ChartSeriesView::CategoryLabel(size_t index) const
+{
+	if (categories) {
+		return categories->Label(index);
+	}
+	return std::to_string(index + 1);
+}
+
+/*
+*/
+size_t ChartDataset::GetRowCount() const
+{
+	size_t rows = 0;
+	for (const ChartColumn& column : fColumns) {
+		rows = rows > column.Size() ? rows : column.Size();
+	}
+	return rows;
+}
+
+/*
+*/
+const ChartColumn* ChartDataset::FindColumn(const std::string& name) const
+{
+	for (const ChartColumn& column : fColumns) {
+		if (column.name == name) {
+			return &column;
+		}
+	}
+	return nullptr;
+}
+
+/*
+*/
+void ChartDataset::AddColumn(const ChartColumn& column)
+{
+	fColumns.push_back(column);
+	fContentHash = 0;
+}
+
+/*
+*/
+uint64_t ChartDataset::GetContentHash() const
+{
+	if (fContentHash == 0) {
+		std::vector<uint8_t> bytes;
+		SerializeColumns(bytes);
+		ChartHasher hasher;
+		hasher.Add(bytes.data(), bytes.size());
+		fContentHash = hasher.Get();
+	}
+	return fContentHash;
+}
+
+/*
+*/
+bool ChartDataset::Resolve(const ChartDataRef& ref, ChartSeriesView& view) const
+{
+	view.categories = nullptr;
+	view.series.clear();
+
+	if (!ref.categoryColumn.empty()) {
+		view.categories = FindColumn(ref.categoryColumn);
+		if (!view.categories) return false;
+	}
+	else {
+		for (const ChartColumn& column : fColumns) {
+			if (column.kind == ChartColumn::kText) {
+				view.categories = &column;
+				break;
+			}
+		}
+	}
+
+	if (ref.valueColumns.empty()) {
+		for (const ChartColumn& column : fColumns) {
+			if (column.kind == ChartColumn::kNumeric && &column != view.categories) {
+				view.series.push_back(&column);
+			}
+		}
+	}
+	else {
+		for (const std::string& name : ref.valueColumns) {
+			const ChartColumn* column = FindColumn(name);
+			if (!column || column->kind != ChartColumn::kNumeric) return false;
+			view.series.push_back(column);
+		}
+	}
+
+	return !view.series.empty();
+}
+
+/*
+*/
+bool ChartDataset::Facet(const std::string& column, std::vector<ChartDataset>& facets) const
+{
+	facets.clear();
+	const ChartColumn* facetColumn = FindColumn(column);
+	if (!facetColumn) return false;
+
+	// Rows of each facet, in order
+	std::vector<std::string> cells;
+	std::vector<std::vector<size_t> > rows;
+	std::unordered_map<std::string, size_t> index;
+	for (size_t row = 0; row < facetColumn->Size(); row++) {
+		const std::string cell = facetColumn->Label(row);
+		auto found = index.find(cell);
+		if (found == index.end()) {
+			found = index.emplace(cell, cells.size()).first;
+			cells.push_back(cell);
+			rows.push_back(std::vector<size_t>());
+		}
+		rows[found->second].push_back(row);
+	}
+
+	// The facet column itself is left out, so a selection that takes the first text or
+	// every numeric column picks the same columns from each facet
+	facets.resize(cells.size());
+	for (size_t f = 0; f < cells.size(); f++) {
+		ChartDataset& facet = facets[f];
+		facet.fID = fID + "/" + cells[f];
+		for (const ChartColumn& source : fColumns) {
+			if (&source == facetColumn) continue;
+
+			ChartColumn part;
+			part.name = source.name;
+			part.kind = source.kind;
+			if (source.kind == ChartColumn::kNumeric) {
+				part.numbers.reserve(rows[f].size());
+				for (size_t row : rows[f]) {
+					part.numbers.push_back(row < source.numbers.size() ? source.numbers[row] : std::numeric_limits<double>::quiet_NaN());
+				}
+			}
+			else {
+				part.texts.reserve(rows[f].size());
+				for (size_t row : rows[f]) {
+					part.texts.push_back(source.Label(row));
+				}
+			}
+			facet.fColumns.push_back(std::move(part));
+		}
+		facet.GetContentHash();
+	}
+	return true;
+}
+
+/*
+*/
+void ChartDataset::SerializeColumns(std::vector<uint8_t>& out) const
+{
+	ChartBinaryWriter writer(out);
+	writer.WriteU32((uint32_t)fColumns.size());
+	for (const ChartColumn& column : fColumns) {
+		writer.WriteString(column.name);
+		writer.WriteU8((uint8_t)column.kind);
+		writer.WriteU32((uint32_t)column.Size());
+		if (column.kind == ChartColumn::kNumeric) {
+			writer.Write(column.numbers.data(), column.numbers.size() * sizeof(double));
+		}
+		else {
+			for (const std::string& text : column.texts) {
+				writer.WriteString(text);
+			}
+		}
+	}
+}
+
+/*
+*/
+void ChartDataset::Serialize(std::vector<uint8_t>& out) const
+{
+	out.clear();
+	ChartBinaryWriter writer(out);
+	writer.WriteU32(kDatasetMagic);
+	writer.WriteString(fID);
+	SerializeColumns(out);
+}
+
+/*
+*/
+bool ChartDataset::Deserialize(const uint8_t* data, size_t size, ChartDataset& dataset)
+{
+	ChartBinaryReader reader(data, size);
+	uint32_t magic = 0, columnCount = 0;
+	if (!reader.ReadU32(magic) || magic != kDatasetMagic) return false;
+
+	ChartDataset result;
+	if (!reader.ReadString(result.fID) || !reader.ReadU32(columnCount)) return false;
+
+	result.fColumns.resize(columnCount);
+	for (ChartColumn& column : result.fColumns) {
+		uint8_t kind = 0;
+		uint32_t count = 0;
+		if (!reader.ReadString(column.name) || !reader.ReadU8(kind) || !reader.ReadU32(count)) return false;
+		column.kind = kind == ChartColumn::kText ? ChartColumn::kText : ChartColumn::kNumeric;
+		if (column.kind == ChartColumn::kNumeric) {
+			if (!reader.CanHold(count, sizeof(double))) return false;
+			column.numbers.resize(count);
+			if (!reader.Read(column.numbers.data(), count * sizeof(double))) return false;
+		}
+		else {
+			if (!reader.CanHold(count, sizeof(uint32_t))) return false;
+			column.texts.resize(count);
+			for (std::string& text : column.texts) {
+				if (!reader.ReadString(text)) return false;
+			}
+		}
+	}
+
+	result.GetContentHash();
+	dataset = std::move(result);
+	return true;
+}
+
+/*
+*/
+bool ChartDataset::ParseCSV(const std::string& text, ChartDataset& dataset)
+{
+	size_t pos = 0;
+	std::vector<std::string> header, fields;
+	if (!NextRecord(text, pos, header) || header.empty()) return false;
+
+	std::vector<std::vector<std::string>> cells(header.size());
+	while (NextRecord(text, pos, fields)) {
+		if (fields.size() == 1 && fields[0].empty()) continue;	// Blank line
+		for (size_t i = 0; i < header.size(); i++) {
+			cells[i].push_back(i < fields.size() ? fields[i] : std::string());
+		}
+	}
+
+	dataset.fColumns.clear();
+	dataset.fContentHash = 0;
+	for (size_t i = 0; i < header.size(); i++) {
+		ChartColumn column;
+		column.name = header[i];
+		column.numbers.reserve(cells[i].size());
+
+		bool numeric = true;
+		for (const std::string& cell : cells[i]) {
+			double value = 0;
+			if (!ParseNumber(cell, value)) {
+				numeric = false;
+				break;
+			}
+			column.numbers.push_back(value);
+		}
+
+		if (!numeric) {
+			column.kind = ChartColumn::kText;
+			column.numbers.clear();
+			column.texts.swap(cells[i]);
+		}
+		dataset.fColumns.push_back(std::move(column));
+	}
+	dataset.GetContentHash();
+	return true;
+}
+
+/*
+*/
+const ChartDataset& ChartDataset::Sample()
+{
+	static const ChartDataset sample = []() {
+		ChartDataset dataset("Sample");
+
+		ChartColumn months;
+		months.name = "Month";
+		months.kind = ChartColumn::kText;
+		months.texts = {"Jan", "Feb", "Mar", "Apr", "May"};
+		dataset.AddColumn(months);
+
+		const char* names[] = {"2022", "2023", "2024"};
+		const double values[3][5] = {
+			{75.0, 45.0, 90.0, 60.0, 85.0},
+			{65.0, 55.0, 80.0, 70.0, 75.0},
+			{85.0, 50.0, 95.0, 65.0, 90.0}
+		};
+		for (int i = 0; i < 3; i++) {
+			ChartColumn series;
+			series.name = names[i];
+			series.numbers.assign(values[i], values[i] + 5);
+			dataset.AddColumn(series);
+		}
+		dataset.GetContentHash();
+		return dataset;
+	}();
+	return sample;
+}
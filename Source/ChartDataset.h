@@ -0,0 +1,119 @@
+//========================================================================================
+//  
+//  ChartDataset.h
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#ifndef __ChartDataset_h__
+#define __ChartDataset_h__
+
+// Tabular chart data. Deliberately free of Illustrator SDK types so the same model
+// can be decoded, shared and laid out without the application.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// One column of a dataset
+struct ChartColumn {
+	enum Kind {
+		kNumeric = 0,
+		kText
+	};
+
+	std::string name;
+	Kind kind;
+	std::vector<double> numbers;		// Used when kind == kNumeric, NaN for missing values
+	std::vector<std::string> texts;		// Used when kind == kText
+
+	ChartColumn() : kind(kNumeric) {}
+
+	size_t Size() const { return kind == kNumeric ? numbers.size() : texts.size(); }
+
+	// Cell as display text
+	std::string Label(size_t row) const;
+};
+
+// A chart's reference into a shared dataset: which dataset and which columns
+struct ChartDataRef {
+	std::string datasetID;
+	std::string categoryColumn;				// Empty uses the first text column
+	std::vector<std::string> valueColumns;	// Empty uses every numeric column
+};
+
+// Columns of a dataset selected by a ChartDataRef. Points into the dataset, which
+// must outlive the view.
+struct ChartSeriesView {
+	const ChartColumn* categories;
+	std::vector<const ChartColumn*> series;
+
+	ChartSeriesView() : categories(nullptr) {}
+
+	size_t CategoryCount() const;
+	std::string CategoryLabel(size_t index) const;
+};
+
+// A named table of columns, identified by ID and by a hash of its content
+class ChartDataset {
+public:
+	ChartDataset() : fContentHash(0) {}
+	explicit ChartDataset(const std::string& datasetID) : fID(datasetID), fContentHash(0) {}
+
+	const std::string& GetID() const { return fID; }
+	void SetID(const std::string& datasetID) { fID = datasetID; }
+
+	size_t GetColumnCount() const { return fColumns.size(); }
+	size_t GetRowCount() const;
+	const ChartColumn& GetColumn(size_t index) const { return fColumns[index]; }
+	const ChartColumn* FindColumn(const std::string& name) const;
+
+	// Adds a column; invalidates the content hash
+	void AddColumn(const ChartColumn& column);
+
+	// Hash of the column names and cells, independent of the ID. Datasets from ParseCSV,
+	// Deserialize, Facet and Sample hold it already, so threads sharing one only read it;
+	// one built with AddColumn computes it on the first call, which must not race.
+	uint64_t GetContentHash() const;
+
+	// Resolves a column selection against this dataset
+	bool Resolve(const ChartDataRef& ref, ChartSeriesView& view) const;
+
+	// Splits the rows by their cell in column, one dataset per distinct cell in order of
+	// first appearance, holding the other columns' cells of its rows. A facet's ID is this
+	// dataset's ID and the cell, joined by a slash. Returns false if there is no such column.
+	bool Facet(const std::string& column, std::vector<ChartDataset>& facets) const;
+
+	// Compact binary form used for document storage
+	void Serialize(std::vector<uint8_t>& out) const;
+	static bool Deserialize(const uint8_t* data, size_t size, ChartDataset& dataset);
+
+	// Parses CSV text with a header row. Columns whose cells all parse as numbers
+	// become numeric columns.
+	static bool ParseCSV(const std::string& text, ChartDataset& dataset);
+
+	// The dataset charts are drawn from until the user binds their own
+	static const ChartDataset& Sample();
+
+private:
+	void SerializeColumns(std::vector<uint8_t>& out) const;
+
+	std::string fID;
+	std::vector<ChartColumn> fColumns;
+	mutable uint64_t fContentHash;		// 0 until computed
+};
+
+// A resolved data binding for rendering: the shared decoded dataset and the selection
+struct ChartDataSource {
+	std::shared_ptr<const ChartDataset> dataset;
+	ChartDataRef ref;
+};
+
+#endif // __ChartDataset_h__
@@ -0,0 +1,183 @@
+//========================================================================================
+//  
+//  ChartDatasetStore.cpp
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#include "IllustratorSDK.h"
+#include "ChartDatasetStore.h"
+#include "ChartsSuites.h"
+#include "SDKErrors.h"
+#include <cstdio>
+
+namespace {
+
+std::string HashString(uint64_t hash)
+{
+	char buffer[17];
+	snprintf(buffer, sizeof(buffer), "%016llx", (unsigned long long)hash);
+	return buffer;
+}
+
+} // namespace
+
+/*
+*/
+std::string ChartDatasetStore::EntryKey(const std::string& datasetID)
+{
+	return std::string("ChartDataset:") + datasetID;
+}
+
+/*
+*/
+std::string ChartDatasetStore::HashKey(const std::string& datasetID)
+{
+	return std::string("ChartDatasetHash:") + datasetID;
+}
+
+/*
+*/
+ASErr ChartDatasetStore::Put(const ChartDataset& dataset, AIBoolean* changed)
+{
+	ASErr result = kNoErr;
+	AIDictionaryRef dict = nullptr;
+
+	if (changed) {
+		*changed = false;
+	}
+
+	try {
+		result = sAIDocument->GetDictionary(&dict);
+		aisdk::check_ai_error(result);
+
+		// Compare hashes first so re-importing identical data costs no document write
+		std::string hash = HashString(dataset.GetContentHash());
+		const char* storedHash = nullptr;
+		AIBoolean same = sAIDictionary->GetStringEntry(dict, sAIDictionary->Key(HashKey(dataset.GetID()).c_str()), &storedHash) == kNoErr
+			&& storedHash && hash == storedHash;
+
+		if (!same) {
+			std::vector<uint8_t> bytes;
+			dataset.Serialize(bytes);
+			result = sAIDictionary->SetBinaryEntry(dict, sAIDictionary->Key(EntryKey(dataset.GetID()).c_str()), bytes.data(), (ai::int32)bytes.size());
+			aisdk::check_ai_error(result);
+			result = sAIDictionary->SetStringEntry(dict, sAIDictionary->Key(HashKey(dataset.GetID()).c_str()), hash.c_str());
+			aisdk::check_ai_error(result);
+
+			if (changed) {
+				*changed = true;
+			}
+		}
+
+		auto cached = fDecoded.find(dataset.GetID());
+		if (!same || cached == fDecoded.end()) {
+			fDecoded[dataset.GetID()] = std::make_shared<const ChartDataset>(dataset);
+		}
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+
+	if (dict) {
+		sAIDictionary->Release(dict);
+	}
+
+	return result;
+}
+
+/*
+*/
+std::shared_ptr<const ChartDataset> ChartDatasetStore::Get(const std::string& datasetID)
+{
+	auto cached = fDecoded.find(datasetID);
+	if (cached != fDecoded.end()) {
+		return cached->second;
+	}
+
+	std::shared_ptr<const ChartDataset> decoded;
+	AIDictionaryRef dict = nullptr;
+	if (sAIDocument->GetDictionary(&dict) == kNoErr && dict) {
+		AIDictKey key = sAIDictionary->Key(EntryKey(datasetID).c_str());
+
+		// Query the size, then read the entry
+		ai::int32 size = 0;
+		if (sAIDictionary->GetBinaryEntry(dict, key, nullptr, &size) == kNoErr && size > 0) {
+			std::vector<uint8_t> bytes((size_t)size);
+			auto dataset = std::make_shared<ChartDataset>();
+			if (sAIDictionary->GetBinaryEntry(dict, key, bytes.data(), &size) == kNoErr &&
+				ChartDataset::Deserialize(bytes.data(), bytes.size(), *dataset)) {
+				decoded = dataset;
+				fDecoded[datasetID] = decoded;
+			}
+		}
+		sAIDictionary->Release(dict);
+	}
+
+	return decoded;
+}
+
+/*
+*/
+ASErr ChartDatasetStore::Remove(const std::string& datasetID)
+{
+	ASErr result = kNoErr;
+	AIDictionaryRef dict = nullptr;
+
+	try {
+		fDecoded.erase(datasetID);
+
+		result = sAIDocument->GetDictionary(&dict);
+		aisdk::check_ai_error(result);
+		sAIDictionary->DeleteEntry(dict, sAIDictionary->Key(EntryKey(datasetID).c_str()));
+		sAIDictionary->DeleteEntry(dict, sAIDictionary->Key(HashKey(datasetID).c_str()));
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+
+	if (dict) {
+		sAIDictionary->Release(dict);
+	}
+
+	return result;
+}
+
+/*
+*/
+ASErr ChartDatasetStore::Resolve(const ChartDataRef& ref, ChartDataSource& source)
+{
+	ASErr result = kNoErr;
+
+	try {
+		source.ref = ref;
+		source.dataset.reset();
+
+		if (!ref.datasetID.empty()) {
+			source.dataset = this->Get(ref.datasetID);
+		}
+
+		if (!source.dataset) {
+			const ChartDataset& sample = ChartDataset::Sample();
+			source.dataset = this->Get(sample.GetID());
+			if (!source.dataset) {
+				result = this->Put(sample);
+				aisdk::check_ai_error(result);
+				source.dataset = this->Get(sample.GetID());
+			}
+			source.ref = ChartDataRef();
+			source.ref.datasetID = sample.GetID();
+		}
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+
+	return result;
+}
@@ -0,0 +1,80 @@
+//========================================================================================
+//  
+//  ChartDatasetStore.h
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#ifndef __ChartDatasetStore_h__
+#define __ChartDatasetStore_h__
+
+#include "IllustratorSDK.h"
+#include "ChartDataset.h"
+#include <map>
+#include <memory>
+#include <string>
+
+/** Document-level storage of chart datasets.
+
+	Each dataset is persisted once in the document dictionary, keyed by its ID,
+	and charts store only a ChartDataRef. Decoded datasets are cached so every
+	chart drawn from the same dataset shares one in-memory copy.
+*/
+class ChartDatasetStore
+{
+public:
+	/** Stores a dataset in the document, replacing any dataset with the same ID.
+		Nothing is written if the stored content hash already matches.
+		@param dataset IN the dataset to store.
+		@param changed OUT optional, set to true if the stored content changed.
+		@return kNoErr on success, other ASErr otherwise.
+	*/
+	ASErr Put(const ChartDataset& dataset, AIBoolean* changed = nullptr);
+
+	/** Gets the shared decoded copy of a dataset, decoding it from the document
+		on first use.
+		@param datasetID IN the dataset ID.
+		@return the dataset, or an empty pointer if the document has no such dataset.
+	*/
+	std::shared_ptr<const ChartDataset> Get(const std::string& datasetID);
+
+	/** Removes a dataset from the document.
+		@param datasetID IN the dataset ID.
+		@return kNoErr on success, other ASErr otherwise.
+	*/
+	ASErr Remove(const std::string& datasetID);
+
+	/** Resolves a chart's data reference to a data source for rendering.
+		Falls back to the sample dataset, storing it in the document if needed,
+		when the reference is empty or its dataset is missing.
+		@param ref IN the chart's data reference.
+		@param source OUT the resolved source.
+		@return kNoErr on success, other ASErr otherwise.
+	*/
+	ASErr Resolve(const ChartDataRef& ref, ChartDataSource& source);
+
+	/** Drops all decoded datasets; they are decoded again on next use.
+	*/
+	void Clear() { fDecoded.clear(); }
+
+private:
+	/** Document dictionary key holding a dataset.
+	*/
+	static std::string EntryKey(const std::string& datasetID);
+
+	/** Document dictionary key holding a dataset's content hash.
+	*/
+	static std::string HashKey(const std::string& datasetID);
+
+	/** Decoded datasets keyed by ID.
+	*/
+	std::map<std::string, std::shared_ptr<const ChartDataset>> fDecoded;
+};
+
+#endif // __ChartDatasetStore_h__
@@ -0,0 +1,484 @@
+//========================================================================================
+//  
+//  ChartDisplayEmitter.cpp
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#include "IllustratorSDK.h"
+#include "ChartDisplayEmitter.h"
+#include "ChartsSuites.h"
+#include "SDKErrors.h"
+#include "AITextFrame.h"
+#include "IText.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace {
+
+const char* const kShapeNames[kChartMarkerShapeCount] = {"Circle", "Square", "Diamond", "Triangle"};
+
+// Sets text at anchor in the cursor's next point text, moving it and rewriting its
+// contents only where they differ, or in a new point text if the cursor has none.
+// changed reports a new, moved or rewritten text, whose paragraph features the caller
+// then sets.
+ASErr SetPointText(ChartArtCursor& cursor, const ChartPoint& anchor, const std::string& text, AIArtHandle* textArt, AIBoolean* changed)
+{
+	ASErr result = kNoErr;
+
+	try {
+		*changed = false;
+		const ai::UnicodeString contents = ai::UnicodeString::FromUTF8(text);
+
+		AIArtHandle art = cursor.Take(kTextFrameArt);
+		if (art) {
+			// A point text's frame matrix translates it to its anchor
+			AIRealMatrix matrix;
+			result = sAITextFrame->GetTextFrameMatrix(art, &matrix);
+			aisdk::check_ai_error(result);
+			if (!ChartPathBuilder::IsSamePoint(matrix.tx, matrix.ty, (AIReal)anchor.h, (AIReal)anchor.v)) {
+				matrix.tx = (AIReal)anchor.h;
+				matrix.ty = (AIReal)anchor.v;
+				result = sAITextFrame->SetTextFrameMatrix(art, &matrix);
+				aisdk::check_ai_error(result);
+				*changed = true;
+			}
+
+			TextRangeRef range = nullptr;
+			result = sAITextFrame->GetATETextRange(art, &range);
+			aisdk::check_ai_error(result);
+			ATE::ITextRange textRange(range);
+
+			const std::basic_string<ASUnicode> wanted = contents.as_ASUnicode();
+			std::vector<ASUnicode> existing((size_t)textRange.GetSize() + 1);
+			const ASInt32 length = textRange.GetContents(existing.data(), (ASInt32)existing.size());
+			if ((size_t)length != wanted.size() || !std::equal(wanted.begin(), wanted.end(), existing.begin())) {
+				textRange.Remove();
+				textRange.InsertAfter(wanted.c_str());
+				*changed = true;
+			}
+		}
+		else {
+			short paintOrder;
+			AIArtHandle prep;
+			cursor.GetInsertion(paintOrder, prep);
+
+			AIRealPoint point;
+			point.h = (AIReal)anchor.h;
+			point.v = (AIReal)anchor.v;
+			result = sAITextFrame->NewPointText(paintOrder, prep, kHorizontalTextOrientation, point, &art);
+			aisdk::check_ai_error(result);
+
+			TextRangeRef range = nullptr;
+			result = sAITextFrame->GetATETextRange(art, &range);
+			aisdk::check_ai_error(result);
+			ATE::ITextRange textRange(range);
+			textRange.InsertAfter(contents.as_ASUnicode().c_str());
+			*changed = true;
+		}
+
+		*textArt = art;
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+
+	return result;
+}
+
+ATE::ParagraphJustification GetJustification(ChartJustification justification)
+{
+	return justification == kChartJustifyCenter ? ATE::kCenterJustify :
+		justification == kChartJustifyRight ? ATE::kRightJustify : ATE::kLeftJustify;
+}
+
+} // namespace
+
+/*
+*/
+ASErr ChartDisplayEmitter::Emit(const ChartDisplayList& list, ChartArtCursor& cursor, const ChartDisplayDiff* diff)
+{
+	Begin(list, cursor, diff);
+
+	AIBoolean done = false;
+	return Resume(SIZE_MAX, &done);
+}
+
+/*
+*/
+void ChartDisplayEmitter::Begin(const ChartDisplayList& list, ChartArtCursor& cursor, const ChartDisplayDiff* diff)
+{
+	fList = &list;
+	fDiff = (diff && diff->states.size() == list.GetSize()) ? diff : nullptr;
+
+	fFrames.clear();
+	std::unique_ptr<Frame> root(new Frame);
+	root->end = list.GetSize();
+	root->cursor = &cursor;
+	fFrames.push_back(std::move(root));
+}
+
+/*
+*/
+ASErr ChartDisplayEmitter::Resume(size_t count, AIBoolean* done)
+{
+	ASErr result = kNoErr;
+
+	try {
+		size_t emitted = 0;
+		while (!fFrames.empty() && emitted < count) {
+			Frame& frame = *fFrames.back();
+			if (frame.next >= frame.end) {
+				result = CloseGroup();
+				aisdk::check_ai_error(result);
+				continue;
+			}
+
+			// The frame stays in place when a group pushes its own above it
+			const size_t index = frame.next;
+			const ChartPrimitive& primitive = (*fList)[index];
+			if (primitive.kind == kChartPrimitiveGroup) {
+				frame.next = primitive.end;
+				result = OpenGroup(index, *frame.cursor);
+			}
+			else {
+				frame.next = index + 1;
+				result = EmitChild(index, frame);
+			}
+			aisdk::check_ai_error(result);
+			emitted++;
+		}
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+
+	if (result != kNoErr || fFrames.empty()) {
+		Cancel();
+	}
+	*done = fFrames.empty();
+	return result;
+}
+
+/*
+*/
+void ChartDisplayEmitter::Cancel()
+{
+	fFrames.clear();
+	fList = nullptr;
+	fDiff = nullptr;
+}
+
+/*
+*/
+ASErr ChartDisplayEmitter::OpenGroup(size_t index, ChartArtCursor& cursor)
+{
+	ASErr result = kNoErr;
+
+	try {
+		const ChartPrimitive& primitive = (*fList)[index];
+
+		// Nothing inside an unchanged group moved, so its art is kept as it is
+		if (IsUnchanged(index) && cursor.Take(kGroupArt)) {
+			return kNoErr;
+		}
+
+		AIArtHandle group = nullptr;
+		result = cursor.TakeGroup(ai::UnicodeString::FromUTF8(primitive.text), &group);
+		aisdk::check_ai_error(result);
+
+		std::unique_ptr<Frame> frame(new Frame);
+		frame->next = index + 1;
+		frame->end = primitive.end;
+		frame->children = ChartArtCursor(group);
+		if (primitive.merge) {
+			result = GetMarkerSymbol(index, group, &frame->symbol);
+			aisdk::check_ai_error(result);
+			if (!frame->symbol) {
+				frame->paths.reset(new ChartPathSet(frame->children, GetStyle(primitive), fEmitMode));
+			}
+		}
+		fFrames.push_back(std::move(frame));
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+
+	return result;
+}
+
+/*
+*/
+ASErr ChartDisplayEmitter::CloseGroup()
+{
+	ASErr result = kNoErr;
+
+	try {
+		Frame& frame = *fFrames.back();
+		if (frame.paths) {
+			result = frame.paths->Finish();
+			aisdk::check_ai_error(result);
+		}
+
+		// The caller finishes its own cursor
+		if (frame.cursor == &frame.children) {
+			result = frame.children.Finish();
+			aisdk::check_ai_error(result);
+		}
+		fFrames.pop_back();
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+
+	return result;
+}
+
+/*
+*/
+ASErr ChartDisplayEmitter::EmitChild(size_t index, Frame& frame)
+{
+	ASErr result = kNoErr;
+
+	try {
+		const ChartPrimitive& primitive = (*fList)[index];
+		ChartArtCursor& cursor = *frame.cursor;
+
+		if (frame.symbol) {
+			if (!IsUnchanged(index) || !cursor.Take(kSymbolArt)) {
+				result = ChartPathBuilder::PlaceSymbol(cursor, frame.symbol, (AIReal)primitive.origin.h, (AIReal)primitive.origin.v);
+				aisdk::check_ai_error(result);
+			}
+		}
+		else if (primitive.kind == kChartPrimitiveText) {
+			if (!IsUnchanged(index) || !cursor.Take(kTextFrameArt)) {
+				result = EmitText(primitive, cursor);
+				aisdk::check_ai_error(result);
+			}
+		}
+		else if (frame.paths) {
+			if (!IsUnchanged(index) || !frame.paths->Keep()) {
+				AIBoolean closed = false;
+				BuildPath(primitive, closed);
+				result = frame.paths->Add(fBuilder, closed);
+				aisdk::check_ai_error(result);
+			}
+		}
+		else if (!IsUnchanged(index) || !cursor.Take(kPathArt)) {
+			AIBoolean closed = false;
+			BuildPath(primitive, closed);
+			result = ChartPathBuilder::CommitSegments(cursor, fBuilder.GetSegments(), fBuilder.GetCount(), closed, GetStyle(primitive));
+			aisdk::check_ai_error(result);
+		}
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+
+	return result;
+}
+
+/*
+*/
+ASErr ChartDisplayEmitter::GetMarkerSymbol(size_t index, AIArtHandle group, AIPatternHandle* symbol)
+{
+	ASErr result = kNoErr;
+
+	try {
+		*symbol = nullptr;
+		const ChartPrimitive& parent = (*fList)[index];
+		ChartStyle* style = GetStyle(parent);
+
+		// A group of markers alone may be cheaper as instances of one symbol
+		size_t markerCount = 0;
+		for (size_t child = index + 1; child < parent.end; child++) {
+			if ((*fList)[child].kind != kChartPrimitiveMarker) {
+				return kNoErr;
+			}
+			markerCount++;
+		}
+		if (markerCount == 0 || !style) {
+			return kNoErr;
+		}
+
+		const ChartPrimitive& first = (*fList)[index + 1];
+		ChartMarkerMode mode = fMarkerMode;
+		if (mode == kChartMarkersAuto) {
+			mode = ChartMarkerPath::ChooseMode(first.shape, markerCount);
+		}
+		if (mode != kChartMarkersSymbols) {
+			return kNoErr;
+		}
+
+		// One symbol per style, shape and size, shared by every chart in the document
+		ai::UnicodeString symbolName;
+		if (!style->name.empty()) {
+			char suffix[64];
+			snprintf(suffix, sizeof(suffix), " %s %gpt Marker", kShapeNames[first.shape], first.size);
+			symbolName = style->name;
+			symbolName.append(ai::UnicodeString(suffix));
+		}
+
+		result = ChartMarkerPath::GetSymbol(first.shape, (AIReal)first.size, *style, symbolName, group, symbol);
+		aisdk::check_ai_error(result);
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+
+	return result;
+}
+
+/*
+*/
+ASErr ChartDisplayEmitter::EmitText(const ChartPrimitive& text, ChartArtCursor& cursor)
+{
+	AIArtHandle textArt = nullptr;
+	AIBoolean changed = false;
+	ASErr result = SetPointText(cursor, text.origin, text.text, &textArt, &changed);
+	if (result != kNoErr || !changed) {
+		return result;
+	}
+
+	TextRangeRef range = nullptr;
+	result = sAITextFrame->GetATETextRange(textArt, &range);
+	if (result == kNoErr && range) {
+		ATE::ITextRange textRange(range);
+
+		// Justification and cell positions apply to every line
+		ATE::IParaFeatures paraFeatures;
+		paraFeatures.SetJustification(GetJustification(text.justification));
+		if (!text.tabStops.empty()) {
+			ATE::ITabStops tabStops;
+			for (double position : text.tabStops) {
+				ATE::ITabStop tabStop;
+				tabStop.SetTabType(ATE::kCenterTabType);
+				tabStop.SetPosition((AIReal)position);
+				tabStops.ReplaceOrAdd(tabStop);
+			}
+			paraFeatures.SetTabStops(tabStops);
+		}
+		textRange.SetLocalParaFeatures(paraFeatures);
+
+		// Lines of a block sit exactly on the labels' baselines
+		if (text.leading > 0) {
+			ATE::ICharFeatures charFeatures;
+			charFeatures.SetAutoLeading(false);
+			charFeatures.SetLeading((AIReal)text.leading);
+			textRange.SetLocalCharFeatures(charFeatures);
+		}
+	}
+
+	return result;
+}
+
+/*
+*/
+AIBoolean ChartDisplayEmitter::IsUnchanged(size_t index) const
+{
+	if (!fDiff) {
+		return false;
+	}
+
+	const ChartPrimitive& primitive = (*fList)[index];
+	const size_t end = primitive.kind == kChartPrimitiveGroup ? primitive.end : index + 1;
+	for (size_t i = index; i < end; i++) {
+		if (fDiff->states[i] != kChartPrimitiveUnchanged) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+*/
+void ChartDisplayEmitter::BuildPath(const ChartPrimitive& primitive, AIBoolean& closed)
+{
+	fBuilder.Clear();
+	closed = true;
+
+	switch (primitive.kind) {
+		case kChartPrimitiveRect: {
+			const ChartRectPath rect(primitive.rect);
+			fBuilder.AddSegments(rect.GetSegments(), 4);
+			break;
+		}
+		case kChartPrimitivePolyline:
+			fBuilder.Reserve(primitive.points.size());
+			for (const ChartPoint& point : primitive.points) {
+				fBuilder.AddPoint(point);
+			}
+			closed = primitive.closed;
+			break;
+		case kChartPrimitiveArc: {
+			const double kFullTurn = 6.283185307179586;
+			fBuilder.AddArc(primitive.origin, primitive.radius, primitive.startAngle, primitive.endAngle);
+			if (primitive.innerRadius > 0) {
+				// Ring sector: back along the inner edge
+				fBuilder.AddArc(primitive.origin, primitive.innerRadius, primitive.endAngle, primitive.startAngle);
+			}
+			else if (std::fabs(primitive.endAngle - primitive.startAngle) < kFullTurn - 1e-9) {
+				// Wedge: the two radii meet at the center
+				fBuilder.AddPoint(primitive.origin);
+			}
+			else {
+				fBuilder.CloseLoop();
+			}
+			break;
+		}
+		case kChartPrimitiveMarker: {
+			const ChartMarkerPath marker(primitive.shape, (AIReal)primitive.origin.h, (AIReal)primitive.origin.v, (AIReal)primitive.size);
+			fBuilder.AddSegments(marker.GetSegments(), marker.GetCount());
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+/*
+*/
+ChartStyle* ChartDisplayEmitter::GetStyle(const ChartPrimitive& primitive)
+{
+	if (primitive.role >= 0 && primitive.role < kChartStyleRoleCount) {
+		return &fStyles.Get((ChartStyleRole)primitive.role);
+	}
+	if (primitive.role == kChartPaintSeries) {
+		return &fStyles.GetSeries(primitive.series);
+	}
+	if (primitive.role == kChartPaintSeriesLine) {
+		return &fStyles.GetSeriesLine(primitive.series);
+	}
+	return nullptr;
+}
+
+/*
+*/
+AIBoolean ChartRetainedArt::Matches(AIArtHandle chartArt, ChartEmitMode emitMode, ChartMarkerMode markerMode) const
+{
+	if (!fValid || chartArt != fArt || emitMode != fEmitMode || markerMode != fMarkerMode) {
+		return false;
+	}
+
+	size_t timeStamp = 0;
+	return sAIArt->GetArtTimeStamp(chartArt, kAITimeStampMaxFromArtAndChildren, &timeStamp) == kNoErr && timeStamp == fTimeStamp;
+}
+
+/*
+*/
+void ChartRetainedArt::Retain(AIArtHandle chartArt, ChartDisplayList& list, ChartEmitMode emitMode, ChartMarkerMode markerMode)
+{
+	fList.Swap(list);
+	list.Clear();
+	fArt = chartArt;
+	fEmitMode = emitMode;
+	fMarkerMode = markerMode;
+	fValid = sAIArt->GetArtTimeStamp(chartArt, kAITimeStampMaxFromArtAndChildren, &fTimeStamp) == kNoErr;
+}
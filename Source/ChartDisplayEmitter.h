@@ -0,0 +1,126 @@
+//========================================================================================
+//  
+//  ChartDisplayEmitter.h
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#ifndef __ChartDisplayEmitter_h__
+#define __ChartDisplayEmitter_h__
+
+#include "IllustratorSDK.h"
+#include "ChartDisplayList.h"
+#include "ChartPathBuilder.h"
+#include "ChartStyleTable.h"
+#include <memory>
+#include <vector>
+
+// Turns a display list into Illustrator art at a cursor, the one place chart art is
+// emitted. Groups become named groups; the path children of a merged group share one
+// compound path, or one symbol per series for markers when that is cheaper. Art of an
+// earlier render is rewritten in place through the cursor. Given the diff against the
+// list that art was emitted from, unchanged primitives are kept without reading them
+// back, and unchanged groups are skipped whole. Emission can be spread over several
+// calls, resuming where the last one stopped.
+class ChartDisplayEmitter {
+public:
+	ChartDisplayEmitter(ChartStyleTable& styles, ChartEmitMode emitMode, ChartMarkerMode markerMode) :
+		fStyles(styles), fEmitMode(emitMode), fMarkerMode(markerMode), fList(nullptr), fDiff(nullptr), fBuilder(16) {}
+
+	// Emits list at cursor; the caller finishes the cursor. diff must compare list with
+	// the list the cursor's art was emitted from, or be null to check the art itself.
+	ASErr Emit(const ChartDisplayList& list, ChartArtCursor& cursor, const ChartDisplayDiff* diff = nullptr);
+
+	// Starts emitting list at cursor in steps, as Emit does at once. list, cursor and diff
+	// must outlive the emission, and the art must not be edited between steps.
+	void Begin(const ChartDisplayList& list, ChartArtCursor& cursor, const ChartDisplayDiff* diff = nullptr);
+
+	// Emits up to count more primitives of the list begun, finishing each group once its
+	// last child is emitted; done is set when the whole list is emitted or on an error
+	ASErr Resume(size_t count, AIBoolean* done);
+
+	// Abandons the emission begun; the art emitted so far stays as it is
+	void Cancel();
+
+	// Index of the next primitive to emit, for progress
+	size_t GetPosition() const { return fFrames.empty() ? 0 : fFrames.back()->next; }
+
+private:
+	// A group whose children are being emitted, from next to end, through a cursor of its
+	// own; the list itself is the bottom frame, emitted through the caller's cursor
+	struct Frame {
+		size_t next;
+		size_t end;
+		ChartArtCursor children;
+		ChartArtCursor* cursor;
+		std::unique_ptr<ChartPathSet> paths;	// Merged groups of paths
+		AIPatternHandle symbol;					// Merged groups of markers placed as symbols
+
+		Frame() : next(0), end(0), cursor(&children), symbol(nullptr) {}
+	};
+
+	// Takes or creates the group at index and pushes its frame, unless it is unchanged
+	ASErr OpenGroup(size_t index, ChartArtCursor& cursor);
+
+	// Finishes the top frame's paths and disposes its group's leftover children
+	ASErr CloseGroup();
+
+	ASErr EmitChild(size_t index, Frame& frame);
+	ASErr EmitText(const ChartPrimitive& text, ChartArtCursor& cursor);
+
+	// The symbol to place the markers of a merged group with, or null to merge them into
+	// a compound path
+	ASErr GetMarkerSymbol(size_t index, AIArtHandle group, AIPatternHandle* symbol);
+
+	// Whether the primitive, and for a group everything in it, is as it was emitted
+	AIBoolean IsUnchanged(size_t index) const;
+
+	// Segments of a path primitive into fBuilder
+	void BuildPath(const ChartPrimitive& primitive, AIBoolean& closed);
+
+	// Style of a primitive's paint, or null for none
+	ChartStyle* GetStyle(const ChartPrimitive& primitive);
+
+	ChartStyleTable& fStyles;
+	ChartEmitMode fEmitMode;
+	ChartMarkerMode fMarkerMode;
+	const ChartDisplayList* fList;
+	const ChartDisplayDiff* fDiff;
+	ChartPathBuilder fBuilder;
+	std::vector<std::unique_ptr<Frame> > fFrames;	// Open groups, the list first
+};
+
+// The display list a chart's art was last emitted from, kept between renders so that
+// the next render can diff against it. It is trusted only while the art is untouched:
+// any edit to the chart or its contents since it was retained moves the art's time
+// stamp, and the next render then checks the art itself.
+class ChartRetainedArt {
+public:
+	ChartRetainedArt() : fArt(nullptr), fTimeStamp(0), fEmitMode(kChartEmitCompoundPaths), fMarkerMode(kChartMarkersAuto), fValid(false) {}
+
+	// Whether the retained list still describes chartArt, emitted with these modes
+	AIBoolean Matches(AIArtHandle chartArt, ChartEmitMode emitMode, ChartMarkerMode markerMode) const;
+
+	// Retains list, emptying it, as the list chartArt was just emitted from
+	void Retain(AIArtHandle chartArt, ChartDisplayList& list, ChartEmitMode emitMode, ChartMarkerMode markerMode);
+
+	void Invalidate() { fValid = false; }
+
+	const ChartDisplayList& GetList() const { return fList; }
+
+private:
+	ChartDisplayList fList;
+	AIArtHandle fArt;
+	size_t fTimeStamp;
+	ChartEmitMode fEmitMode;
+	ChartMarkerMode fMarkerMode;
+	AIBoolean fValid;
+};
+
+#endif // __ChartDisplayEmitter_h__
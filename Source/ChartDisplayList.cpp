@@ -0,0 +1,628 @@
+//========================================================================================
+//  
+//  ChartDisplayList.cpp
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#include "ChartDisplayList.h"
+#include "ChartBinary.h"
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+namespace {
+
+bool IsSamePoint(const ChartPoint& a, const ChartPoint& b)
+{
+	return a.h == b.h && a.v == b.v;
+}
+
+bool IsSameRect(const ChartRect& a, const ChartRect& b)
+{
+	return a.left == b.left && a.top == b.top && a.right == b.right && a.bottom == b.bottom;
+}
+
+} // namespace
+
+/*
+*/
+ChartPrimitive::ChartPrimitive() :
+	id(0), kind(kChartPrimitiveGroup), role(kChartPaintNone), series(0), end(0), merge(false), data(false), closed(false),
+	radius(0), innerRadius(0), startAngle(0), endAngle(0), shape(kChartMarkerCircle), size(0),
+	justification(kChartJustifyLeft), leading(0)
+{
+	rect.left = rect.top = rect.right = rect.bottom = 0;
+	origin.h = origin.v = 0;
+}
+
+/*
+*/
+bool ChartPrimitive::IsSame(const ChartPrimitive& other) const
+{
+	if (kind != other.kind || role != other.role || series != other.series) {
+		return false;
+	}
+
+	switch (kind) {
+		case kChartPrimitiveGroup:
+			return merge == other.merge && text == other.text;
+		case kChartPrimitiveRect:
+			return IsSameRect(rect, other.rect);
+		case kChartPrimitivePolyline:
+			if (closed != other.closed || points.size() != other.points.size()) {
+				return false;
+			}
+			for (size_t i = 0; i < points.size(); i++) {
+				if (!IsSamePoint(points[i], other.points[i])) {
+					return false;
+				}
+			}
+			return true;
+		case kChartPrimitiveArc:
+			return IsSamePoint(origin, other.origin) && radius == other.radius && innerRadius == other.innerRadius &&
+				startAngle == other.startAngle && endAngle == other.endAngle;
+		case kChartPrimitiveMarker:
+			return IsSamePoint(origin, other.origin) && shape == other.shape && size == other.size;
+		case kChartPrimitiveText:
+			return IsSamePoint(origin, other.origin) && text == other.text && justification == other.justification &&
+				leading == other.leading && tabStops == other.tabStops;
+	}
+	return false;
+}
+
+/*
+*/
+void ChartDisplayList::Clear()
+{
+	fPrimitives.clear();
+	fOpenGroups.clear();
+
+	OpenGroup root = {};
+	root.index = UINT32_MAX;
+	fOpenGroups.push_back(root);
+}
+
+/*
+*/
+ChartPrimitive& ChartDisplayList::Append(ChartPrimitiveKind kind, int32_t role, int32_t series, const std::string* name)
+{
+	OpenGroup& parent = fOpenGroups.back();
+
+	// Groups are identified by name, so optional groups do not shift their siblings; other
+	// primitives by their position among the parent's children of the same kind
+	ChartHasher hasher;
+	hasher.AddU64(parent.id);
+	hasher.AddU64((uint64_t)kind);
+	if (name) {
+		hasher.AddString(*name);
+	}
+	else {
+		hasher.AddU64(parent.childCounts[kind]);
+	}
+	parent.childCounts[kind]++;
+
+	fPrimitives.emplace_back();
+	ChartPrimitive& primitive = fPrimitives.back();
+	primitive.id = hasher.Get();
+	primitive.kind = kind;
+	primitive.role = role;
+	primitive.series = series;
+	primitive.end = (uint32_t)fPrimitives.size();
+	return primitive;
+}
+
+/*
+*/
+ChartPrimitive& ChartDisplayList::BeginGroup(const std::string& name, int32_t role, int32_t series, bool merge)
+{
+	ChartPrimitive& group = Append(kChartPrimitiveGroup, role, series, &name);
+	group.text = name;
+	group.merge = merge;
+
+	OpenGroup open = {};
+	open.index = (uint32_t)(fPrimitives.size() - 1);
+	open.id = group.id;
+	fOpenGroups.push_back(open);
+	return group;
+}
+
+/*
+*/
+void ChartDisplayList::EndGroup()
+{
+	if (fOpenGroups.size() > 1) {
+		fPrimitives[fOpenGroups.back().index].end = (uint32_t)fPrimitives.size();
+		fOpenGroups.pop_back();
+	}
+}
+
+/*
+*/
+ChartPrimitive& ChartDisplayList::AddRect(const ChartRect& rect, int32_t role, int32_t series)
+{
+	ChartPrimitive& primitive = Append(kChartPrimitiveRect, role, series);
+	primitive.rect = rect;
+	return primitive;
+}
+
+/*
+*/
+ChartPrimitive& ChartDisplayList::AddLine(const ChartSegment& line, int32_t role)
+{
+	ChartPrimitive& primitive = Append(kChartPrimitivePolyline, role, 0);
+	primitive.points.reserve(2);
+	primitive.points.push_back(line.from);
+	primitive.points.push_back(line.to);
+	return primitive;
+}
+
+/*
+*/
+ChartPrimitive& ChartDisplayList::AddPolyline(const std::vector<ChartPoint>& points, bool closed, int32_t role, int32_t series)
+{
+	return AddPolyline(points.data(), points.size(), closed, role, series);
+}
+
+/*
+*/
+ChartPrimitive& ChartDisplayList::AddPolyline(const ChartPoint* points, size_t count, bool closed, int32_t role, int32_t series)
+{
+	ChartPrimitive& primitive = Append(kChartPrimitivePolyline, role, series);
+	primitive.points.assign(points, points + count);
+	primitive.closed = closed;
+	return primitive;
+}
+
+/*
+*/
+ChartPrimitive& ChartDisplayList::AddArc(const ChartPoint& center, double radius, double innerRadius, double startAngle, double endAngle, int32_t role, int32_t series)
+{
+	ChartPrimitive& primitive = Append(kChartPrimitiveArc, role, series);
+	primitive.origin = center;
+	primitive.radius = radius;
+	primitive.innerRadius = innerRadius;
+	primitive.startAngle = startAngle;
+	primitive.endAngle = endAngle;
+	return primitive;
+}
+
+/*
+*/
+ChartPrimitive& ChartDisplayList::AddMarker(ChartMarkerShape shape, const ChartPoint& center, double size, int32_t series)
+{
+	ChartPrimitive& primitive = Append(kChartPrimitiveMarker, kChartPaintSeries, series);
+	primitive.origin = center;
+	primitive.shape = shape;
+	primitive.size = size;
+	return primitive;
+}
+
+/*
+*/
+ChartPrimitive& ChartDisplayList::AddText(const ChartLabel& label)
+{
+	ChartPrimitive& primitive = Append(kChartPrimitiveText, kChartPaintNone, 0);
+	primitive.origin = label.anchor;
+	primitive.text = label.text;
+	primitive.justification = label.justification;
+	return primitive;
+}
+
+/*
+*/
+ChartPrimitive& ChartDisplayList::AddText(const ChartLabelBlock& block)
+{
+	ChartPrimitive& primitive = Append(kChartPrimitiveText, kChartPaintNone, 0);
+	primitive.origin = block.anchor;
+	primitive.text = block.text;
+	primitive.justification = block.justification;
+	primitive.leading = block.leading;
+	primitive.tabStops = block.tabStops;
+	return primitive;
+}
+
+/*
+*/
+void ChartDisplayList::Build(const ChartLayout& layout, bool combineLabels, ChartDisplayList& list)
+{
+	list.Clear();
+
+	size_t markerCount = 0;
+	for (const ChartMarkerSet& set : layout.markers) {
+		markerCount += set.centers.size();
+	}
+	for (const ChartLineSet& set : layout.lines) {
+		markerCount += set.runEnds.size() + 1;
+	}
+	markerCount += layout.areas.GetBoundaryCount();
+	markerCount += layout.wedges.size() * 2 + layout.seriesNames.size();
+	markerCount += layout.polygons.size() + layout.radarGrid.spokeEnds.size() + layout.radarGrid.GetRingCount();
+	list.Reserve(32 + layout.xGridLines.size() + layout.yGridLines.size() + layout.bars.size() + markerCount +
+		layout.xTicks.size() + layout.yTicks.size() + layout.xLabels.size() + layout.yLabels.size() +
+		layout.dataLabels.size() + layout.leaderLines.size());
+
+	// 1. Plot area background
+	list.BeginGroup("Background");
+	list.AddRect(layout.plotArea, kChartStylePlotArea);
+	list.EndGroup();
+
+	// 2. Grid lines, one compound path per direction
+	const struct {
+		const char* name;
+		const std::vector<ChartSegment>* lines;
+	} grids[2] = {{"X Grid", &layout.xGridLines}, {"Y Grid", &layout.yGridLines}};
+
+	for (const auto& grid : grids) {
+		list.BeginGroup(grid.name, kChartStyleGrid, 0, true);
+		for (const ChartSegment& line : *grid.lines) {
+			list.AddLine(line, kChartStyleGrid);
+		}
+		list.EndGroup();
+	}
+	list.AddRadarGrid(layout);
+
+	// 3. Series: a marker set, a line set, an area layer or a column set per series
+	const char* seriesGroup = "Columns";
+	if (!layout.markers.empty()) {
+		seriesGroup = "Markers";
+	}
+	else if (!layout.lines.empty()) {
+		seriesGroup = "Lines";
+	}
+	else if (!layout.areas.h.empty()) {
+		seriesGroup = "Areas";
+	}
+	else if (!layout.wedges.empty()) {
+		seriesGroup = "Slices";
+	}
+	else if (!layout.polygons.empty()) {
+		seriesGroup = "Polygons";
+	}
+	list.BeginGroup(seriesGroup);
+	list.AddMarkerSets(layout);
+	list.AddLineSets(layout);
+	list.AddAreaLayers(layout);
+	list.AddWedges(layout);
+	list.AddRadarPolygons(layout);
+	list.AddColumnSets(layout);
+	list.EndGroup();
+
+	// 4. Axes, which pie, donut and radar charts have none of
+	const bool polar = !layout.wedges.empty() || !layout.radarGrid.spokeEnds.empty();
+	list.BeginGroup("X Axis");
+	if (!polar) {
+		list.AddLine(layout.xAxis, kChartStyleAxis);
+	}
+	list.EndGroup();
+
+	list.BeginGroup("Y Axis");
+	if (!polar) {
+		list.AddLine(layout.yAxis, kChartStyleAxis);
+	}
+	list.EndGroup();
+
+	// 5. Tick marks
+	const struct {
+		const char* name;
+		const std::vector<ChartSegment>* lines;
+	} ticks[2] = {{"X Ticks", &layout.xTicks}, {"Y Ticks", &layout.yTicks}};
+
+	for (const auto& tick : ticks) {
+		list.BeginGroup(tick.name, kChartStyleTick, 0, true);
+		for (const ChartSegment& line : *tick.lines) {
+			list.AddLine(line, kChartStyleTick);
+		}
+		list.EndGroup();
+	}
+
+	// 6. Axis labels, one text object per axis where the labels allow it
+	const struct {
+		const char* name;
+		const std::vector<ChartLabel>* labels;
+		bool isRow;
+	} labelSets[2] = {{"X Axis Labels", &layout.xLabels, true}, {"Y Axis Labels", &layout.yLabels, false}};
+
+	for (const auto& labelSet : labelSets) {
+		list.BeginGroup(labelSet.name);
+		ChartLabelBlock block;
+		if (combineLabels &&
+			(labelSet.isRow ? ChartLayout::MakeLabelRow(*labelSet.labels, block) : ChartLayout::MakeLabelColumn(*labelSet.labels, block))) {
+			list.AddText(block);
+		}
+		else {
+			for (const ChartLabel& label : *labelSet.labels) {
+				list.AddText(label);
+			}
+		}
+		list.EndGroup();
+	}
+
+	// 7. Data labels
+	list.AddDataLabels(layout);
+}
+
+/*
+*/
+void ChartDisplayList::AddMarkerSets(const ChartLayout& layout)
+{
+	for (const ChartMarkerSet& set : layout.markers) {
+		if (set.centers.empty()) {
+			continue;
+		}
+		BeginGroup("Marker Set " + layout.seriesNames[set.series], kChartPaintSeries, set.series, true).data = true;
+		for (const ChartPoint& center : set.centers) {
+			AddMarker(set.shape, center, layout.markerSize, set.series);
+		}
+		EndGroup();
+	}
+}
+
+/*
+*/
+void ChartDisplayList::AddColumnSets(const ChartLayout& layout)
+{
+	// The layout orders bars by series
+	const int32_t columnSeries = layout.bars.empty() ? 0 : (int32_t)layout.seriesNames.size();
+	size_t barIdx = 0;
+	for (int32_t seriesIdx = 0; seriesIdx < columnSeries; seriesIdx++) {
+		BeginGroup("Column Set " + layout.seriesNames[seriesIdx], kChartPaintSeries, seriesIdx, true).data = true;
+		for (; barIdx < layout.bars.size() && layout.bars[barIdx].series == seriesIdx; barIdx++) {
+			AddRect(layout.bars[barIdx].rect, kChartPaintSeries, seriesIdx);
+		}
+		EndGroup();
+	}
+}
+
+/*
+*/
+void ChartDisplayList::AddLineSets(const ChartLayout& layout)
+{
+	for (const ChartLineSet& set : layout.lines) {
+		if (set.runEnds.empty()) {
+			continue;
+		}
+
+		// Each run is one path, its points written whole by the emitter. A run longer than
+		// a path allows continues in further paths, each starting on the last one's end.
+		BeginGroup("Line Set " + layout.seriesNames[set.series], kChartPaintNone, set.series).data = true;
+		uint32_t start = 0;
+		for (uint32_t end : set.runEnds) {
+			size_t first = start;
+			do {
+				const size_t count = std::min<size_t>(end - first, kChartMaxPathPoints);
+				AddPolyline(set.points.data() + first, count, false, kChartPaintSeriesLine, set.series);
+				first += count - 1;
+			} while (first + 1 < end);
+			start = end;
+		}
+		EndGroup();
+	}
+}
+
+/*
+*/
+void ChartDisplayList::AddAreaLayers(const ChartLayout& layout)
+{
+	const ChartAreaStack& stack = layout.areas;
+	const size_t count = stack.h.size();
+	if (count == 0 || stack.GetBoundaryCount() < 2) {
+		return;
+	}
+
+	// Each layer is a closed path along its top boundary and back along the boundary below,
+	// which is the top of the layer beneath it. A layer wider than a path allows is cut
+	// into bands side by side, each sharing its last category with the next.
+	BeginGroup("Area Layers").data = true;
+	const size_t bandWidth = kChartMaxPathPoints / 2;
+	std::vector<ChartPoint> points;
+	for (size_t layer = 0; layer + 1 < stack.GetBoundaryCount(); layer++) {
+		const double* bottom = stack.GetBoundary(layer);
+		const double* top = stack.GetBoundary(layer + 1);
+		size_t first = 0;
+		do {
+			const size_t width = std::min(count - first, bandWidth);
+			points.resize(width * 2);
+			for (size_t i = 0; i < width; i++) {
+				points[i].h = points[2 * width - 1 - i].h = stack.h[first + i];
+				points[i].v = top[first + i];
+				points[2 * width - 1 - i].v = bottom[first + i];
+			}
+			AddPolyline(points, true, kChartPaintSeries, (int32_t)layer);
+			first += width - 1;
+		} while (first + 1 < count);
+	}
+	EndGroup();
+}
+
+/*
+*/
+void ChartDisplayList::AddWedges(const ChartLayout& layout)
+{
+	if (layout.wedges.empty()) {
+		return;
+	}
+
+	// A pie's wedges are single paths
+	if (layout.wedges.front().innerRadius <= 0) {
+		BeginGroup("Wedges").data = true;
+		for (const ChartWedge& wedge : layout.wedges) {
+			AddArc(wedge.center, wedge.radius, 0, wedge.startAngle, wedge.endAngle, kChartPaintSeries, wedge.series);
+		}
+		EndGroup();
+		return;
+	}
+
+	// A donut slice's sectors, one per ring, share one compound path. A sector closing the
+	// whole ring is the outer circle with the inner one reversed inside it, which leaves
+	// the hole open.
+	const double kFullTurn = 6.283185307179586;
+	size_t index = 0;
+	while (index < layout.wedges.size()) {
+		const int32_t series = layout.wedges[index].series;
+		BeginGroup("Slice " + layout.seriesNames[series], kChartPaintSeries, series, true).data = true;
+		for (; index < layout.wedges.size() && layout.wedges[index].series == series; index++) {
+			const ChartWedge& wedge = layout.wedges[index];
+			if (std::fabs(wedge.endAngle - wedge.startAngle) < kFullTurn - 1e-9) {
+				AddArc(wedge.center, wedge.radius, wedge.innerRadius, wedge.startAngle, wedge.endAngle, kChartPaintSeries, series);
+			}
+			else {
+				AddArc(wedge.center, wedge.radius, 0, wedge.startAngle, wedge.endAngle, kChartPaintSeries, series);
+				AddArc(wedge.center, wedge.innerRadius, 0, wedge.endAngle, wedge.startAngle, kChartPaintSeries, series);
+			}
+		}
+		EndGroup();
+	}
+}
+
+/*
+*/
+void ChartDisplayList::AddRadarPolygons(const ChartLayout& layout)
+{
+	if (layout.polygons.empty()) {
+		return;
+	}
+
+	// Each series is one closed outline through its point on every spoke
+	BeginGroup("Radar Polygons").data = true;
+	for (const ChartLineSet& polygon : layout.polygons) {
+		AddPolyline(polygon.points, true, kChartPaintSeriesLine, polygon.series);
+	}
+	EndGroup();
+}
+
+/*
+*/
+void ChartDisplayList::AddRadarGrid(const ChartLayout& layout)
+{
+	const ChartRadarGrid& grid = layout.radarGrid;
+	const size_t spokes = grid.spokeEnds.size();
+	if (spokes == 0) {
+		return;
+	}
+
+	BeginGroup("Radar Grid", kChartStyleGrid, 0, true);
+	for (const ChartPoint& end : grid.spokeEnds) {
+		AddLine({grid.center, end}, kChartStyleGrid);
+	}
+	for (size_t ring = 0; ring < grid.GetRingCount(); ring++) {
+		AddPolyline(grid.GetRing(ring), spokes, true, kChartStyleGrid);
+	}
+	EndGroup();
+}
+
+/*
+*/
+void ChartDisplayList::AddDataLabels(const ChartLayout& layout)
+{
+	if (layout.dataLabels.empty()) {
+		return;
+	}
+
+	// Leader lines share one compound path behind the labels
+	BeginGroup("Data Labels", kChartStyleLeader, 0, true).data = true;
+	for (const ChartSegment& line : layout.leaderLines) {
+		AddLine(line, kChartStyleLeader);
+	}
+	for (const ChartLabel& label : layout.dataLabels) {
+		AddText(label);
+	}
+	EndGroup();
+}
+
+/*
+*/
+void ChartDisplayList::BuildSkeleton(const ChartDisplayList& list, ChartDisplayList& skeleton)
+{
+	skeleton.Clear();
+
+	// kept[i] counts the primitives of list before i that the skeleton keeps, which maps
+	// both a kept primitive and a group's end to the skeleton
+	const std::vector<ChartPrimitive>& primitives = list.fPrimitives;
+	std::vector<uint32_t> kept(primitives.size() + 1);
+	uint32_t count = 0;
+	size_t skipEnd = 0;
+	for (size_t i = 0; i < primitives.size(); i++) {
+		kept[i] = count;
+		if (i < skipEnd) {
+			continue;
+		}
+		count++;
+		if (primitives[i].kind == kChartPrimitiveGroup && primitives[i].data) {
+			skipEnd = primitives[i].end;
+		}
+	}
+	kept[primitives.size()] = count;
+
+	skeleton.Reserve(count);
+	skipEnd = 0;
+	for (size_t i = 0; i < primitives.size(); i++) {
+		if (i < skipEnd) {
+			continue;
+		}
+		skeleton.fPrimitives.push_back(primitives[i]);
+		if (primitives[i].kind == kChartPrimitiveGroup) {
+			skeleton.fPrimitives.back().end = kept[primitives[i].end];
+			if (primitives[i].data) {
+				skipEnd = primitives[i].end;
+			}
+		}
+		else {
+			skeleton.fPrimitives.back().end = kept[i] + 1;
+		}
+	}
+}
+
+/*
+*/
+void ChartDisplayList::Diff(const ChartDisplayList& previous, const ChartDisplayList& next, ChartDisplayDiff& diff)
+{
+	diff = ChartDisplayDiff();
+	diff.states.resize(next.fPrimitives.size());
+
+	// Lists of the same chart mostly line up, so a primitive is first looked for at its
+	// own index, and the index by ID is only built once that fails
+	std::unordered_map<uint64_t, uint32_t> previousIndex;
+
+	size_t matched = 0;
+	for (size_t i = 0; i < next.fPrimitives.size(); i++) {
+		const ChartPrimitive& primitive = next.fPrimitives[i];
+
+		size_t found = i;
+		if (found >= previous.fPrimitives.size() || previous.fPrimitives[found].id != primitive.id) {
+			if (previousIndex.empty()) {
+				previousIndex.reserve(previous.fPrimitives.size());
+				for (uint32_t j = 0; j < (uint32_t)previous.fPrimitives.size(); j++) {
+					previousIndex[previous.fPrimitives[j].id] = j;
+				}
+			}
+			auto entry = previousIndex.find(primitive.id);
+			if (entry == previousIndex.end()) {
+				diff.states[i] = kChartPrimitiveAdded;
+				diff.added++;
+				continue;
+			}
+			found = entry->second;
+		}
+
+		// A group is also unchanged only if it has as many descendants as before
+		matched++;
+		const ChartPrimitive& before = previous.fPrimitives[found];
+		if (primitive.IsSame(before) && (primitive.kind != kChartPrimitiveGroup || primitive.end - i == before.end - found)) {
+			diff.states[i] = kChartPrimitiveUnchanged;
+			diff.unchanged++;
+		}
+		else {
+			diff.states[i] = kChartPrimitiveChanged;
+			diff.changed++;
+		}
+	}
+
+	diff.removed = previous.fPrimitives.size() - matched;
+}
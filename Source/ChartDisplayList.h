@@ -0,0 +1,183 @@
+//========================================================================================
+//  
+//  ChartDisplayList.h
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#ifndef __ChartDisplayList_h__
+#define __ChartDisplayList_h__
+
+// The art of a chart as a flat list of typed primitives, between layout and emission.
+// Layout produces the list and one emitter turns it into Illustrator art. Like the
+// layout it is free of Illustrator SDK types, so it can be built off the main thread
+// and outside the application.
+
+#include "ChartLayout.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum ChartPrimitiveKind {
+	kChartPrimitiveGroup = 0,	// Named group; its descendants follow it in the list
+	kChartPrimitiveRect,		// Closed rectangle
+	kChartPrimitivePolyline,	// Straight segments through points, open or closed
+	kChartPrimitiveArc,			// Closed circular wedge, or ring sector when it has an inner radius
+	kChartPrimitiveMarker,		// Scatter marker outline
+	kChartPrimitiveText			// Point text: one label, or a block of labels
+};
+
+// Chart components that share one path style
+enum ChartStyleRole {
+	kChartStyleBackground = 0,
+	kChartStylePlotArea,
+	kChartStyleGrid,
+	kChartStyleTick,
+	kChartStyleAxis,
+	kChartStyleLeader,
+	kChartStyleRoleCount
+};
+
+// Paints that are not a chart component style
+const int32_t kChartPaintSeries = -1;	// The fill of the primitive's series
+const int32_t kChartPaintNone = -2;		// Unpainted, for groups that are not merged
+const int32_t kChartPaintSeriesLine = -3;	// The stroke of the primitive's series, unfilled
+
+// Most points of one polyline. Illustrator indexes path segments with 16 bits, so longer
+// lines and areas are split into several polylines.
+const size_t kChartMaxPathPoints = 32767;
+
+// One primitive. The fields used depend on the kind.
+struct ChartPrimitive {
+	// Stable across renders: derived from the primitive's place in the chart (its group
+	// and its position among the group's children), never from its geometry, so the same
+	// column or label keeps its ID when its value changes
+	uint64_t id;
+	ChartPrimitiveKind kind;
+	int32_t role;				// ChartStyleRole of the paint, or one of the paints above
+	int32_t series;				// Series of a kChartPaintSeries or kChartPaintSeriesLine paint
+
+	uint32_t end;				// Groups: index one past the group's last descendant
+	bool merge;					// Groups: the path children share one compound path
+	bool data;					// Groups: the children are data marks, left out of the skeleton
+
+	ChartRect rect;				// Rects
+	std::vector<ChartPoint> points;	// Polylines
+	bool closed;				// Polylines
+
+	ChartPoint origin;			// Arc and marker center, text anchor
+	double radius;				// Arcs
+	double innerRadius;			// Arcs, 0 for a wedge to the center
+	double startAngle;			// Arcs, in radians counterclockwise from the positive h axis
+	double endAngle;
+	ChartMarkerShape shape;		// Markers
+	double size;				// Markers
+
+	std::string text;			// Group name, or text contents
+	ChartJustification justification;	// Texts
+	double leading;				// Texts, 0 for a single line
+	std::vector<double> tabStops;	// Texts, centered tab stops relative to origin.h
+
+	ChartPrimitive();
+
+	// Whether two primitives draw the same art, whatever their IDs
+	bool IsSame(const ChartPrimitive& other) const;
+};
+
+// How a primitive compares with the previous render's list
+enum ChartPrimitiveState {
+	kChartPrimitiveUnchanged = 0,
+	kChartPrimitiveChanged,
+	kChartPrimitiveAdded
+};
+
+struct ChartDisplayDiff {
+	std::vector<uint8_t> states;	// A ChartPrimitiveState per primitive of the new list
+	size_t unchanged;
+	size_t changed;
+	size_t added;
+	size_t removed;					// Primitives of the previous list without a match
+
+	ChartDisplayDiff() : unchanged(0), changed(0), added(0), removed(0) {}
+};
+
+// Primitives in emission order: a group is followed by its descendants, and siblings
+// are in stacking order from the back. Build a list with BeginGroup, the Add functions
+// and EndGroup, or from a layout with Build.
+class ChartDisplayList {
+public:
+	// Builds the list of a chart from its layout: named groups for the background, grids,
+	// series, axes, ticks, axis labels and data labels, in that order from the back. Axis
+	// labels become one text block per axis when combineLabels is set and they allow it.
+	static void Build(const ChartLayout& layout, bool combineLabels, ChartDisplayList& list);
+
+	// Copies list without the children of its data groups: the chart's skeleton of
+	// background, grids, axes and labels, with its data groups empty and IDs unchanged,
+	// so that diffing it against list marks only the data marks as added
+	static void BuildSkeleton(const ChartDisplayList& list, ChartDisplayList& skeleton);
+
+	// Compares next with the list of the previous render, matching primitives by ID
+	static void Diff(const ChartDisplayList& previous, const ChartDisplayList& next, ChartDisplayDiff& diff);
+
+	ChartDisplayList() { Clear(); }
+
+	void Clear();
+	void Reserve(size_t count) { fPrimitives.reserve(count); }
+	void Swap(ChartDisplayList& other) { fPrimitives.swap(other.fPrimitives); fOpenGroups.swap(other.fOpenGroups); }
+
+	// Opens a group inside the innermost open group; primitives added until the matching
+	// EndGroup are its children
+	ChartPrimitive& BeginGroup(const std::string& name, int32_t role = kChartPaintNone, int32_t series = 0, bool merge = false);
+	void EndGroup();
+
+	ChartPrimitive& AddRect(const ChartRect& rect, int32_t role, int32_t series = 0);
+	ChartPrimitive& AddLine(const ChartSegment& line, int32_t role);
+	ChartPrimitive& AddPolyline(const std::vector<ChartPoint>& points, bool closed, int32_t role, int32_t series = 0);
+	ChartPrimitive& AddPolyline(const ChartPoint* points, size_t count, bool closed, int32_t role, int32_t series = 0);
+	ChartPrimitive& AddArc(const ChartPoint& center, double radius, double innerRadius, double startAngle, double endAngle, int32_t role, int32_t series = 0);
+	ChartPrimitive& AddMarker(ChartMarkerShape shape, const ChartPoint& center, double size, int32_t series);
+	ChartPrimitive& AddText(const ChartLabel& label);
+	ChartPrimitive& AddText(const ChartLabelBlock& block);
+
+	// Adds the parts of a layout that Build adds: a merged group of markers per series,
+	// a group per line series holding one open path per run, a group of one closed path
+	// per area layer, a group of pie wedges or a merged group per donut slice, a group of
+	// one closed path per radar series, a merged group of columns per series, and a
+	// "Data Labels" group of leader lines and data labels if the layout placed any
+	void AddMarkerSets(const ChartLayout& layout);
+	void AddLineSets(const ChartLayout& layout);
+	void AddAreaLayers(const ChartLayout& layout);
+	void AddWedges(const ChartLayout& layout);
+	void AddRadarPolygons(const ChartLayout& layout);
+	void AddColumnSets(const ChartLayout& layout);
+
+	// Adds the grid of a radar layout as Build does: one merged group of the spokes and
+	// rings, which emits as a single compound path
+	void AddRadarGrid(const ChartLayout& layout);
+	void AddDataLabels(const ChartLayout& layout);
+
+	size_t GetSize() const { return fPrimitives.size(); }
+	const ChartPrimitive& operator[](size_t index) const { return fPrimitives[index]; }
+	const std::vector<ChartPrimitive>& GetPrimitives() const { return fPrimitives; }
+
+private:
+	// Appends a primitive as the next child of the innermost open group
+	ChartPrimitive& Append(ChartPrimitiveKind kind, int32_t role, int32_t series, const std::string* name = nullptr);
+
+	struct OpenGroup {
+		uint32_t index;
+		uint64_t id;
+		uint32_t childCounts[kChartPrimitiveText + 1];	// Children so far, by kind
+	};
+
+	std::vector<ChartPrimitive> fPrimitives;
+	std::vector<OpenGroup> fOpenGroups;	// The root first
+};
+
+#endif // __ChartDisplayList_h__
@@ -13,14 +13,27 @@
 
 #include "IllustratorSDK.h"
 #include "ChartItem.h"
+#include "ChartATEMeasurer.h"
+#include "ChartDisplayEmitter.h"
+#include "ChartLayoutCache.h"
+#include "ChartRenderQueue.h"
+#include "ChartPathBuilder.h"
+#include "ChartStyleTable.h"
 #include "ChartsSuites.h"
 #include "SDKErrors.h"
 #include "AIPluginGroup.h"
-#include "AITextFrame.h"
-#include "IText.h"
+#include <cmath>
 
 // Initialize static member
 ai::int32 ChartItem::sNextChartID = 1;
+ChartLayoutCache* ChartItem::sLayoutCache = nullptr;
+ChartTextMeasurer* ChartItem::sTextMeasurer = nullptr;
+ChartEmitMode ChartItem::sEmitMode = kChartEmitCompoundPaths;
+ChartMarkerMode ChartItem::sMarkerMode = kChartMarkersAuto;
+ChartLabelMode ChartItem::sLabelMode = kChartLabelsCombined;
+ChartWorkerPool* ChartItem::sWorkerPool = nullptr;
+ChartRenderQueue* ChartItem::sRenderQueue = nullptr;
+ai::int32 ChartItem::sDetailLevel = 0;
 
 /*
 */
@@ -172,54 +185,9 @@ ASErr ChartItem::CreateChartArt()
 		result = sAIArt->SetArtName(fChartGroup, artName);
 		aisdk::check_ai_error(result);
 		
-		// Create the chart background
-		result = CreateChartBackground();
-		aisdk::check_ai_error(result);
-		
-		// Render the chart based on type
-		switch (fChartType) {
-			case kChartTypeBar:
-				result = RenderBarChart();
-				break;
-			case kChartTypeLine:
-				result = RenderLineChart();
-				break;
-			case kChartTypePie:
-				result = RenderPieChart();
-				break;
-			case kChartTypeArea:
-				result = RenderAreaChart();
-				break;
-			case kChartTypeScatter:
-				result = RenderScatterChart();
-				break;
-			case kChartTypeColumn:
-				result = RenderColumnChart();
-				break;
-			case kChartTypeDonut:
-				result = RenderDonutChart();
-				break;
-			case kChartTypeRadar:
-				result = RenderRadarChart();
-				break;
-			default:
-				// Default to bar chart
-				result = RenderBarChart();
-				break;
-		}
+		// Draw the chart into the new group
+		result = RenderChartContent();
 		aisdk::check_ai_error(result);
-		
-		// Create axes if applicable
-		if (fChartType != kChartTypePie && fChartType != kChartTypeDonut) {
-			result = CreateAxes();
-			aisdk::check_ai_error(result);
-		}
-		
-		// Create legend if enabled
-		if (fShowLegend && fDataSeries.size() > 1) {
-			result = CreateLegend();
-			aisdk::check_ai_error(result);
-		}
 	}
 	catch (ai::Error& ex) {
 		result = ex;
@@ -232,8 +200,30 @@ ASErr ChartItem::CreateChartArt()
 */
 ASErr ChartItem::UpdateChartArt()
 {
-	// Delete existing art and recreate
-	return CreateChartArt();
+	if (!fChartGroup) {
+		return CreateChartArt();
+	}
+	
+	ASErr result = kNoErr;
+	
+	try {
+		AIDictionaryRef dict = nullptr;
+		result = sAIArt->GetDictionary(fChartGroup, &dict);
+		aisdk::check_ai_error(result);
+		
+		result = WriteToDictionary(dict);
+		sAIDictionary->Release(dict);
+		aisdk::check_ai_error(result);
+		
+		// Rewrite the existing content rather than disposing and recreating it
+		result = RenderChartContent();
+		aisdk::check_ai_error(result);
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+	
+	return result;
 }
 
 /*
@@ -296,72 +286,13 @@ ai::UnicodeString ChartItem::GetChartTypeString() const
 
 /*
 */
-ASErr ChartItem::CreateChartBackground()
+ASErr ChartItem::CreateChartBackground(ChartArtCursor& content, ChartStyleTable& styles)
 {
 	ASErr result = kNoErr;
 	
 	try {
-		// Create a rectangle for the background
-		AIArtHandle backgroundRect;
-		result = sAIArt->NewArt(kPathArt, kPlaceInsideOnTop, fChartGroup, &backgroundRect);
-		aisdk::check_ai_error(result);
-		
-		// Set up the path
-		result = sAIPath->SetPathSegmentCount(backgroundRect, 4);
-		aisdk::check_ai_error(result);
-		
-		AIPathSegment segments[4];
-		
-		// Top-left corner
-		segments[0].p.h = fBounds.left;
-		segments[0].p.v = fBounds.top;
-		segments[0].in = segments[0].out = segments[0].p;
-		segments[0].corner = true;
-		
-		// Top-right corner
-		segments[1].p.h = fBounds.right;
-		segments[1].p.v = fBounds.top;
-		segments[1].in = segments[1].out = segments[1].p;
-		segments[1].corner = true;
-		
-		// Bottom-right corner
-		segments[2].p.h = fBounds.right;
-		segments[2].p.v = fBounds.bottom;
-		segments[2].in = segments[2].out = segments[2].p;
-		segments[2].corner = true;
-		
-		// Bottom-left corner
-		segments[3].p.h = fBounds.left;
-		segments[3].p.v = fBounds.bottom;
-		segments[3].in = segments[3].out = segments[3].p;
-		segments[3].corner = true;
-		
-		for (ai::int32 i = 0; i < 4; i++) {
-			result = sAIPath->SetPathSegments(backgroundRect, i, 1, &segments[i]);
-			aisdk::check_ai_error(result);
-		}
-		
-		result = sAIPath->SetPathClosed(backgroundRect, true);
-		aisdk::check_ai_error(result);
-		
-		// Set the style - white fill with light gray stroke
-		AIPathStyle style;
-		AIBoolean hasAdvFill = false;
-		result = sAIPathStyle->GetPathStyle(backgroundRect, &style, &hasAdvFill);
-		aisdk::check_ai_error(result);
-		
-		// White fill
-		style.fillPaint = true;
-		style.fill.color.kind = kGrayColor;
-		style.fill.color.c.g.gray = 0;  // White
-		
-		// Light gray stroke
-		style.strokePaint = true;
-		style.stroke.color.kind = kGrayColor;
-		style.stroke.color.c.g.gray = 0.7 * kAIRealOne;  // Light gray
-		style.stroke.width = 1.0;
-		
-		result = sAIPathStyle->SetPathStyle(backgroundRect, &style);
+		// Create a rectangle for the background - white fill with light gray stroke
+		result = ChartRectPath(fBounds).Commit(content, &styles.Get(kChartStyleBackground));
 		aisdk::check_ai_error(result);
 	}
 	catch (ai::Error& ex) {
@@ -397,211 +328,138 @@ ASErr ChartItem::CreateLegend()
 
 /*
 */
-void ChartItem::CalculateDataRange(AIReal& minValue, AIReal& maxValue) const
+ASErr ChartItem::RenderBarChart(ChartArtCursor& content, ChartStyleTable& styles)
 {
-	minValue = 0;
-	maxValue = 0;
-	
-	bool firstValue = true;
-	
-	for (const auto& series : fDataSeries) {
-		for (const auto& point : series.dataPoints) {
-			if (firstValue) {
-				minValue = maxValue = point.value;
-				firstValue = false;
-			} else {
-				if (point.value < minValue) minValue = point.value;
-				if (point.value > maxValue) maxValue = point.value;
-			}
-		}
-	}
-	
-	// Add some padding to the range
-	AIReal range = maxValue - minValue;
-	if (range > 0) {
-		minValue -= range * 0.1;
-		maxValue += range * 0.1;
-	}
-	
-	// Ensure we include zero for bar/column charts
-	if (fChartType == kChartTypeBar || fChartType == kChartTypeColumn) {
-		if (minValue > 0) minValue = 0;
-		if (maxValue < 0) maxValue = 0;
-	}
+	return RenderSeriesLayout(content, kChartTypeBar, styles);
 }
 
 /*
 */
-ASErr ChartItem::RenderBarChart()
+ASErr ChartItem::RenderLineChart(ChartArtCursor& content, ChartStyleTable& styles)
 {
-	ASErr result = kNoErr;
-	
-	try {
-		// Simple bar chart implementation for now
-		// TODO: Full implementation with proper scaling and multiple series support
-		
-		if (!ValidateData()) {
-			return kBadParameterErr;
-		}
-		
-		// Get the first series
-		const ChartDataSeries* series = GetSeries(0);
-		if (!series || series->dataPoints.empty()) {
-			return kBadParameterErr;
-		}
-		
-		// Calculate chart area (inside margins)
-		AIRealRect chartArea;
-		chartArea.left = fBounds.left + fMargin;
-		chartArea.right = fBounds.right - fMargin;
-		chartArea.top = fBounds.top + fMargin;
-		chartArea.bottom = fBounds.bottom - fMargin;
-		
-		AIReal chartWidth = chartArea.right - chartArea.left;
-		AIReal chartHeight = chartArea.bottom - chartArea.top;
-		
-		// Calculate bar width
-		size_t numBars = series->dataPoints.size();
-		AIReal barWidth = chartWidth / (numBars * 1.5);  // Leave space between bars
-		AIReal barSpacing = barWidth * 0.5;
-		
-		// Find data range
-		AIReal minValue, maxValue;
-		CalculateDataRange(minValue, maxValue);
-		
-		// Draw bars
-		for (size_t i = 0; i < numBars; i++) {
-			const ChartDataPoint& point = series->dataPoints[i];
-			
-			// Calculate bar position and height
-			AIReal barX = chartArea.left + (i * (barWidth + barSpacing)) + barSpacing/2;
-			AIReal barHeight = (point.value / maxValue) * chartHeight;
-			
-			// Create bar rectangle
-			AIArtHandle barArt;
-			result = sAIArt->NewArt(kPathArt, kPlaceInsideOnTop, fChartGroup, &barArt);
-			aisdk::check_ai_error(result);
-			
-			// Set up the path
-			result = sAIPath->SetPathSegmentCount(barArt, 4);
-			aisdk::check_ai_error(result);
-			
-			AIPathSegment segments[4];
-			
-			// Bottom-left corner
-			segments[0].p.h = barX;
-			segments[0].p.v = chartArea.bottom;
-			segments[0].in = segments[0].out = segments[0].p;
-			segments[0].corner = true;
-			
-			// Top-left corner
-			segments[1].p.h = barX;
-			segments[1].p.v = chartArea.bottom - barHeight;
-			segments[1].in = segments[1].out = segments[1].p;
-			segments[1].corner = true;
-			
-			// Top-right corner
-			segments[2].p.h = barX + barWidth;
-			segments[2].p.v = chartArea.bottom - barHeight;
-			segments[2].in = segments[2].out = segments[2].p;
-			segments[2].corner = true;
-			
-			// Bottom-right corner
-			segments[3].p.h = barX + barWidth;
-			segments[3].p.v = chartArea.bottom;
-			segments[3].in = segments[3].out = segments[3].p;
-			segments[3].corner = true;
-			
-			for (ai::int32 j = 0; j < 4; j++) {
-				result = sAIPath->SetPathSegments(barArt, j, 1, &segments[j]);
-				aisdk::check_ai_error(result);
-			}
-			
-			result = sAIPath->SetPathClosed(barArt, true);
-			aisdk::check_ai_error(result);
-			
-			// Set the style - blue fill
-			AIPathStyle style;
-			AIBoolean hasAdvFill = false;
-			result = sAIPathStyle->GetPathStyle(barArt, &style, &hasAdvFill);
-			aisdk::check_ai_error(result);
-			
-			// Blue fill
-			style.fillPaint = true;
-			style.fill.color.kind = kThreeColor;
-			style.fill.color.c.rgb.red = 0;
-			style.fill.color.c.rgb.green = 30000;
-			style.fill.color.c.rgb.blue = 65000;
-			
-			// No stroke for now
-			style.strokePaint = false;
-			
-			result = sAIPathStyle->SetPathStyle(barArt, &style);
-			aisdk::check_ai_error(result);
-		}
-	}
-	catch (ai::Error& ex) {
-		result = ex;
-	}
-	
-	return result;
+	return RenderSeriesLayout(content, kChartTypeLine, styles);
 }
 
 /*
 */
-ASErr ChartItem::RenderLineChart()
+ASErr ChartItem::RenderPieChart(ChartArtCursor& content, ChartStyleTable& styles)
 {
-	// TODO: Implement line chart rendering
-	return kNoErr;
+	return RenderSeriesLayout(content, kChartTypePie, styles);
 }
 
 /*
 */
-ASErr ChartItem::RenderPieChart()
+ASErr ChartItem::RenderAreaChart(ChartArtCursor& content, ChartStyleTable& styles)
 {
-	// TODO: Implement pie chart rendering
-	return kNoErr;
+	return RenderSeriesLayout(content, kChartTypeArea, styles);
 }
 
 /*
 */
-ASErr ChartItem::RenderAreaChart()
+ASErr ChartItem::RenderScatterChart(ChartArtCursor& content, ChartStyleTable& styles)
 {
-	// TODO: Implement area chart rendering
-	return kNoErr;
+	return RenderSeriesLayout(content, kChartTypeScatter, styles);
 }
 
 /*
 */
-ASErr ChartItem::RenderScatterChart()
+void ChartItem::BuildDataset(ChartDataset& dataset) const
 {
-	// TODO: Implement scatter chart rendering
-	return kNoErr;
+	ChartColumn categories;
+	categories.name = "Category";
+	categories.kind = ChartColumn::kText;
+	if (!fDataSeries.empty()) {
+		for (const ChartDataPoint& point : fDataSeries[0].dataPoints) {
+			categories.texts.push_back(point.label.as_UTF8());
+		}
+	}
+	dataset.AddColumn(categories);
+	
+	for (const ChartDataSeries& series : fDataSeries) {
+		ChartColumn values;
+		values.name = series.name.as_UTF8();
+		values.numbers.reserve(series.dataPoints.size());
+		for (const ChartDataPoint& point : series.dataPoints) {
+			values.numbers.push_back(point.value);
+		}
+		dataset.AddColumn(values);
+	}
 }
 
 /*
 */
-ASErr ChartItem::RenderColumnChart()
+ASErr ChartItem::RenderSeriesLayout(ChartArtCursor& content, ChartType type, ChartStyleTable& styles)
 {
-	// TODO: Implement column chart rendering (vertical bars)
-	// For now, just use bar chart rotated
-	return RenderBarChart();
+	ASErr result = kNoErr;
+	
+	try {
+		if (!ValidateData()) {
+			return kBadParameterErr;
+		}
+		
+		// Lay out the chart's own series inside the margins
+		ChartDataset dataset;
+		BuildDataset(dataset);
+		
+		ChartLayoutParams params;
+		params.chartType = type;
+		params.plotArea.left = fBounds.left + fMargin;
+		params.plotArea.top = fBounds.top - fMargin;
+		params.plotArea.right = fBounds.right - fMargin;
+		params.plotArea.bottom = fBounds.bottom + fMargin;
+		params.showDataLabels = fShowDataLabels ? true : false;
+		ChartATEMeasurer::GetDefaultFont(params.fontName, params.fontSize);
+		
+		ChartSeriesView view;
+		ChartTextMeasurer estimate;
+		ChartTextMeasurer& measurer = sTextMeasurer ? *sTextMeasurer : estimate;
+		ChartLayout layout;
+		if (!dataset.Resolve(ChartDataRef(), view) || !ChartLayout::Compute(view, params, measurer, layout, sWorkerPool)) {
+			return kBadParameterErr;
+		}
+		
+		// Data marks and data labels over the background already in content; a radar
+		// chart's grid stands in for the axes, so it goes in beneath them
+		ChartDisplayList list;
+		list.AddRadarGrid(layout);
+		list.AddMarkerSets(layout);
+		list.AddLineSets(layout);
+		list.AddAreaLayers(layout);
+		list.AddWedges(layout);
+		list.AddRadarPolygons(layout);
+		list.AddColumnSets(layout);
+		list.AddDataLabels(layout);
+		
+		ChartDisplayEmitter emitter(styles, sEmitMode, sMarkerMode);
+		result = emitter.Emit(list, content);
+		aisdk::check_ai_error(result);
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+	
+	return result;
 }
 
 /*
 */
-ASErr ChartItem::RenderDonutChart()
+ASErr ChartItem::RenderColumnChart(ChartArtCursor& content, ChartStyleTable& styles)
 {
-	// TODO: Implement donut chart rendering
-	return kNoErr;
+	return RenderSeriesLayout(content, kChartTypeColumn, styles);
 }
 
 /*
 */
-ASErr ChartItem::RenderRadarChart()
+ASErr ChartItem::RenderDonutChart(ChartArtCursor& content, ChartStyleTable& styles)
 {
-	// TODO: Implement radar chart rendering
-	return kNoErr;
+	return RenderSeriesLayout(content, kChartTypeDonut, styles);
+}
+
+/*
+*/
+ASErr ChartItem::RenderRadarChart(ChartArtCursor& content, ChartStyleTable& styles)
+{
+	return RenderSeriesLayout(content, kChartTypeRadar, styles);
 }
 
 /*
@@ -723,17 +581,22 @@ AIBoolean ChartItem::IsChartArt(AIArtHandle art)
 		// Check if it's a group
 		short type;
 		result = sAIArt->GetArtType(art, &type);
-		if (result == kNoErr && type == kGroupArt) {
+		if (result == kNoErr && type == kGroupArt && sAIArt->HasDictionary(art)) {
 			// Check if it has our chart type identifier in the dictionary
 			AIDictionaryRef dict = nullptr;
 			result = sAIArt->GetDictionary(art, &dict);
 			if (result == kNoErr && dict) {
-				// Check for our chart version key to identify it as a chart
+				// Check for our chart version key or chart flag to identify it as a chart
 				ai::int32 version = 0;
+				AIBoolean flagged = false;
 				result = sAIDictionary->GetIntegerEntry(dict, sAIDictionary->Key(kChartVersionDictKey), &version);
 				if (result == kNoErr && version > 0) {
 					isChart = true;
 				}
+				else if (sAIDictionary->GetBooleanEntry(dict, sAIDictionary->Key(kChartIsChartDictKey), &flagged) == kNoErr && flagged) {
+					isChart = true;
+				}
+				sAIDictionary->Release(dict);
 			}
 		}
 	}
@@ -796,45 +659,58 @@ ASErr ChartItem::RenderChartContent()
 			return kBadParameterErr;
 		}
 		
+		// Content of an earlier render is taken in order and rewritten; what is not
+		// taken is disposed at the end
+		ChartArtCursor content(fChartGroup);
+		
+		// One table bound to the document paints the background and every series
+		std::vector<std::string> seriesNames;
+		for (const ChartDataSeries& series : fDataSeries) {
+			seriesNames.push_back(series.name.as_UTF8());
+		}
+		ChartStyleTable styles;
+		result = styles.BindToDocument(seriesNames);
+		aisdk::check_ai_error(result);
+		
 		// Create the chart background
-		result = CreateChartBackground();
+		result = CreateChartBackground(content, styles);
 		aisdk::check_ai_error(result);
 		
 		// Render the chart based on type
 		switch (fChartType) {
 			case kChartTypeBar:
-				result = RenderBarChart();
+				result = RenderBarChart(content, styles);
 				break;
 			case kChartTypeLine:
-				result = RenderLineChart();
+				result = RenderLineChart(content, styles);
 				break;
 			case kChartTypePie:
-				result = RenderPieChart();
+				result = RenderPieChart(content, styles);
 				break;
 			case kChartTypeArea:
-				result = RenderAreaChart();
+				result = RenderAreaChart(content, styles);
 				break;
 			case kChartTypeScatter:
-				result = RenderScatterChart();
+				result = RenderScatterChart(content, styles);
 				break;
 			case kChartTypeColumn:
-				result = RenderColumnChart();
+				result = RenderColumnChart(content, styles);
 				break;
 			case kChartTypeDonut:
-				result = RenderDonutChart();
+				result = RenderDonutChart(content, styles);
 				break;
 			case kChartTypeRadar:
-				result = RenderRadarChart();
+				result = RenderRadarChart(content, styles);
 				break;
 			default:
 				// Default to bar chart
-				result = RenderBarChart();
+				result = RenderBarChart(content, styles);
 				break;
 		}
 		aisdk::check_ai_error(result);
 		
-		// Create axes if applicable
-		if (fChartType != kChartTypePie && fChartType != kChartTypeDonut) {
+		// Create axes if applicable; polar charts have none
+		if (fChartType != kChartTypePie && fChartType != kChartTypeDonut && fChartType != kChartTypeRadar) {
 			result = CreateAxes();
 			aisdk::check_ai_error(result);
 		}
@@ -844,6 +720,9 @@ ASErr ChartItem::RenderChartContent()
 			result = CreateLegend();
 			aisdk::check_ai_error(result);
 		}
+		
+		result = content.Finish();
+		aisdk::check_ai_error(result);
 	}
 	catch (ai::Error& ex) {
 		result = ex;
@@ -854,7 +733,8 @@ ASErr ChartItem::RenderChartContent()
 
 /*
 */
-ASErr ChartItem::CreatePluginArt(const AIRealRect& bounds, ChartType type, AIPluginGroupHandle pluginGroupHandle, AIArtHandle* chartArt)
+ASErr ChartItem::CreatePluginArt(const AIRealRect& bounds, ChartType type, AIPluginGroupHandle pluginGroupHandle, AIArtHandle* chartArt, ai::int32 chartID, const ChartDataSource* source, const ChartOptions* options, ChartRetainedArt* retained,
+	const ChartLayout* layout, ChartStyleTable* styles)
 {
 	ASErr result = kNoErr;
 	
@@ -869,525 +749,277 @@ ASErr ChartItem::CreatePluginArt(const AIRealRect& bounds, ChartType type, AIPlu
 		// Set the art name to identify it as a Chart
 		ai::UnicodeString chartName("<Chart>");
 		result = sAIArt->SetArtName(*chartArt, chartName);
-		if (result != kNoErr) {
+		aisdk::check_ai_error(result);
+		
+		if (chartID <= 0) {
+			chartID = AllocateChartID();
+		}
+		
+		// Drawing into the empty group creates every component
+		result = UpdatePluginArt(*chartArt, bounds, type, chartID, source, options, retained, layout, styles);
+		aisdk::check_ai_error(result);
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+		if (chartArt && *chartArt) {
 			sAIArt->DisposeArt(*chartArt);
 			*chartArt = nullptr;
-			return result;
 		}
+	}
+	
+	return result;
+}
+
+/*
+*/
+ASErr ChartItem::UpdatePluginArt(AIArtHandle chartArt, const AIRealRect& bounds, ChartType type, ai::int32 chartID, const ChartDataSource* source, const ChartOptions* options, ChartRetainedArt* retained, const ChartLayout* layout,
+	ChartStyleTable* styles)
+{
+	ASErr result = kNoErr;
+	
+	try {
+		// This render replaces one still in progress
+		if (sRenderQueue) {
+			sRenderQueue->Cancel(chartArt);
+		}
+		
+		// Checked before the dictionary is written, which moves the art's time stamp
+		const AIBoolean reused = retained && retained->Matches(chartArt, sEmitMode, sMarkerMode);
 		
 		// Store chart data in the art's dictionary
 		AIDictionaryRef dict = nullptr;
-		result = sAIArt->GetDictionary(*chartArt, &dict);
+		result = sAIArt->GetDictionary(chartArt, &dict);
 		if (result != kNoErr || !dict) {
 			// Groups should have dictionaries automatically
-			sAIArt->DisposeArt(*chartArt);
-			*chartArt = nullptr;
 			return kBadParameterErr;
 		}
 		
-		// Mark this as a Chart in the dictionary
-		result = sAIDictionary->SetBooleanEntry(dict, sAIDictionary->Key("isChart"), true);
-		result = sAIDictionary->SetIntegerEntry(dict, sAIDictionary->Key("chartType"), (ai::int32)type);
-		sAIDictionary->Release(dict);
-		
-		// Use the group itself as the container for chart content
-		AIArtHandle resultArt = *chartArt;
-		
-		// The bounds passed in ARE the plot area
-		// We need to position labels outside this area
-		AIRealRect plotArea = bounds;  // The drawn rectangle IS the plot area
-		AIReal labelGap = 6.0;  // 6 points gap between plot area and labels
-		
-		// Create named groups for chart components (in z-order from back to front)
-		
-		// 1. Background group
-		AIArtHandle backgroundGroup;
-		result = sAIArt->NewArt(kGroupArt, kPlaceInsideOnTop, resultArt, &backgroundGroup);
-		aisdk::check_ai_error(result);
-		result = sAIArt->SetArtName(backgroundGroup, ai::UnicodeString("Background"));
-		
-		// 2. Grid groups
-		AIArtHandle xGridGroup;
-		result = sAIArt->NewArt(kGroupArt, kPlaceInsideOnTop, resultArt, &xGridGroup);
-		aisdk::check_ai_error(result);
-		result = sAIArt->SetArtName(xGridGroup, ai::UnicodeString("X Grid"));
-		
-		AIArtHandle yGridGroup;
-		result = sAIArt->NewArt(kGroupArt, kPlaceInsideOnTop, resultArt, &yGridGroup);
-		aisdk::check_ai_error(result);
-		result = sAIArt->SetArtName(yGridGroup, ai::UnicodeString("Y Grid"));
-		
-		// 3. Column groups (we'll create multiple as needed)
-		AIArtHandle columnsGroup;
-		result = sAIArt->NewArt(kGroupArt, kPlaceInsideOnTop, resultArt, &columnsGroup);
-		aisdk::check_ai_error(result);
-		result = sAIArt->SetArtName(columnsGroup, ai::UnicodeString("Columns"));
-		
-		// 4. Axis groups
-		AIArtHandle xAxisGroup;
-		result = sAIArt->NewArt(kGroupArt, kPlaceInsideOnTop, resultArt, &xAxisGroup);
-		aisdk::check_ai_error(result);
-		result = sAIArt->SetArtName(xAxisGroup, ai::UnicodeString("X Axis"));
-		
-		AIArtHandle yAxisGroup;
-		result = sAIArt->NewArt(kGroupArt, kPlaceInsideOnTop, resultArt, &yAxisGroup);
-		aisdk::check_ai_error(result);
-		result = sAIArt->SetArtName(yAxisGroup, ai::UnicodeString("Y Axis"));
-		
-		// 5. Tick groups
-		AIArtHandle xTicksGroup;
-		result = sAIArt->NewArt(kGroupArt, kPlaceInsideOnTop, resultArt, &xTicksGroup);
-		aisdk::check_ai_error(result);
-		result = sAIArt->SetArtName(xTicksGroup, ai::UnicodeString("X Ticks"));
-		
-		AIArtHandle yTicksGroup;
-		result = sAIArt->NewArt(kGroupArt, kPlaceInsideOnTop, resultArt, &yTicksGroup);
-		aisdk::check_ai_error(result);
-		result = sAIArt->SetArtName(yTicksGroup, ai::UnicodeString("Y Ticks"));
-		
-		// 6. Label groups
-		AIArtHandle xLabelsGroup;
-		result = sAIArt->NewArt(kGroupArt, kPlaceInsideOnTop, resultArt, &xLabelsGroup);
-		aisdk::check_ai_error(result);
-		result = sAIArt->SetArtName(xLabelsGroup, ai::UnicodeString("X Axis Labels"));
-		
-		AIArtHandle yLabelsGroup;
-		result = sAIArt->NewArt(kGroupArt, kPlaceInsideOnTop, resultArt, &yLabelsGroup);
-		aisdk::check_ai_error(result);
-		result = sAIArt->SetArtName(yLabelsGroup, ai::UnicodeString("Y Axis Labels"));
-		
-		// Create the plot area background in the background group
-		AIArtHandle plotAreaRect;
-		result = sAIArt->NewArt(kPathArt, kPlaceInsideOnTop, backgroundGroup, &plotAreaRect);
-		aisdk::check_ai_error(result);
-		
-		result = sAIPath->SetPathSegmentCount(plotAreaRect, 4);
-		aisdk::check_ai_error(result);
-		
-		AIPathSegment segments[4];
-		segments[0].p.h = plotArea.left; segments[0].p.v = plotArea.top;
-		segments[1].p.h = plotArea.right; segments[1].p.v = plotArea.top;
-		segments[2].p.h = plotArea.right; segments[2].p.v = plotArea.bottom;
-		segments[3].p.h = plotArea.left; segments[3].p.v = plotArea.bottom;
-		
-		for (int i = 0; i < 4; i++) {
-			segments[i].in = segments[i].out = segments[i].p;
-			segments[i].corner = true;
-			result = sAIPath->SetPathSegments(plotAreaRect, i, 1, &segments[i]);
-			aisdk::check_ai_error(result);
+		// Mark this as a Chart in the dictionary, with the header the chart registry indexes
+		result = sAIDictionary->SetBooleanEntry(dict, sAIDictionary->Key(kChartIsChartDictKey), true);
+		result = sAIDictionary->SetIntegerEntry(dict, sAIDictionary->Key(kChartTypeDictKey), (ai::int32)type);
+		result = sAIDictionary->SetIntegerEntry(dict, sAIDictionary->Key(kChartIDDictKey), chartID);
+		result = sAIDictionary->SetIntegerEntry(dict, sAIDictionary->Key(kChartVersionDictKey), 1);
+		result = sAIDictionary->SetBinaryEntry(dict, sAIDictionary->Key(kChartBoundsDictKey), (void*)&bounds, sizeof(AIRealRect));
+		sAIDictionary->DeleteEntry(dict, sAIDictionary->Key(kChartIncompleteDictKey));
+		
+		// Resolve the data to draw; the chart stores only a reference to the shared dataset
+		const ChartDataset& dataset = (source && source->dataset) ? *source->dataset : ChartDataset::Sample();
+		ChartDataRef dataRef;
+		if (source && source->dataset) {
+			dataRef = source->ref;
 		}
+		dataRef.datasetID = dataset.GetID();
+		result = WriteDataRef(dict, dataRef);
 		
-		result = sAIPath->SetPathClosed(plotAreaRect, true);
-		aisdk::check_ai_error(result);
-		
-		// Plot area style - white fill with gray stroke
-		AIPathStyle style;
-		AIBoolean hasAdvFill = false;
-		result = sAIPathStyle->GetPathStyle(plotAreaRect, &style, &hasAdvFill);
-		aisdk::check_ai_error(result);
-		
-		style.fillPaint = true;
-		style.fill.color.kind = kGrayColor;
-		style.fill.color.c.g.gray = 0;  // White
-		
-		style.strokePaint = true;
-		style.stroke.color.kind = kGrayColor;
-		style.stroke.color.c.g.gray = 0.5 * kAIRealOne;  // Medium gray
-		style.stroke.width = 0.5;
-		
-		result = sAIPathStyle->SetPathStyle(plotAreaRect, &style);
-		aisdk::check_ai_error(result);
-		
-		// Calculate plot dimensions
-		AIReal plotWidth = plotArea.right - plotArea.left;
-		AIReal plotHeight = plotArea.top - plotArea.bottom;
-		
-		// Create horizontal grid lines (Y grid)
-		for (int i = 1; i <= 4; i++) {  // Skip 0 and 100 as they're on the border
-			AIArtHandle gridLine;
-			result = sAIArt->NewArt(kPathArt, kPlaceInsideOnTop, yGridGroup, &gridLine);
-			if (result == kNoErr) {
-				result = sAIPath->SetPathSegmentCount(gridLine, 2);
-				AIPathSegment gridSegs[2];
-				gridSegs[0].p.h = plotArea.left;
-				gridSegs[0].p.v = plotArea.bottom + (i * plotHeight / 4);
-				gridSegs[0].in = gridSegs[0].out = gridSegs[0].p;
-				gridSegs[0].corner = true;
-				
-				gridSegs[1].p.h = plotArea.right;
-				gridSegs[1].p.v = plotArea.bottom + (i * plotHeight / 4);
-				gridSegs[1].in = gridSegs[1].out = gridSegs[1].p;
-				gridSegs[1].corner = true;
-				
-				for (int j = 0; j < 2; j++) {
-					result = sAIPath->SetPathSegments(gridLine, j, 1, &gridSegs[j]);
-				}
-				result = sAIPath->SetPathClosed(gridLine, false);
-				
-				// Style the grid line
-				AIPathStyle gridStyle;
-				AIBoolean hasAdvFill = false;
-				sAIPathStyle->GetPathStyle(gridLine, &gridStyle, &hasAdvFill);
-				gridStyle.fillPaint = false;
-				gridStyle.strokePaint = true;
-				gridStyle.stroke.color.kind = kGrayColor;
-				gridStyle.stroke.color.c.g.gray = 0.85 * kAIRealOne;  // Light gray
-				gridStyle.stroke.width = 0.25;
-				gridStyle.stroke.dash.length = 2;  // Number of dash entries
-				gridStyle.stroke.dash.array[0] = 2.0;  // Dash length
-				gridStyle.stroke.dash.array[1] = 2.0;  // Gap length
-				sAIPathStyle->SetPathStyle(gridLine, &gridStyle);
-			}
+		const ChartOptions chartOptions = options ? *options : ChartOptions();
+		if (result == kNoErr) {
+			result = WriteOptions(dict, chartOptions);
 		}
 		
-		// Create column chart with multiple data series
-		const int numCategories = 5;  // Number of X-axis categories (months)
-		const int numSeries = 3;      // Number of data series (e.g., different years)
-		
-		// Multiple data series - each row is a series
-		AIReal values[numSeries][numCategories] = {
-			{75.0, 45.0, 90.0, 60.0, 85.0},  // Series 1 (e.g., 2022)
-			{65.0, 55.0, 80.0, 70.0, 75.0},  // Series 2 (e.g., 2023)
-			{85.0, 50.0, 95.0, 65.0, 90.0}   // Series 3 (e.g., 2024)
-		};
-		
-		const char* categoryLabels[numCategories] = {"Jan", "Feb", "Mar", "Apr", "May"};
-		const char* seriesNames[numSeries] = {"2022", "2023", "2024"};
-		
-		// Define CMYK colors for each series
-		struct SeriesColor {
-			AIReal cyan, magenta, yellow, black;
-		};
-		SeriesColor seriesColors[numSeries] = {
-			{1.0 * kAIRealOne, 0.5 * kAIRealOne, 0.0 * kAIRealOne, 0.0 * kAIRealOne},  // Blue for series 1
-			{0.0 * kAIRealOne, 0.5 * kAIRealOne, 1.0 * kAIRealOne, 0.0 * kAIRealOne},  // Orange for series 2
-			{0.5 * kAIRealOne, 0.0 * kAIRealOne, 1.0 * kAIRealOne, 0.0 * kAIRealOne}   // Green for series 3
-		};
-		
-		// Calculate column dimensions
-		AIReal categoryWidth = plotWidth / numCategories;
-		AIReal columnGroupWidth = categoryWidth * 0.8;  // 80% of category width for columns
-		AIReal columnGroupGap = categoryWidth * 0.2;    // 20% for gaps
-		AIReal individualColumnWidth = columnGroupWidth / numSeries;
-		
-		// Create vertical grid lines (X grid) - one per category
-		for (int i = 0; i < numCategories; i++) {
-			AIReal xPos = plotArea.left + (i + 0.5) * categoryWidth;  // Center of category
-			AIArtHandle gridLine;
-			result = sAIArt->NewArt(kPathArt, kPlaceInsideOnTop, xGridGroup, &gridLine);
-			if (result == kNoErr) {
-				result = sAIPath->SetPathSegmentCount(gridLine, 2);
-				AIPathSegment gridSegs[2];
-				gridSegs[0].p.h = xPos;
-				gridSegs[0].p.v = plotArea.bottom;
-				gridSegs[0].in = gridSegs[0].out = gridSegs[0].p;
-				gridSegs[0].corner = true;
-				
-				gridSegs[1].p.h = xPos;
-				gridSegs[1].p.v = plotArea.top;
-				gridSegs[1].in = gridSegs[1].out = gridSegs[1].p;
-				gridSegs[1].corner = true;
-				
-				for (int j = 0; j < 2; j++) {
-					result = sAIPath->SetPathSegments(gridLine, j, 1, &gridSegs[j]);
-				}
-				result = sAIPath->SetPathClosed(gridLine, false);
-				
-				// Style the grid line
-				AIPathStyle gridStyle;
-				AIBoolean hasAdvFill = false;
-				sAIPathStyle->GetPathStyle(gridLine, &gridStyle, &hasAdvFill);
-				gridStyle.fillPaint = false;
-				gridStyle.strokePaint = true;
-				gridStyle.stroke.color.kind = kGrayColor;
-				gridStyle.stroke.color.c.g.gray = 0.85 * kAIRealOne;  // Light gray
-				gridStyle.stroke.width = 0.25;
-				gridStyle.stroke.dash.length = 2;  // Number of dash entries
-				gridStyle.stroke.dash.array[0] = 2.0;  // Dash length
-				gridStyle.stroke.dash.array[1] = 2.0;  // Gap length
-				sAIPathStyle->SetPathStyle(gridLine, &gridStyle);
+		// An adaptive chart records the level of detail it is drawn at, to be drawn again
+		// when the view zooms away from it
+		if (result == kNoErr) {
+			if (chartOptions.adaptiveDetail) {
+				result = sAIDictionary->SetIntegerEntry(dict, sAIDictionary->Key(kChartDetailLevelDictKey), sDetailLevel);
 			}
-		}
-		
-		// Create columns organized by series
-		for (int seriesIdx = 0; seriesIdx < numSeries; seriesIdx++) {
-			// Create a group for this series within the columns group
-			AIArtHandle seriesGroup;
-			result = sAIArt->NewArt(kGroupArt, kPlaceInsideOnTop, columnsGroup, &seriesGroup);
-			aisdk::check_ai_error(result);
-			ai::UnicodeString seriesGroupName("Column Set ");
-			seriesGroupName.append(ai::UnicodeString(seriesNames[seriesIdx]));
-			result = sAIArt->SetArtName(seriesGroup, seriesGroupName);
-			
-			// Create columns for this series
-			for (int catIdx = 0; catIdx < numCategories; catIdx++) {
-				// Calculate column position
-				AIReal categoryLeft = plotArea.left + catIdx * categoryWidth;
-				AIReal columnGroupLeft = categoryLeft + columnGroupGap / 2;
-				AIReal columnLeft = columnGroupLeft + seriesIdx * individualColumnWidth;
-				AIReal columnRight = columnLeft + individualColumnWidth * 0.9;  // Small gap between columns
-				
-				// Calculate column height
-				AIReal columnHeight = (values[seriesIdx][catIdx] / 100.0) * plotHeight;
-				AIReal columnTop = plotArea.bottom + columnHeight;
-				
-				// Create column rectangle in the series group
-				AIArtHandle column;
-				result = sAIArt->NewArt(kPathArt, kPlaceInsideOnTop, seriesGroup, &column);
-				aisdk::check_ai_error(result);
-			
-				result = sAIPath->SetPathSegmentCount(column, 4);
-				aisdk::check_ai_error(result);
-				
-				segments[0].p.h = columnLeft; segments[0].p.v = plotArea.bottom;
-				segments[1].p.h = columnLeft; segments[1].p.v = columnTop;
-				segments[2].p.h = columnRight; segments[2].p.v = columnTop;
-				segments[3].p.h = columnRight; segments[3].p.v = plotArea.bottom;
-				
-				for (int j = 0; j < 4; j++) {
-					segments[j].in = segments[j].out = segments[j].p;
-					segments[j].corner = true;
-					result = sAIPath->SetPathSegments(column, j, 1, &segments[j]);
-					aisdk::check_ai_error(result);
-				}
-				
-				result = sAIPath->SetPathClosed(column, true);
-				aisdk::check_ai_error(result);
-				
-				// Column style - use series color
-				AIPathStyle columnStyle;
-				AIBoolean hasAdvFill = false;
-				result = sAIPathStyle->GetPathStyle(column, &columnStyle, &hasAdvFill);
-				aisdk::check_ai_error(result);
-				
-				// Set fill with series color using CMYK
-				columnStyle.fillPaint = true;
-				columnStyle.fill.color.kind = kFourColor;
-				columnStyle.fill.color.c.f.cyan = seriesColors[seriesIdx].cyan;
-				columnStyle.fill.color.c.f.magenta = seriesColors[seriesIdx].magenta;
-				columnStyle.fill.color.c.f.yellow = seriesColors[seriesIdx].yellow;
-				columnStyle.fill.color.c.f.black = seriesColors[seriesIdx].black;
-				
-				// Set stroke
-				columnStyle.strokePaint = true;
-				columnStyle.stroke.color.kind = kGrayColor;
-				columnStyle.stroke.color.c.g.gray = 0.3 * kAIRealOne;
-				columnStyle.stroke.width = 0.5;
-				
-				result = sAIPathStyle->SetPathStyle(column, &columnStyle);
-				aisdk::check_ai_error(result);
+			else {
+				sAIDictionary->DeleteEntry(dict, sAIDictionary->Key(kChartDetailLevelDictKey));
 			}
 		}
+		sAIDictionary->Release(dict);
 		
-		// Create X-axis labels and ticks (one per category)
-		for (int i = 0; i < numCategories; i++) {
-			AIReal categoryCenter = plotArea.left + (i + 0.5) * categoryWidth;
-			
-			// X-axis label
-			AITextOrientation orient = kHorizontalTextOrientation;
-			AIRealPoint anchor;
-			anchor.h = categoryCenter;
-			anchor.v = plotArea.bottom - labelGap - 10;
+		// A chart whose reference or options weren't stored would refresh from the wrong data
+		aisdk::check_ai_error(result);
+		
+		// Lay out the chart, or reuse the layout cached from an earlier session, unless the
+		// caller laid it out already
+		ChartLayout computed;
+		if (!layout) {
+			ChartLayoutParams params;
+			MakeLayoutParams(bounds, type, chartOptions, params);
 			
-			AIArtHandle xLabel = nullptr;
-			result = sAITextFrame->NewPointText(kPlaceInsideOnTop, xLabelsGroup, orient, anchor, &xLabel);
-			if (result == kNoErr && xLabel) {
-				TextRangeRef range = nullptr;
-				result = sAITextFrame->GetATETextRange(xLabel, &range);
-				if (result == kNoErr && range) {
-					ATE::ITextRange textRange(range);
-					
-					// Set the text content
-					textRange.InsertAfter(ai::UnicodeString(categoryLabels[i]).as_ASUnicode().c_str());
-					
-					// Set paragraph alignment to center
-					ATE::IParaFeatures paraFeatures;
-					paraFeatures.SetJustification(ATE::kCenterJustify);
-					textRange.SetLocalParaFeatures(paraFeatures);
+			ChartTextMeasurer estimate;
+			ChartTextMeasurer& measurer = sTextMeasurer ? *sTextMeasurer : estimate;
+			uint64_t layoutKey = ChartLayout::ComputeKey(dataset, dataRef, params, measurer);
+			if (!sLayoutCache || !sLayoutCache->Load(layoutKey, computed)) {
+				ChartSeriesView view;
+				if (!dataset.Resolve(dataRef, view) || !ChartLayout::Compute(view, params, measurer, computed, sWorkerPool)) {
+					return kBadParameterErr;
 				}
-			}
-			
-			// Also add tick mark
-			AIArtHandle tick;
-			result = sAIArt->NewArt(kPathArt, kPlaceInsideOnTop, xTicksGroup, &tick);
-			if (result == kNoErr) {
-				result = sAIPath->SetPathSegmentCount(tick, 2);
-				AIPathSegment tickSegs[2];
-				tickSegs[0].p.h = categoryCenter;
-				tickSegs[0].p.v = plotArea.bottom;
-				tickSegs[0].in = tickSegs[0].out = tickSegs[0].p;
-				tickSegs[0].corner = true;
-				
-				tickSegs[1].p.h = categoryCenter;
-				tickSegs[1].p.v = plotArea.bottom - 5;
-				tickSegs[1].in = tickSegs[1].out = tickSegs[1].p;
-				tickSegs[1].corner = true;
-				
-				for (int j = 0; j < 2; j++) {
-					result = sAIPath->SetPathSegments(tick, j, 1, &tickSegs[j]);
+				if (sLayoutCache) {
+					sLayoutCache->Store(layoutKey, computed);
 				}
-				result = sAIPath->SetPathClosed(tick, false);
-				
-				AIPathStyle tickStyle;
-				AIBoolean hasAdvFill = false;
-				sAIPathStyle->GetPathStyle(tick, &tickStyle, &hasAdvFill);
-				tickStyle.fillPaint = false;
-				tickStyle.strokePaint = true;
-				tickStyle.stroke.color.kind = kGrayColor;
-				tickStyle.stroke.color.c.g.gray = 0.3 * kAIRealOne;
-				tickStyle.stroke.width = 0.5;
-				sAIPathStyle->SetPathStyle(tick, &tickStyle);
 			}
+			layout = &computed;
 		}
 		
-		// Add Y-axis (vertical line)
-	AIArtHandle yAxis;
-	result = sAIArt->NewArt(kPathArt, kPlaceInsideOnTop, yAxisGroup, &yAxis);
-	if (result == kNoErr) {
-		result = sAIPath->SetPathSegmentCount(yAxis, 2);
-		AIPathSegment axisSegs[2];
-		axisSegs[0].p.h = plotArea.left;
-		axisSegs[0].p.v = plotArea.bottom;
-		axisSegs[0].in = axisSegs[0].out = axisSegs[0].p;
-		axisSegs[0].corner = true;
+		// The chart's art as a display list, diffed against the list of the last render
+		// while the art is known to be untouched since then
+		ChartDisplayList list;
+		ChartDisplayList::Build(*layout, sLabelMode == kChartLabelsCombined, list);
 		
-		axisSegs[1].p.h = plotArea.left;
-		axisSegs[1].p.v = plotArea.top;
-		axisSegs[1].in = axisSegs[1].out = axisSegs[1].p;
-		axisSegs[1].corner = true;
+		// A large chart is drawn in slices from the idle timer, after its skeleton
+		if (sRenderQueue && sRenderQueue->Wants(list)) {
+			result = sRenderQueue->Start(chartArt, chartID, list, layout->seriesNames, sEmitMode, sMarkerMode, retained, reused ? &retained->GetList() : nullptr);
+			aisdk::check_ai_error(result);
+			return kNoErr;
+		}
 		
-		for (int j = 0; j < 2; j++) {
-			result = sAIPath->SetPathSegments(yAxis, j, 1, &axisSegs[j]);
+		ChartDisplayDiff diff;
+		if (reused) {
+			ChartDisplayList::Diff(retained->GetList(), list, diff);
 		}
-		result = sAIPath->SetPathClosed(yAxis, false);
 		
-		// Style the axis
-		AIPathStyle axisStyle;
-		AIBoolean hasAdvFill = false;
-		sAIPathStyle->GetPathStyle(yAxis, &axisStyle, &hasAdvFill);
-		axisStyle.fillPaint = false;
-		axisStyle.strokePaint = true;
-		axisStyle.stroke.color.kind = kGrayColor;
-		axisStyle.stroke.color.c.g.gray = 0.3 * kAIRealOne;
-		axisStyle.stroke.width = 0.5;
-		sAIPathStyle->SetPathStyle(yAxis, &axisStyle);
-	}
-	
-	// Add X-axis (horizontal line)
-	AIArtHandle xAxis;
-	result = sAIArt->NewArt(kPathArt, kPlaceInsideOnTop, xAxisGroup, &xAxis);
-	if (result == kNoErr) {
-		result = sAIPath->SetPathSegmentCount(xAxis, 2);
-		AIPathSegment axisSegs[2];
-		axisSegs[0].p.h = plotArea.left;
-		axisSegs[0].p.v = plotArea.bottom;
-		axisSegs[0].in = axisSegs[0].out = axisSegs[0].p;
-		axisSegs[0].corner = true;
+		// All path styles come from the chart's style table, painted by reference to the
+		// document's chart swatches and graphic styles, unless the caller shares one
+		ChartStyleTable ownStyles;
+		if (!styles) {
+			result = ownStyles.BindToDocument(layout->seriesNames);
+			aisdk::check_ai_error(result);
+			styles = &ownStyles;
+		}
 		
-		axisSegs[1].p.h = plotArea.right;
-		axisSegs[1].p.v = plotArea.bottom;
-		axisSegs[1].in = axisSegs[1].out = axisSegs[1].p;
-		axisSegs[1].corner = true;
+		// Component groups are taken in z-order from back to front, reusing those of an
+		// earlier render; what the chart no longer has is disposed
+		ChartArtCursor components(chartArt);
+		ChartDisplayEmitter emitter(*styles, sEmitMode, sMarkerMode);
+		result = emitter.Emit(list, components, reused ? &diff : nullptr);
+		aisdk::check_ai_error(result);
 		
-		for (int j = 0; j < 2; j++) {
-			result = sAIPath->SetPathSegments(xAxis, j, 1, &axisSegs[j]);
-		}
-		result = sAIPath->SetPathClosed(xAxis, false);
+		result = components.Finish();
+		aisdk::check_ai_error(result);
 		
-		// Style the axis
-		AIPathStyle axisStyle;
-		AIBoolean hasAdvFill = false;
-		sAIPathStyle->GetPathStyle(xAxis, &axisStyle, &hasAdvFill);
-		axisStyle.fillPaint = false;
-		axisStyle.strokePaint = true;
-		axisStyle.stroke.color.kind = kGrayColor;
-		axisStyle.stroke.color.c.g.gray = 0.3 * kAIRealOne;
-		axisStyle.stroke.width = 0.5;
-		sAIPathStyle->SetPathStyle(xAxis, &axisStyle);
+		if (retained) {
+			retained->Retain(chartArt, list, sEmitMode, sMarkerMode);
+		}
+	}
+	catch (ai::Error& ex) {
+		result = ex;
 	}
 	
-	// Add Y-axis labels and tick marks (for 0, 25, 50, 75, 100)
-	for (int i = 0; i <= 4; i++) {
-		// Y-axis label
-		AITextOrientation orient = kHorizontalTextOrientation;
-		
-		// Get the default font size to adjust vertical position
-		AIReal fontSize = 12.0; // Default font size
-		ATE::ICharFeatures defaultCharFeatures;
-		bool isAssigned = false;
-		AIReal actualFontSize = defaultCharFeatures.GetFontSize(&isAssigned);
-		if (isAssigned) {
-			fontSize = actualFontSize;
-		}
+	return result;
+}
+
+/*
+*/
+void ChartItem::MakeLayoutParams(const AIRealRect& bounds, ChartType type, const ChartOptions& options, ChartLayoutParams& params)
+{
+	params = ChartLayoutParams();
+	params.chartType = (int32_t)type;
+	params.plotArea.left = bounds.left;  // The drawn rectangle IS the plot area
+	params.plotArea.top = bounds.top;
+	params.plotArea.right = bounds.right;
+	params.plotArea.bottom = bounds.bottom;
+	params.showDataLabels = options.showDataLabels ? true : false;
+	params.resolution = options.adaptiveDetail ? ChartLayout::GetDetailResolution(sDetailLevel) : 0;
+	params.bridgeGaps = options.bridgeGaps ? true : false;
+	params.normalizeStack = options.normalizeStack ? true : false;
+	params.valueScale = options.valueScale;
+	params.xScale = options.xScale;
+	
+	ChartATEMeasurer::GetDefaultFont(params.fontName, params.fontSize);
+}
+
+/*
+*/
+ASErr ChartItem::WriteDataRef(AIDictionaryRef dict, const ChartDataRef& ref)
+{
+	ASErr result = kNoErr;
+	
+	try {
+		result = sAIDictionary->SetStringEntry(dict, sAIDictionary->Key(kChartDatasetIDDictKey), ref.datasetID.c_str());
+		aisdk::check_ai_error(result);
 		
-		AIRealPoint anchor;
-		anchor.h = plotArea.left - labelGap - 5;  // Position closer to axis for right alignment
-		// Adjust vertical position by moving down by 0.35 * fontSize (half of 0.7 cap height estimate)
-		anchor.v = plotArea.bottom + (i * plotHeight / 4) - (fontSize * 0.35);
+		result = sAIDictionary->SetStringEntry(dict, sAIDictionary->Key(kChartCategoryColumnDictKey), ref.categoryColumn.c_str());
+		aisdk::check_ai_error(result);
 		
-		AIArtHandle yLabel = nullptr;
-		result = sAITextFrame->NewPointText(kPlaceInsideOnTop, yLabelsGroup, orient, anchor, &yLabel);
-		if (result == kNoErr && yLabel) {
-			TextRangeRef range = nullptr;
-			result = sAITextFrame->GetATETextRange(yLabel, &range);
-			if (result == kNoErr && range) {
-				ATE::ITextRange textRange(range);
-				
-				// Set the text content
-				ai::UnicodeString labelText;
-				ai::NumberFormat numFormat;
-				numFormat.toString(i * 25.0, 0, labelText);
-				labelText = labelText + ai::UnicodeString("%");
-				textRange.InsertAfter(labelText.as_ASUnicode().c_str());
-				
-				// Set paragraph alignment to right
-				ATE::IParaFeatures paraFeatures;
-				paraFeatures.SetJustification(ATE::kRightJustify);
-				textRange.SetLocalParaFeatures(paraFeatures);
-			}
+		// Value column names are stored tab-separated
+		std::string valueColumns;
+		for (size_t i = 0; i < ref.valueColumns.size(); i++) {
+			if (i > 0) valueColumns += '\t';
+			valueColumns += ref.valueColumns[i];
 		}
-		
-		// Add tick mark
-		AIArtHandle tick;
-		result = sAIArt->NewArt(kPathArt, kPlaceInsideOnTop, yTicksGroup, &tick);
-		if (result == kNoErr) {
-			result = sAIPath->SetPathSegmentCount(tick, 2);
-			AIPathSegment tickSegs[2];
-			tickSegs[0].p.h = plotArea.left;
-			tickSegs[0].p.v = plotArea.bottom + (i * plotHeight / 4);
-			tickSegs[0].in = tickSegs[0].out = tickSegs[0].p;
-			tickSegs[0].corner = true;
-			
-			tickSegs[1].p.h = plotArea.left - 5;  // 5 point tick extending left
-			tickSegs[1].p.v = plotArea.bottom + (i * plotHeight / 4);
-			tickSegs[1].in = tickSegs[1].out = tickSegs[1].p;
-			tickSegs[1].corner = true;
-			
-			for (int j = 0; j < 2; j++) {
-				result = sAIPath->SetPathSegments(tick, j, 1, &tickSegs[j]);
-			}
-			result = sAIPath->SetPathClosed(tick, false);
-			
-			// Style the tick mark
-			AIPathStyle tickStyle;
-			AIBoolean hasAdvFill = false;
-			sAIPathStyle->GetPathStyle(tick, &tickStyle, &hasAdvFill);
-			tickStyle.fillPaint = false;
-			tickStyle.strokePaint = true;
-			tickStyle.stroke.color.kind = kGrayColor;
-			tickStyle.stroke.color.c.g.gray = 0.3 * kAIRealOne;
-			tickStyle.stroke.width = 0.5;
-			sAIPathStyle->SetPathStyle(tick, &tickStyle);
-		}
-	}
+		result = sAIDictionary->SetStringEntry(dict, sAIDictionary->Key(kChartValueColumnsDictKey), valueColumns.c_str());
+		aisdk::check_ai_error(result);
 	}
 	catch (ai::Error& ex) {
 		result = ex;
-		if (chartArt && *chartArt) {
-			sAIArt->DisposeArt(*chartArt);
-			*chartArt = nullptr;
+	}
+	
+	return result;
+}
+
+/*
+*/
+ASErr ChartItem::ReadDataRef(AIDictionaryRef dict, ChartDataRef& ref)
+{
+	ref = ChartDataRef();
+	
+	const char* value = nullptr;
+	if (sAIDictionary->GetStringEntry(dict, sAIDictionary->Key(kChartDatasetIDDictKey), &value) == kNoErr && value) {
+		ref.datasetID = value;
+	}
+	
+	value = nullptr;
+	if (sAIDictionary->GetStringEntry(dict, sAIDictionary->Key(kChartCategoryColumnDictKey), &value) == kNoErr && value) {
+		ref.categoryColumn = value;
+	}
+	
+	value = nullptr;
+	if (sAIDictionary->GetStringEntry(dict, sAIDictionary->Key(kChartValueColumnsDictKey), &value) == kNoErr && value && *value) {
+		std::string columns(value);
+		size_t start = 0;
+		while (start <= columns.size()) {
+			size_t end = columns.find('\t', start);
+			if (end == std::string::npos) end = columns.size();
+			ref.valueColumns.push_back(columns.substr(start, end - start));
+			start = end + 1;
 		}
 	}
 	
+	// Entries are optional; charts without a reference draw the sample dataset
+	return kNoErr;
+}
+
+/*
+*/
+ASErr ChartItem::WriteOptions(AIDictionaryRef dict, const ChartOptions& options)
+{
+	ASErr result = sAIDictionary->SetBooleanEntry(dict, sAIDictionary->Key(kChartShowDataLabelsDictKey), options.showDataLabels);
+	if (result == kNoErr) {
+		result = sAIDictionary->SetBooleanEntry(dict, sAIDictionary->Key(kChartAdaptiveDetailDictKey), options.adaptiveDetail);
+	}
+	if (result == kNoErr) {
+		result = sAIDictionary->SetBooleanEntry(dict, sAIDictionary->Key(kChartBridgeGapsDictKey), options.bridgeGaps);
+	}
+	if (result == kNoErr) {
+		result = sAIDictionary->SetBooleanEntry(dict, sAIDictionary->Key(kChartNormalizeStackDictKey), options.normalizeStack);
+	}
+	if (result == kNoErr) {
+		result = sAIDictionary->SetIntegerEntry(dict, sAIDictionary->Key(kChartValueScaleDictKey), options.valueScale);
+	}
+	if (result == kNoErr) {
+		result = sAIDictionary->SetIntegerEntry(dict, sAIDictionary->Key(kChartXScaleDictKey), options.xScale);
+	}
 	return result;
-}
\ No newline at end of file
+}
+
+/*
+*/
+ASErr ChartItem::ReadOptions(AIDictionaryRef dict, ChartOptions& options)
+{
+	options = ChartOptions();
+	
+	// Entries are optional; charts saved without them use the defaults
+	sAIDictionary->GetBooleanEntry(dict, sAIDictionary->Key(kChartShowDataLabelsDictKey), &options.showDataLabels);
+	sAIDictionary->GetBooleanEntry(dict, sAIDictionary->Key(kChartAdaptiveDetailDictKey), &options.adaptiveDetail);
+	sAIDictionary->GetBooleanEntry(dict, sAIDictionary->Key(kChartBridgeGapsDictKey), &options.bridgeGaps);
+	sAIDictionary->GetBooleanEntry(dict, sAIDictionary->Key(kChartNormalizeStackDictKey), &options.normalizeStack);
+	sAIDictionary->GetIntegerEntry(dict, sAIDictionary->Key(kChartValueScaleDictKey), &options.valueScale);
+	sAIDictionary->GetIntegerEntry(dict, sAIDictionary->Key(kChartXScaleDictKey), &options.xScale);
+	
+	// Scales from a newer version of the plug-in draw as linear
+	if (options.valueScale < 0 || options.valueScale >= kChartScaleTypeCount) options.valueScale = kChartScaleLinear;
+	if (options.xScale < 0 || options.xScale >= kChartScaleTypeCount) options.xScale = kChartScaleLinear;
+	return kNoErr;
+}
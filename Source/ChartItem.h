@@ -15,6 +15,10 @@
 #define __ChartItem_h__
 
 #include "IllustratorSDK.h"
+#include "ChartDataset.h"
+#include "ChartLayout.h"
+#include "ChartPathBuilder.h"
+#include "ChartScale.h"
 #include <vector>
 #include <string>
 
@@ -30,21 +34,38 @@
 #define kChartMarginDictKey			"ChartMargin"
 #define kChartIDDictKey				"ChartID"
 #define kChartVersionDictKey		"ChartVersion"
+#define kChartBoundsDictKey			"ChartBounds"
+#define kChartIsChartDictKey		"isChart"
+#define kChartDatasetIDDictKey		"ChartDatasetID"
+#define kChartCategoryColumnDictKey	"ChartCategoryColumn"
+#define kChartValueColumnsDictKey	"ChartValueColumns"
+#define kChartIncompleteDictKey		"ChartIncomplete"
+#define kChartAdaptiveDetailDictKey	"ChartAdaptiveDetail"
+#define kChartDetailLevelDictKey	"ChartDetailLevel"
+#define kChartBridgeGapsDictKey		"ChartBridgeGaps"
+#define kChartNormalizeStackDictKey	"ChartNormalizeStack"
+#define kChartValueScaleDictKey		"ChartValueScale"
+#define kChartXScaleDictKey			"ChartXScale"
 
 // Chart art type identifier
 #define kChartArtType				"com.adobe.illustrator.charts.chartObject"
 
-// Chart type enumeration
-enum ChartType {
-	kChartTypeBar = 0,
-	kChartTypeLine,
-	kChartTypePie,
-	kChartTypeArea,
-	kChartTypeScatter,
-	kChartTypeColumn,
-	kChartTypeDonut,
-	kChartTypeRadar,
-	kChartTypeUnknown
+// How the labels of an axis are set
+enum ChartLabelMode {
+	kChartLabelsCombined = 0,	// One text object per axis where the labels allow it
+	kChartLabelsSeparate		// One point text per label
+};
+
+// Per-chart presentation options, stored in the chart's dictionary
+struct ChartOptions {
+	AIBoolean showDataLabels;
+	AIBoolean adaptiveDetail;	// Data marks follow the view zoom, at the current detail level
+	AIBoolean bridgeGaps;		// Lines join across missing values instead of breaking
+	AIBoolean normalizeStack;	// Stacked areas fill the value axis, each layer its share
+	ai::int32 valueScale;		// ChartScaleType of the value axis
+	ai::int32 xScale;			// ChartScaleType of the X axis of scatter charts
+	
+	ChartOptions() : showDataLabels(false), adaptiveDetail(false), bridgeGaps(false), normalizeStack(false), valueScale(kChartScaleLinear), xScale(kChartScaleLinear) {}
 };
 
 // Data point structure
@@ -80,6 +101,12 @@ struct ChartDataSeries {
 	}
 };
 
+class ChartLayoutCache;
+class ChartRenderQueue;
+class ChartRetainedArt;
+class ChartStyleTable;
+class ChartWorkerPool;
+
 // Chart item class
 class ChartItem {
 private:
@@ -109,6 +136,30 @@ private:
 	// Unique identifier for this chart
 	ai::int32 fChartID;
 	static ai::int32 sNextChartID;
+	
+	// Cache consulted for chart layouts before computing them, or null for none
+	static ChartLayoutCache* sLayoutCache;
+	
+	// Measures labels during layout, or null to estimate their extents
+	static ChartTextMeasurer* sTextMeasurer;
+	
+	// Whether grid lines, ticks and the columns of a series are merged into compound paths
+	static ChartEmitMode sEmitMode;
+	
+	// How scatter markers are emitted; chosen per series from the cost estimate by default
+	static ChartMarkerMode sMarkerMode;
+	
+	// Whether axis labels are combined into one text object per axis
+	static ChartLabelMode sLabelMode;
+	
+	// Workers for the geometry of large series, or null to lay out on the calling thread
+	static ChartWorkerPool* sWorkerPool;
+	
+	// Emits large charts in slices from the idle timer, or null to emit every chart at once
+	static ChartRenderQueue* sRenderQueue;
+	
+	// Level of detail that charts with adaptive detail are laid out at
+	static ai::int32 sDetailLevel;
 
 public:
 	// Constructor
@@ -166,15 +217,83 @@ public:
 	// Chart ID
 	ai::int32 GetChartID() const { return fChartID; }
 	
+	// Hand out a new chart ID, and keep IDs read from a document from being handed out again
+	static ai::int32 AllocateChartID() { return sNextChartID++; }
+	static void ReserveChartID(ai::int32 chartID) { if (chartID >= sNextChartID) sNextChartID = chartID + 1; }
+	
+	// Layout cache used by CreatePluginArt; the caller keeps ownership
+	static void SetLayoutCache(ChartLayoutCache* cache) { sLayoutCache = cache; }
+	static ChartLayoutCache* GetLayoutCache() { return sLayoutCache; }
+	
+	// Text measurer used for layout; the caller keeps ownership
+	static void SetTextMeasurer(ChartTextMeasurer* measurer) { sTextMeasurer = measurer; }
+	static ChartTextMeasurer* GetTextMeasurer() { return sTextMeasurer; }
+	
+	// Emission mode used by CreatePluginArt; compound paths by default
+	static void SetEmitMode(ChartEmitMode mode) { sEmitMode = mode; }
+	static ChartEmitMode GetEmitMode() { return sEmitMode; }
+	
+	// Marker emission used for scatter charts
+	static void SetMarkerMode(ChartMarkerMode mode) { sMarkerMode = mode; }
+	static ChartMarkerMode GetMarkerMode() { return sMarkerMode; }
+	
+	// Label emission used by CreatePluginArt; combined by default
+	static void SetLabelMode(ChartLabelMode mode) { sLabelMode = mode; }
+	static ChartLabelMode GetLabelMode() { return sLabelMode; }
+	
+	// Worker pool used for layout; the caller keeps ownership
+	static void SetWorkerPool(ChartWorkerPool* pool) { sWorkerPool = pool; }
+	static ChartWorkerPool* GetWorkerPool() { return sWorkerPool; }
+	
+	// Render queue used by UpdatePluginArt; the caller keeps ownership
+	static void SetRenderQueue(ChartRenderQueue* queue) { sRenderQueue = queue; }
+	static ChartRenderQueue* GetRenderQueue() { return sRenderQueue; }
+	
+	// Detail level used by MakeLayoutParams for charts with adaptive detail, following
+	// the zoom of the current view; each such chart records the level it was drawn at
+	static void SetDetailLevel(ai::int32 level) { sDetailLevel = level; }
+	static ai::int32 GetDetailLevel() { return sDetailLevel; }
+	
 	// Chart rendering
 	ASErr CreateChartArt();  // Creates the Illustrator artwork for the chart
-	ASErr UpdateChartArt();  // Updates existing chart artwork
+	ASErr UpdateChartArt();  // Rewrites existing chart artwork in place, or creates it
 	ASErr DeleteChartArt();  // Removes the chart artwork
 
 	// Plugin art creation
-	static ASErr CreatePluginArt(const AIRealRect& bounds, ChartType type, AIPluginGroupHandle pluginGroupHandle, AIArtHandle* chartArt);
-	
-	// Render chart content in existing group (for plugin art)
+	// Pass a chartID of 0 to allocate a new ID, or an existing ID when recreating a chart.
+	// The chart is drawn from source, or from the sample dataset if source is null, with
+	// options, or the default options if options is null. retained, if not null, receives
+	// the display list the art was emitted from, for the chart's next UpdatePluginArt.
+	// layout and styles are as for UpdatePluginArt.
+	static ASErr CreatePluginArt(const AIRealRect& bounds, ChartType type, AIPluginGroupHandle pluginGroupHandle, AIArtHandle* chartArt, ai::int32 chartID = 0, const ChartDataSource* source = nullptr, const ChartOptions* options = nullptr, ChartRetainedArt* retained = nullptr,
+		const ChartLayout* layout = nullptr, ChartStyleTable* styles = nullptr);
+	
+	// Redraws a chart made by CreatePluginArt in place. The layout is built into a display
+	// list and emitted through the component groups in order, rewriting paths and texts
+	// where they differ, so objects are only added or removed when counts change and the
+	// chart keeps its art handle. With the list retained from the chart's last render, and
+	// the art untouched since, only primitives that changed between the lists are visited.
+	// layout, if not null, is the chart's layout computed by the caller, as for a batch of
+	// charts laid out together; otherwise it is computed here. styles, if not null, is a
+	// table already bound to the document for the layout's series, shared by a batch of
+	// charts; otherwise the chart binds its own. A chart too large for the render queue's
+	// threshold returns with its skeleton drawn and the rest queued.
+	static ASErr UpdatePluginArt(AIArtHandle chartArt, const AIRealRect& bounds, ChartType type, ai::int32 chartID, const ChartDataSource* source = nullptr, const ChartOptions* options = nullptr, ChartRetainedArt* retained = nullptr, const ChartLayout* layout = nullptr,
+		ChartStyleTable* styles = nullptr);
+	
+	// Layout parameters of a chart drawn in bounds. Reads the default font, so call on the
+	// main thread.
+	static void MakeLayoutParams(const AIRealRect& bounds, ChartType type, const ChartOptions& options, ChartLayoutParams& params);
+	
+	// Dataset reference stored in a chart's dictionary
+	static ASErr WriteDataRef(AIDictionaryRef dict, const ChartDataRef& ref);
+	static ASErr ReadDataRef(AIDictionaryRef dict, ChartDataRef& ref);
+	
+	// Options stored in a chart's dictionary
+	static ASErr WriteOptions(AIDictionaryRef dict, const ChartOptions& options);
+	static ASErr ReadOptions(AIDictionaryRef dict, ChartOptions& options);
+	
+	// Render chart content in existing group (for plugin art), reusing any content already there
 	ASErr RenderChartContent();
 	
 	// Data validation
@@ -194,18 +313,19 @@ public:
 	static ChartItem* CreateFromArt(AIArtHandle art);
 	
 private:
-	// Helper methods for rendering different chart types
-	ASErr RenderBarChart();
-	ASErr RenderLineChart();
-	ASErr RenderPieChart();
-	ASErr RenderAreaChart();
-	ASErr RenderScatterChart();
-	ASErr RenderColumnChart();
-	ASErr RenderDonutChart();
-	ASErr RenderRadarChart();
+	// Helper methods for rendering different chart types; content walks the chart group and
+	// styles is the table RenderChartContent bound to the document for the chart's series
+	ASErr RenderBarChart(ChartArtCursor& content, ChartStyleTable& styles);
+	ASErr RenderLineChart(ChartArtCursor& content, ChartStyleTable& styles);
+	ASErr RenderPieChart(ChartArtCursor& content, ChartStyleTable& styles);
+	ASErr RenderAreaChart(ChartArtCursor& content, ChartStyleTable& styles);
+	ASErr RenderScatterChart(ChartArtCursor& content, ChartStyleTable& styles);
+	ASErr RenderColumnChart(ChartArtCursor& content, ChartStyleTable& styles);
+	ASErr RenderDonutChart(ChartArtCursor& content, ChartStyleTable& styles);
+	ASErr RenderRadarChart(ChartArtCursor& content, ChartStyleTable& styles);
 	
 	// Helper for creating chart background
-	ASErr CreateChartBackground();
+	ASErr CreateChartBackground(ChartArtCursor& content, ChartStyleTable& styles);
 	
 	// Helper for creating axes
 	ASErr CreateAxes();
@@ -213,8 +333,14 @@ private:
 	// Helper for creating legend
 	ASErr CreateLegend();
 	
-	// Helper for calculating data ranges
-	void CalculateDataRange(AIReal& minValue, AIReal& maxValue) const;
+	// Converts the chart's data series to a dataset: point labels become the category
+	// column and each series a numeric column
+	void BuildDataset(ChartDataset& dataset) const;
+	
+	// Lays out the chart's series as a chart of type inside the margins and emits its
+	// data marks and data labels into content, over the background already there, with
+	// the grid of a radar chart beneath them, painted from styles
+	ASErr RenderSeriesLayout(ChartArtCursor& content, ChartType type, ChartStyleTable& styles);
 };
 
 #endif // __ChartItem_h__
\ No newline at end of file
@@ -0,0 +1,203 @@
+//========================================================================================
+//  
+//  ChartLabelPlacement.cpp
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#include "ChartLabelPlacement.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace {
+
+// Most grid cells allocated, whatever the cell size asked for
+const double kMaxCells = 1 << 20;
+
+// Directions tried around a mark, in order of preference: above, right, left, below,
+// then the corners
+const int kDirections[8][2] = {
+	{0, 1}, {1, 0}, {-1, 0}, {0, -1},
+	{1, 1}, {-1, 1}, {1, -1}, {-1, -1}
+};
+
+// Further rings tried with a leader line, in label heights beyond the adjacent ring
+const int kLeaderRings = 2;
+
+} // namespace
+
+/*
+*/
+ChartLabelPlacer::ChartLabelPlacer(const ChartRect& bounds, double cellSize, double gap) :
+	fBounds(MakeBox(bounds)), fCellSize(cellSize), fGap(gap), fColumns(1), fRows(1), fDropped(0)
+{
+	const double width = std::max(fBounds.right - fBounds.left, 1.0);
+	const double height = std::max(fBounds.top - fBounds.bottom, 1.0);
+
+	// Coarsen the grid rather than allocate an unbounded number of cells
+	if (!(fCellSize > 0)) {
+		fCellSize = std::max(width, height);
+	}
+	const double cells = (width / fCellSize) * (height / fCellSize);
+	if (cells > kMaxCells) {
+		fCellSize *= std::sqrt(cells / kMaxCells);
+	}
+
+	fColumns = std::max((int32_t)std::ceil(width / fCellSize), 1);
+	fRows = std::max((int32_t)std::ceil(height / fCellSize), 1);
+	fCells.resize((size_t)fColumns * fRows);
+}
+
+/*
+*/
+ChartLabelPlacer::Box ChartLabelPlacer::MakeBox(const ChartRect& rect)
+{
+	Box box;
+	box.left = std::min(rect.left, rect.right);
+	box.right = std::max(rect.left, rect.right);
+	box.bottom = std::min(rect.bottom, rect.top);
+	box.top = std::max(rect.bottom, rect.top);
+	return box;
+}
+
+/*
+*/
+void ChartLabelPlacer::CellRange(const Box& box, int32_t& col0, int32_t& row0, int32_t& col1, int32_t& row1) const
+{
+	auto clampColumn = [this](double h) { return std::min(std::max((int32_t)std::floor((h - fBounds.left) / fCellSize), (int32_t)0), fColumns - 1); };
+	auto clampRow = [this](double v) { return std::min(std::max((int32_t)std::floor((v - fBounds.bottom) / fCellSize), (int32_t)0), fRows - 1); };
+	col0 = clampColumn(box.left);
+	col1 = clampColumn(box.right);
+	row0 = clampRow(box.bottom);
+	row1 = clampRow(box.top);
+}
+
+/*
+*/
+bool ChartLabelPlacer::IsFree(const Box& box) const
+{
+	if (box.left < fBounds.left || box.right > fBounds.right || box.bottom < fBounds.bottom || box.top > fBounds.top) {
+		return false;
+	}
+
+	int32_t col0, row0, col1, row1;
+	CellRange(box, col0, row0, col1, row1);
+	for (int32_t row = row0; row <= row1; row++) {
+		for (int32_t col = col0; col <= col1; col++) {
+			for (uint32_t index : fCells[(size_t)row * fColumns + col]) {
+				// Boxes that only touch do not overlap
+				const Box& other = fBoxes[index];
+				if (box.left < other.right && other.left < box.right && box.bottom < other.top && other.bottom < box.top) {
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+/*
+*/
+void ChartLabelPlacer::Insert(const Box& box)
+{
+	const uint32_t index = (uint32_t)fBoxes.size();
+	fBoxes.push_back(box);
+
+	int32_t col0, row0, col1, row1;
+	CellRange(box, col0, row0, col1, row1);
+	for (int32_t row = row0; row <= row1; row++) {
+		for (int32_t col = col0; col <= col1; col++) {
+			fCells[(size_t)row * fColumns + col].push_back(index);
+		}
+	}
+}
+
+/*
+*/
+void ChartLabelPlacer::AddObstacle(const ChartRect& rect)
+{
+	Insert(MakeBox(rect));
+}
+
+/*
+*/
+void ChartLabelPlacer::Place(const std::vector<ChartLabelRequest>& requests, std::vector<ChartLabel>& labels, std::vector<ChartSegment>& leaders)
+{
+	for (const ChartLabelRequest& request : requests) {
+		AddObstacle(request.mark);
+	}
+
+	std::vector<size_t> order(requests.size());
+	std::iota(order.begin(), order.end(), (size_t)0);
+	std::stable_sort(order.begin(), order.end(), [&requests](size_t a, size_t b) { return requests[a].priority > requests[b].priority; });
+
+	labels.reserve(labels.size() + requests.size());
+
+	for (size_t index : order) {
+		const ChartLabelRequest& request = requests[index];
+		const Box mark = MakeBox(request.mark);
+		const double width = request.extent.width;
+		const double height = request.extent.height;
+		const double centerH = (mark.left + mark.right) / 2;
+		const double centerV = (mark.bottom + mark.top) / 2;
+
+		bool placed = false;
+		for (int ring = 0; ring <= kLeaderRings && !placed; ring++) {
+			// Distance of the label from the mark's edge
+			const double offset = fGap + ring * (height + fGap);
+
+			for (const auto& direction : kDirections) {
+				const int dh = direction[0];
+				const int dv = direction[1];
+
+				// The point on the mark's edge the label sits against
+				ChartPoint from;
+				from.h = dh < 0 ? mark.left : dh > 0 ? mark.right : centerH;
+				from.v = dv < 0 ? mark.bottom : dv > 0 ? mark.top : centerV;
+
+				Box box;
+				box.left = dh < 0 ? from.h - offset - width : dh > 0 ? from.h + offset : from.h - width / 2;
+				box.right = box.left + width;
+				box.bottom = dv < 0 ? from.v - offset - height : dv > 0 ? from.v + offset : from.v - height / 2;
+				box.top = box.bottom + height;
+
+				// Keep the gap between neighboring labels as well
+				Box padded = {box.left - fGap / 2, box.bottom - fGap / 2, box.right + fGap / 2, box.top + fGap / 2};
+				if (!IsFree(padded)) {
+					continue;
+				}
+				Insert(padded);
+
+				ChartLabel label;
+				label.text = request.text;
+				label.extent = request.extent;
+				label.justification = kChartJustifyCenter;
+				label.anchor.h = (box.left + box.right) / 2;
+				label.anchor.v = box.bottom;
+				labels.push_back(label);
+
+				if (ring > 0) {
+					// Join the label's nearest edge to the mark
+					ChartPoint to;
+					to.h = dh < 0 ? box.right : dh > 0 ? box.left : label.anchor.h;
+					to.v = dv < 0 ? box.top : dv > 0 ? box.bottom : (box.bottom + box.top) / 2;
+					leaders.push_back({from, to});
+				}
+
+				placed = true;
+				break;
+			}
+		}
+
+		if (!placed) {
+			fDropped++;
+		}
+	}
+}
@@ -0,0 +1,76 @@
+//========================================================================================
+//  
+//  ChartLabelPlacement.h
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#ifndef __ChartLabelPlacement_h__
+#define __ChartLabelPlacement_h__
+
+// Data label placement with overlap removal. Each label tries positions around its mark,
+// nearest first, then positions further out joined to the mark by a leader line, and is
+// dropped if none is free. Placed labels and marks are kept in a uniform grid, so testing
+// a position only looks at the few boxes in the cells it covers and placing n labels
+// costs O(n log n) for the priority sort plus O(n) for the tests.
+
+#include "ChartLayout.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// A data label to place next to its mark
+struct ChartLabelRequest {
+	ChartRect mark;				// Bounds of the column or marker the label belongs to
+	std::string text;
+	ChartTextExtent extent;
+	double priority;			// Higher priorities are placed first
+};
+
+class ChartLabelPlacer {
+public:
+	// Labels are kept inside bounds, gap apart from their mark and from each other.
+	// cellSize is the grid pitch; around twice the typical label height works well.
+	ChartLabelPlacer(const ChartRect& bounds, double cellSize, double gap);
+
+	// Keeps labels off a rectangle, such as a mark without a label
+	void AddObstacle(const ChartRect& rect);
+
+	// Places labels in decreasing priority. Every request's mark is an obstacle to the
+	// other labels. Appends a centered label per placed request, and a leader line per
+	// label set away from its mark.
+	void Place(const std::vector<ChartLabelRequest>& requests, std::vector<ChartLabel>& labels, std::vector<ChartSegment>& leaders);
+
+	// Labels dropped by Place for lack of space
+	size_t GetDroppedCount() const { return fDropped; }
+
+private:
+	// Box edges as left, bottom, right, top with bottom <= top
+	struct Box {
+		double left, bottom, right, top;
+	};
+
+	static Box MakeBox(const ChartRect& rect);
+
+	bool IsFree(const Box& box) const;
+	void Insert(const Box& box);
+	void CellRange(const Box& box, int32_t& col0, int32_t& row0, int32_t& col1, int32_t& row1) const;
+
+	Box fBounds;
+	double fCellSize;
+	double fGap;
+	int32_t fColumns;
+	int32_t fRows;
+
+	std::vector<Box> fBoxes;
+	std::vector<std::vector<uint32_t> > fCells;		// Indices into fBoxes, by row then column
+	size_t fDropped;
+};
+
+#endif // __ChartLabelPlacement_h__
@@ -0,0 +1,1496 @@
+//========================================================================================
+//  
+//  ChartLayout.cpp
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#include "ChartLayout.h"
+#include "ChartArc.h"
+#include "ChartBinary.h"
+#include "ChartLabelPlacement.h"
+#include "ChartScale.h"
+#include "ChartWorkerPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iterator>
+#include <unordered_set>
+
+namespace {
+
+const uint32_t kLayoutMagic = 0x31594C43;	// "CLY1"
+
+// Bump when Compute changes, so stale cached layouts are never keyed as current
+const uint64_t kLayoutVersion = 10;
+
+void WritePoint(ChartBinaryWriter& writer, const ChartPoint& point)
+{
+	writer.WriteDouble(point.h);
+	writer.WriteDouble(point.v);
+}
+
+bool ReadPoint(ChartBinaryReader& reader, ChartPoint& point)
+{
+	return reader.ReadDouble(point.h) && reader.ReadDouble(point.v);
+}
+
+void WriteRect(ChartBinaryWriter& writer, const ChartRect& rect)
+{
+	writer.WriteDouble(rect.left);
+	writer.WriteDouble(rect.top);
+	writer.WriteDouble(rect.right);
+	writer.WriteDouble(rect.bottom);
+}
+
+bool ReadRect(ChartBinaryReader& reader, ChartRect& rect)
+{
+	return reader.ReadDouble(rect.left) && reader.ReadDouble(rect.top) &&
+		reader.ReadDouble(rect.right) && reader.ReadDouble(rect.bottom);
+}
+
+void WriteSegments(ChartBinaryWriter& writer, const std::vector<ChartSegment>& segments)
+{
+	writer.WriteU32((uint32_t)segments.size());
+	for (const ChartSegment& segment : segments) {
+		WritePoint(writer, segment.from);
+		WritePoint(writer, segment.to);
+	}
+}
+
+bool ReadSegments(ChartBinaryReader& reader, std::vector<ChartSegment>& segments)
+{
+	uint32_t count = 0;
+	if (!reader.ReadU32(count) || !reader.CanHold(count, sizeof(ChartSegment))) return false;
+	segments.resize(count);
+	for (ChartSegment& segment : segments) {
+		if (!ReadPoint(reader, segment.from) || !ReadPoint(reader, segment.to)) return false;
+	}
+	return true;
+}
+
+void WriteLabels(ChartBinaryWriter& writer, const std::vector<ChartLabel>& labels)
+{
+	writer.WriteU32((uint32_t)labels.size());
+	for (const ChartLabel& label : labels) {
+		writer.WriteString(label.text);
+		WritePoint(writer, label.anchor);
+		writer.WriteU8((uint8_t)label.justification);
+		writer.WriteDouble(label.extent.width);
+		writer.WriteDouble(label.extent.height);
+	}
+}
+
+bool ReadLabels(ChartBinaryReader& reader, std::vector<ChartLabel>& labels)
+{
+	uint32_t count = 0;
+	if (!reader.ReadU32(count) || !reader.CanHold(count, sizeof(uint32_t) + sizeof(ChartPoint))) return false;
+	labels.resize(count);
+	for (ChartLabel& label : labels) {
+		uint8_t justification = 0;
+		if (!reader.ReadString(label.text) || !ReadPoint(reader, label.anchor) || !reader.ReadU8(justification) ||
+			!reader.ReadDouble(label.extent.width) || !reader.ReadDouble(label.extent.height)) {
+			return false;
+		}
+		label.justification = justification <= kChartJustifyRight ? (ChartJustification)justification : kChartJustifyLeft;
+	}
+	return true;
+}
+
+// Number of code points in a UTF-8 string
+size_t CharacterCount(const std::string& text)
+{
+	size_t count = 0;
+	for (unsigned char c : text) {
+		if ((c & 0xC0) != 0x80) count++;
+	}
+	return count;
+}
+
+// Tabs and line breaks would break up a combined label block
+bool IsSingleCell(const std::string& text)
+{
+	return text.find_first_of("\t\r\n") == std::string::npos;
+}
+
+// Largest difference in points still treated as the same position
+const double kPositionTolerance = 0.01;
+
+// Space between a data label and its mark
+const double kDataLabelGap = 2.0;
+
+// Value as label text
+std::string FormatValue(double value)
+{
+	char text[32];
+	snprintf(text, sizeof(text), "%.4g", value);
+	return text;
+}
+
+void WriteMarkers(ChartBinaryWriter& writer, const std::vector<ChartMarkerSet>& markers)
+{
+	writer.WriteU32((uint32_t)markers.size());
+	for (const ChartMarkerSet& set : markers) {
+		writer.WriteU32((uint32_t)set.series);
+		writer.WriteU8((uint8_t)set.shape);
+		writer.WriteU32((uint32_t)set.centers.size());
+		for (const ChartPoint& center : set.centers) {
+			WritePoint(writer, center);
+		}
+	}
+}
+
+bool ReadMarkers(ChartBinaryReader& reader, size_t seriesCount, std::vector<ChartMarkerSet>& markers)
+{
+	uint32_t count = 0;
+	if (!reader.ReadU32(count) || !reader.CanHold(count, sizeof(uint32_t) * 2 + 1)) return false;
+	markers.resize(count);
+	for (ChartMarkerSet& set : markers) {
+		uint32_t series = 0, points = 0;
+		uint8_t shape = 0;
+		if (!reader.ReadU32(series) || !reader.ReadU8(shape) || !reader.ReadU32(points)) return false;
+		if (series >= seriesCount || shape >= kChartMarkerShapeCount || !reader.CanHold(points, sizeof(ChartPoint))) return false;
+		set.series = (int32_t)series;
+		set.shape = (ChartMarkerShape)shape;
+		set.centers.resize(points);
+		for (ChartPoint& center : set.centers) {
+			if (!ReadPoint(reader, center)) return false;
+		}
+	}
+	return true;
+}
+
+void WriteLines(ChartBinaryWriter& writer, const std::vector<ChartLineSet>& lines)
+{
+	writer.WriteU32((uint32_t)lines.size());
+	for (const ChartLineSet& set : lines) {
+		writer.WriteU32((uint32_t)set.series);
+		writer.WriteU32((uint32_t)set.points.size());
+		for (const ChartPoint& point : set.points) {
+			WritePoint(writer, point);
+		}
+		writer.WriteU32((uint32_t)set.runEnds.size());
+		for (uint32_t end : set.runEnds) {
+			writer.WriteU32(end);
+		}
+	}
+}
+
+bool ReadLines(ChartBinaryReader& reader, size_t seriesCount, std::vector<ChartLineSet>& lines)
+{
+	uint32_t count = 0;
+	if (!reader.ReadU32(count) || !reader.CanHold(count, sizeof(uint32_t) * 3)) return false;
+	lines.resize(count);
+	for (ChartLineSet& set : lines) {
+		uint32_t series = 0, points = 0, runs = 0;
+		if (!reader.ReadU32(series) || !reader.ReadU32(points)) return false;
+		if (series >= seriesCount || !reader.CanHold(points, sizeof(ChartPoint))) return false;
+		set.series = (int32_t)series;
+		set.points.resize(points);
+		for (ChartPoint& point : set.points) {
+			if (!ReadPoint(reader, point)) return false;
+		}
+		if (!reader.ReadU32(runs) || !reader.CanHold(runs, sizeof(uint32_t))) return false;
+		set.runEnds.resize(runs);
+		uint32_t previous = 0;
+		for (uint32_t& end : set.runEnds) {
+			if (!reader.ReadU32(end) || end < previous || end > points) return false;
+			previous = end;
+		}
+	}
+	return true;
+}
+
+void WriteDoubles(ChartBinaryWriter& writer, const std::vector<double>& values)
+{
+	writer.WriteU32((uint32_t)values.size());
+	for (double value : values) {
+		writer.WriteDouble(value);
+	}
+}
+
+bool ReadDoubles(ChartBinaryReader& reader, std::vector<double>& values)
+{
+	uint32_t count = 0;
+	if (!reader.ReadU32(count) || !reader.CanHold(count, sizeof(double))) return false;
+	values.resize(count);
+	for (double& value : values) {
+		if (!reader.ReadDouble(value)) return false;
+	}
+	return true;
+}
+
+void WritePoints(ChartBinaryWriter& writer, const std::vector<ChartPoint>& points)
+{
+	writer.WriteU32((uint32_t)points.size());
+	for (const ChartPoint& point : points) {
+		WritePoint(writer, point);
+	}
+}
+
+bool ReadPoints(ChartBinaryReader& reader, std::vector<ChartPoint>& points)
+{
+	uint32_t count = 0;
+	if (!reader.ReadU32(count) || !reader.CanHold(count, sizeof(ChartPoint))) return false;
+	points.resize(count);
+	for (ChartPoint& point : points) {
+		if (!ReadPoint(reader, point)) return false;
+	}
+	return true;
+}
+
+void WriteWedges(ChartBinaryWriter& writer, const std::vector<ChartWedge>& wedges)
+{
+	writer.WriteU32((uint32_t)wedges.size());
+	for (const ChartWedge& wedge : wedges) {
+		writer.WriteU32((uint32_t)wedge.series);
+		WritePoint(writer, wedge.center);
+		writer.WriteDouble(wedge.radius);
+		writer.WriteDouble(wedge.innerRadius);
+		writer.WriteDouble(wedge.startAngle);
+		writer.WriteDouble(wedge.endAngle);
+	}
+}
+
+bool ReadWedges(ChartBinaryReader& reader, size_t seriesCount, std::vector<ChartWedge>& wedges)
+{
+	uint32_t count = 0;
+	if (!reader.ReadU32(count) || !reader.CanHold(count, sizeof(uint32_t) + sizeof(double) * 6)) return false;
+	wedges.resize(count);
+	for (ChartWedge& wedge : wedges) {
+		uint32_t series = 0;
+		if (!reader.ReadU32(series) || series >= seriesCount || !ReadPoint(reader, wedge.center) ||
+			!reader.ReadDouble(wedge.radius) || !reader.ReadDouble(wedge.innerRadius) ||
+			!reader.ReadDouble(wedge.startAngle) || !reader.ReadDouble(wedge.endAngle)) {
+			return false;
+		}
+		wedge.series = (int32_t)series;
+	}
+	return true;
+}
+
+// Series geometry is split over a worker pool only when there is enough of it to
+// outweigh handing it over
+const size_t kParallelSeriesPoints = 16384;
+
+// Calls layoutSeries for each of count series, on pool's workers if there is a pool and
+// the series hold at least kParallelSeriesPoints points between them
+template <typename Body>
+void ForEachSeries(ChartWorkerPool* pool, size_t count, size_t points, const Body& layoutSeries)
+{
+	if (pool && count > 1 && points >= kParallelSeriesPoints) {
+		pool->ParallelFor(count, layoutSeries);
+		return;
+	}
+	for (size_t i = 0; i < count; i++) {
+		layoutSeries(i);
+	}
+}
+
+// The finite range of the values of series first up to end. Returns false if they have none.
+bool GetValueRange(const ChartSeriesView& view, size_t first, size_t end, double& lo, double& hi)
+{
+	lo = INFINITY;
+	hi = -INFINITY;
+	for (size_t seriesIdx = first; seriesIdx < end; seriesIdx++) {
+		// NaN fails both comparisons, and infinities are left out after
+		for (double value : view.series[seriesIdx]->numbers) {
+			if (value - value == 0) {
+				lo = value < lo ? value : lo;
+				hi = value > hi ? value : hi;
+			}
+		}
+	}
+	return lo <= hi;
+}
+
+// The scale of an axis of length points over lo to hi, from the shared cache
+std::shared_ptr<const ChartScale> GetScale(int32_t type, double lo, double hi, double length, const ChartLayoutParams& params, bool includeZero, bool percent)
+{
+	ChartScaleSpec spec;
+	spec.type = type;
+	spec.min = lo;
+	spec.max = hi;
+	spec.length = length;
+	spec.fontSize = params.fontSize;
+	spec.includeZero = includeZero;
+	spec.percent = percent;
+	return ChartScaleCache::GetShared().Get(spec);
+}
+
+// Both axes, and the horizontal grid lines, ticks and labels of a value axis over lo to
+// hi. Returns the axis's scale, which places values on it.
+std::shared_ptr<const ChartScale> LayoutValueAxis(double lo, double hi, bool includeZero, bool percent, const ChartLayoutParams& params, ChartTextMeasurer& measurer, ChartLayout& layout)
+{
+	const ChartRect& plotArea = params.plotArea;
+	std::shared_ptr<const ChartScale> scale = GetScale(params.valueScale, lo, hi, plotArea.Height(), params, includeZero, percent);
+
+	// Axes
+	layout.yAxis = {{plotArea.left, plotArea.bottom}, {plotArea.left, plotArea.top}};
+	layout.xAxis = {{plotArea.left, plotArea.bottom}, {plotArea.right, plotArea.bottom}};
+
+	// Grid lines at the ticks, skipping the first and last as they're on the border;
+	// labels are centered on their tick
+	const std::vector<ChartTick>& ticks = scale->GetTicks();
+	for (size_t i = 0; i < ticks.size(); i++) {
+		const double v = plotArea.bottom + ticks[i].position;
+		if (i > 0 && i + 1 < ticks.size()) {
+			layout.yGridLines.push_back({{plotArea.left, v}, {plotArea.right, v}});
+		}
+
+		ChartLabel label;
+		label.text = ticks[i].label;
+		label.extent = measurer.Measure(params.fontName, params.fontSize, label.text);
+		label.anchor.h = plotArea.left - params.labelGap - params.tickLength;
+		label.anchor.v = v - label.extent.height / 2;
+		label.justification = kChartJustifyRight;
+		layout.yLabels.push_back(label);
+
+		layout.yTicks.push_back({{plotArea.left, v}, {plotArea.left - params.tickLength, v}});
+	}
+
+	return scale;
+}
+
+// An X-axis label hanging below the plot area, with its tick
+void AddXLabel(const std::string& text, double h, const ChartLayoutParams& params, ChartTextMeasurer& measurer, ChartLayout& layout)
+{
+	const ChartRect& plotArea = params.plotArea;
+
+	ChartLabel label;
+	label.text = text;
+	label.extent = measurer.Measure(params.fontName, params.fontSize, label.text);
+	label.anchor.h = h;
+	label.anchor.v = plotArea.bottom - params.labelGap - label.extent.height;
+	label.justification = kChartJustifyCenter;
+	layout.xLabels.push_back(label);
+
+	layout.xTicks.push_back({{h, plotArea.bottom}, {h, plotArea.bottom - params.tickLength}});
+}
+
+// Vertical grid lines, ticks and labels at the centers of the categories
+void LayoutCategoryAxis(const ChartSeriesView& view, const ChartLayoutParams& params, ChartTextMeasurer& measurer, ChartLayout& layout)
+{
+	const ChartRect& plotArea = params.plotArea;
+	const int numCategories = (int)view.CategoryCount();
+	const double categoryWidth = plotArea.Width() / numCategories;
+
+	// Categories narrower than the font size only get a grid line and label every stride
+	// categories, so long series do not bury the axis in text nobody can read
+	const int stride = std::max(1, (int)std::ceil(params.fontSize / categoryWidth));
+
+	for (int i = 0; i < numCategories; i += stride) {
+		double h = plotArea.left + (i + 0.5) * categoryWidth;  // Center of category
+		layout.xGridLines.push_back({{h, plotArea.bottom}, {h, plotArea.top}});
+	}
+
+	for (int i = 0; i < numCategories; i += stride) {
+		AddXLabel(view.CategoryLabel(i), plotArea.left + (i + 0.5) * categoryWidth, params, measurer, layout);
+	}
+}
+
+// Columns grouped by category, ordered by series, from the baseline of a value axis that
+// reaches zero. Requests a data label per column if requests is not null. Series are laid
+// out on pool's workers when there is one.
+void LayoutColumns(const ChartSeriesView& view, const ChartLayoutParams& params, ChartTextMeasurer& measurer, ChartLayout& layout, std::vector<ChartLabelRequest>* requests, ChartWorkerPool* pool)
+{
+	const ChartRect& plotArea = params.plotArea;
+	const int numCategories = (int)view.CategoryCount();
+	const int numSeries = (int)view.series.size();
+
+	// Calculate column dimensions
+	double categoryWidth = plotArea.Width() / numCategories;
+	double columnGroupWidth = categoryWidth * 0.8;  // 80% of category width for columns
+	double columnGroupGap = categoryWidth * 0.2;    // 20% for gaps
+	double individualColumnWidth = columnGroupWidth / numSeries;
+
+	for (int seriesIdx = 0; seriesIdx < numSeries; seriesIdx++) {
+		layout.seriesNames.push_back(view.series[seriesIdx]->name);
+	}
+
+	double lo = 0, hi = 0;
+	GetValueRange(view, 0, view.series.size(), lo, hi);
+	const std::shared_ptr<const ChartScale> scale = LayoutValueAxis(lo, hi, true, false, params, measurer, layout);
+	const double baseline = plotArea.bottom + scale->GetBaseline();
+
+	// Each series fills its own lists, joined in series order below
+	std::vector<std::vector<ChartBar> > seriesBars(numSeries);
+	std::vector<std::vector<ChartLabelRequest> > seriesRequests(requests ? numSeries : 0);
+
+	auto layoutSeries = [&](size_t index) {
+		const int seriesIdx = (int)index;
+		std::vector<ChartBar>& bars = seriesBars[seriesIdx];
+		bars.reserve(numCategories);
+
+		// Columns narrower than the resolution merge with the others of their resolution
+		// cell into one column spanning their extremes
+		const bool merge = params.resolution > 0 && categoryWidth < params.resolution;
+		int64_t mergeCell = -1;
+
+		const std::vector<double>& values = view.series[seriesIdx]->numbers;
+		for (int catIdx = 0; catIdx < numCategories; catIdx++) {
+			// Missing values, and values the scale cannot show, leave a gap
+			const double v = catIdx < (int)values.size() ? plotArea.bottom + scale->ToPlot(values[catIdx]) : NAN;
+			if (!std::isfinite(v)) {
+				continue;
+			}
+
+			// Columns rise from the baseline, or hang from it for values below it
+			ChartBar bar;
+			bar.series = seriesIdx;
+			bar.category = catIdx;
+			bar.rect.left = plotArea.left + catIdx * categoryWidth + columnGroupGap / 2 + seriesIdx * individualColumnWidth;
+			bar.rect.right = bar.rect.left + individualColumnWidth * 0.9;  // Small gap between columns
+			bar.rect.bottom = std::min(v, baseline);
+			bar.rect.top = std::max(v, baseline);
+
+			if (merge) {
+				const int64_t cell = (int64_t)std::floor((bar.rect.left - plotArea.left) / params.resolution);
+				if (cell == mergeCell) {
+					ChartBar& merged = bars.back();
+					merged.rect.right = bar.rect.right;
+					merged.rect.top = std::max(merged.rect.top, bar.rect.top);
+					merged.rect.bottom = std::min(merged.rect.bottom, bar.rect.bottom);
+
+					// The merged column is labeled with its largest value
+					if (requests) {
+						ChartLabelRequest& request = seriesRequests[seriesIdx].back();
+						request.mark = merged.rect;
+						if (std::fabs(values[catIdx]) > request.priority) {
+							request.text = FormatValue(values[catIdx]);
+							request.priority = std::fabs(values[catIdx]);
+						}
+					}
+					continue;
+				}
+				mergeCell = cell;
+			}
+			bars.push_back(bar);
+
+			// Taller columns are labeled first
+			if (requests) {
+				ChartLabelRequest request;
+				request.mark = bar.rect;
+				request.text = FormatValue(values[catIdx]);
+				request.priority = std::fabs(values[catIdx]);
+				seriesRequests[seriesIdx].push_back(request);
+			}
+		}
+	};
+	ForEachSeries(pool, (size_t)numSeries, (size_t)numCategories * numSeries, layoutSeries);
+
+	size_t barCount = 0;
+	for (const std::vector<ChartBar>& bars : seriesBars) {
+		barCount += bars.size();
+	}
+	layout.bars.reserve(barCount);
+	for (std::vector<ChartBar>& bars : seriesBars) {
+		layout.bars.insert(layout.bars.end(), bars.begin(), bars.end());
+	}
+	for (std::vector<ChartLabelRequest>& seriesRequest : seriesRequests) {
+		requests->insert(requests->end(), std::make_move_iterator(seriesRequest.begin()), std::make_move_iterator(seriesRequest.end()));
+	}
+}
+
+// Markers of each Y series at its X values, with a numeric X axis when the first series
+// is X, or at the category centers otherwise. Requests a data label per marker if
+// requests is not null. Series are laid out on pool's workers when there is one.
+void LayoutScatter(const ChartSeriesView& view, const ChartLayoutParams& params, ChartTextMeasurer& measurer, ChartLayout& layout, std::vector<ChartLabelRequest>* requests, ChartWorkerPool* pool)
+{
+	const ChartRect& plotArea = params.plotArea;
+	const size_t numCategories = view.CategoryCount();
+	const bool hasX = view.series.size() >= 2;
+	const std::vector<double>* xValues = hasX ? &view.series[0]->numbers : nullptr;
+
+	// The value axis over the Y series
+	const size_t firstY = hasX ? 1 : 0;
+	double lo = 0, hi = 0;
+	GetValueRange(view, firstY, view.series.size(), lo, hi);
+	const std::shared_ptr<const ChartScale> scale = LayoutValueAxis(lo, hi, false, false, params, measurer, layout);
+
+	// A numeric X axis on its own scale, with grid lines at the ticks between the borders
+	std::shared_ptr<const ChartScale> xScale;
+	if (hasX) {
+		double minX = 0, maxX = 0;
+		GetValueRange(view, 0, 1, minX, maxX);
+		xScale = GetScale(params.xScale, minX, maxX, plotArea.Width(), params, false, false);
+
+		const std::vector<ChartTick>& ticks = xScale->GetTicks();
+		for (size_t i = 0; i < ticks.size(); i++) {
+			const double h = plotArea.left + ticks[i].position;
+			if (i > 0 && i + 1 < ticks.size()) {
+				layout.xGridLines.push_back({{h, plotArea.bottom}, {h, plotArea.top}});
+			}
+			AddXLabel(ticks[i].label, h, params, measurer, layout);
+		}
+	}
+	else {
+		LayoutCategoryAxis(view, params, measurer, layout);
+	}
+
+	const double categoryWidth = plotArea.Width() / numCategories;
+
+	// Each Y series fills its own set and requests, joined in series order below
+	const size_t numSets = view.series.size() - firstY;
+	layout.markers.resize(numSets);
+	std::vector<std::vector<ChartLabelRequest> > seriesRequests(requests ? numSets : 0);
+	for (size_t seriesIdx = firstY; seriesIdx < view.series.size(); seriesIdx++) {
+		layout.seriesNames.push_back(view.series[seriesIdx]->name);
+	}
+
+	auto layoutSeries = [&](size_t index) {
+		const size_t seriesIdx = firstY + index;
+		ChartMarkerSet& set = layout.markers[index];
+		set.series = (int32_t)index;
+		set.shape = (ChartMarkerShape)(set.series % kChartMarkerShapeCount);
+
+		const std::vector<double>& values = view.series[seriesIdx]->numbers;
+		const size_t count = hasX ? std::min(values.size(), xValues->size()) : std::min(values.size(), numCategories);
+		set.centers.reserve(count);
+
+		// With a resolution, markers of the series in a resolution cell that already holds
+		// one cannot be told apart from it, and are left out
+		std::unordered_set<uint64_t> cells;
+		if (params.resolution > 0) {
+			cells.reserve(count);
+		}
+		for (size_t row = 0; row < count; row++) {
+			// Points missing either coordinate, or off either scale, are not plotted
+			ChartPoint center;
+			center.h = hasX ? plotArea.left + xScale->ToPlot((*xValues)[row]) : plotArea.left + (row + 0.5) * categoryWidth;
+			center.v = plotArea.bottom + scale->ToPlot(values[row]);
+			if (!std::isfinite(center.h) || !std::isfinite(center.v)) {
+				continue;
+			}
+			if (params.resolution > 0) {
+				const uint32_t cellH = (uint32_t)(int32_t)std::floor((center.h - plotArea.left) / params.resolution);
+				const uint32_t cellV = (uint32_t)(int32_t)std::floor((center.v - plotArea.bottom) / params.resolution);
+				if (!cells.insert(((uint64_t)cellH << 32) | cellV).second) {
+					continue;
+				}
+			}
+			set.centers.push_back(center);
+
+			// Earlier series are labeled first
+			if (requests) {
+				const double r = params.markerSize / 2;
+				ChartLabelRequest request;
+				request.mark = {center.h - r, center.v + r, center.h + r, center.v - r};
+				request.text = FormatValue(values[row]);
+				request.priority = -(double)set.series;
+				seriesRequests[index].push_back(request);
+			}
+		}
+	};
+	ForEachSeries(pool, numSets, numSets * (hasX ? xValues->size() : numCategories), layoutSeries);
+
+	for (std::vector<ChartLabelRequest>& seriesRequest : seriesRequests) {
+		requests->insert(requests->end(), std::make_move_iterator(seriesRequest.begin()), std::make_move_iterator(seriesRequest.end()));
+	}
+}
+
+// Appends the points of a line run, keeping of the points that fall in one resolution
+// cell only the first, the lowest, the highest and the last, in their order along the
+// line, which draws the same at that resolution. Without a resolution every point is kept.
+class LineThinner {
+public:
+	LineThinner(ChartLineSet& line, std::vector<uint32_t>* rows, double origin, double resolution) :
+		fLine(line), fRows(rows), fOrigin(origin), fResolution(resolution), fCell(INT64_MIN), fCount(0) {}
+
+	void Add(const ChartPoint& point, uint32_t row)
+	{
+		if (fResolution <= 0) {
+			Append(point, row);
+			return;
+		}
+
+		const int64_t cell = (int64_t)std::floor((point.h - fOrigin) / fResolution);
+		if (cell != fCell || fCount == 0) {
+			Flush();
+			fCell = cell;
+			fKept[0] = fKept[1] = fKept[2] = fKept[3] = {point, row};
+			fCount = 1;
+			return;
+		}
+		if (point.v < fKept[1].point.v) fKept[1] = {point, row};
+		if (point.v > fKept[2].point.v) fKept[2] = {point, row};
+		fKept[3] = {point, row};
+		fCount++;
+	}
+
+	// Appends the points kept of the current cell; call at the end of each run
+	void Flush()
+	{
+		if (fCount == 0) {
+			return;
+		}
+
+		// First and last stay at the ends, the extremes between them in row order
+		Kept* order[4] = {&fKept[0], &fKept[1], &fKept[2], &fKept[3]};
+		if (order[2]->row < order[1]->row) std::swap(order[1], order[2]);
+		uint32_t previous = UINT32_MAX;
+		for (Kept* kept : order) {
+			if (kept->row != previous) {
+				Append(kept->point, kept->row);
+				previous = kept->row;
+			}
+		}
+		fCount = 0;
+	}
+
+private:
+	struct Kept {
+		ChartPoint point;
+		uint32_t row;
+	};
+
+	void Append(const ChartPoint& point, uint32_t row)
+	{
+		fLine.points.push_back(point);
+		if (fRows) {
+			fRows->push_back(row);
+		}
+	}
+
+	ChartLineSet& fLine;
+	std::vector<uint32_t>* fRows;
+	double fOrigin;
+	double fResolution;
+	int64_t fCell;
+	size_t fCount;
+	Kept fKept[4];
+};
+
+// The line of each series through its values at the category centers, broken into runs
+// at missing values, and values the scale cannot show, unless params.bridgeGaps joins
+// across them. Requests a data label per point if requests is not null. Series are laid
+// out on pool's workers when there is one.
+void LayoutLines(const ChartSeriesView& view, const ChartLayoutParams& params, ChartTextMeasurer& measurer, ChartLayout& layout, std::vector<ChartLabelRequest>* requests, ChartWorkerPool* pool)
+{
+	const ChartRect& plotArea = params.plotArea;
+	const size_t numCategories = view.CategoryCount();
+	const size_t numSeries = view.series.size();
+	const double categoryWidth = plotArea.Width() / numCategories;
+	const bool thin = params.resolution > 0 && categoryWidth < params.resolution;
+
+	for (size_t seriesIdx = 0; seriesIdx < numSeries; seriesIdx++) {
+		layout.seriesNames.push_back(view.series[seriesIdx]->name);
+	}
+
+	double lo = 0, hi = 0;
+	GetValueRange(view, 0, numSeries, lo, hi);
+	const std::shared_ptr<const ChartScale> scale = LayoutValueAxis(lo, hi, false, false, params, measurer, layout);
+
+	// Each series fills its own set and requests, joined in series order below
+	layout.lines.resize(numSeries);
+	std::vector<std::vector<ChartLabelRequest> > seriesRequests(requests ? numSeries : 0);
+
+	auto layoutSeries = [&](size_t seriesIdx) {
+		ChartLineSet& line = layout.lines[seriesIdx];
+		line.series = (int32_t)seriesIdx;
+
+		const std::vector<double>& values = view.series[seriesIdx]->numbers;
+		const size_t count = std::min(values.size(), numCategories);
+
+		// The value transform in one pass over the whole series, branch-free for linear
+		// scales so the compiler vectorizes it; missing values stay NaN
+		std::vector<double> vs(count);
+		double* out = vs.data();
+		scale->Transform(values.data(), out, count, plotArea.bottom);
+
+		// Rows of the kept points, for their labels
+		std::vector<uint32_t> rows;
+		std::vector<uint32_t>* keptRows = requests ? &rows : nullptr;
+		line.points.reserve(thin ? (size_t)(plotArea.Width() / params.resolution + 1) * 4 : count);
+
+		LineThinner thinner(line, keptRows, plotArea.left, thin ? params.resolution : 0);
+		uint32_t runStart = 0;
+		auto endRun = [&]() {
+			thinner.Flush();
+
+			// A lone point between gaps has no line to draw
+			const uint32_t runEnd = (uint32_t)line.points.size();
+			if (runEnd - runStart < 2) {
+				line.points.resize(runStart);
+				if (keptRows) {
+					rows.resize(runStart);
+				}
+			}
+			else {
+				line.runEnds.push_back(runEnd);
+				runStart = runEnd;
+			}
+		};
+
+		for (size_t row = 0; row < count; row++) {
+			if (!std::isfinite(out[row])) {
+				if (!params.bridgeGaps) {
+					endRun();
+				}
+				continue;
+			}
+			thinner.Add({plotArea.left + (row + 0.5) * categoryWidth, out[row]}, (uint32_t)row);
+		}
+		endRun();
+
+		// Earlier series are labeled first
+		if (requests) {
+			const double r = params.markerSize / 2;
+			std::vector<ChartLabelRequest>& labels = seriesRequests[seriesIdx];
+			labels.reserve(rows.size());
+			for (size_t i = 0; i < rows.size(); i++) {
+				const ChartPoint& point = line.points[i];
+				ChartLabelRequest request;
+				request.mark = {point.h - r, point.v + r, point.h + r, point.v - r};
+				request.text = FormatValue(values[rows[i]]);
+				request.priority = -(double)line.series;
+				labels.push_back(request);
+			}
+		}
+	};
+	ForEachSeries(pool, numSeries, numSeries * numCategories, layoutSeries);
+
+	for (std::vector<ChartLabelRequest>& seriesRequest : seriesRequests) {
+		requests->insert(requests->end(), std::make_move_iterator(seriesRequest.begin()), std::make_move_iterator(seriesRequest.end()));
+	}
+}
+
+// Categories whose layers are stacked as one unit of work, few enough that every
+// boundary of a block stays in cache while the block is summed, scaled and placed
+const size_t kStackBlockSize = 1024;
+
+// The stacked layers of the series at the category centers, normalized to fill the
+// value axis if params.normalizeStack is set, and the value axis spanning the stack.
+// Missing values add nothing to the stack. Requests a data label per layer, at its
+// thickest category, if requests is not null. Blocks of categories are stacked on
+// pool's workers when there is one.
+void LayoutAreas(const ChartSeriesView& view, const ChartLayoutParams& params, ChartTextMeasurer& measurer, ChartLayout& layout,
+	std::vector<ChartLabelRequest>* requests, ChartWorkerPool* pool)
+{
+	const ChartRect& plotArea = params.plotArea;
+	const size_t numCategories = view.CategoryCount();
+	const size_t numSeries = view.series.size();
+	const size_t numBoundaries = numSeries + 1;
+	const double categoryWidth = plotArea.Width() / numCategories;
+	const double bottom = plotArea.bottom;
+	const size_t numBlocks = (numCategories + kStackBlockSize - 1) / kStackBlockSize;
+
+	for (size_t seriesIdx = 0; seriesIdx < numSeries; seriesIdx++) {
+		layout.seriesNames.push_back(view.series[seriesIdx]->name);
+	}
+
+	// Every level of a category lies between the sum of its negative values and the sum
+	// of its positive ones, which bound the stack without stacking it twice. A normalized
+	// stack fills 0 to 100 percent.
+	double lo = 0, hi = 100;
+	if (!params.normalizeStack) {
+		std::vector<std::pair<double, double> > blockRanges(numBlocks, std::make_pair(0.0, 0.0));
+		auto rangeBlock = [&](size_t block) {
+			const size_t begin = block * kStackBlockSize;
+			const size_t end = std::min(numCategories, begin + kStackBlockSize);
+			double negative[kStackBlockSize] = {};
+			double positive[kStackBlockSize] = {};
+			for (size_t seriesIdx = 0; seriesIdx < numSeries; seriesIdx++) {
+				const std::vector<double>& values = view.series[seriesIdx]->numbers;
+				const double* in = values.data();
+				const size_t valueEnd = std::max(begin, std::min(end, values.size()));
+				for (size_t c = begin; c < valueEnd; c++) {
+					const double x = in[c] - in[c] == 0 ? in[c] : 0;
+					negative[c - begin] += x < 0 ? x : 0;
+					positive[c - begin] += x > 0 ? x : 0;
+				}
+			}
+			std::pair<double, double>& range = blockRanges[block];
+			for (size_t c = 0; c < end - begin; c++) {
+				range.first = std::min(range.first, negative[c]);
+				range.second = std::max(range.second, positive[c]);
+			}
+		};
+		ForEachSeries(pool, numBlocks, numSeries * numCategories, rangeBlock);
+
+		lo = hi = 0;
+		for (const std::pair<double, double>& range : blockRanges) {
+			lo = std::min(lo, range.first);
+			hi = std::max(hi, range.second);
+		}
+	}
+	const std::shared_ptr<const ChartScale> scale = LayoutValueAxis(lo, hi, true, params.normalizeStack, params, measurer, layout);
+
+	ChartAreaStack& stack = layout.areas;
+	stack.h.resize(numCategories);
+	for (size_t c = 0; c < numCategories; c++) {
+		stack.h[c] = plotArea.left + (c + 0.5) * categoryWidth;
+	}
+
+	// Cumulative levels, boundary by boundary: each is the one below plus the values of
+	// its series, summed over a block of categories in one pass the compiler vectorizes.
+	// The levels are then scaled and placed on the value axis where they are, so every
+	// boundary is computed once, in the layout's own array. Boundary 0 is the baseline.
+	stack.v.resize(numBoundaries * numCategories);
+	auto stackBlock = [&](size_t block) {
+		const size_t begin = block * kStackBlockSize;
+		const size_t end = std::min(numCategories, begin + kStackBlockSize);
+
+		for (size_t seriesIdx = 0; seriesIdx < numSeries; seriesIdx++) {
+			const std::vector<double>& values = view.series[seriesIdx]->numbers;
+			const double* in = values.data();
+			const double* below = stack.v.data() + seriesIdx * numCategories;
+			double* above = stack.v.data() + (seriesIdx + 1) * numCategories;
+			const size_t valueEnd = std::max(begin, std::min(end, values.size()));
+
+			// x - x is 0 for finite x and NaN otherwise, which keeps the loop free of branches
+			for (size_t c = begin; c < valueEnd; c++) {
+				const double x = in[c];
+				above[c] = below[c] + (x - x == 0 ? x : 0);
+			}
+			for (size_t c = valueEnd; c < end; c++) {
+				above[c] = below[c];
+			}
+		}
+
+		// Normalized, each category's levels scale by its own total, so the top boundary
+		// is at 100. A linear scale folds into the same factor.
+		double factor[kStackBlockSize];
+		const double* total = stack.v.data() + numSeries * numCategories;
+		for (size_t c = begin; c < end; c++) {
+			factor[c - begin] = !params.normalizeStack ? 1 : total[c] != 0 ? 100.0 / total[c] : 0;
+		}
+		if (scale->IsLinear()) {
+			const double origin = bottom + scale->GetOffset();
+			for (size_t c = begin; c < end; c++) {
+				factor[c - begin] *= scale->GetFactor();
+			}
+			for (size_t boundary = 0; boundary < numBoundaries; boundary++) {
+				double* level = stack.v.data() + boundary * numCategories;
+				for (size_t c = begin; c < end; c++) {
+					level[c] = origin + level[c] * factor[c - begin];
+				}
+			}
+		}
+		else {
+			// Levels the scale cannot show, such as zero on a log axis, rest on its baseline
+			const double baseline = bottom + scale->GetBaseline();
+			for (size_t boundary = 0; boundary < numBoundaries; boundary++) {
+				double* level = stack.v.data() + boundary * numCategories;
+				for (size_t c = begin; c < end; c++) {
+					const double v = bottom + scale->ToPlot(level[c] * factor[c - begin]);
+					level[c] = std::isfinite(v) ? v : baseline;
+				}
+			}
+		}
+	};
+	ForEachSeries(pool, numBlocks, numSeries * numCategories, stackBlock);
+
+	// Each layer is labeled with its value where it is thickest, larger values first
+	if (requests) {
+		const double r = params.markerSize / 2;
+		for (size_t seriesIdx = 0; seriesIdx < numSeries; seriesIdx++) {
+			const double* below = stack.GetBoundary(seriesIdx);
+			const double* above = stack.GetBoundary(seriesIdx + 1);
+			size_t thickest = 0;
+			for (size_t c = 1; c < numCategories; c++) {
+				if (above[c] - below[c] > above[thickest] - below[thickest]) {
+					thickest = c;
+				}
+			}
+
+			const std::vector<double>& values = view.series[seriesIdx]->numbers;
+			if (thickest >= values.size() || !std::isfinite(values[thickest]) || above[thickest] == below[thickest]) {
+				continue;
+			}
+			ChartLabelRequest request;
+			request.mark = {stack.h[thickest] - r, above[thickest], stack.h[thickest] + r, below[thickest]};
+			request.text = FormatValue(values[thickest]);
+			request.priority = std::fabs(values[thickest]);
+			requests->push_back(request);
+		}
+	}
+
+	// With a resolution coarser than the categories, only the first and last category of
+	// each resolution cell are drawn, where every boundary takes its highest level in the
+	// cell. Where no value is negative, levels only rise from one boundary to the next, so
+	// the layers still meet without overlapping.
+	if (params.resolution > 0 && categoryWidth < params.resolution) {
+		std::vector<std::pair<size_t, size_t> > cells;
+		int64_t current = INT64_MIN;
+		for (size_t c = 0; c < numCategories; c++) {
+			const int64_t cell = (int64_t)std::floor((stack.h[c] - plotArea.left) / params.resolution);
+			if (cell != current) {
+				cells.push_back({c, c});
+				current = cell;
+			}
+			cells.back().second = c;
+		}
+
+		ChartAreaStack thinned;
+		for (const std::pair<size_t, size_t>& cell : cells) {
+			thinned.h.push_back(stack.h[cell.first]);
+			if (cell.second != cell.first) {
+				thinned.h.push_back(stack.h[cell.second]);
+			}
+		}
+		thinned.v.reserve(numBoundaries * thinned.h.size());
+		for (size_t boundary = 0; boundary < numBoundaries; boundary++) {
+			const double* level = stack.GetBoundary(boundary);
+			for (const std::pair<size_t, size_t>& cell : cells) {
+				const double highest = *std::max_element(level + cell.first, level + cell.second + 1);
+				thinned.v.push_back(highest);
+				if (cell.second != cell.first) {
+					thinned.v.push_back(highest);
+				}
+			}
+		}
+		stack = std::move(thinned);
+	}
+}
+
+// Pie and donut proportions: the outer radius as a fraction of the plot area's shorter
+// side, and a donut's hole as a fraction of the outer radius
+const double kPieRadiusRatio = 0.45;
+const double kDonutHoleRatio = 0.5;
+
+// Wedges of the categories' shares of each ring's total, clockwise from the top. A pie is
+// one ring of the first series; a donut has a ring per series around a hole. Missing
+// and non-positive values get no wedge. Requests a data label per wedge, at its middle,
+// if requests is not null.
+void LayoutWedges(const ChartSeriesView& view, const ChartLayoutParams& params, ChartLayout& layout, std::vector<ChartLabelRequest>* requests)
+{
+	const double kTwoPi = 6.283185307179586;
+	const double kTop = kTwoPi / 4;
+
+	const ChartRect& plotArea = params.plotArea;
+	const size_t numCategories = view.CategoryCount();
+	const bool donut = params.chartType == kChartTypeDonut;
+	const size_t numRings = donut ? view.series.size() : 1;
+
+	for (size_t c = 0; c < numCategories; c++) {
+		layout.seriesNames.push_back(view.CategoryLabel(c));
+	}
+
+	const ChartPoint center = {(plotArea.left + plotArea.right) / 2, (plotArea.top + plotArea.bottom) / 2};
+	const double outer = kPieRadiusRatio * std::min(std::fabs(plotArea.Width()), std::fabs(plotArea.Height()));
+	const double hole = donut ? outer * kDonutHoleRatio : 0;
+	const double ringWidth = (outer - hole) / numRings;
+
+	// Each ring's wedges, by category; a category without a share has no sweep
+	std::vector<double> starts(numRings * numCategories, 0);
+	std::vector<double> sweeps(numRings * numCategories, 0);
+	for (size_t ring = 0; ring < numRings; ring++) {
+		const std::vector<double>& values = view.series[ring]->numbers;
+		const size_t count = std::min(numCategories, values.size());
+
+		double total = 0;
+		for (size_t c = 0; c < count; c++) {
+			if (values[c] > 0 && std::isfinite(values[c])) {
+				total += values[c];
+			}
+		}
+		if (!(total > 0) || !std::isfinite(total)) {
+			continue;
+		}
+
+		double share = 0;
+		for (size_t c = 0; c < count; c++) {
+			if (values[c] > 0 && std::isfinite(values[c])) {
+				starts[ring * numCategories + c] = kTop - kTwoPi * share / total;
+				share += values[c];
+				sweeps[ring * numCategories + c] = -kTwoPi * values[c] / total;
+			}
+		}
+	}
+
+	const double r = params.markerSize / 2;
+	for (size_t c = 0; c < numCategories; c++) {
+		for (size_t ring = 0; ring < numRings; ring++) {
+			const double sweep = sweeps[ring * numCategories + c];
+			if (sweep == 0) {
+				continue;
+			}
+
+			ChartWedge wedge;
+			wedge.series = (int32_t)c;
+			wedge.center = center;
+			wedge.innerRadius = hole + ring * ringWidth;
+			wedge.radius = wedge.innerRadius + ringWidth;
+			wedge.startAngle = starts[ring * numCategories + c];
+			wedge.endAngle = wedge.startAngle + sweep;
+			layout.wedges.push_back(wedge);
+
+			// The label sits at the middle of the wedge, halfway across its ring
+			if (requests) {
+				const ChartUnitVector middle = ChartArc::GetUnitVector(wedge.startAngle + sweep / 2);
+				const double distance = (wedge.innerRadius + wedge.radius) / 2;
+				const ChartPoint at = {center.h + distance * middle.c, center.v + distance * middle.s};
+				const double value = view.series[ring]->numbers[c];
+
+				ChartLabelRequest request;
+				request.mark = {at.h - r, at.v + r, at.h + r, at.v - r};
+				request.text = FormatValue(value);
+				request.priority = value;
+				requests->push_back(request);
+			}
+		}
+	}
+}
+
+// A spoke per category clockwise from the top, with rings at the ticks of the value scale
+// and category labels around it, and a closed polygon per series through its values on
+// the spokes. The center is the start of the scale; missing values, and values the scale
+// cannot show, sit there. Requests a data label per vertex if requests is not null.
+// Series are transformed on pool's workers when there is one.
+void LayoutRadar(const ChartSeriesView& view, const ChartLayoutParams& params, ChartTextMeasurer& measurer, ChartLayout& layout, std::vector<ChartLabelRequest>* requests, ChartWorkerPool* pool)
+{
+	const double kTwoPi = 6.283185307179586;
+	const double kTop = kTwoPi / 4;
+
+	const ChartRect& plotArea = params.plotArea;
+	const size_t numCategories = view.CategoryCount();
+	const size_t numSeries = view.series.size();
+
+	for (size_t seriesIdx = 0; seriesIdx < numSeries; seriesIdx++) {
+		layout.seriesNames.push_back(view.series[seriesIdx]->name);
+	}
+
+	ChartRadarGrid& grid = layout.radarGrid;
+	grid.center = {(plotArea.left + plotArea.right) / 2, (plotArea.top + plotArea.bottom) / 2};
+	const ChartPoint center = grid.center;
+	const double radius = kPieRadiusRatio * std::min(std::fabs(plotArea.Width()), std::fabs(plotArea.Height()));
+
+	// The spokes are value axes as long as the radius
+	double lo = 0, hi = 0;
+	GetValueRange(view, 0, numSeries, lo, hi);
+	const std::shared_ptr<const ChartScale> scale = GetScale(params.valueScale, lo, hi, radius, params, true, false);
+	std::vector<const ChartTick*> rings;
+	for (const ChartTick& tick : scale->GetTicks()) {
+		if (tick.position > 0) {
+			rings.push_back(&tick);
+		}
+	}
+	const size_t numRings = rings.size();
+
+	// The spoke directions are looked up once and shared by the grid and every series,
+	// their cosines and sines in separate arrays the series transform reads in step
+	std::vector<double> spokeC(numCategories);
+	std::vector<double> spokeS(numCategories);
+	for (size_t c = 0; c < numCategories; c++) {
+		const ChartUnitVector direction = ChartArc::GetUnitVector(kTop - kTwoPi * c / numCategories);
+		spokeC[c] = direction.c;
+		spokeS[c] = direction.s;
+	}
+
+	grid.spokeEnds.resize(numCategories);
+	grid.rings.resize(numRings * numCategories);
+	for (size_t c = 0; c < numCategories; c++) {
+		grid.spokeEnds[c] = {center.h + radius * spokeC[c], center.v + radius * spokeS[c]};
+		for (size_t ring = 0; ring < numRings; ring++) {
+			const double distance = rings[ring]->position;
+			grid.rings[ring * numCategories + c] = {center.h + distance * spokeC[c], center.v + distance * spokeS[c]};
+		}
+	}
+
+	// Ring values up the top spoke
+	for (size_t ring = 0; ring < numRings; ring++) {
+		ChartLabel label;
+		label.text = rings[ring]->label;
+		label.extent = measurer.Measure(params.fontName, params.fontSize, label.text);
+		label.anchor.h = center.h + params.labelGap;
+		label.anchor.v = center.v + rings[ring]->position - label.extent.height / 2;
+		label.justification = kChartJustifyLeft;
+		layout.yLabels.push_back(label);
+	}
+
+	// Category labels beyond the spoke ends, every stride spokes when the spokes are closer
+	// at the rim than the font size. Labels lean away from the center: left or right of
+	// their spoke at the sides, above it at the top and below it at the bottom.
+	const double spacing = kTwoPi * radius / numCategories;
+	const size_t stride = (size_t)std::max(1.0, std::ceil(params.fontSize / spacing));
+	for (size_t c = 0; c < numCategories; c += stride) {
+		ChartLabel label;
+		label.text = view.CategoryLabel(c);
+		label.extent = measurer.Measure(params.fontName, params.fontSize, label.text);
+		label.anchor.h = center.h + (radius + params.labelGap) * spokeC[c];
+		label.anchor.v = center.v + (radius + params.labelGap) * spokeS[c] + (spokeS[c] - 1) * label.extent.height / 2;
+		label.justification = spokeC[c] > 0.1 ? kChartJustifyLeft : spokeC[c] < -0.1 ? kChartJustifyRight : kChartJustifyCenter;
+		layout.xLabels.push_back(label);
+	}
+
+	// Each series in one pass over its values: the distance along each spoke, then the
+	// point, without branches on a linear scale so the compiler vectorizes it. NaN fails
+	// the comparison, so missing values fall to the center.
+	const bool linear = scale->IsLinear();
+	const double offset = scale->GetOffset();
+	const double factor = scale->GetFactor();
+	layout.polygons.resize(numSeries);
+	auto transformSeries = [&](size_t seriesIdx) {
+		const std::vector<double>& values = view.series[seriesIdx]->numbers;
+		const size_t count = std::min(numCategories, values.size());
+		const double* in = values.data();
+		const double* cosines = spokeC.data();
+		const double* sines = spokeS.data();
+
+		ChartLineSet& polygon = layout.polygons[seriesIdx];
+		polygon.series = (int32_t)seriesIdx;
+		polygon.points.resize(numCategories);
+		polygon.runEnds.assign(1, (uint32_t)numCategories);
+		ChartPoint* out = polygon.points.data();
+		if (linear) {
+			for (size_t c = 0; c < count; c++) {
+				const double d = offset + in[c] * factor;
+				const double distance = d > 0 ? d : 0;
+				out[c].h = center.h + distance * cosines[c];
+				out[c].v = center.v + distance * sines[c];
+			}
+		}
+		else {
+			for (size_t c = 0; c < count; c++) {
+				const double d = scale->ToPlot(in[c]);
+				const double distance = d > 0 ? d : 0;
+				out[c].h = center.h + distance * cosines[c];
+				out[c].v = center.v + distance * sines[c];
+			}
+		}
+		for (size_t c = count; c < numCategories; c++) {
+			out[c] = center;
+		}
+	};
+	ForEachSeries(pool, numSeries, numSeries * numCategories, transformSeries);
+
+	if (requests) {
+		const double r = params.markerSize / 2;
+		for (const ChartLineSet& polygon : layout.polygons) {
+			const std::vector<double>& values = view.series[polygon.series]->numbers;
+			const size_t count = std::min(numCategories, values.size());
+			for (size_t c = 0; c < count; c++) {
+				if (!std::isfinite(values[c])) {
+					continue;
+				}
+				const ChartPoint& at = polygon.points[c];
+				ChartLabelRequest request;
+				request.mark = {at.h - r, at.v + r, at.h + r, at.v - r};
+				request.text = FormatValue(values[c]);
+				request.priority = std::fabs(values[c]);
+				requests->push_back(request);
+			}
+		}
+	}
+}
+
+} // namespace
+
+/*
+*/
+ChartTextExtent ChartTextMeasurer::Measure(const std::string& /*fontName*/, double fontSize, const std::string& text)
+{
+	// Average advance of half an em, and a cap height of 0.7 em
+	ChartTextExtent extent;
+	extent.width = CharacterCount(text) * fontSize * 0.5;
+	extent.height = fontSize * 0.7;
+	return extent;
+}
+
+/*
+*/
+bool ChartLayout::Compute(const ChartSeriesView& view, const ChartLayoutParams& params, ChartTextMeasurer& measurer, ChartLayout& layout, ChartWorkerPool* pool)
+{
+	if (view.CategoryCount() == 0 || view.series.empty()) {
+		return false;
+	}
+
+	layout = ChartLayout();
+	layout.plotArea = params.plotArea;
+	layout.fontSize = params.fontSize;
+	layout.markerSize = params.markerSize;
+
+	std::vector<ChartLabelRequest> requests;
+	std::vector<ChartLabelRequest>* dataLabels = params.showDataLabels ? &requests : nullptr;
+
+	if (params.chartType == kChartTypeRadar) {
+		LayoutRadar(view, params, measurer, layout, dataLabels, pool);
+	}
+	else if (params.chartType == kChartTypePie || params.chartType == kChartTypeDonut) {
+		LayoutWedges(view, params, layout, dataLabels);
+	}
+	else if (params.chartType == kChartTypeScatter) {
+		LayoutScatter(view, params, measurer, layout, dataLabels, pool);
+	}
+	else if (params.chartType == kChartTypeLine) {
+		LayoutCategoryAxis(view, params, measurer, layout);
+		LayoutLines(view, params, measurer, layout, dataLabels, pool);
+	}
+	else if (params.chartType == kChartTypeArea) {
+		LayoutCategoryAxis(view, params, measurer, layout);
+		LayoutAreas(view, params, measurer, layout, dataLabels, pool);
+	}
+	else {
+		LayoutCategoryAxis(view, params, measurer, layout);
+		LayoutColumns(view, params, measurer, layout, dataLabels, pool);
+	}
+
+	// Data labels inside the plot area, clear of the marks and of each other
+	if (!requests.empty()) {
+		for (ChartLabelRequest& request : requests) {
+			request.extent = measurer.Measure(params.fontName, params.fontSize, request.text);
+		}
+		ChartLabelPlacer placer(params.plotArea, params.fontSize * 2, kDataLabelGap);
+		placer.Place(requests, layout.dataLabels, layout.leaderLines);
+	}
+
+	return true;
+}
+
+/*
+*/
+bool ChartLayout::MakeLabelRow(const std::vector<ChartLabel>& labels, ChartLabelBlock& block)
+{
+	if (labels.empty()) {
+		return false;
+	}
+
+	// The line starts at the left edge of the first label, so every cell lies to the
+	// right of the anchor
+	const ChartLabel& first = labels.front();
+	block = ChartLabelBlock();
+	block.anchor.h = first.anchor.h - first.extent.width;
+	block.anchor.v = first.anchor.v;
+	block.justification = kChartJustifyLeft;
+
+	double previousRight = block.anchor.h;
+	for (const ChartLabel& label : labels) {
+		if (label.justification != kChartJustifyCenter || !IsSingleCell(label.text) ||
+			std::fabs(label.anchor.v - first.anchor.v) > kPositionTolerance) {
+			return false;
+		}
+
+		// A cell that reaches into the previous one would be pushed to a later tab stop
+		const double left = label.anchor.h - label.extent.width / 2;
+		if (left < previousRight - kPositionTolerance) {
+			return false;
+		}
+		previousRight = label.anchor.h + label.extent.width / 2;
+
+		block.text += '\t';
+		block.text += label.text;
+		block.tabStops.push_back(label.anchor.h - block.anchor.h);
+	}
+
+	return true;
+}
+
+/*
+*/
+bool ChartLayout::MakeLabelColumn(const std::vector<ChartLabel>& labels, ChartLabelBlock& block)
+{
+	if (labels.empty()) {
+		return false;
+	}
+
+	// Lines are set from the top down
+	std::vector<const ChartLabel*> lines;
+	lines.reserve(labels.size());
+	for (const ChartLabel& label : labels) {
+		lines.push_back(&label);
+	}
+	std::sort(lines.begin(), lines.end(), [](const ChartLabel* a, const ChartLabel* b) { return a->anchor.v > b->anchor.v; });
+
+	const ChartLabel& top = *lines.front();
+	block = ChartLabelBlock();
+	block.anchor = top.anchor;
+	block.justification = top.justification;
+	block.leading = lines.size() > 1 ? top.anchor.v - lines[1]->anchor.v : 0;
+	if (lines.size() > 1 && block.leading <= kPositionTolerance) {
+		return false;
+	}
+
+	for (size_t i = 0; i < lines.size(); i++) {
+		const ChartLabel& label = *lines[i];
+		if (label.justification != top.justification || !IsSingleCell(label.text) ||
+			std::fabs(label.anchor.h - top.anchor.h) > kPositionTolerance ||
+			std::fabs(top.anchor.v - i * block.leading - label.anchor.v) > kPositionTolerance) {
+			return false;
+		}
+
+		if (i > 0) {
+			block.text += '\r';
+		}
+		block.text += label.text;
+	}
+
+	return true;
+}
+
+/*
+*/
+uint64_t ChartLayout::ComputeKey(const ChartDataset& dataset, const ChartDataRef& ref, const ChartLayoutParams& params, const ChartTextMeasurer& measurer)
+{
+	ChartHasher hasher;
+	hasher.AddU64(kLayoutVersion);
+	hasher.AddU64(measurer.GetIdentity());
+	hasher.AddU64(dataset.GetContentHash());
+	hasher.AddString(ref.categoryColumn);
+	hasher.AddU64(ref.valueColumns.size());
+	for (const std::string& column : ref.valueColumns) {
+		hasher.AddString(column);
+	}
+	hasher.AddU64((uint64_t)params.chartType);
+	hasher.AddDouble(params.plotArea.left);
+	hasher.AddDouble(params.plotArea.top);
+	hasher.AddDouble(params.plotArea.right);
+	hasher.AddDouble(params.plotArea.bottom);
+	hasher.AddString(params.fontName);
+	hasher.AddDouble(params.fontSize);
+	hasher.AddDouble(params.labelGap);
+	hasher.AddDouble(params.tickLength);
+	hasher.AddDouble(params.markerSize);
+	hasher.AddU64(params.showDataLabels ? 1 : 0);
+	hasher.AddDouble(params.resolution);
+	hasher.AddU64(params.bridgeGaps ? 1 : 0);
+	hasher.AddU64(params.normalizeStack ? 1 : 0);
+	hasher.AddU64((uint64_t)params.valueScale);
+	hasher.AddU64((uint64_t)params.xScale);
+	return hasher.Get();
+}
+
+/*
+*/
+int32_t ChartLayout::GetDetailLevel(double zoom)
+{
+	if (!(zoom > 0)) {
+		return 0;
+	}
+	const double level = std::round(std::log2(zoom));
+	return (int32_t)std::max((double)kChartMinDetailLevel, std::min((double)kChartMaxDetailLevel, level));
+}
+
+/*
+*/
+double ChartLayout::GetDetailResolution(int32_t level)
+{
+	// Half a device pixel at a zoom of 2 to the power level, and full detail at the top
+	if (level >= kChartMaxDetailLevel) {
+		return 0;
+	}
+	return std::ldexp(0.5, -level);
+}
+
+/*
+*/
+bool ChartLayout::IsDetailStale(int32_t level, double zoom)
+{
+	if (!(zoom > 0) || GetDetailLevel(zoom) == level) {
+		return false;
+	}
+	return std::fabs(std::log2(zoom) - level) >= 1.0;
+}
+
+/*
+*/
+void ChartLayout::Serialize(std::vector<uint8_t>& out) const
+{
+	out.clear();
+	ChartBinaryWriter writer(out);
+	writer.WriteU32(kLayoutMagic);
+	WriteRect(writer, plotArea);
+	writer.WriteDouble(fontSize);
+	WriteSegments(writer, xGridLines);
+	WriteSegments(writer, yGridLines);
+
+	writer.WriteU32((uint32_t)seriesNames.size());
+	for (const std::string& name : seriesNames) {
+		writer.WriteString(name);
+	}
+
+	writer.WriteU32((uint32_t)bars.size());
+	for (const ChartBar& bar : bars) {
+		writer.WriteU32((uint32_t)bar.series);
+		writer.WriteU32((uint32_t)bar.category);
+		WriteRect(writer, bar.rect);
+	}
+
+	writer.WriteDouble(markerSize);
+	WriteMarkers(writer, markers);
+	WriteLines(writer, lines);
+	WriteDoubles(writer, areas.h);
+	WriteDoubles(writer, areas.v);
+	WriteWedges(writer, wedges);
+	WriteLines(writer, polygons);
+	WritePoint(writer, radarGrid.center);
+	WritePoints(writer, radarGrid.spokeEnds);
+	WritePoints(writer, radarGrid.rings);
+
+	WritePoint(writer, xAxis.from);
+	WritePoint(writer, xAxis.to);
+	WritePoint(writer, yAxis.from);
+	WritePoint(writer, yAxis.to);
+	WriteSegments(writer, xTicks);
+	WriteSegments(writer, yTicks);
+	WriteLabels(writer, xLabels);
+	WriteLabels(writer, yLabels);
+	WriteLabels(writer, dataLabels);
+	WriteSegments(writer, leaderLines);
+}
+
+/*
+*/
+bool ChartLayout::Deserialize(const uint8_t* data, size_t size, ChartLayout& layout)
+{
+	ChartBinaryReader reader(data, size);
+	uint32_t magic = 0;
+	if (!reader.ReadU32(magic) || magic != kLayoutMagic) return false;
+
+	ChartLayout result;
+	if (!ReadRect(reader, result.plotArea) || !reader.ReadDouble(result.fontSize) ||
+		!ReadSegments(reader, result.xGridLines) || !ReadSegments(reader, result.yGridLines)) {
+		return false;
+	}
+
+	uint32_t count = 0;
+	if (!reader.ReadU32(count) || !reader.CanHold(count, sizeof(uint32_t))) return false;
+	result.seriesNames.resize(count);
+	for (std::string& name : result.seriesNames) {
+		if (!reader.ReadString(name)) return false;
+	}
+
+	if (!reader.ReadU32(count) || !reader.CanHold(count, sizeof(ChartBar))) return false;
+	result.bars.resize(count);
+	for (ChartBar& bar : result.bars) {
+		uint32_t series = 0, category = 0;
+		if (!reader.ReadU32(series) || !reader.ReadU32(category) || !ReadRect(reader, bar.rect)) return false;
+		if (series >= result.seriesNames.size()) return false;
+		bar.series = (int32_t)series;
+		bar.category = (int32_t)category;
+	}
+
+	if (!reader.ReadDouble(result.markerSize) || !ReadMarkers(reader, result.seriesNames.size(), result.markers) ||
+		!ReadLines(reader, result.seriesNames.size(), result.lines) ||
+		!ReadDoubles(reader, result.areas.h) || !ReadDoubles(reader, result.areas.v) ||
+		!ReadWedges(reader, result.seriesNames.size(), result.wedges) ||
+		!ReadLines(reader, result.seriesNames.size(), result.polygons) || !ReadPoint(reader, result.radarGrid.center) ||
+		!ReadPoints(reader, result.radarGrid.spokeEnds) || !ReadPoints(reader, result.radarGrid.rings)) {
+		return false;
+	}
+	if (result.areas.v.size() != (result.areas.h.empty() ? 0 : result.areas.h.size() * (result.seriesNames.size() + 1))) {
+		return false;
+	}
+	const size_t spokes = result.radarGrid.spokeEnds.size();
+	if (spokes == 0 ? !result.radarGrid.rings.empty() : result.radarGrid.rings.size() % spokes != 0) {
+		return false;
+	}
+
+	if (!ReadPoint(reader, result.xAxis.from) || !ReadPoint(reader, result.xAxis.to) ||
+		!ReadPoint(reader, result.yAxis.from) || !ReadPoint(reader, result.yAxis.to) ||
+		!ReadSegments(reader, result.xTicks) || !ReadSegments(reader, result.yTicks) ||
+		!ReadLabels(reader, result.xLabels) || !ReadLabels(reader, result.yLabels) ||
+		!ReadLabels(reader, result.dataLabels) || !ReadSegments(reader, result.leaderLines) ||
+		!reader.AtEnd()) {
+		return false;
+	}
+
+	layout = std::move(result);
+	return true;
+}
@@ -0,0 +1,272 @@
+//========================================================================================
+//  
+//  ChartLayout.h
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#ifndef __ChartLayout_h__
+#define __ChartLayout_h__
+
+// Computed geometry of a chart: everything needed to emit art without touching the
+// dataset or measuring text again. Free of Illustrator SDK types so layouts can be
+// computed, cached and reused outside the application. Coordinates are artwork
+// coordinates, with v increasing upwards.
+
+#include "ChartDataset.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Chart type enumeration
+enum ChartType {
+	kChartTypeBar = 0,
+	kChartTypeLine,
+	kChartTypePie,
+	kChartTypeArea,
+	kChartTypeScatter,
+	kChartTypeColumn,
+	kChartTypeDonut,
+	kChartTypeRadar,
+	kChartTypeUnknown
+};
+
+struct ChartPoint {
+	double h, v;
+};
+
+struct ChartRect {
+	double left, top, right, bottom;
+
+	double Width() const { return right - left; }
+	double Height() const { return top - bottom; }
+};
+
+// A straight line, used for grid lines, ticks and axes
+struct ChartSegment {
+	ChartPoint from, to;
+};
+
+struct ChartTextExtent {
+	double width, height;
+};
+
+enum ChartJustification {
+	kChartJustifyLeft = 0,
+	kChartJustifyCenter,
+	kChartJustifyRight
+};
+
+// A point text label: anchor is the baseline point the justification is relative to
+struct ChartLabel {
+	std::string text;
+	ChartPoint anchor;
+	ChartJustification justification;
+	ChartTextExtent extent;
+};
+
+// The labels of one axis set as a single text object: one line of tab separated cells
+// on centered tab stops, or one line per label at a fixed leading
+struct ChartLabelBlock {
+	std::string text;				// Cells separated by tabs, lines by carriage returns
+	ChartPoint anchor;				// Baseline of the first line
+	ChartJustification justification;
+	double leading;					// Baseline to baseline, 0 for a single line
+	std::vector<double> tabStops;	// Centered tab stops, relative to anchor.h
+
+	ChartLabelBlock() : justification(kChartJustifyLeft), leading(0)
+	{
+		anchor.h = anchor.v = 0;
+	}
+};
+
+// One column of a column chart
+struct ChartBar {
+	int32_t series;
+	int32_t category;
+	ChartRect rect;
+};
+
+// Marker shapes of scatter series, assigned to series in order
+enum ChartMarkerShape {
+	kChartMarkerCircle = 0,
+	kChartMarkerSquare,
+	kChartMarkerDiamond,
+	kChartMarkerTriangle,
+	kChartMarkerShapeCount
+};
+
+// The markers of one scatter series
+struct ChartMarkerSet {
+	int32_t series;
+	ChartMarkerShape shape;
+	std::vector<ChartPoint> centers;
+};
+
+// The line of one series, as runs of consecutive points split at missing values. The
+// points of every run share one array, so a series is laid out without a vector per run.
+struct ChartLineSet {
+	int32_t series;
+	std::vector<ChartPoint> points;
+	std::vector<uint32_t> runEnds;	// Index one past the last point of each run
+};
+
+// The layers of a stacked area chart. The boundaries between layers are stored once
+// each, shared by the layer below and the layer above: boundary 0 is the baseline, and
+// layer i, the area of series i, lies between boundaries i and i + 1.
+struct ChartAreaStack {
+	std::vector<double> h;		// Positions along the category axis, shared by every boundary
+	std::vector<double> v;		// Boundary positions, h.size() per boundary in boundary order
+
+	size_t GetBoundaryCount() const { return h.empty() ? 0 : v.size() / h.size(); }
+	const double* GetBoundary(size_t index) const { return v.data() + index * h.size(); }
+};
+
+// A pie wedge, or a sector of a donut ring when innerRadius is not 0. Angles are in
+// radians counterclockwise from the positive h axis; wedges run clockwise from the top,
+// so endAngle is below startAngle.
+struct ChartWedge {
+	int32_t series;			// Paint index: the wedge's category
+	ChartPoint center;
+	double radius, innerRadius;
+	double startAngle, endAngle;
+};
+
+// The grid of a radar chart: a spoke from the center per category, and rings at even
+// steps of the value axis, each a polygon through one point per spoke
+struct ChartRadarGrid {
+	ChartPoint center;
+	std::vector<ChartPoint> spokeEnds;	// Outer end of each spoke, in category order
+	std::vector<ChartPoint> rings;		// spokeEnds.size() points per ring, innermost first
+
+	ChartRadarGrid() { center.h = center.v = 0; }
+
+	size_t GetRingCount() const { return spokeEnds.empty() ? 0 : rings.size() / spokeEnds.size(); }
+	const ChartPoint* GetRing(size_t index) const { return rings.data() + index * spokeEnds.size(); }
+};
+
+class ChartWorkerPool;
+
+// Levels of detail: a chart laid out for a view zoom of 2 to the power level resolves its
+// data marks to half a device pixel at that zoom. Levels are clamped to this range, and
+// the top level is full detail.
+const int32_t kChartMinDetailLevel = -6;
+const int32_t kChartMaxDetailLevel = 6;
+
+// Measures label text for layout: the advance width, and the height above the baseline.
+// The default estimates from the font size; the plug-in substitutes a cached measurer
+// backed by the text engine.
+class ChartTextMeasurer {
+public:
+	virtual ~ChartTextMeasurer() {}
+	virtual ChartTextExtent Measure(const std::string& fontName, double fontSize, const std::string& text);
+
+	// Identifies the source of the extents, and its version, for layout keys: measurers
+	// that may return different extents for the same text have different identities. The
+	// estimate's is 0; measurers in front of another report the other's.
+	virtual uint64_t GetIdentity() const { return 0; }
+};
+
+// Everything besides the data that a layout depends on
+struct ChartLayoutParams {
+	int32_t chartType;
+	ChartRect plotArea;
+	std::string fontName;	// Label font, empty for the default
+	double fontSize;
+	double labelGap;		// Between the plot area and axis labels
+	double tickLength;
+	double markerSize;		// Width of scatter markers
+	bool showDataLabels;	// Label each column or marker with its value
+	double resolution;		// Finest detail data marks resolve, in points; 0 for full detail
+	bool bridgeGaps;		// Lines join across missing values instead of breaking
+	bool normalizeStack;	// Stacked areas fill the value axis, each layer its share
+	int32_t valueScale;		// ChartScaleType of the value axis
+	int32_t xScale;			// ChartScaleType of the X axis of scatter charts with an X series
+
+	ChartLayoutParams() : chartType(0), fontSize(12.0), labelGap(6.0), tickLength(5.0), markerSize(6.0), showDataLabels(false), resolution(0), bridgeGaps(false),
+		normalizeStack(false), valueScale(0), xScale(0)
+	{
+		plotArea.left = plotArea.top = plotArea.right = plotArea.bottom = 0;
+	}
+};
+
+struct ChartLayout {
+	ChartRect plotArea;
+	double fontSize;
+
+	std::vector<ChartSegment> xGridLines;
+	std::vector<ChartSegment> yGridLines;
+	std::vector<std::string> seriesNames;
+	std::vector<ChartBar> bars;				// Ordered by series, then category
+	std::vector<ChartMarkerSet> markers;	// Scatter charts, one set per series
+	std::vector<ChartLineSet> lines;		// Line charts, one set per series
+	ChartAreaStack areas;					// Area charts, one layer per series
+	std::vector<ChartWedge> wedges;			// Pie and donut charts, ordered by category, then ring
+	std::vector<ChartLineSet> polygons;		// Radar charts, one closed polygon of one run per series
+	ChartRadarGrid radarGrid;				// Radar charts
+	double markerSize;
+	ChartSegment xAxis;
+	ChartSegment yAxis;
+	std::vector<ChartSegment> xTicks;
+	std::vector<ChartSegment> yTicks;
+	std::vector<ChartLabel> xLabels;
+	std::vector<ChartLabel> yLabels;
+	std::vector<ChartLabel> dataLabels;		// Placed clear of each other and of the marks
+	std::vector<ChartSegment> leaderLines;	// From marks to data labels set away from them
+
+	// Lays out a chart of view inside params.plotArea: markers for scatter charts, lines
+	// for line charts, stacked layers for area charts, wedges for pie and donut charts,
+	// polygons for radar charts and columns for every other type. Pie and donut charts have
+	// no axes, and their series names are the category labels, which the wedges are
+	// painted by; a pie charts the first series, and a donut each series as a ring, the
+	// first innermost. A radar chart has a spoke per category in place of the axes.
+	// Axes span the data, ticked by the ChartScale of params.valueScale and, for the X
+	// series of a scatter chart, params.xScale; column and area axes reach zero.
+	// Returns false if the view has no categories or series. With a resolution, markers
+	// closer together than it are drawn once, columns narrower than it are merged into one
+	// column per series spanning their extremes, the points of a line within it are
+	// reduced to its first, lowest, highest and last, and area boundaries within it to
+	// their highest level.
+	// A scatter chart with two or more series plots the first series as X against the
+	// others; with one series it plots the values against the categories. Given a pool,
+	// the geometry of large series is computed on its workers; text is only ever measured
+	// on the calling thread.
+	static bool Compute(const ChartSeriesView& view, const ChartLayoutParams& params, ChartTextMeasurer& measurer, ChartLayout& layout, ChartWorkerPool* pool = nullptr);
+
+	// The level of detail for a view zoom, 1 being 100%
+	static int32_t GetDetailLevel(double zoom);
+
+	// The layout resolution of a level of detail, for ChartLayoutParams
+	static double GetDetailResolution(int32_t level);
+
+	// Whether a chart laid out at level should be laid out again for zoom: only once the
+	// zoom is a whole octave from the level's own, so that small zooms, and zooming back
+	// and forth across the boundary between two levels, leave the chart as it is.
+	static bool IsDetailStale(int32_t level, double zoom);
+
+	// Identifies a layout by the chart's data, column selection, layout parameters and the
+	// measurer its labels are measured by. Two charts with equal keys have identical layouts.
+	static uint64_t ComputeKey(const ChartDataset& dataset, const ChartDataRef& ref, const ChartLayoutParams& params, const ChartTextMeasurer& measurer);
+
+	// Combines labels centered on a common baseline, such as X-axis labels, into one
+	// line of cells. Returns false if the labels are not in order or would overlap,
+	// and must be set individually.
+	static bool MakeLabelRow(const std::vector<ChartLabel>& labels, ChartLabelBlock& block);
+
+	// Combines evenly spaced labels sharing an anchor and justification, such as Y-axis
+	// labels, into one line per label from the top down. Returns false if they must be
+	// set individually.
+	static bool MakeLabelColumn(const std::vector<ChartLabel>& labels, ChartLabelBlock& block);
+
+	// Compact binary form used by the layout cache
+	void Serialize(std::vector<uint8_t>& out) const;
+	static bool Deserialize(const uint8_t* data, size_t size, ChartLayout& layout);
+};
+
+#endif // __ChartLayout_h__
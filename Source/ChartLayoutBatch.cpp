@@ -0,0 +1,83 @@
+//========================================================================================
+//  
+//  ChartLayoutBatch.cpp
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#include "ChartLayoutBatch.h"
+#include "ChartLayoutCache.h"
+#include "ChartTextMetrics.h"
+#include "ChartWorkerPool.h"
+#include <memory>
+
+/*
+*/
+void ChartLayoutBatch::Compute(std::vector<ChartLayoutJob>& jobs, ChartWorkerPool& pool, ChartTextMetricsCache& metrics, ChartLayoutCache* cache)
+{
+	std::vector<uint64_t> keys(jobs.size());
+	std::vector<std::unique_ptr<ChartDeferredMeasurer> > measurers(jobs.size());
+
+	// Keys first, here: a dataset computes its content hash on first use, and jobs share datasets
+	for (size_t i = 0; i < jobs.size(); i++) {
+		if (jobs[i].dataset) {
+			keys[i] = ChartLayout::ComputeKey(*jobs[i].dataset, jobs[i].ref, jobs[i].params, metrics);
+		}
+	}
+
+	// 1. Every chart on the workers, from the layout cache where it has them
+	pool.ParallelFor(jobs.size(), [&](size_t i) {
+		ChartLayoutJob& job = jobs[i];
+		job.computed = false;
+		if (!job.dataset) {
+			return;
+		}
+
+		if (cache && cache->Load(keys[i], job.layout)) {
+			job.computed = true;
+			return;
+		}
+
+		ChartSeriesView view;
+		if (!job.dataset->Resolve(job.ref, view)) {
+			return;
+		}
+
+		measurers[i].reset(new ChartDeferredMeasurer(metrics));
+		job.computed = ChartLayout::Compute(view, job.params, *measurers[i], job.layout);
+	});
+
+	// 2. Labels the metrics cache did not hold, measured here
+	std::vector<size_t> remeasured;
+	for (size_t i = 0; i < jobs.size(); i++) {
+		if (measurers[i] && measurers[i]->HasMisses()) {
+			measurers[i]->MeasureMisses();
+			remeasured.push_back(i);
+		}
+	}
+
+	// 3. The charts laid out with estimates, again with every extent cached. A string
+	// evicted in between is estimated once more, and that layout is not stored.
+	pool.ParallelFor(remeasured.size(), [&](size_t r) {
+		const size_t i = remeasured[r];
+		ChartLayoutJob& job = jobs[i];
+
+		ChartSeriesView view;
+		job.dataset->Resolve(job.ref, view);
+		job.computed = ChartLayout::Compute(view, job.params, *measurers[i], job.layout);
+	});
+
+	if (cache) {
+		pool.ParallelFor(jobs.size(), [&](size_t i) {
+			if (measurers[i] && jobs[i].computed && !measurers[i]->HasMisses()) {
+				cache->Store(keys[i], jobs[i].layout);
+			}
+		});
+	}
+}
@@ -0,0 +1,49 @@
+//========================================================================================
+//  
+//  ChartLayoutBatch.h
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#ifndef __ChartLayoutBatch_h__
+#define __ChartLayoutBatch_h__
+
+// Lays out many charts at once on a worker pool, for refreshing every chart of a
+// document. Workers measure labels only from the text metrics cache; labels it does not
+// hold yet are measured afterwards on the calling thread, and the charts that used them
+// are laid out again, so the text engine is only called from the calling thread.
+
+#include "ChartDataset.h"
+#include "ChartLayout.h"
+#include <vector>
+
+class ChartLayoutCache;
+class ChartTextMetricsCache;
+class ChartWorkerPool;
+
+// One chart to lay out
+struct ChartLayoutJob {
+	const ChartDataset* dataset;
+	ChartDataRef ref;
+	ChartLayoutParams params;
+
+	ChartLayout layout;			// Valid when computed is set
+	bool computed;				// False if the data has nothing to lay out
+
+	ChartLayoutJob() : dataset(nullptr), computed(false) {}
+};
+
+class ChartLayoutBatch {
+public:
+	// Computes the layout of every job, loading and storing layouts through cache if it
+	// is not null. Call from the thread that may measure text through metrics.
+	static void Compute(std::vector<ChartLayoutJob>& jobs, ChartWorkerPool& pool, ChartTextMetricsCache& metrics, ChartLayoutCache* cache);
+};
+
+#endif // __ChartLayoutBatch_h__
@@ -0,0 +1,301 @@
+//========================================================================================
+//  
+//  ChartLayoutCache.cpp
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#include "ChartLayoutCache.h"
+#include "ChartBinary.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const uint32_t kEntryMagic = 0x31434C43;	// "CLC1"
+const char* kEntryExtension = ".layout";
+const char* kTempExtension = ".tmp";
+
+// Temporary files older than this were left by a writer that died mid-write
+const auto kStaleTempAge = std::chrono::hours(1);
+
+// Entry header: magic, key, payload size, payload checksum
+const size_t kHeaderSize = sizeof(uint32_t) + 3 * sizeof(uint64_t);
+
+uint64_t Checksum(const uint8_t* data, size_t size)
+{
+	ChartHasher hasher;
+	hasher.Add(data, size);
+	return hasher.Get();
+}
+
+bool ReadFile(const fs::path& path, std::vector<uint8_t>& bytes)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file) return false;
+
+	file.seekg(0, std::ios::end);
+	std::streamoff size = file.tellg();
+	if (size < (std::streamoff)kHeaderSize) return false;
+	file.seekg(0, std::ios::beg);
+
+	bytes.resize((size_t)size);
+	return (bool)file.read(reinterpret_cast<char*>(bytes.data()), size);
+}
+
+// Name unique across threads and processes sharing the directory
+std::string TempSuffix()
+{
+	static std::atomic<uint32_t> counter(0);
+	static const uint32_t seed = std::random_device()();
+	char buffer[32];
+	snprintf(buffer, sizeof(buffer), ".%08x%08x", seed, (unsigned)counter++);
+	return buffer;
+}
+
+} // namespace
+
+/*
+*/
+ChartLayoutCache::ChartLayoutCache(const std::string& directory, uint64_t maxBytes) :
+	fDirectory(directory),
+	fMaxBytes(maxBytes),
+	fHits(0),
+	fMisses(0),
+	fBytesSinceTrim(maxBytes / 8)	// Trim on the first store
+{
+	if (!fDirectory.empty()) {
+		std::error_code error;
+		fs::create_directories(fs::u8path(fDirectory), error);
+		if (error) {
+			fDirectory.clear();
+		}
+	}
+}
+
+/*
+*/
+std::string ChartLayoutCache::DefaultDirectory()
+{
+	fs::path base;
+#if defined(_WIN32)
+	if (const wchar_t* localAppData = _wgetenv(L"LOCALAPPDATA")) {
+		base = fs::path(localAppData) / "Adobe" / "Illustrator Charts";
+	}
+#elif defined(__APPLE__)
+	if (const char* home = getenv("HOME")) {
+		base = fs::path(home) / "Library" / "Caches" / "com.adobe.illustrator.charts";
+	}
+#else
+	if (const char* cacheHome = getenv("XDG_CACHE_HOME")) {
+		base = fs::path(cacheHome) / "illustrator-charts";
+	}
+	else if (const char* home = getenv("HOME")) {
+		base = fs::path(home) / ".cache" / "illustrator-charts";
+	}
+#endif
+	if (base.empty()) {
+		return std::string();
+	}
+	return (base / "LayoutCache").u8string();
+}
+
+/*
+*/
+std::string ChartLayoutCache::EntryPath(uint64_t key) const
+{
+	char name[32];
+	snprintf(name, sizeof(name), "%016llx", (unsigned long long)key);
+	return (fs::u8path(fDirectory) / (std::string(name) + kEntryExtension)).u8string();
+}
+
+/*
+*/
+double ChartLayoutCache::GetHitRate() const
+{
+	uint64_t hits = fHits, lookups = fHits + fMisses;
+	return lookups > 0 ? (double)hits / lookups : 0.0;
+}
+
+/*
+*/
+bool ChartLayoutCache::Load(uint64_t key, ChartLayout& layout)
+{
+	if (fDirectory.empty()) {
+		fMisses++;
+		return false;
+	}
+
+	fs::path path = fs::u8path(EntryPath(key));
+	std::vector<uint8_t> bytes;
+	if (!ReadFile(path, bytes)) {
+		fMisses++;
+		return false;
+	}
+
+	ChartBinaryReader reader(bytes.data(), bytes.size());
+	uint32_t magic = 0;
+	uint64_t entryKey = 0, payloadSize = 0, checksum = 0;
+	bool valid = reader.ReadU32(magic) && magic == kEntryMagic &&
+		reader.ReadU64(entryKey) && entryKey == key &&
+		reader.ReadU64(payloadSize) && payloadSize == bytes.size() - kHeaderSize &&
+		reader.ReadU64(checksum) && checksum == Checksum(bytes.data() + kHeaderSize, (size_t)payloadSize) &&
+		ChartLayout::Deserialize(bytes.data() + kHeaderSize, (size_t)payloadSize, layout);
+
+	std::error_code error;
+	if (!valid) {
+		// Written by an incompatible build or damaged; a fresh entry will replace it
+		fs::remove(path, error);
+		fMisses++;
+		return false;
+	}
+
+	// Touch the entry so eviction drops the least recently used layouts first
+	fs::last_write_time(path, fs::file_time_type::clock::now(), error);
+	fHits++;
+	return true;
+}
+
+/*
+*/
+bool ChartLayoutCache::Store(uint64_t key, const ChartLayout& layout)
+{
+	if (fDirectory.empty()) {
+		return false;
+	}
+
+	std::vector<uint8_t> payload;
+	layout.Serialize(payload);
+
+	std::vector<uint8_t> bytes;
+	bytes.reserve(kHeaderSize + payload.size());
+	ChartBinaryWriter writer(bytes);
+	writer.WriteU32(kEntryMagic);
+	writer.WriteU64(key);
+	writer.WriteU64(payload.size());
+	writer.WriteU64(Checksum(payload.data(), payload.size()));
+	writer.Write(payload.data(), payload.size());
+
+	// A single entry may not take more than a small share of the cache
+	if (bytes.size() > fMaxBytes / 16) {
+		return false;
+	}
+
+	// Write under a unique temporary name, then rename into place so readers in other
+	// processes never see a partial entry
+	fs::path path = fs::u8path(EntryPath(key));
+	fs::path tempPath = path;
+	tempPath += TempSuffix() + kTempExtension;
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file || !file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size()) || !file.flush()) {
+			file.close();
+			std::error_code error;
+			fs::remove(tempPath, error);
+			return false;
+		}
+	}
+
+	std::error_code error;
+	fs::rename(tempPath, path, error);
+	if (error) {
+		// Another instance holds the entry open; its content is the same, so drop ours
+		fs::remove(tempPath, error);
+		return false;
+	}
+
+	if ((fBytesSinceTrim += bytes.size()) >= fMaxBytes / 8) {
+		Trim();
+	}
+	return true;
+}
+
+/*
+*/
+void ChartLayoutCache::Trim()
+{
+	std::lock_guard<std::mutex> lock(fTrimMutex);
+	fBytesSinceTrim = 0;
+	if (fDirectory.empty()) {
+		return;
+	}
+
+	struct Entry {
+		fs::path path;
+		fs::file_time_type time;
+		uint64_t size;
+	};
+	std::vector<Entry> entries;
+	uint64_t totalBytes = 0;
+	auto now = fs::file_time_type::clock::now();
+
+	std::error_code error;
+	for (fs::directory_iterator it(fs::u8path(fDirectory), error), end; !error && it != end; it.increment(error)) {
+		std::error_code entryError;
+		if (!it->is_regular_file(entryError)) continue;
+
+		Entry entry;
+		entry.path = it->path();
+		entry.time = it->last_write_time(entryError);
+		entry.size = entryError ? 0 : it->file_size(entryError);
+		if (entryError) continue;
+
+		std::string extension = entry.path.extension().string();
+		if (extension == kTempExtension) {
+			if (now - entry.time > kStaleTempAge) {
+				fs::remove(entry.path, entryError);
+			}
+		}
+		else if (extension == kEntryExtension) {
+			totalBytes += entry.size;
+			entries.push_back(entry);
+		}
+	}
+
+	if (totalBytes <= fMaxBytes) {
+		return;
+	}
+
+	// Evict oldest first down to three quarters of the limit, so trimming is not
+	// needed again straight away. Entries another instance has open may fail to
+	// delete; they are skipped and retried on the next trim.
+	std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.time < b.time; });
+	for (const Entry& entry : entries) {
+		if (totalBytes <= fMaxBytes / 4 * 3) break;
+		std::error_code removeError;
+		if (fs::remove(entry.path, removeError)) {
+			totalBytes -= entry.size;
+		}
+	}
+}
+
+/*
+*/
+void ChartLayoutCache::Clear()
+{
+	std::lock_guard<std::mutex> lock(fTrimMutex);
+	if (fDirectory.empty()) {
+		return;
+	}
+
+	std::error_code error;
+	for (fs::directory_iterator it(fs::u8path(fDirectory), error), end; !error && it != end; it.increment(error)) {
+		std::error_code removeError;
+		if (it->path().extension().string() == kEntryExtension) {
+			fs::remove(it->path(), removeError);
+		}
+	}
+}
@@ -0,0 +1,76 @@
+//========================================================================================
+//  
+//  ChartLayoutCache.h
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#ifndef __ChartLayoutCache_h__
+#define __ChartLayoutCache_h__
+
+// On-disk cache of computed chart layouts, keyed by ChartLayout::ComputeKey, so that
+// charts re-rendered after a document is reopened skip layout and text measurement.
+//
+// One file per layout. Files are written to a temporary name and renamed into place,
+// and every file carries its key and a checksum, so several Illustrator instances can
+// share the directory: a reader sees a complete entry or none. The directory is kept
+// under a size limit by evicting the least recently used entries.
+
+#include "ChartLayout.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+class ChartLayoutCache {
+public:
+	static const uint64_t kDefaultMaxBytes = 32 * 1024 * 1024;
+
+	// An empty directory disables the cache
+	explicit ChartLayoutCache(const std::string& directory = DefaultDirectory(), uint64_t maxBytes = kDefaultMaxBytes);
+
+	// Reads a cached layout. Returns false on a miss or if the entry is unreadable.
+	bool Load(uint64_t key, ChartLayout& layout);
+
+	// Writes a layout, replacing any entry with the same key
+	bool Store(uint64_t key, const ChartLayout& layout);
+
+	// Evicts least recently used entries until the cache is within its size limit
+	void Trim();
+
+	// Removes every entry
+	void Clear();
+
+	const std::string& GetDirectory() const { return fDirectory; }
+
+	// Hit-rate counters for this process
+	uint64_t GetHits() const { return fHits; }
+	uint64_t GetMisses() const { return fMisses; }
+	double GetHitRate() const;
+	void ResetCounters() { fHits = 0; fMisses = 0; }
+
+	// Per-user cache location for the platform, or empty if it cannot be determined
+	static std::string DefaultDirectory();
+
+private:
+	std::string EntryPath(uint64_t key) const;
+
+	std::string fDirectory;
+	uint64_t fMaxBytes;
+
+	std::atomic<uint64_t> fHits;
+	std::atomic<uint64_t> fMisses;
+
+	// Bytes stored since the directory was last trimmed; trimming is deferred until
+	// enough has been written to possibly exceed the limit
+	std::atomic<uint64_t> fBytesSinceTrim;
+	std::mutex fTrimMutex;
+};
+
+#endif // __ChartLayoutCache_h__
@@ -0,0 +1,577 @@
+//========================================================================================
+//  
+//  ChartPathBuilder.cpp
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#include "IllustratorSDK.h"
+#include "ChartPathBuilder.h"
+#include "ChartDisplayList.h"
+#include "ChartsSuites.h"
+#include "SDKErrors.h"
+#include <algorithm>
+#include <cmath>
+
+std::vector<AIPathSegment> ChartPathBuilder::sReadBuffer;
+
+namespace {
+
+// Estimated document cost of a marker in stored points. Compound path members and symbol
+// instances are both art objects; a path adds one point per corner anchor and three per
+// smooth anchor, an instance adds its transform.
+const size_t kArtOverheadPoints = 2;
+const size_t kTransformPoints = 3;
+const size_t kSymbolDefinitionPoints = 32;
+
+// Bezier handle length of a quarter circle, as a fraction of the radius
+const AIReal kCircleKappa = 0.5522847498;
+
+// Largest difference between positions that are taken as the same, in points. Positions
+// are stored in single precision, so a coordinate of a few thousand points reads back
+// within a thousandth of a point.
+const AIReal kSamePointTolerance = 0.005;
+
+AIBoolean IsSameSegment(const AIPathSegment& a, const AIPathSegment& b)
+{
+	return a.corner == b.corner &&
+		ChartPathBuilder::IsSamePoint(a.p.h, a.p.v, b.p.h, b.p.v) &&
+		ChartPathBuilder::IsSamePoint(a.in.h, a.in.v, b.in.h, b.in.v) &&
+		ChartPathBuilder::IsSamePoint(a.out.h, a.out.v, b.out.h, b.out.v);
+}
+
+} // namespace
+
+/*
+*/
+ChartArtCursor::ChartArtCursor(AIArtHandle parent) : fParent(parent), fNext(nullptr)
+{
+	// Emission places art on top, so earlier art is further down the stacking order
+	if (parent) {
+		sAIArt->GetArtLastChild(parent, &fNext);
+	}
+}
+
+/*
+*/
+void ChartArtCursor::Advance()
+{
+	AIArtHandle next = nullptr;
+	if (sAIArt->GetArtPriorSibling(fNext, &next) != kNoErr) {
+		next = nullptr;
+	}
+	fNext = next;
+}
+
+/*
+*/
+AIArtHandle ChartArtCursor::Take(short type)
+{
+	short nextType = kUnknownArt;
+	if (!fNext || sAIArt->GetArtType(fNext, &nextType) != kNoErr || nextType != type) {
+		return nullptr;
+	}
+
+	AIArtHandle taken = fNext;
+	Advance();
+	return taken;
+}
+
+/*
+*/
+ASErr ChartArtCursor::TakeGroup(const ai::UnicodeString& name, AIArtHandle* group)
+{
+	ASErr result = kNoErr;
+
+	try {
+		short nextType = kUnknownArt;
+		if (fNext && sAIArt->GetArtType(fNext, &nextType) == kNoErr && nextType == kGroupArt) {
+			ai::UnicodeString nextName;
+			AIBoolean isDefaultName = false;
+			if (sAIArt->GetArtName(fNext, nextName, &isDefaultName) == kNoErr && !isDefaultName && nextName == name) {
+				*group = fNext;
+				Advance();
+				return kNoErr;
+			}
+		}
+
+		result = NewArt(kGroupArt, group);
+		aisdk::check_ai_error(result);
+
+		result = sAIArt->SetArtName(*group, name);
+		aisdk::check_ai_error(result);
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+
+	return result;
+}
+
+/*
+*/
+ASErr ChartArtCursor::NewArt(short type, AIArtHandle* art)
+{
+	short paintOrder;
+	AIArtHandle prep;
+	GetInsertion(paintOrder, prep);
+
+	return sAIArt->NewArt(type, paintOrder, prep, art);
+}
+
+/*
+*/
+void ChartArtCursor::GetInsertion(short& paintOrder, AIArtHandle& prep) const
+{
+	if (fNext) {
+		paintOrder = kPlaceBelow;
+		prep = fNext;
+	}
+	else {
+		paintOrder = kPlaceInsideOnTop;
+		prep = fParent;
+	}
+}
+
+/*
+*/
+ASErr ChartArtCursor::Finish()
+{
+	ASErr result = kNoErr;
+
+	while (fNext && result == kNoErr) {
+		AIArtHandle leftover = fNext;
+		Advance();
+		result = sAIArt->DisposeArt(leftover);
+	}
+
+	return result;
+}
+
+/*
+*/
+AIBoolean ChartPathBuilder::IsSamePoint(AIReal h1, AIReal v1, AIReal h2, AIReal v2)
+{
+	return fabs(h1 - h2) <= kSamePointTolerance && fabs(v1 - v2) <= kSamePointTolerance;
+}
+
+/*
+*/
+void ChartPathBuilder::AddPoint(AIReal h, AIReal v)
+{
+	AIPathSegment segment;
+	MakeCorner(segment, h, v);
+	fSegments.push_back(segment);
+}
+
+/*
+*/
+void ChartPathBuilder::AddArc(const ChartPoint& center, double radius, double startAngle, double endAngle, double tolerance)
+{
+	const double sweep = endAngle - startAngle;
+	const int pieces = ChartArc::GetPieceCount(sweep, radius, tolerance);
+	const double step = sweep / pieces;
+
+	// Handle length of a piece; negative for a clockwise arc, which flips the tangents
+	const double k = radius * ChartArc::GetHandleLength(step);
+
+	// Anchor directions turn by one piece at a time from the start; the end is looked up
+	// itself, so the arc closes exactly on endAngle
+	ChartUnitVector direction = ChartArc::GetUnitVector(startAngle);
+	const ChartUnitVector turn = ChartArc::GetUnitVector(step);
+
+	for (int i = 0; i <= pieces; i++) {
+		if (i == pieces) {
+			direction = ChartArc::GetUnitVector(endAngle);
+		}
+		const double c = direction.c;
+		const double s = direction.s;
+
+		AIPathSegment segment;
+		segment.p.h = (AIReal)(center.h + radius * c);
+		segment.p.v = (AIReal)(center.v + radius * s);
+		segment.in.h = i > 0 ? (AIReal)(segment.p.h + k * s) : segment.p.h;
+		segment.in.v = i > 0 ? (AIReal)(segment.p.v - k * c) : segment.p.v;
+		segment.out.h = i < pieces ? (AIReal)(segment.p.h - k * s) : segment.p.h;
+		segment.out.v = i < pieces ? (AIReal)(segment.p.v + k * c) : segment.p.v;
+		segment.corner = i == 0 || i == pieces;
+		fSegments.push_back(segment);
+
+		direction.c = c * turn.c - s * turn.s;
+		direction.s = s * turn.c + c * turn.s;
+	}
+}
+
+/*
+*/
+void ChartPathBuilder::CloseLoop()
+{
+	if (fSegments.size() < 2) {
+		return;
+	}
+
+	AIPathSegment& first = fSegments.front();
+	const AIPathSegment& last = fSegments.back();
+	if (!IsSamePoint(first.p.h, first.p.v, last.p.h, last.p.v)) {
+		return;
+	}
+
+	first.in = last.in;
+	first.corner = first.corner && last.corner;
+	fSegments.pop_back();
+}
+
+/*
+*/
+ASErr ChartPathBuilder::Commit(AIArtHandle parent, AIBoolean closed, ChartStyle* style, AIArtHandle* path)
+{
+	return CommitSegments(parent, fSegments.data(), fSegments.size(), closed, style, path);
+}
+
+/*
+*/
+ASErr ChartPathBuilder::CommitSegments(AIArtHandle parent, const AIPathSegment* segments, size_t count, AIBoolean closed, ChartStyle* style, AIArtHandle* path)
+{
+	return NewPath(kPlaceInsideOnTop, parent, segments, count, closed, style, path);
+}
+
+/*
+*/
+ASErr ChartPathBuilder::NewPath(short paintOrder, AIArtHandle prep, const AIPathSegment* segments, size_t count, AIBoolean closed, ChartStyle* style, AIArtHandle* path)
+{
+	ASErr result = kNoErr;
+	AIArtHandle art = nullptr;
+
+	try {
+		// Segment indices are 16 bit
+		if (count == 0 || count > kChartMaxPathPoints) {
+			result = kBadParameterErr;
+			aisdk::check_ai_error(result);
+		}
+
+		result = sAIArt->NewArt(kPathArt, paintOrder, prep, &art);
+		aisdk::check_ai_error(result);
+
+		result = sAIPath->SetPathSegmentCount(art, (ai::int16)count);
+		aisdk::check_ai_error(result);
+
+		result = sAIPath->SetPathSegments(art, 0, (ai::int16)count, segments);
+		aisdk::check_ai_error(result);
+
+		if (closed) {
+			result = sAIPath->SetPathClosed(art, true);
+			aisdk::check_ai_error(result);
+		}
+
+		if (style) {
+			result = SetStyle(art, *style);
+			aisdk::check_ai_error(result);
+		}
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+		if (art) {
+			sAIArt->DisposeArt(art);
+			art = nullptr;
+		}
+	}
+
+	if (path) {
+		*path = art;
+	}
+
+	return result;
+}
+
+/*
+*/
+ASErr ChartPathBuilder::CommitSegments(ChartArtCursor& cursor, const AIPathSegment* segments, size_t count, AIBoolean closed, ChartStyle* style, AIArtHandle* path)
+{
+	AIArtHandle art = cursor.Take(kPathArt);
+	if (!art) {
+		// Nothing to reuse; create the path where the cursor stands
+		short paintOrder;
+		AIArtHandle prep;
+		cursor.GetInsertion(paintOrder, prep);
+		return NewPath(paintOrder, prep, segments, count, closed, style, path);
+	}
+
+	ASErr result = kNoErr;
+
+	try {
+		if (count == 0 || count > kChartMaxPathPoints) {
+			result = kBadParameterErr;
+			aisdk::check_ai_error(result);
+		}
+
+		// Read the path back and write only what differs from the new geometry
+		ai::int16 existingCount = 0;
+		result = sAIPath->GetPathSegmentCount(art, &existingCount);
+		aisdk::check_ai_error(result);
+
+		AIBoolean same = (size_t)existingCount == count;
+		if (same) {
+			sReadBuffer.resize(count);
+			result = sAIPath->GetPathSegments(art, 0, existingCount, sReadBuffer.data());
+			aisdk::check_ai_error(result);
+			for (size_t i = 0; i < count && same; i++) {
+				same = IsSameSegment(sReadBuffer[i], segments[i]);
+			}
+		}
+
+		if (!same) {
+			if ((size_t)existingCount != count) {
+				result = sAIPath->SetPathSegmentCount(art, (ai::int16)count);
+				aisdk::check_ai_error(result);
+			}
+
+			result = sAIPath->SetPathSegments(art, 0, (ai::int16)count, segments);
+			aisdk::check_ai_error(result);
+		}
+
+		AIBoolean existingClosed = false;
+		result = sAIPath->GetPathClosed(art, &existingClosed);
+		aisdk::check_ai_error(result);
+		if ((existingClosed ? true : false) != (closed ? true : false)) {
+			result = sAIPath->SetPathClosed(art, closed);
+			aisdk::check_ai_error(result);
+		}
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+
+	if (path) {
+		*path = art;
+	}
+
+	return result;
+}
+
+/*
+*/
+ASErr ChartPathBuilder::PlaceSymbol(AIArtHandle parent, AIPatternHandle symbol, AIReal h, AIReal v)
+{
+	AIRealPoint center;
+	center.h = h;
+	center.v = v;
+
+	AIArtHandle instance = nullptr;
+	return sAISymbol->NewInstanceAtLocation(symbol, center, kPlaceInsideOnTop, parent, &instance);
+}
+
+/*
+*/
+ASErr ChartPathBuilder::PlaceSymbol(ChartArtCursor& cursor, AIPatternHandle symbol, AIReal h, AIReal v)
+{
+	AIArtHandle instance = cursor.Take(kSymbolArt);
+	if (instance) {
+		// Instances are centered on their point, so the center of the bounds is the point
+		AIPatternHandle placed = nullptr;
+		AIRealRect bounds;
+		if (sAISymbol->GetSymbolPatternOfSymbolArt(instance, &placed) == kNoErr && placed == symbol &&
+			sAIArt->GetArtBounds(instance, &bounds) == kNoErr &&
+			IsSamePoint((bounds.left + bounds.right) / 2, (bounds.top + bounds.bottom) / 2, h, v)) {
+			return kNoErr;
+		}
+
+		ASErr result = sAIArt->DisposeArt(instance);
+		if (result != kNoErr) {
+			return result;
+		}
+	}
+
+	AIRealPoint center;
+	center.h = h;
+	center.v = v;
+
+	short paintOrder;
+	AIArtHandle prep;
+	cursor.GetInsertion(paintOrder, prep);
+
+	return sAISymbol->NewInstanceAtLocation(symbol, center, paintOrder, prep, &instance);
+}
+
+/*
+*/
+ASErr ChartPathBuilder::SetStyle(AIArtHandle art, ChartStyle& style)
+{
+	return style.ApplyTo(art);
+}
+
+/*
+*/
+ASErr ChartPathSet::Add(const AIPathSegment* segments, size_t count, AIBoolean closed)
+{
+	if (fMode == kChartEmitSeparatePaths) {
+		return ChartPathBuilder::CommitSegments(fCursor, segments, count, closed, fStyle);
+	}
+
+	ASErr result = kNoErr;
+
+	try {
+		result = Open();
+		aisdk::check_ai_error(result);
+
+		// Members take the compound path's style
+		result = ChartPathBuilder::CommitSegments(fMembers, segments, count, closed, nullptr);
+		aisdk::check_ai_error(result);
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+
+	return result;
+}
+
+/*
+*/
+ASErr ChartPathSet::Open()
+{
+	if (fCompound) {
+		return kNoErr;
+	}
+
+	fCompound = fCursor.Take(kCompoundPathArt);
+	if (!fCompound) {
+		ASErr result = fCursor.NewArt(kCompoundPathArt, &fCompound);
+		if (result != kNoErr) {
+			return result;
+		}
+		fNewCompound = true;
+	}
+	fMembers = ChartArtCursor(fCompound);
+	return kNoErr;
+}
+
+/*
+*/
+AIBoolean ChartPathSet::Keep()
+{
+	if (fMode == kChartEmitSeparatePaths) {
+		return fCursor.Take(kPathArt) != nullptr;
+	}
+
+	if (Open() != kNoErr) {
+		return false;
+	}
+	return fMembers.Take(kPathArt) != nullptr;
+}
+
+/*
+*/
+ASErr ChartPathSet::Finish()
+{
+	if (!fCompound) {
+		return kNoErr;
+	}
+
+	ASErr result = fMembers.Finish();
+	if (result != kNoErr || !fNewCompound || !fStyle) {
+		return result;
+	}
+
+	// Setting the style of a compound path styles all of its member paths
+	return ChartPathBuilder::SetStyle(fCompound, *fStyle);
+}
+
+/*
+*/
+ChartMarkerPath::ChartMarkerPath(ChartMarkerShape shape, AIReal h, AIReal v, AIReal size) : fCount(4)
+{
+	const AIReal r = size / 2;
+
+	switch (shape) {
+		case kChartMarkerCircle: {
+			// Four smooth anchors at the compass points, wound clockwise from the left
+			const AIReal k = r * kCircleKappa;
+			const AIReal points[4][2] = {{h - r, v}, {h, v + r}, {h + r, v}, {h, v - r}};
+			const AIReal tangents[4][2] = {{0, 1}, {1, 0}, {0, -1}, {-1, 0}};
+			for (size_t i = 0; i < 4; i++) {
+				AIPathSegment& segment = fSegments[i];
+				segment.p.h = points[i][0];
+				segment.p.v = points[i][1];
+				segment.in.h = segment.p.h - tangents[i][0] * k;
+				segment.in.v = segment.p.v - tangents[i][1] * k;
+				segment.out.h = segment.p.h + tangents[i][0] * k;
+				segment.out.v = segment.p.v + tangents[i][1] * k;
+				segment.corner = false;
+			}
+			break;
+		}
+		case kChartMarkerDiamond:
+			ChartPathBuilder::MakeCorner(fSegments[0], h - r, v);
+			ChartPathBuilder::MakeCorner(fSegments[1], h, v + r);
+			ChartPathBuilder::MakeCorner(fSegments[2], h + r, v);
+			ChartPathBuilder::MakeCorner(fSegments[3], h, v - r);
+			break;
+		case kChartMarkerTriangle:
+			fCount = 3;
+			ChartPathBuilder::MakeCorner(fSegments[0], h - r, v - r);
+			ChartPathBuilder::MakeCorner(fSegments[1], h, v + r);
+			ChartPathBuilder::MakeCorner(fSegments[2], h + r, v - r);
+			break;
+		case kChartMarkerSquare:
+		default:
+			ChartPathBuilder::MakeCorner(fSegments[0], h - r, v - r);
+			ChartPathBuilder::MakeCorner(fSegments[1], h - r, v + r);
+			ChartPathBuilder::MakeCorner(fSegments[2], h + r, v + r);
+			ChartPathBuilder::MakeCorner(fSegments[3], h + r, v - r);
+			break;
+	}
+}
+
+/*
+*/
+ChartMarkerMode ChartMarkerPath::ChooseMode(ChartMarkerShape shape, size_t count)
+{
+	const ChartMarkerPath marker(shape, 0, 0, 1);
+	size_t markerPoints = kArtOverheadPoints;
+	for (size_t i = 0; i < marker.GetCount(); i++) {
+		markerPoints += marker.fSegments[i].corner ? 1 : 3;
+	}
+
+	const size_t compoundPoints = count * markerPoints;
+	const size_t symbolPoints = kSymbolDefinitionPoints + count * (kArtOverheadPoints + kTransformPoints);
+	return symbolPoints < compoundPoints ? kChartMarkersSymbols : kChartMarkersCompound;
+}
+
+/*
+*/
+ASErr ChartMarkerPath::GetSymbol(ChartMarkerShape shape, AIReal size, ChartStyle& style, const ai::UnicodeString& name, AIArtHandle scratch, AIPatternHandle* symbol)
+{
+	ASErr result = kNoErr;
+	AIArtHandle definition = nullptr;
+
+	try {
+		*symbol = nullptr;
+		if (!name.empty() && sAISymbol->GetSymbolByName(name, symbol) == kNoErr && *symbol) {
+			return kNoErr;
+		}
+
+		// The symbol copies the definition art, so the marker built here is discarded
+		result = ChartMarkerPath(shape, 0, 0, size).Commit(scratch, &style, &definition);
+		aisdk::check_ai_error(result);
+
+		result = sAISymbol->NewSymbolPattern(symbol, definition, false);
+		aisdk::check_ai_error(result);
+
+		result = sAISymbol->SetSymbolPatternBaseName(*symbol, name.empty() ? ai::UnicodeString("Chart Marker") : name);
+		aisdk::check_ai_error(result);
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+
+	if (definition) {
+		sAIArt->DisposeArt(definition);
+	}
+
+	return result;
+}
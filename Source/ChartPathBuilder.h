@@ -0,0 +1,290 @@
+//========================================================================================
+//  
+//  ChartPathBuilder.h
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#ifndef __ChartPathBuilder_h__
+#define __ChartPathBuilder_h__
+
+#include "IllustratorSDK.h"
+#include "ChartArc.h"
+#include "ChartLayout.h"
+#include "ChartStyleTable.h"
+#include <vector>
+
+// How the same-styled paths of a chart component are emitted
+enum ChartEmitMode {
+	kChartEmitSeparatePaths = 0,	// One path art per primitive
+	kChartEmitCompoundPaths			// One compound path per component
+};
+
+// How the markers of a scatter series are emitted
+enum ChartMarkerMode {
+	kChartMarkersAuto = 0,			// Whichever the cost estimate favors, per series
+	kChartMarkersCompound,			// Marker outlines in one compound path per series
+	kChartMarkersSymbols			// One document symbol per series, placed per marker
+};
+
+// Walks the existing children of a group from the bottom of the stacking order up, so
+// that emission rewrites the art of an earlier render in place instead of recreating it.
+// Emission takes the next child when its type fits and otherwise creates art just below
+// it, which keeps the emitted order; children not taken by Finish are disposed. Over an
+// empty group every Take fails and emission simply creates.
+class ChartArtCursor {
+public:
+	ChartArtCursor() : fParent(nullptr), fNext(nullptr) {}
+	explicit ChartArtCursor(AIArtHandle parent);
+
+	// The next child if it is of type, or null; the cursor moves past it only when taken
+	AIArtHandle Take(short type);
+
+	// The next child if it is a group named name, otherwise a new group of that name
+	ASErr TakeGroup(const ai::UnicodeString& name, AIArtHandle* group);
+
+	// Creates art of type at the cursor
+	ASErr NewArt(short type, AIArtHandle* art);
+
+	// Where new art goes: below the next child, or on top of the group when none is left
+	void GetInsertion(short& paintOrder, AIArtHandle& prep) const;
+
+	// Disposes the children that were not taken; call once after the last emission
+	ASErr Finish();
+
+	AIArtHandle GetParent() const { return fParent; }
+
+private:
+	void Advance();
+
+	AIArtHandle fParent;
+	AIArtHandle fNext;
+};
+
+// Accumulates the segments of one path locally and creates the path with a single
+// SetPathSegments call. Reuse one builder for many paths to reuse its buffer.
+class ChartPathBuilder {
+public:
+	explicit ChartPathBuilder(size_t capacity = 0) { fSegments.reserve(capacity); }
+
+	// Starts a new path
+	void Clear() { fSegments.clear(); }
+
+	// Makes room for count segments, so a long path is accumulated without regrowing
+	void Reserve(size_t count) { fSegments.reserve(count); }
+
+	// Appends a corner point
+	void AddPoint(AIReal h, AIReal v);
+	void AddPoint(const ChartPoint& point) { AddPoint((AIReal)point.h, (AIReal)point.v); }
+
+	// Appends prepared segments
+	void AddSegments(const AIPathSegment* segments, size_t count) { fSegments.insert(fSegments.end(), segments, segments + count); }
+
+	// Appends a circular arc around center from startAngle to endAngle, in radians
+	// counterclockwise, as the fewest equal Bezier pieces, of at most a quarter turn, that
+	// stay within tolerance points of the circle. Directions come from ChartArc's tables,
+	// so an arc costs no trigonometry. The arc's ends are corner anchors, so it joins
+	// straight edges added before and after it.
+	void AddArc(const ChartPoint& center, double radius, double startAngle, double endAngle, double tolerance = kChartArcTolerance);
+
+	// Removes the last anchor when it coincides with the first, moving its incoming handle
+	// to the first anchor, so a closed path ends without a zero-length segment
+	void CloseLoop();
+
+	size_t GetCount() const { return fSegments.size(); }
+	const AIPathSegment* GetSegments() const { return fSegments.data(); }
+
+	// Creates a path art inside parent from the accumulated segments.
+	// style may be null to keep the document's default style.
+	ASErr Commit(AIArtHandle parent, AIBoolean closed, ChartStyle* style, AIArtHandle* path = nullptr);
+
+	// Creates a path art from a segment array: NewArt, SetPathSegmentCount and one
+	// SetPathSegments call, plus SetPathClosed only for closed paths since new paths
+	// are open.
+	static ASErr CommitSegments(AIArtHandle parent, const AIPathSegment* segments, size_t count, AIBoolean closed, ChartStyle* style, AIArtHandle* path = nullptr);
+
+	// Rewrites the next path of the cursor with a segment array, or creates the path there
+	// if the cursor has none. A path whose segments and closure already match is only
+	// read, and reused paths keep their style; style paints new paths only.
+	static ASErr CommitSegments(ChartArtCursor& cursor, const AIPathSegment* segments, size_t count, AIBoolean closed, ChartStyle* style, AIArtHandle* path = nullptr);
+
+	// Places an instance of a symbol centered on a point
+	static ASErr PlaceSymbol(AIArtHandle parent, AIPatternHandle symbol, AIReal h, AIReal v);
+
+	// Keeps the next instance of the cursor if it already shows symbol at the point, and
+	// otherwise replaces it, or places a new instance when the cursor has none
+	static ASErr PlaceSymbol(ChartArtCursor& cursor, AIPatternHandle symbol, AIReal h, AIReal v);
+
+	// Paints an art with a chart style, by graphic style reference once the style is
+	// bound to the document
+	static ASErr SetStyle(AIArtHandle art, ChartStyle& style);
+
+	static void MakeCorner(AIPathSegment& segment, AIReal h, AIReal v)
+	{
+		segment.p.h = h;
+		segment.p.v = v;
+		segment.in = segment.out = segment.p;
+		segment.corner = true;
+	}
+
+	// Whether two positions are the same to within what survives a round trip through the
+	// document
+	static AIBoolean IsSamePoint(AIReal h1, AIReal v1, AIReal h2, AIReal v2);
+
+private:
+	// Creates a path art placed relative to prep from a segment array
+	static ASErr NewPath(short paintOrder, AIArtHandle prep, const AIPathSegment* segments, size_t count, AIBoolean closed, ChartStyle* style, AIArtHandle* path);
+
+	std::vector<AIPathSegment> fSegments;
+
+	// Segments read back from a path being updated
+	static std::vector<AIPathSegment> sReadBuffer;
+
+	friend class ChartArtCursor;
+	friend class ChartPathSet;
+};
+
+// Path with a segment count known at compile time, built on the stack
+template <size_t N>
+class ChartFixedPath {
+public:
+	void Set(size_t index, AIReal h, AIReal v) { ChartPathBuilder::MakeCorner(fSegments[index], h, v); }
+
+	ASErr Commit(AIArtHandle parent, AIBoolean closed, ChartStyle* style, AIArtHandle* path = nullptr) const
+	{
+		return ChartPathBuilder::CommitSegments(parent, fSegments, N, closed, style, path);
+	}
+
+	ASErr Commit(ChartArtCursor& cursor, AIBoolean closed, ChartStyle* style, AIArtHandle* path = nullptr) const
+	{
+		return ChartPathBuilder::CommitSegments(cursor, fSegments, N, closed, style, path);
+	}
+
+	const AIPathSegment* GetSegments() const { return fSegments; }
+
+protected:
+	AIPathSegment fSegments[N];
+};
+
+// Closed rectangle, wound clockwise from the bottom left corner
+class ChartRectPath : public ChartFixedPath<4> {
+public:
+	ChartRectPath(AIReal left, AIReal top, AIReal right, AIReal bottom)
+	{
+		Set(0, left, bottom);
+		Set(1, left, top);
+		Set(2, right, top);
+		Set(3, right, bottom);
+	}
+	explicit ChartRectPath(const AIRealRect& rect) : ChartRectPath(rect.left, rect.top, rect.right, rect.bottom) {}
+	explicit ChartRectPath(const ChartRect& rect) : ChartRectPath((AIReal)rect.left, (AIReal)rect.top, (AIReal)rect.right, (AIReal)rect.bottom) {}
+
+	ASErr Commit(AIArtHandle parent, ChartStyle* style, AIArtHandle* path = nullptr) const
+	{
+		return ChartFixedPath<4>::Commit(parent, true, style, path);
+	}
+
+	ASErr Commit(ChartArtCursor& cursor, ChartStyle* style, AIArtHandle* path = nullptr) const
+	{
+		return ChartFixedPath<4>::Commit(cursor, true, style, path);
+	}
+};
+
+// Open two-point line
+class ChartLinePath : public ChartFixedPath<2> {
+public:
+	ChartLinePath(AIReal fromH, AIReal fromV, AIReal toH, AIReal toV)
+	{
+		Set(0, fromH, fromV);
+		Set(1, toH, toV);
+	}
+	explicit ChartLinePath(const ChartSegment& line) : ChartLinePath((AIReal)line.from.h, (AIReal)line.from.v, (AIReal)line.to.h, (AIReal)line.to.v) {}
+
+	ASErr Commit(AIArtHandle parent, ChartStyle* style, AIArtHandle* path = nullptr) const
+	{
+		return ChartFixedPath<2>::Commit(parent, false, style, path);
+	}
+
+	ASErr Commit(ChartArtCursor& cursor, ChartStyle* style, AIArtHandle* path = nullptr) const
+	{
+		return ChartFixedPath<2>::Commit(cursor, false, style, path);
+	}
+};
+
+// Closed scatter marker outline centered on a point. Circles are four Bezier arcs,
+// the other shapes are corner polygons.
+class ChartMarkerPath {
+public:
+	ChartMarkerPath(ChartMarkerShape shape, AIReal h, AIReal v, AIReal size);
+
+	const AIPathSegment* GetSegments() const { return fSegments; }
+	size_t GetCount() const { return fCount; }
+
+	ASErr Commit(AIArtHandle parent, ChartStyle* style, AIArtHandle* path = nullptr) const
+	{
+		return ChartPathBuilder::CommitSegments(parent, fSegments, fCount, true, style, path);
+	}
+
+	// Picks compound paths or symbol instances for count markers of a shape, whichever
+	// stores fewer points in the document. A compound path member stores every anchor
+	// and handle of its outline; a symbol instance stores a transform, after a one-off
+	// definition. Circles become symbols beyond a handful of markers, squares and
+	// diamonds only for large series, and triangles stay compound paths.
+	static ChartMarkerMode ChooseMode(ChartMarkerShape shape, size_t count);
+
+	// Creates a document symbol from a styled marker at the origin, named name, or
+	// returns the existing symbol of that name. scratch is a group the definition art
+	// is built in before the symbol copies it.
+	static ASErr GetSymbol(ChartMarkerShape shape, AIReal size, ChartStyle& style, const ai::UnicodeString& name, AIArtHandle scratch, AIPatternHandle* symbol);
+
+private:
+	AIPathSegment fSegments[4];
+	size_t fCount;
+};
+
+// Collects the same-styled paths of one chart component (all Y grid lines, all X ticks,
+// all columns of one series) and emits them at a cursor according to the emit mode. In
+// compound mode the paths go into a single compound path, the cursor's next one or a new
+// one created on the first Add, and a new compound path is styled once by Finish. Paths
+// left over from an earlier render are rewritten in place, so an update touches only the
+// paths that changed and adds or removes paths only when the count changes.
+class ChartPathSet {
+public:
+	ChartPathSet(ChartArtCursor& cursor, ChartStyle* style, ChartEmitMode mode) :
+		fCursor(cursor), fStyle(style), fMode(mode), fCompound(nullptr), fNewCompound(false) {}
+
+	ASErr Add(const ChartRectPath& rect) { return Add(rect.GetSegments(), 4, true); }
+	ASErr Add(const ChartLinePath& line) { return Add(line.GetSegments(), 2, false); }
+	ASErr Add(const ChartMarkerPath& marker) { return Add(marker.GetSegments(), marker.GetCount(), true); }
+	ASErr Add(const ChartPathBuilder& builder, AIBoolean closed) { return Add(builder.GetSegments(), builder.GetCount(), closed); }
+	ASErr Add(const AIPathSegment* segments, size_t count, AIBoolean closed);
+
+	// Keeps the next path unread, for a primitive the caller knows is unchanged since it
+	// emitted it. Returns false if there is no path to keep, in which case call Add.
+	AIBoolean Keep();
+
+	// Disposes leftover members and styles a new compound path; call once after the last Add
+	ASErr Finish();
+
+	// The compound path, or null in separate mode or before the first Add
+	AIArtHandle GetCompound() const { return fCompound; }
+
+private:
+	// Takes the cursor's next compound path, or creates one, before the first member
+	ASErr Open();
+
+	ChartArtCursor& fCursor;
+	ChartStyle* fStyle;
+	ChartEmitMode fMode;
+	AIArtHandle fCompound;
+	AIBoolean fNewCompound;
+	ChartArtCursor fMembers;
+};
+
+#endif // __ChartPathBuilder_h__
@@ -0,0 +1,249 @@
+//========================================================================================
+//  
+//  ChartPreview.cpp
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#include "ChartPreview.h"
+#include "ChartArc.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Straight pieces per full turn of a preview arc; a few view pixels each at usual sizes.
+// Markers are a few pixels across, so octagons pass for circles.
+static const double kArcPiecesPerTurn = 48;
+static const double kMarkerPiecesPerTurn = 8;
+
+/*
+*/
+ChartPreview::ChartPreview() : fBound(false), fWidth(0), fHeight(0)
+{
+}
+
+/*
+*/
+void ChartPreview::Bind(const ChartSeriesView& view, const ChartLayoutParams& params, size_t markBudget)
+{
+	const double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+	fParams = params;
+	fParams.showDataLabels = false;
+	fParams.resolution = 0;
+
+	const size_t rows = view.CategoryCount();
+	const size_t seriesCount = view.series.size();
+	const size_t buckets = std::min(rows, std::max<size_t>(2, markBudget / std::max<size_t>(1, seriesCount)));
+
+	// Bucket b holds rows b * rows / buckets up to (b + 1) * rows / buckets
+	ChartColumn categories;
+	categories.name = view.categories ? view.categories->name : std::string();
+	categories.kind = ChartColumn::kText;
+	categories.texts.reserve(buckets);
+	for (size_t bucket = 0; bucket < buckets; bucket++) {
+		categories.texts.push_back(view.CategoryLabel(bucket * rows / buckets));
+	}
+
+	fSample = ChartDataset();
+	fSample.AddColumn(categories);
+	for (size_t seriesIdx = 0; seriesIdx < seriesCount; seriesIdx++) {
+		const ChartColumn& source = *view.series[seriesIdx];
+		ChartColumn column;
+		column.name = source.name;
+		column.numbers.reserve(buckets);
+
+		for (size_t bucket = 0; bucket < buckets; bucket++) {
+			const size_t first = bucket * rows / buckets;
+			const size_t last = std::min((bucket + 1) * rows / buckets, source.numbers.size());
+			double value = kNaN;
+			if (fParams.chartType == kChartTypeScatter) {
+				value = first < source.numbers.size() ? source.numbers[first] : kNaN;
+			}
+			else if (fParams.chartType == kChartTypePie || fParams.chartType == kChartTypeDonut) {
+				for (size_t row = first; row < last; row++) {
+					if (!std::isnan(source.numbers[row])) {
+						value = std::isnan(value) ? source.numbers[row] : value + source.numbers[row];
+					}
+				}
+			}
+			else {
+				for (size_t row = first; row < last; row++) {
+					if (!std::isnan(source.numbers[row]) && !(std::fabs(source.numbers[row]) <= std::fabs(value))) {
+						value = source.numbers[row];
+					}
+				}
+			}
+			column.numbers.push_back(value);
+		}
+		fSample.AddColumn(column);
+	}
+
+	// The sample's columns are complete, so the view can point into them
+	fView = ChartSeriesView();
+	fView.categories = &fSample.GetColumn(0);
+	for (size_t seriesIdx = 0; seriesIdx < seriesCount; seriesIdx++) {
+		fView.series.push_back(&fSample.GetColumn(seriesIdx + 1));
+	}
+
+	fBound = true;
+	fWidth = fHeight = 0;
+	fShapes.clear();
+	fPoints.clear();
+}
+
+/*
+*/
+void ChartPreview::Unbind()
+{
+	fBound = false;
+	fView = ChartSeriesView();
+	fSample = ChartDataset();
+	fWidth = fHeight = 0;
+	fLayout = ChartLayout();
+	fList.Clear();
+	fShapes.clear();
+	fPoints.clear();
+}
+
+/*
+*/
+bool ChartPreview::Update(double width, double height, double quantum, ChartTextMeasurer& measurer)
+{
+	if (!fBound || !(width > 0) || !(height > 0)) {
+		return false;
+	}
+	if (fWidth > 0 && std::fabs(width - fWidth) < quantum && std::fabs(height - fHeight) < quantum) {
+		return false;
+	}
+
+	fWidth = width;
+	fHeight = height;
+	fShapes.clear();
+	fPoints.clear();
+
+	ChartLayoutParams params = fParams;
+	params.plotArea.left = 0;
+	params.plotArea.bottom = 0;
+	params.plotArea.right = width;
+	params.plotArea.top = height;
+	if (!ChartLayout::Compute(fView, params, measurer, fLayout)) {
+		return true;
+	}
+
+	// The chart's own display list, less its text, so the preview draws what the chart will
+	ChartDisplayList::Build(fLayout, false, fList);
+	const std::vector<ChartPrimitive>& primitives = fList.GetPrimitives();
+	for (size_t i = 0; i < primitives.size(); i++) {
+		const ChartPrimitive& primitive = primitives[i];
+		if (primitive.kind != kChartPrimitiveGroup && primitive.kind != kChartPrimitiveText) {
+			AddPrimitive(primitive);
+		}
+	}
+	return true;
+}
+
+/*
+*/
+void ChartPreview::AddPrimitive(const ChartPrimitive& primitive)
+{
+	const int32_t role = primitive.role;
+	const int32_t series = primitive.series;
+
+	// Axes, grids and ticks always fit; data marks stop at the budget
+	const bool data = role == kChartPaintSeries || role == kChartPaintSeriesLine;
+	if (data && fPoints.size() >= kChartPreviewPointBudget) {
+		return;
+	}
+
+	switch (primitive.kind) {
+		case kChartPrimitiveRect:
+			fPoints.push_back({primitive.rect.left, primitive.rect.top});
+			fPoints.push_back({primitive.rect.right, primitive.rect.top});
+			fPoints.push_back({primitive.rect.right, primitive.rect.bottom});
+			fPoints.push_back({primitive.rect.left, primitive.rect.bottom});
+			EndShape(role, series, true);
+			break;
+		case kChartPrimitivePolyline:
+			if (primitive.points.size() > 1) {
+				fPoints.insert(fPoints.end(), primitive.points.begin(), primitive.points.end());
+				EndShape(role, series, primitive.closed);
+			}
+			break;
+		case kChartPrimitiveArc:
+			// A wedge from the center, or a ring sector back along the inner radius
+			if (primitive.innerRadius > 0) {
+				AddArc(primitive.origin, primitive.radius, primitive.startAngle, primitive.endAngle, kArcPiecesPerTurn);
+				AddArc(primitive.origin, primitive.innerRadius, primitive.endAngle, primitive.startAngle, kArcPiecesPerTurn);
+			}
+			else {
+				fPoints.push_back(primitive.origin);
+				AddArc(primitive.origin, primitive.radius, primitive.startAngle, primitive.endAngle, kArcPiecesPerTurn);
+			}
+			EndShape(role, series, true);
+			break;
+		case kChartPrimitiveMarker: {
+			const double h = primitive.origin.h;
+			const double v = primitive.origin.v;
+			const double r = primitive.size / 2;
+			switch (primitive.shape) {
+				case kChartMarkerCircle:
+					AddArc(primitive.origin, r, 0, 6.283185307179586 * (1 - 1 / kMarkerPiecesPerTurn), kMarkerPiecesPerTurn);
+					break;
+				case kChartMarkerDiamond:
+					fPoints.push_back({h - r, v});
+					fPoints.push_back({h, v + r});
+					fPoints.push_back({h + r, v});
+					fPoints.push_back({h, v - r});
+					break;
+				case kChartMarkerTriangle:
+					fPoints.push_back({h - r, v - r});
+					fPoints.push_back({h, v + r});
+					fPoints.push_back({h + r, v - r});
+					break;
+				case kChartMarkerSquare:
+				default:
+					fPoints.push_back({h - r, v - r});
+					fPoints.push_back({h - r, v + r});
+					fPoints.push_back({h + r, v + r});
+					fPoints.push_back({h + r, v - r});
+					break;
+			}
+			EndShape(role, series, true);
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+/*
+*/
+void ChartPreview::AddArc(const ChartPoint& center, double radius, double startAngle, double endAngle, double piecesPerTurn)
+{
+	const double kFullTurn = 6.283185307179586;
+	const double sweep = endAngle - startAngle;
+	const int pieces = std::max(1, (int)std::ceil(std::fabs(sweep) * piecesPerTurn / kFullTurn));
+	for (int piece = 0; piece <= pieces; piece++) {
+		const ChartUnitVector direction = ChartArc::GetUnitVector(startAngle + sweep * piece / pieces);
+		fPoints.push_back({center.h + radius * direction.c, center.v + radius * direction.s});
+	}
+}
+
+/*
+*/
+void ChartPreview::EndShape(int32_t role, int32_t series, bool closed)
+{
+	ChartPreviewShape shape;
+	shape.role = role;
+	shape.series = series;
+	shape.closed = closed;
+	shape.end = (uint32_t)fPoints.size();
+	fShapes.push_back(shape);
+}
@@ -0,0 +1,92 @@
+//========================================================================================
+//  
+//  ChartPreview.h
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#ifndef __ChartPreview_h__
+#define __ChartPreview_h__
+
+// A live outline of the chart a drag would create, for drawing as an annotation. The data
+// is sampled down to a fixed budget of marks once, when the drag starts, so laying the
+// preview out again as the rectangle changes costs the same however large the dataset.
+// Geometry is reduced to point runs, relative to the bottom left of the plot area, that
+// the annotator draws as polygons and lines. Free of Illustrator SDK types, like the layout.
+
+#include "ChartLayout.h"
+#include "ChartDisplayList.h"
+#include <cstdint>
+#include <vector>
+
+// Data marks sampled into a preview: columns, markers, or points per line
+const size_t kChartPreviewMarkBudget = 512;
+
+// Points of all the preview's shapes together, beyond which data shapes are left out
+const size_t kChartPreviewPointBudget = 8192;
+
+// One run of preview points: a filled polygon, a closed outline or an open line
+struct ChartPreviewShape {
+	int32_t role;		// ChartStyleRole, kChartPaintSeries or kChartPaintSeriesLine
+	int32_t series;		// Series of a series paint
+	bool closed;
+	uint32_t end;		// Index one past the shape's last point
+};
+
+class ChartPreview {
+public:
+	ChartPreview();
+
+	// Samples view for a chart laid out with params, whose plot area is ignored. Buckets
+	// of consecutive categories become one: summed for pie and donut charts, so wedges
+	// keep their shares; the first of the bucket for scatter charts, so X and Y stay
+	// paired; and otherwise the value furthest from zero, so peaks survive. Data labels
+	// are left out.
+	void Bind(const ChartSeriesView& view, const ChartLayoutParams& params, size_t markBudget = kChartPreviewMarkBudget);
+
+	// Releases the sample
+	void Unbind();
+
+	bool IsBound() const { return fBound; }
+
+	// Lays the sample out in a plot area of width by height points, unless a layout
+	// within quantum points of that size is current, which callers stretch to fit.
+	// Returns whether the shapes changed.
+	bool Update(double width, double height, double quantum, ChartTextMeasurer& measurer);
+
+	// The size the shapes were laid out at, 0 before the first update
+	double GetWidth() const { return fWidth; }
+	double GetHeight() const { return fHeight; }
+
+	// Shapes from the back, their points from the plot area's bottom left, v up
+	const std::vector<ChartPreviewShape>& GetShapes() const { return fShapes; }
+	const std::vector<ChartPoint>& GetPoints() const { return fPoints; }
+
+	// Categories of the sample
+	size_t GetCategoryCount() const { return fView.CategoryCount(); }
+
+private:
+	// Appends primitive's outline as shapes, when the point budget allows
+	void AddPrimitive(const ChartPrimitive& primitive);
+	void AddArc(const ChartPoint& center, double radius, double startAngle, double endAngle, double piecesPerTurn);
+	void EndShape(int32_t role, int32_t series, bool closed);
+
+	bool fBound;
+	ChartLayoutParams fParams;
+	ChartDataset fSample;
+	ChartSeriesView fView;
+
+	double fWidth, fHeight;
+	ChartLayout fLayout;
+	ChartDisplayList fList;
+	std::vector<ChartPreviewShape> fShapes;
+	std::vector<ChartPoint> fPoints;
+};
+
+#endif // __ChartPreview_h__
@@ -0,0 +1,331 @@
+//========================================================================================
+//  
+//  ChartRegistry.cpp
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#include "IllustratorSDK.h"
+#include "ChartRegistry.h"
+#include "ChartsSuites.h"
+#include "SDKErrors.h"
+#include <vector>
+
+/*
+*/
+ASErr ChartRegistry::Rebuild()
+{
+	ASErr result = kNoErr;
+	AIArtHandle** matches = nullptr;
+
+	try {
+		Clear();
+
+		// One pass over every group in the document; charts are groups tagged in their dictionary
+		AIMatchingArtSpec spec;
+		spec.type = kGroupArt;
+		spec.whichAttr = 0;
+		spec.attr = 0;
+
+		ai::int32 numMatches = 0;
+		result = sAIMatchingArt->GetMatchingArt(&spec, 1, &matches, &numMatches);
+		aisdk::check_ai_error(result);
+
+		// Every saved ID is reserved before any is handed out, so a chart saved without
+		// one, or a copy sharing one, cannot be given the ID of a chart found later
+		std::vector<ChartRecord> records;
+		for (ai::int32 i = 0; i < numMatches; i++) {
+			AIArtHandle art = (*matches)[i];
+			if (ChartItem::IsChartArt(art)) {
+				ChartRecord record;
+				result = ReadRecord(art, record);
+				aisdk::check_ai_error(result);
+				ChartItem::ReserveChartID(record.chartID);
+				records.push_back(record);
+			}
+		}
+
+		for (size_t i = 0; i < records.size(); i++) {
+			Index(records[i]);
+		}
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+
+	if (matches) {
+		sAIMdMemory->MdMemoryDisposeHandle((AIMdMemoryHandle)matches);
+	}
+
+	return result;
+}
+
+/*
+*/
+ASErr ChartRegistry::Register(AIArtHandle art)
+{
+	ASErr result = kNoErr;
+
+	try {
+		ChartRecord record;
+		result = ReadRecord(art, record);
+		aisdk::check_ai_error(result);
+
+		// Already indexed under this art; keep the ID it was given if its dictionary has
+		// none of its own yet, otherwise just refresh the entry
+		auto known = fArtIndex.find(art);
+		if (known != fArtIndex.end() && known->second != record.chartID) {
+			if (record.chartID <= 0 || IsTaken(record.chartID, art)) {
+				record.chartID = known->second;
+			}
+			else {
+				fRecords.erase(known->second);
+			}
+		}
+
+		Index(record);
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+
+	return result;
+}
+
+/*
+*/
+void ChartRegistry::Index(ChartRecord& record)
+{
+	// A chart saved without an ID, or a copy of another chart carrying the same one, is
+	// given its own. Only the index holds it until the chart is next drawn, which writes
+	// it, so opening a document does not change it.
+	if (record.chartID <= 0 || IsTaken(record.chartID, record.art)) {
+		record.chartID = ChartItem::AllocateChartID();
+	}
+	else {
+		ChartItem::ReserveChartID(record.chartID);
+	}
+
+	fRecords[record.chartID] = record;
+	fArtIndex[record.art] = record.chartID;
+}
+
+/*
+*/
+AIBoolean ChartRegistry::IsTaken(ai::int32 chartID, AIArtHandle art) const
+{
+	auto existing = fRecords.find(chartID);
+	return existing != fRecords.end() && existing->second.art != art && sAIArt->ValidArt(existing->second.art, false);
+}
+
+/*
+*/
+void ChartRegistry::Unregister(ai::int32 chartID)
+{
+	auto it = fRecords.find(chartID);
+	if (it != fRecords.end()) {
+		fArtIndex.erase(it->second.art);
+		fRecords.erase(it);
+	}
+}
+
+/*
+*/
+ASErr ChartRegistry::Validate()
+{
+	ASErr result = kNoErr;
+
+	try {
+		for (auto it = fRecords.begin(); it != fRecords.end(); ) {
+			ChartRecord& record = it->second;
+			if (!sAIArt->ValidArt(record.art, false)) {
+				fArtIndex.erase(record.art);
+				it = fRecords.erase(it);
+				continue;
+			}
+
+			AIRealRect artBounds;
+			result = sAIArt->GetArtBounds(record.art, &artBounds);
+			aisdk::check_ai_error(result);
+
+			// A chart that has been moved keeps its size; carry the plot area along with it
+			AIReal dh = artBounds.left - record.artBounds.left;
+			AIReal dv = artBounds.top - record.artBounds.top;
+			AIReal dWidth = (artBounds.right - artBounds.left) - (record.artBounds.right - record.artBounds.left);
+			AIReal dHeight = (artBounds.top - artBounds.bottom) - (record.artBounds.top - record.artBounds.bottom);
+			if ((dh != 0 || dv != 0) && dWidth == 0 && dHeight == 0) {
+				record.plotBounds.left += dh;
+				record.plotBounds.right += dh;
+				record.plotBounds.top += dv;
+				record.plotBounds.bottom += dv;
+
+				AIDictionaryRef dict = nullptr;
+				result = sAIArt->GetDictionary(record.art, &dict);
+				aisdk::check_ai_error(result);
+				result = sAIDictionary->SetBinaryEntry(dict, sAIDictionary->Key(kChartBoundsDictKey), &record.plotBounds, sizeof(AIRealRect));
+				sAIDictionary->Release(dict);
+				aisdk::check_ai_error(result);
+			}
+			record.artBounds = artBounds;
+			++it;
+		}
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+
+	return result;
+}
+
+/*
+*/
+ASErr ChartRegistry::RegisterSelection()
+{
+	ASErr result = kNoErr;
+	AIArtHandle** selection = nullptr;
+
+	try {
+		ai::int32 count = 0;
+		result = sAIMatchingArt->GetSelectedArt(&selection, &count);
+		aisdk::check_ai_error(result);
+
+		for (ai::int32 i = 0; i < count; i++) {
+			AIArtHandle art = (*selection)[i];
+			if (fArtIndex.find(art) == fArtIndex.end() && ChartItem::IsChartArt(art)) {
+				result = Register(art);
+				aisdk::check_ai_error(result);
+			}
+		}
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+
+	if (selection) {
+		sAIMdMemory->MdMemoryDisposeHandle((AIMdMemoryHandle)selection);
+	}
+
+	return result;
+}
+
+/*
+*/
+const ChartRecord* ChartRegistry::Find(ai::int32 chartID) const
+{
+	auto it = fRecords.find(chartID);
+	if (it != fRecords.end() && sAIArt->ValidArt(it->second.art, false)) {
+		return &it->second;
+	}
+	return nullptr;
+}
+
+/*
+*/
+const ChartRecord* ChartRegistry::FindOwner(AIArtHandle art) const
+{
+	// Walk up from the hit art; depth is bounded by the chart's component nesting
+	while (art != nullptr) {
+		auto it = fArtIndex.find(art);
+		if (it != fArtIndex.end()) {
+			return Find(it->second);
+		}
+
+		AIArtHandle parent = nullptr;
+		if (sAIArt->GetArtParent(art, &parent) != kNoErr) {
+			break;
+		}
+		art = parent;
+	}
+	return nullptr;
+}
+
+/*
+*/
+const ChartRecord* ChartRegistry::FindSelected() const
+{
+	const ChartRecord* record = nullptr;
+	AIArtHandle** selection = nullptr;
+	ai::int32 count = 0;
+	if (sAIMatchingArt->GetSelectedArt(&selection, &count) == kNoErr && selection) {
+		for (ai::int32 i = 0; i < count && !record; i++) {
+			record = FindOwner((*selection)[i]);
+		}
+		sAIMdMemory->MdMemoryDisposeHandle((AIMdMemoryHandle)selection);
+	}
+	return record;
+}
+
+/*
+*/
+void ChartRegistry::Clear()
+{
+	fRecords.clear();
+	fArtIndex.clear();
+}
+
+/*
+*/
+ASErr ChartRegistry::ReadRecord(AIArtHandle art, ChartRecord& record)
+{
+	ASErr result = kNoErr;
+	AIDictionaryRef dict = nullptr;
+
+	try {
+		if (!ChartItem::IsChartArt(art)) {
+			return kBadParameterErr;
+		}
+
+		result = sAIArt->GetDictionary(art, &dict);
+		aisdk::check_ai_error(result);
+
+		record.art = art;
+
+		// Charts saved before IDs were written read as 0, and are given one when indexed
+		record.chartID = 0;
+		if (sAIDictionary->GetIntegerEntry(dict, sAIDictionary->Key(kChartIDDictKey), &record.chartID) != kNoErr) {
+			record.chartID = 0;
+		}
+
+		ai::int32 chartType = kChartTypeColumn;
+		sAIDictionary->GetIntegerEntry(dict, sAIDictionary->Key(kChartTypeDictKey), &chartType);
+		record.chartType = (ChartType)chartType;
+
+		record.version = 1;
+		sAIDictionary->GetIntegerEntry(dict, sAIDictionary->Key(kChartVersionDictKey), &record.version);
+
+		result = ChartItem::ReadDataRef(dict, record.dataRef);
+		aisdk::check_ai_error(result);
+
+		result = ChartItem::ReadOptions(dict, record.options);
+		aisdk::check_ai_error(result);
+
+		record.detailLevel = kChartMaxDetailLevel;
+		sAIDictionary->GetIntegerEntry(dict, sAIDictionary->Key(kChartDetailLevelDictKey), &record.detailLevel);
+
+		result = sAIArt->GetArtBounds(art, &record.artBounds);
+		aisdk::check_ai_error(result);
+
+		ai::int32 size = sizeof(AIRealRect);
+		result = sAIDictionary->GetBinaryEntry(dict, sAIDictionary->Key(kChartBoundsDictKey), &record.plotBounds, &size);
+		if (result != kNoErr || size != sizeof(AIRealRect)) {
+			record.plotBounds = record.artBounds;
+		}
+
+		result = kNoErr;
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+
+	if (dict) {
+		sAIDictionary->Release(dict);
+	}
+
+	return result;
+}
@@ -0,0 +1,156 @@
+//========================================================================================
+//  
+//  ChartRegistry.h
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#ifndef __ChartRegistry_h__
+#define __ChartRegistry_h__
+
+#include "IllustratorSDK.h"
+#include "ChartItem.h"
+#include <map>
+#include <unordered_map>
+
+/** Index entry describing one chart in a document.
+*/
+struct ChartRecord {
+	/** Chart ID as stored in the chart dictionary.
+	*/
+	ai::int32 chartID;
+
+	/** The chart group art.
+	*/
+	AIArtHandle art;
+
+	/** The plot area the chart was laid out in, in artwork coordinates.
+	*/
+	AIRealRect plotBounds;
+
+	/** The art bounds of the chart group when last validated.
+	*/
+	AIRealRect artBounds;
+
+	/** Chart header values read from the chart dictionary.
+	*/
+	ChartType chartType;
+	ai::int32 version;
+
+	/** The shared dataset and columns the chart is drawn from.
+	*/
+	ChartDataRef dataRef;
+
+	/** The chart's presentation options.
+	*/
+	ChartOptions options;
+
+	/** Level of detail the chart was last drawn at, if its options make it adaptive.
+	*/
+	ai::int32 detailLevel;
+};
+
+/** Per-document index of chart art, keyed by chart ID.
+
+	The registry is built by a single scan of the document when it is opened
+	and is then kept current by the plug-in's notifiers, so that operations
+	that need to find charts (refresh, hit-testing) never walk the art tree.
+*/
+class ChartRegistry
+{
+public:
+	typedef std::map<ai::int32, ChartRecord> RecordMap;
+
+	/** Discards the index and rebuilds it with one scan of the current document.
+		@return kNoErr on success, other ASErr otherwise.
+	*/
+	ASErr Rebuild();
+
+	/** Adds a chart group to the index, or refreshes its entry if already indexed.
+		A chart without an ID, or whose ID collides with another indexed chart (for
+		example after a duplicate or paste), is given a fresh ID in the index only;
+		the chart's dictionary is left as it is until the chart is next drawn.
+		@param art IN the chart group.
+		@return kNoErr on success, kBadParameterErr if art is not a chart.
+	*/
+	ASErr Register(AIArtHandle art);
+
+	/** Removes a chart from the index.
+		@param chartID IN ID of the chart to remove.
+	*/
+	void Unregister(ai::int32 chartID);
+
+	/** Drops entries whose art no longer exists and refreshes the bounds of
+		the remaining entries. Cost is proportional to the number of charts,
+		not the size of the document.
+		@return kNoErr on success, other ASErr otherwise.
+	*/
+	ASErr Validate();
+
+	/** Indexes any selected chart groups that are not yet known, which picks up
+		charts that arrive through paste, duplicate or undo.
+		@return kNoErr on success, other ASErr otherwise.
+	*/
+	ASErr RegisterSelection();
+
+	/** Looks up a chart by ID.
+		@param chartID IN the chart ID.
+		@return the record, or nullptr if unknown.
+	*/
+	const ChartRecord* Find(ai::int32 chartID) const;
+
+	/** Looks up the chart that owns an art object, which may be the chart group
+		itself or any art nested inside it.
+		@param art IN the art to look up, typically the result of a hit test.
+		@return the record, or nullptr if the art is not part of a chart.
+	*/
+	const ChartRecord* FindOwner(AIArtHandle art) const;
+
+	/** Looks up the chart that owns the first selected art belonging to one.
+		@return the record, or nullptr if no chart is selected.
+	*/
+	const ChartRecord* FindSelected() const;
+
+	/** All indexed charts, ordered by chart ID.
+	*/
+	const RecordMap& GetRecords() const { return fRecords; }
+
+	/** Number of indexed charts.
+	*/
+	size_t Size() const { return fRecords.size(); }
+
+	/** Empties the index.
+	*/
+	void Clear();
+
+private:
+	/** Reads the index entry for a chart group from its dictionary, with a chart ID
+		of 0 if it has none. Does not modify the dictionary.
+	*/
+	static ASErr ReadRecord(AIArtHandle art, ChartRecord& record);
+
+	/** Indexes a record, first giving it a fresh chart ID if it has none or its ID
+		belongs to other art.
+	*/
+	void Index(ChartRecord& record);
+
+	/** Reports whether chartID is indexed for art other than art.
+	*/
+	AIBoolean IsTaken(ai::int32 chartID, AIArtHandle art) const;
+
+	/** Chart records keyed by chart ID.
+	*/
+	RecordMap fRecords;
+
+	/** Reverse index from chart group art to chart ID.
+	*/
+	std::unordered_map<AIArtHandle, ai::int32> fArtIndex;
+};
+
+#endif // __ChartRegistry_h__
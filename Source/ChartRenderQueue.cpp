@@ -0,0 +1,290 @@
+//========================================================================================
+//  
+//  ChartRenderQueue.cpp
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#include "IllustratorSDK.h"
+#include "ChartRenderQueue.h"
+#include "ChartItem.h"
+#include "ChartsSuites.h"
+#include "SDKErrors.h"
+#include <algorithm>
+
+namespace {
+
+// Primitives emitted between checks of the clock, small enough not to overrun a slice
+const size_t kPrimitivesPerCheck = 64;
+
+size_t GetTimeStamp(AIArtHandle art)
+{
+	size_t timeStamp = 0;
+	sAIArt->GetArtTimeStamp(art, kAITimeStampMaxFromArtAndChildren, &timeStamp);
+	return timeStamp;
+}
+
+} // namespace
+
+/*
+*/
+ChartRenderJob::ChartRenderJob(AIArtHandle chartArt, ai::int32 chartID, ChartEmitMode emitMode, ChartMarkerMode markerMode, ChartRetainedArt* retained) :
+	fArt(chartArt), fChartID(chartID), fDocument(nullptr), fEmitMode(emitMode), fMarkerMode(markerMode), fRetained(retained),
+	fCursor(chartArt), fEmitter(fStyles, emitMode, markerMode), fTimeStamp(0)
+{
+	sAIDocument->GetDocument(&fDocument);
+}
+
+/*
+*/
+ASErr ChartRenderJob::Start(ChartDisplayList& list, const std::vector<std::string>& seriesNames, const ChartDisplayList* previous)
+{
+	ASErr result = kNoErr;
+
+	try {
+		fList.Swap(list);
+		list.Clear();
+
+		// The retained list stops describing the art with the first slice
+		if (fRetained) {
+			fRetained->Invalidate();
+		}
+
+		result = MarkIncomplete(true);
+		aisdk::check_ai_error(result);
+
+		result = fStyles.BindToDocument(seriesNames);
+		aisdk::check_ai_error(result);
+
+		if (previous) {
+			ChartDisplayList::Diff(*previous, fList, fDiff);
+		}
+		else {
+			// The skeleton's groups are taken whole by the slices, which fill in the data
+			// groups it left empty
+			ChartDisplayList skeleton;
+			ChartDisplayList::BuildSkeleton(fList, skeleton);
+
+			ChartArtCursor components(fArt);
+			ChartDisplayEmitter emitter(fStyles, fEmitMode, fMarkerMode);
+			result = emitter.Emit(skeleton, components);
+			aisdk::check_ai_error(result);
+
+			result = components.Finish();
+			aisdk::check_ai_error(result);
+
+			ChartDisplayList::Diff(skeleton, fList, fDiff);
+		}
+
+		fCursor = ChartArtCursor(fArt);
+		fEmitter.Begin(fList, fCursor, &fDiff);
+		fTimeStamp = GetTimeStamp(fArt);
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+
+	return result;
+}
+
+/*
+*/
+ASErr ChartRenderJob::Resume(Clock::time_point deadline, AIBoolean* done, AIBoolean* edited)
+{
+	ASErr result = kNoErr;
+	*done = false;
+	*edited = false;
+
+	try {
+		// The cursor and open groups hold art handles, which an edit may have disposed
+		if (!sAIArt->ValidArt(fArt, false) || GetTimeStamp(fArt) != fTimeStamp) {
+			fEmitter.Cancel();
+			*edited = true;
+			return kNoErr;
+		}
+
+		do {
+			result = fEmitter.Resume(kPrimitivesPerCheck, done);
+			aisdk::check_ai_error(result);
+		} while (!*done && Clock::now() < deadline);
+
+		if (*done) {
+			result = fCursor.Finish();
+			aisdk::check_ai_error(result);
+
+			result = MarkIncomplete(false);
+			aisdk::check_ai_error(result);
+
+			if (fRetained) {
+				fRetained->Retain(fArt, fList, fEmitMode, fMarkerMode);
+			}
+		}
+		fTimeStamp = GetTimeStamp(fArt);
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+		fEmitter.Cancel();
+		*done = true;
+	}
+
+	return result;
+}
+
+/*
+*/
+void ChartRenderJob::Resync()
+{
+	fTimeStamp = GetTimeStamp(fArt);
+}
+
+/*
+*/
+double ChartRenderJob::GetProgress() const
+{
+	return fList.GetSize() > 0 ? (double)fEmitter.GetPosition() / (double)fList.GetSize() : 1.0;
+}
+
+/*
+*/
+ASErr ChartRenderJob::MarkIncomplete(AIBoolean incomplete)
+{
+	AIDictionaryRef dict = nullptr;
+	ASErr result = sAIArt->GetDictionary(fArt, &dict);
+	if (result != kNoErr || !dict) {
+		return result;
+	}
+
+	if (incomplete) {
+		result = sAIDictionary->SetBooleanEntry(dict, sAIDictionary->Key(kChartIncompleteDictKey), true);
+	}
+	else {
+		sAIDictionary->DeleteEntry(dict, sAIDictionary->Key(kChartIncompleteDictKey));
+	}
+	sAIDictionary->Release(dict);
+	return result;
+}
+
+/*
+*/
+ASErr ChartRenderQueue::Start(AIArtHandle chartArt, ai::int32 chartID, ChartDisplayList& list, const std::vector<std::string>& seriesNames,
+	ChartEmitMode emitMode, ChartMarkerMode markerMode, ChartRetainedArt* retained, const ChartDisplayList* previous)
+{
+	ASErr result = kNoErr;
+
+	try {
+		Cancel(chartArt);
+
+		std::unique_ptr<ChartRenderJob> job(new ChartRenderJob(chartArt, chartID, emitMode, markerMode, retained));
+		result = job->Start(list, seriesNames, previous);
+		aisdk::check_ai_error(result);
+
+		fJobs.push_back(std::move(job));
+		UpdateTimer();
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+
+	return result;
+}
+
+/*
+*/
+void ChartRenderQueue::Cancel(AIArtHandle chartArt)
+{
+	fJobs.erase(std::remove_if(fJobs.begin(), fJobs.end(),
+		[chartArt](const std::unique_ptr<ChartRenderJob>& job) { return job->GetArt() == chartArt; }), fJobs.end());
+	UpdateTimer();
+}
+
+/*
+*/
+void ChartRenderQueue::Resync(AIArtHandle chartArt)
+{
+	for (const std::unique_ptr<ChartRenderJob>& job : fJobs) {
+		if (job->GetArt() == chartArt) {
+			job->Resync();
+		}
+	}
+}
+
+/*
+*/
+ASErr ChartRenderQueue::RunSlice(std::vector<ai::int32>& edited)
+{
+	ASErr result = kNoErr;
+
+	try {
+		AIDocumentHandle document = nullptr;
+		result = sAIDocument->GetDocument(&document);
+		if (result != kNoErr || !document) {
+			return kNoErr;
+		}
+
+		// Jobs share the slice in order, so charts complete one after another
+		const ChartRenderJob::Clock::time_point deadline = ChartRenderJob::Clock::now() + std::chrono::milliseconds(fSliceMilliseconds);
+		AIBoolean ran = false;
+		size_t index = 0;
+		while (index < fJobs.size() && ChartRenderJob::Clock::now() < deadline) {
+			ChartRenderJob& job = *fJobs[index];
+			if (job.GetDocument() != document) {
+				index++;
+				continue;
+			}
+
+			ran = true;
+			AIBoolean done = false;
+			AIBoolean jobEdited = false;
+			const ASErr jobResult = job.Resume(deadline, &done, &jobEdited);
+			if (jobEdited) {
+				edited.push_back(job.GetChartID());
+			}
+			if (done || jobEdited || jobResult != kNoErr) {
+				fJobs.erase(fJobs.begin() + index);
+			}
+			else {
+				index++;
+			}
+			if (jobResult != kNoErr) {
+				result = jobResult;
+			}
+		}
+
+		// A slice is part of the edit that started its chart, not an undo step of its own
+		if (ran) {
+			sAIUndo->SetSilent(true);
+		}
+		UpdateTimer();
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+
+	return result;
+}
+
+/*
+*/
+void ChartRenderQueue::Prune(const std::vector<AIDocumentHandle>& openDocuments)
+{
+	fJobs.erase(std::remove_if(fJobs.begin(), fJobs.end(),
+		[&openDocuments](const std::unique_ptr<ChartRenderJob>& job) {
+			return std::find(openDocuments.begin(), openDocuments.end(), job->GetDocument()) == openDocuments.end();
+		}), fJobs.end());
+	UpdateTimer();
+}
+
+/*
+*/
+void ChartRenderQueue::UpdateTimer()
+{
+	if (fTimer) {
+		sAITimer->SetTimerActive(fTimer, !fJobs.empty());
+	}
+}
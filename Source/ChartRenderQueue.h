@@ -0,0 +1,137 @@
+//========================================================================================
+//  
+//  ChartRenderQueue.h
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#ifndef __ChartRenderQueue_h__
+#define __ChartRenderQueue_h__
+
+// Progressive rendering of large charts. Drawing tens of thousands of marks in one call
+// holds up the application for as long as it takes, so a chart whose display list is
+// large enough is emitted by a job instead: the chart's skeleton of background, grids,
+// axes and labels at once, then its data marks in slices of a few milliseconds from an
+// idle timer. Until the last slice lands the chart's dictionary marks it incomplete.
+
+#include "IllustratorSDK.h"
+#include "ChartDisplayEmitter.h"
+#include <chrono>
+#include <memory>
+#include <vector>
+
+// Emission of one chart, resumable between slices. The job owns everything the
+// emission refers to, and trusts the chart's art only while its time stamp shows that
+// nothing but the job touched it.
+class ChartRenderJob {
+public:
+	typedef std::chrono::steady_clock Clock;
+
+	ChartRenderJob(AIArtHandle chartArt, ai::int32 chartID, ChartEmitMode emitMode, ChartMarkerMode markerMode, ChartRetainedArt* retained);
+
+	// Takes list's contents as the chart's art to emit and marks the chart incomplete.
+	// previous, if not null, is the list the chart's art was emitted from, untouched
+	// since; the job then rewrites only what changed. Otherwise the skeleton is emitted
+	// here, and the data marks are left for Resume.
+	ASErr Start(ChartDisplayList& list, const std::vector<std::string>& seriesNames, const ChartDisplayList* previous);
+
+	// Emits until deadline. done is set once the last mark is emitted, when the chart is
+	// marked complete and its list retained. edited is set instead if the chart was
+	// deleted or changed by anything but the job since its last slice; the job has then
+	// stopped, leaving the chart incomplete.
+	ASErr Resume(Clock::time_point deadline, AIBoolean* done, AIBoolean* edited);
+
+	// Takes the chart's current state as the job's own, after the caller changed the
+	// chart in a way that leaves its contents in place, such as selecting it
+	void Resync();
+
+	AIArtHandle GetArt() const { return fArt; }
+	ai::int32 GetChartID() const { return fChartID; }
+	AIDocumentHandle GetDocument() const { return fDocument; }
+
+	// Fraction of the chart's primitives emitted so far
+	double GetProgress() const;
+
+private:
+	// Sets or removes the chart's incomplete mark
+	ASErr MarkIncomplete(AIBoolean incomplete);
+
+	AIArtHandle fArt;
+	ai::int32 fChartID;
+	AIDocumentHandle fDocument;
+	ChartEmitMode fEmitMode;
+	ChartMarkerMode fMarkerMode;
+	ChartRetainedArt* fRetained;
+
+	ChartDisplayList fList;
+	ChartDisplayDiff fDiff;
+	ChartStyleTable fStyles;
+	ChartArtCursor fCursor;
+	ChartDisplayEmitter fEmitter;
+	size_t fTimeStamp;
+};
+
+// The render jobs of every open document, run one slice per timer tick. Jobs of the
+// current document run in the order they were started; the others wait until their
+// document is current again.
+class ChartRenderQueue {
+public:
+	// Display lists with more primitives than this are emitted progressively
+	static const size_t kDefaultThreshold = 20000;
+
+	// Time given to each slice
+	static const int kDefaultSliceMilliseconds = 4;
+
+	ChartRenderQueue() : fThreshold(kDefaultThreshold), fSliceMilliseconds(kDefaultSliceMilliseconds), fTimer(nullptr) {}
+
+	// The timer whose ticks run slices; the queue keeps it active only while it has jobs
+	void SetTimer(AITimerHandle timer) { fTimer = timer; }
+
+	// Primitive count above which charts are emitted progressively; 0 disables it
+	void SetThreshold(size_t threshold) { fThreshold = threshold; }
+	size_t GetThreshold() const { return fThreshold; }
+
+	void SetSliceMilliseconds(int milliseconds) { fSliceMilliseconds = milliseconds; }
+	int GetSliceMilliseconds() const { return fSliceMilliseconds; }
+
+	// Whether list is large enough to emit in slices
+	AIBoolean Wants(const ChartDisplayList& list) const { return fThreshold > 0 && list.GetSize() > fThreshold; }
+
+	// Starts emitting list, taking its contents, into chartArt, in place of any job the
+	// chart already has. Arguments are as for ChartRenderJob::Start.
+	ASErr Start(AIArtHandle chartArt, ai::int32 chartID, ChartDisplayList& list, const std::vector<std::string>& seriesNames,
+		ChartEmitMode emitMode, ChartMarkerMode markerMode, ChartRetainedArt* retained, const ChartDisplayList* previous);
+
+	// Stops a chart's job, leaving its art as far as it got
+	void Cancel(AIArtHandle chartArt);
+
+	// As ChartRenderJob::Resync, for a chart with a job
+	void Resync(AIArtHandle chartArt);
+
+	// Runs one slice of the current document's jobs. The IDs of charts that were edited
+	// mid render are appended to edited; their jobs are dropped, to be restarted by the
+	// caller if it wants the charts complete.
+	ASErr RunSlice(std::vector<ai::int32>& edited);
+
+	// Drops the jobs of documents that are no longer open
+	void Prune(const std::vector<AIDocumentHandle>& openDocuments);
+
+	AIBoolean IsEmpty() const { return fJobs.empty(); }
+
+private:
+	// Activates the timer while there are jobs
+	void UpdateTimer();
+
+	std::vector<std::unique_ptr<ChartRenderJob> > fJobs;
+	size_t fThreshold;
+	int fSliceMilliseconds;
+	AITimerHandle fTimer;
+};
+
+#endif // __ChartRenderQueue_h__
@@ -0,0 +1,578 @@
+//========================================================================================
+//  
+//  ChartScale.cpp
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#include "ChartScale.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+// Ticks are at least this many font sizes apart, and further when their labels are wide
+const double kMinTickSpacingEms = 3.0;
+
+// Estimated label advance per character and the gap between neighbouring labels, in ems
+const double kLabelCharacterEms = 0.5;
+const double kLabelGapEms = 1.0;
+
+// Coarser and coarser candidates are tried until the labels fit; past this many the
+// coarsest is taken
+const int kMaxCandidates = 48;
+
+// Candidates with more ticks than this are passed over without being labeled
+const size_t kMaxCandidateTicks = 1000;
+
+const int64_t kSecondsPerDay = 86400;
+
+// 1970-01-05, the first Monday after the epoch, which weeks are counted from
+const int64_t kFirstMonday = 4 * kSecondsPerDay;
+
+// Ticks of a scale at one coarseness, the first and last being the ends of the axis
+struct Candidate {
+	std::vector<double> values;
+	std::vector<std::string> labels;
+};
+
+// The value in the scale's own units, in which it is linear
+double ToUnits(ChartScaleType type, double value)
+{
+	switch (type) {
+		case kChartScaleLog:
+			return value > 0 ? std::log10(value) : NAN;
+		case kChartScaleSymlog:
+			return std::copysign(std::log10(1 + std::fabs(value)), value);
+		default:
+			return value;
+	}
+}
+
+std::string FormatNumber(double value, int decimals, bool percent)
+{
+	char text[64];
+	if (std::fabs(value) >= 1e15) {
+		snprintf(text, sizeof(text), "%g", value);
+	}
+	else {
+		snprintf(text, sizeof(text), "%.*f", decimals, value);
+	}
+
+	// Rounding leaves small negative values as "-0"
+	std::string label = text;
+	if (label[0] == '-' && label.find_first_not_of("-0.") == std::string::npos) {
+		label.erase(0, 1);
+	}
+	if (percent) {
+		label += '%';
+	}
+	return label;
+}
+
+// Decimals that show every multiple of step exactly, for steps of 1, 2 or 5 times a power of ten
+int GetStepDecimals(double step)
+{
+	return std::max(0, (int)-std::floor(std::log10(step) + 1e-9));
+}
+
+// A power of ten, or its negative, as a plain number where that is short and in
+// exponent form otherwise
+std::string FormatPower(double value, bool percent)
+{
+	const double magnitude = std::fabs(value);
+	if (magnitude == 0 || (magnitude >= 1e-4 && magnitude < 1e7)) {
+		return FormatNumber(value, magnitude > 0 ? GetStepDecimals(magnitude) : 0, percent);
+	}
+
+	char text[32];
+	snprintf(text, sizeof(text), "%s1e%d%s", value < 0 ? "-" : "", (int)std::lround(std::log10(magnitude)), percent ? "%" : "");
+	return text;
+}
+
+// The proleptic Gregorian calendar date of a day number counted from 1970-01-01, and
+// back; from Howard Hinnant's date algorithms
+void CivilFromDays(int64_t days, int64_t& year, int& month, int& day)
+{
+	days += 719468;
+	const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+	const int64_t dayOfEra = days - era * 146097;
+	const int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+	const int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+	const int64_t monthIndex = (5 * dayOfYear + 2) / 153;
+	day = (int)(dayOfYear - (153 * monthIndex + 2) / 5 + 1);
+	month = (int)(monthIndex < 10 ? monthIndex + 3 : monthIndex - 9);
+	year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+}
+
+int64_t DaysFromCivil(int64_t year, int month, int day)
+{
+	year -= month <= 2 ? 1 : 0;
+	const int64_t era = (year >= 0 ? year : year - 399) / 400;
+	const int64_t yearOfEra = year - era * 400;
+	const int64_t dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+	const int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+	return era * 146097 + dayOfEra - 719468;
+}
+
+int64_t FloorDiv(int64_t a, int64_t b)
+{
+	return a / b - ((a % b != 0 && (a < 0) != (b < 0)) ? 1 : 0);
+}
+
+// Calendar units time ticks step by, finest first. Months are used when months is not
+// 0, seconds otherwise. Years continue past the table in 1, 2, 5 steps.
+enum TimeFormat {
+	kTimeSeconds = 0,
+	kTimeMinutes,
+	kTimeDays,
+	kTimeMonths,
+	kTimeYears
+};
+
+struct TimeUnit {
+	int64_t seconds;
+	int64_t months;
+	TimeFormat format;
+};
+
+const TimeUnit kTimeUnits[] = {
+	{1, 0, kTimeSeconds}, {5, 0, kTimeSeconds}, {15, 0, kTimeSeconds}, {30, 0, kTimeSeconds},
+	{60, 0, kTimeMinutes}, {5 * 60, 0, kTimeMinutes}, {15 * 60, 0, kTimeMinutes}, {30 * 60, 0, kTimeMinutes},
+	{3600, 0, kTimeMinutes}, {3 * 3600, 0, kTimeMinutes}, {6 * 3600, 0, kTimeMinutes}, {12 * 3600, 0, kTimeMinutes},
+	{kSecondsPerDay, 0, kTimeDays}, {2 * kSecondsPerDay, 0, kTimeDays}, {7 * kSecondsPerDay, 0, kTimeDays},
+	{0, 1, kTimeMonths}, {0, 3, kTimeMonths}, {0, 6, kTimeMonths}
+};
+const int kTimeUnitCount = sizeof(kTimeUnits) / sizeof(kTimeUnits[0]);
+
+std::string FormatTime(double seconds, TimeFormat format)
+{
+	const int64_t whole = (int64_t)std::floor(seconds);
+	const int64_t days = FloorDiv(whole, kSecondsPerDay);
+	const int64_t secondOfDay = whole - days * kSecondsPerDay;
+	int64_t year = 0;
+	int month = 0, day = 0;
+	CivilFromDays(days, year, month, day);
+
+	char text[48];
+	switch (format) {
+		case kTimeSeconds:
+			snprintf(text, sizeof(text), "%02d:%02d:%02d", (int)(secondOfDay / 3600), (int)(secondOfDay / 60 % 60), (int)(secondOfDay % 60));
+			break;
+		case kTimeMinutes:
+			snprintf(text, sizeof(text), "%02d:%02d", (int)(secondOfDay / 3600), (int)(secondOfDay / 60 % 60));
+			break;
+		case kTimeDays:
+			snprintf(text, sizeof(text), "%lld-%02d-%02d", (long long)year, month, day);
+			break;
+		case kTimeMonths:
+			snprintf(text, sizeof(text), "%lld-%02d", (long long)year, month);
+			break;
+		default:
+			snprintf(text, sizeof(text), "%lld", (long long)year);
+			break;
+	}
+	return text;
+}
+
+// Multiples of step from the last at or below lo to the first at or above hi
+bool MakeSteps(double lo, double hi, double step, Candidate& candidate)
+{
+	const double first = std::floor(lo / step);
+	const double last = std::ceil(hi / step);
+	if (!(last - first < kMaxCandidateTicks)) {
+		return false;
+	}
+	for (double i = first; i <= last; i++) {
+		// Snap the rounding error of multiples near zero
+		const double value = i * step;
+		candidate.values.push_back(std::fabs(value) < step * 1e-9 ? 0 : value);
+	}
+	if (candidate.values.size() < 2) {
+		candidate.values.push_back(candidate.values.back() + step);
+	}
+	return true;
+}
+
+// Linear ticks at the index-th of the steps 1, 2 and 5 times a power of ten, counting from
+// 10 to the exponent
+bool MakeLinear(const ChartScaleSpec& spec, double lo, double hi, int exponent, int index, Candidate& candidate)
+{
+	static const double kMultiples[3] = {1, 2, 5};
+	const double step = kMultiples[index % 3] * std::pow(10.0, exponent + index / 3);
+	if (!MakeSteps(lo, hi, step, candidate)) {
+		return false;
+	}
+
+	const int decimals = GetStepDecimals(step);
+	for (double value : candidate.values) {
+		candidate.labels.push_back(FormatNumber(value, decimals, spec.percent));
+	}
+	return true;
+}
+
+// Decades of a log scale, every stride decades; with a stride of 0, every decade with 2
+// and 5 times it between
+bool MakeLog(const ChartScaleSpec& spec, double lo, double hi, int stride, Candidate& candidate)
+{
+	const int step = std::max(1, stride);
+	int first = (int)std::floor(std::log10(lo));
+	int last = (int)std::ceil(std::log10(hi));
+	if (last == first) {
+		last++;
+	}
+	first = (int)FloorDiv(first, step) * step;
+	last = -(int)FloorDiv(-last, step) * step;
+	if ((size_t)((last - first) / step) >= kMaxCandidateTicks) {
+		return false;
+	}
+
+	for (int decade = first; decade <= last; decade += step) {
+		const double power = std::pow(10.0, decade);
+		candidate.values.push_back(power);
+		if (stride == 0 && decade < last) {
+			candidate.values.push_back(2 * power);
+			candidate.values.push_back(5 * power);
+		}
+	}
+	for (double value : candidate.values) {
+		candidate.labels.push_back(FormatPower(value, spec.percent));
+	}
+	return true;
+}
+
+// Zero, where the range nears it, and the signed decades out to the ends of the range,
+// every stride decades
+bool MakeSymlog(const ChartScaleSpec& spec, double lo, double hi, int stride, Candidate& candidate)
+{
+	// Decades of one side of zero from magnitude from to magnitude to. Within 1 of zero,
+	// where the scale is close to linear, zero is the tick, and the decades start one
+	// stride out from it.
+	auto addSide = [stride](double from, double to, double sign, std::vector<double>& values) {
+		auto decadeOf = [](double magnitude) { return magnitude > 1 ? (int)std::ceil(std::log10(magnitude) - 1e-12) : 0; };
+		const int first = from > 1 ? (int)FloorDiv((int64_t)std::floor(std::log10(from) + 1e-12), stride) * stride : stride;
+		const int last = std::max(first, -(int)FloorDiv(-decadeOf(to), stride) * stride);
+		if ((size_t)((last - first) / stride) >= kMaxCandidateTicks) {
+			return false;
+		}
+		for (int decade = first; decade <= last; decade += stride) {
+			values.push_back(sign * std::pow(10.0, decade));
+		}
+		return true;
+	};
+
+	std::vector<double> negative;
+	std::vector<double> positive;
+	if (lo < 0 && !addSide(std::max(0.0, -hi), -lo, -1, negative)) {
+		return false;
+	}
+	if (hi > 0 && !addSide(std::max(0.0, lo), hi, 1, positive)) {
+		return false;
+	}
+
+	candidate.values.assign(negative.rbegin(), negative.rend());
+	if (lo <= 1 && hi >= -1) {
+		candidate.values.push_back(0);
+	}
+	candidate.values.insert(candidate.values.end(), positive.begin(), positive.end());
+
+	for (double value : candidate.values) {
+		candidate.labels.push_back(FormatPower(value, spec.percent));
+	}
+	return true;
+}
+
+// Time ticks on the index-th calendar unit, years in 1, 2 and 5 steps past the table
+bool MakeTime(double lo, double hi, int index, Candidate& candidate)
+{
+	TimeUnit unit;
+	if (index < kTimeUnitCount) {
+		unit = kTimeUnits[index];
+	}
+	else {
+		static const int64_t kMultiples[3] = {1, 2, 5};
+		const int years = index - kTimeUnitCount;
+		int64_t power = 1;
+		for (int i = 0; i < years / 3 && power < INT64_C(1000000000); i++) {
+			power *= 10;
+		}
+		unit = {0, 12 * kMultiples[years % 3] * power, kTimeYears};
+	}
+
+	if (unit.months == 0) {
+		// Weeks start on Mondays; shorter units on the epoch's own boundaries
+		const int64_t origin = unit.seconds == 7 * kSecondsPerDay ? kFirstMonday : 0;
+		const double first = std::floor((lo - origin) / unit.seconds);
+		const double last = std::ceil((hi - origin) / unit.seconds);
+		if (!(last - first < kMaxCandidateTicks)) {
+			return false;
+		}
+		for (double i = first; i <= std::max(last, first + 1); i++) {
+			candidate.values.push_back(origin + i * unit.seconds);
+		}
+	}
+	else {
+		// Months counted from year 0, stepped on multiples of the unit so quarters start
+		// in January, April, July and October and decades on years ending in 0
+		auto monthOf = [](double seconds) {
+			int64_t year = 0;
+			int month = 0, day = 0;
+			CivilFromDays(FloorDiv((int64_t)std::floor(seconds), kSecondsPerDay), year, month, day);
+			return year * 12 + (month - 1);
+		};
+		auto startOf = [](int64_t monthIndex) {
+			const int64_t year = FloorDiv(monthIndex, 12);
+			return (double)(DaysFromCivil(year, (int)(monthIndex - year * 12) + 1, 1) * kSecondsPerDay);
+		};
+
+		if (!(std::fabs(lo) < 1e17 && std::fabs(hi) < 1e17)) {
+			return false;
+		}
+		const int64_t first = FloorDiv(monthOf(lo), unit.months) * unit.months;
+		int64_t last = FloorDiv(monthOf(hi), unit.months) * unit.months;
+		if (startOf(last) < hi) {
+			last += unit.months;
+		}
+		last = std::max(last, first + unit.months);
+		if ((last - first) / unit.months >= (int64_t)kMaxCandidateTicks) {
+			return false;
+		}
+		for (int64_t month = first; month <= last; month += unit.months) {
+			candidate.values.push_back(startOf(month));
+		}
+	}
+
+	for (double value : candidate.values) {
+		candidate.labels.push_back(FormatTime(value, unit.format));
+	}
+	return true;
+}
+
+} // namespace
+
+/*
+*/
+void ChartScale::Compute(const ChartScaleSpec& spec, ChartScale& scale)
+{
+	const ChartScaleType type = spec.type >= 0 && spec.type < kChartScaleTypeCount ? (ChartScaleType)spec.type : kChartScaleLinear;
+	const double length = std::isfinite(spec.length) ? std::fabs(spec.length) : 0;
+	const double fontSize = std::isfinite(spec.fontSize) && spec.fontSize > 0 ? spec.fontSize : 12.0;
+
+	// The data range, reaching zero if asked and widened where it is empty
+	double lo = spec.min;
+	double hi = spec.max;
+	if (!std::isfinite(lo) || !std::isfinite(hi) || lo > hi) {
+		lo = 0;
+		hi = type == kChartScaleTime ? kSecondsPerDay : type == kChartScaleLog ? 10 : 1;
+	}
+	if (type == kChartScaleLog) {
+		// Values that are not positive cannot be shown; an axis of none shows three decades
+		if (!(hi > 0)) {
+			lo = 1;
+			hi = 10;
+		}
+		else if (!(lo > 0)) {
+			lo = hi / 1000;
+		}
+	}
+	else if (spec.includeZero) {
+		lo = std::min(lo, 0.0);
+		hi = std::max(hi, 0.0);
+	}
+	if (lo == hi) {
+		const double widen = type == kChartScaleTime ? kSecondsPerDay / 2 : lo != 0 ? std::fabs(lo) / 2 : 1;
+		lo = type == kChartScaleLog || (spec.includeZero && lo == 0) ? lo : lo - widen;
+		hi += widen;
+	}
+
+	// The first candidate has as many ticks as the axis has room for at the closest
+	// spacing; coarser ones follow until the labels fit between their ticks
+	const int maxIntervals = std::max(1, (int)std::floor(length / (fontSize * kMinTickSpacingEms)));
+	const int linearExponent = (int)std::floor(std::log10((hi - lo) / maxIntervals));
+
+	Candidate chosen;
+	for (int index = 0; index < kMaxCandidates; index++) {
+		Candidate candidate;
+		bool made = false;
+		switch (type) {
+			case kChartScaleLog:
+				made = MakeLog(spec, lo, hi, index, candidate);
+				break;
+			case kChartScaleSymlog:
+				made = MakeSymlog(spec, lo, hi, index + 1, candidate);
+				break;
+			case kChartScaleTime:
+				made = MakeTime(lo, hi, index, candidate);
+				break;
+			default:
+				made = MakeLinear(spec, lo, hi, linearExponent, index, candidate);
+				break;
+		}
+		if (!made) {
+			continue;
+		}
+		chosen = std::move(candidate);
+
+		// The closest pair of ticks must clear the widest label
+		const double span = ToUnits(type, chosen.values.back()) - ToUnits(type, chosen.values.front());
+		double closest = length;
+		for (size_t i = 1; i < chosen.values.size(); i++) {
+			closest = std::min(closest, (ToUnits(type, chosen.values[i]) - ToUnits(type, chosen.values[i - 1])) / span * length);
+		}
+		size_t widest = 0;
+		for (const std::string& label : chosen.labels) {
+			widest = std::max(widest, label.size());
+		}
+		if (closest >= fontSize * std::max(kMinTickSpacingEms, widest * kLabelCharacterEms + kLabelGapEms)) {
+			break;
+		}
+	}
+	if (chosen.values.size() < 2) {
+		chosen.values = {lo, hi};
+		chosen.labels = {FormatNumber(lo, 0, spec.percent), FormatNumber(hi, 0, spec.percent)};
+	}
+
+	scale.fType = type;
+	scale.fMin = chosen.values.front();
+	scale.fMax = chosen.values.back();
+	scale.fLength = length;
+	const double minUnits = ToUnits(type, scale.fMin);
+	const double maxUnits = ToUnits(type, scale.fMax);
+	scale.fFactor = maxUnits > minUnits ? length / (maxUnits - minUnits) : 0;
+	scale.fOffset = -minUnits * scale.fFactor;
+
+	scale.fTicks.resize(chosen.values.size());
+	for (size_t i = 0; i < chosen.values.size(); i++) {
+		ChartTick& tick = scale.fTicks[i];
+		tick.value = chosen.values[i];
+		tick.position = scale.ToPlot(tick.value);
+		tick.label = std::move(chosen.labels[i]);
+	}
+}
+
+/*
+*/
+double ChartScale::ToPlot(double value) const
+{
+	return fOffset + ToUnits(fType, value) * fFactor;
+}
+
+/*
+*/
+void ChartScale::Transform(const double* in, double* out, size_t count, double origin) const
+{
+	if (IsLinear()) {
+		// Missing values stay NaN through the arithmetic
+		const double offset = origin + fOffset;
+		const double factor = fFactor;
+		for (size_t i = 0; i < count; i++) {
+			out[i] = offset + in[i] * factor;
+		}
+		return;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		out[i] = origin + ToPlot(in[i]);
+	}
+}
+
+/*
+*/
+double ChartScale::GetBaseline() const
+{
+	if (fType == kChartScaleLog) {
+		return 0;
+	}
+	return ToPlot(std::max(fMin, std::min(fMax, 0.0)));
+}
+
+/*
+*/
+ChartScaleCache::ChartScaleCache(size_t capacity) :
+	fCapacity(capacity > 0 ? capacity : 1), fHits(0), fMisses(0)
+{
+	fIndex.reserve(fCapacity);
+}
+
+/*
+*/
+std::string ChartScaleCache::MakeKey(const ChartScaleSpec& spec)
+{
+	// Fixed-size fields, so the parts cannot run into each other
+	const double numbers[4] = {spec.min, spec.max, spec.length, spec.fontSize};
+	const uint8_t flags[3] = {(uint8_t)spec.type, (uint8_t)spec.includeZero, (uint8_t)spec.percent};
+	std::string key(sizeof(numbers) + sizeof(flags), '\0');
+	memcpy(&key[0], numbers, sizeof(numbers));
+	memcpy(&key[sizeof(numbers)], flags, sizeof(flags));
+	return key;
+}
+
+/*
+*/
+std::shared_ptr<const ChartScale> ChartScaleCache::Get(const ChartScaleSpec& spec)
+{
+	std::string key = MakeKey(spec);
+
+	{
+		std::lock_guard<std::mutex> lock(fMutex);
+		auto found = fIndex.find(key);
+		if (found != fIndex.end()) {
+			fHits++;
+			fEntries.splice(fEntries.begin(), fEntries, found->second);
+			return found->second->second;
+		}
+	}
+
+	// Computed unlocked; two threads missing the same spec both compute it, and the
+	// second stores an equal scale over the first
+	fMisses++;
+	std::shared_ptr<ChartScale> scale = std::make_shared<ChartScale>();
+	ChartScale::Compute(spec, *scale);
+
+	std::lock_guard<std::mutex> lock(fMutex);
+	auto found = fIndex.find(key);
+	if (found != fIndex.end()) {
+		fEntries.erase(found->second);
+		fIndex.erase(found);
+	}
+	if (fEntries.size() >= fCapacity) {
+		fIndex.erase(fEntries.back().first);
+		fEntries.pop_back();
+	}
+	fEntries.emplace_front(key, scale);
+	fIndex.emplace(std::move(key), fEntries.begin());
+	return scale;
+}
+
+/*
+*/
+void ChartScaleCache::Clear()
+{
+	std::lock_guard<std::mutex> lock(fMutex);
+	fEntries.clear();
+	fIndex.clear();
+}
+
+/*
+*/
+size_t ChartScaleCache::GetSize() const
+{
+	std::lock_guard<std::mutex> lock(fMutex);
+	return fEntries.size();
+}
+
+/*
+*/
+ChartScaleCache& ChartScaleCache::GetShared()
+{
+	static ChartScaleCache shared;
+	return shared;
+}
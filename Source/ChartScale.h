@@ -0,0 +1,140 @@
+//========================================================================================
+//  
+//  ChartScale.h
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#ifndef __ChartScale_h__
+#define __ChartScale_h__
+
+// Axis scales: nice-number ticks, their labels, and the transform from data values to
+// distances along the axis, for linear, logarithmic, symmetric log and calendar time
+// axes. Ticks only change with the data range, the axis length and the label size, so
+// scales are memoized by those in a cache every layout shares. Free of Illustrator SDK
+// types, like the layout.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+enum ChartScaleType {
+	kChartScaleLinear = 0,
+	kChartScaleLog,			// Decades; only positive values are shown
+	kChartScaleSymlog,		// Logarithmic away from zero and linear through it, for either sign
+	kChartScaleTime,		// Seconds since 1970-01-01 UTC, ticked on calendar units
+	kChartScaleTypeCount
+};
+
+// Everything a scale is computed from
+struct ChartScaleSpec {
+	int32_t type;			// A ChartScaleType
+	double min, max;		// Data range; equal, or not finite, when there is no data to speak of
+	double length;			// Axis length, in points
+	double fontSize;		// Label size, which sets how closely ticks may be spaced
+	bool includeZero;		// The axis reaches zero, for marks measured from it
+	bool percent;			// Labels are percentages
+
+	ChartScaleSpec() : type(kChartScaleLinear), min(0), max(1), length(100), fontSize(12), includeZero(false), percent(false) {}
+};
+
+struct ChartTick {
+	double value;
+	double position;		// Distance along the axis from its start
+	std::string label;
+};
+
+// The ticks of an axis and the transform to it. The axis runs from the first tick to
+// the last, which enclose the data range.
+class ChartScale {
+public:
+	ChartScale() : fType(kChartScaleLinear), fMin(0), fMax(1), fLength(0), fOffset(0), fFactor(0) {}
+
+	// Computes the scale of spec, without the cache
+	static void Compute(const ChartScaleSpec& spec, ChartScale& scale);
+
+	ChartScaleType GetType() const { return fType; }
+	double GetMin() const { return fMin; }
+	double GetMax() const { return fMax; }
+	double GetLength() const { return fLength; }
+	const std::vector<ChartTick>& GetTicks() const { return fTicks; }
+
+	// Distance of value along the axis; NaN for values the scale cannot show: missing
+	// values, and values that are not positive on a log scale
+	double ToPlot(double value) const;
+
+	// out[i] = origin + ToPlot(in[i]) for count values. Linear and time scales transform
+	// in one branch-free pass the compiler vectorizes.
+	void Transform(const double* in, double* out, size_t count, double origin) const;
+
+	// Whether ToPlot(value) is GetOffset() + value * GetFactor(), for callers that fold
+	// the transform into loops of their own
+	bool IsLinear() const { return fType == kChartScaleLinear || fType == kChartScaleTime; }
+	double GetOffset() const { return fOffset; }
+	double GetFactor() const { return fFactor; }
+
+	// Where marks measured from zero, such as columns, start: zero's distance along the
+	// axis, or the nearer end when the axis does not reach zero
+	double GetBaseline() const;
+
+private:
+	ChartScaleType fType;
+	double fMin, fMax;
+	double fLength;
+	double fOffset, fFactor;	// Distance = fOffset + fFactor * the value in the scale's own units
+	std::vector<ChartTick> fTicks;
+};
+
+// Scales memoized by their spec. The least recently used are evicted beyond the
+// capacity. Safe to share between threads.
+class ChartScaleCache {
+public:
+	static const size_t kDefaultCapacity = 256;
+
+	explicit ChartScaleCache(size_t capacity = kDefaultCapacity);
+
+	// The scale of spec, computed on the first request and shared by later ones
+	std::shared_ptr<const ChartScale> Get(const ChartScaleSpec& spec);
+
+	void Clear();
+
+	size_t GetSize() const;
+	size_t GetCapacity() const { return fCapacity; }
+
+	// Hit-rate counters since the last reset
+	uint64_t GetHits() const { return fHits; }
+	uint64_t GetMisses() const { return fMisses; }
+	void ResetCounters() { fHits = 0; fMisses = 0; }
+
+	// The cache layouts compute their scales through
+	static ChartScaleCache& GetShared();
+
+private:
+	typedef std::list<std::pair<std::string, std::shared_ptr<const ChartScale> > > Entries;
+
+	static std::string MakeKey(const ChartScaleSpec& spec);
+
+	size_t fCapacity;
+
+	Entries fEntries;		// Most recently used first
+	std::unordered_map<std::string, Entries::iterator> fIndex;
+	mutable std::mutex fMutex;
+
+	std::atomic<uint64_t> fHits;
+	std::atomic<uint64_t> fMisses;
+};
+
+#endif // __ChartScale_h__
@@ -0,0 +1,270 @@
+//========================================================================================
+//  
+//  ChartStyleTable.cpp
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#include "IllustratorSDK.h"
+#include "ChartStyleTable.h"
+#include "ChartsSuites.h"
+#include "SDKErrors.h"
+
+namespace {
+
+// Graphic style names of the chart components, by role
+const char* const kRoleStyleNames[kChartStyleRoleCount] = {
+	"Chart Background",
+	"Chart Plot Area",
+	"Chart Grid",
+	"Chart Ticks",
+	"Chart Axes",
+	"Chart Leader Lines"
+};
+
+void SetGray(AIColor& color, AIReal gray)
+{
+	color.kind = kGrayColor;
+	color.c.g.gray = gray * kAIRealOne;
+}
+
+} // namespace
+
+/*
+*/
+AIPathStyle ChartStyleTable::MakeEmpty()
+{
+	AIPathStyle style;
+
+	style.fillPaint = false;
+	SetGray(style.fill.color, 0);
+	style.fill.overprint = false;
+
+	style.strokePaint = false;
+	SetGray(style.stroke.color, 1);
+	style.stroke.overprint = false;
+	style.stroke.width = 1.0;
+	style.stroke.dash.length = 0;
+	style.stroke.dash.offset = 0;
+	for (int i = 0; i < kMaxDashComponent; i++) {
+		style.stroke.dash.array[i] = 0;
+	}
+	style.stroke.cap = kAIButtCap;
+	style.stroke.join = kAIMiterJoin;
+	style.stroke.miterLimit = 4.0;
+
+	style.clip = false;
+	style.lockClip = false;
+	style.evenodd = false;
+	style.resolution = 800.0;
+
+	return style;
+}
+
+/*
+*/
+AIPathStyle ChartStyleTable::MakeStroke(AIReal gray, AIReal width)
+{
+	AIPathStyle style = MakeEmpty();
+	style.strokePaint = true;
+	SetGray(style.stroke.color, gray);
+	style.stroke.width = width;
+	return style;
+}
+
+/*
+*/
+AIPathStyle ChartStyleTable::MakeFilled(AIReal fillGray, AIReal strokeGray, AIReal strokeWidth)
+{
+	AIPathStyle style = MakeStroke(strokeGray, strokeWidth);
+	style.fillPaint = true;
+	SetGray(style.fill.color, fillGray);
+	return style;
+}
+
+/*
+*/
+AIPathStyle ChartStyleTable::MakeSeries(const AIFourColorStyle& color)
+{
+	AIPathStyle style = MakeStroke(kChartSeriesStrokeGray, kChartSeriesStrokeWidth);
+	style.fillPaint = true;
+	style.fill.color.kind = kFourColor;
+	style.fill.color.c.f = color;
+	return style;
+}
+
+/*
+*/
+AIPathStyle ChartStyleTable::MakeSeriesLine(const AIFourColorStyle& color)
+{
+	AIPathStyle style = MakeEmpty();
+	style.strokePaint = true;
+	style.stroke.color.kind = kFourColor;
+	style.stroke.color.c.f = color;
+	style.stroke.width = kChartSeriesLineWidth;
+	style.stroke.cap = kAIRoundCap;
+	style.stroke.join = kAIRoundJoin;
+	return style;
+}
+
+/*
+*/
+ai::UnicodeString ChartStyleTable::GetSeriesStyleName(const std::string& seriesName)
+{
+	ai::UnicodeString name("Chart Series ");
+	name.append(ai::UnicodeString::FromUTF8(seriesName));
+	return name;
+}
+
+/*
+*/
+ChartStyleTable::ChartStyleTable()
+{
+	// Components from the theme
+	for (int role = 0; role < kChartStyleRoleCount; role++) {
+		const ChartRoleTheme& theme = kChartRoleThemes[role];
+		AIPathStyle style = theme.filled ? MakeFilled(theme.fillGray, theme.strokeGray, theme.strokeWidth) : MakeStroke(theme.strokeGray, theme.strokeWidth);
+		if (theme.dash > 0) {
+			style.stroke.dash.length = 2;  // Number of dash entries
+			style.stroke.dash.array[0] = theme.dash;  // Dash length
+			style.stroke.dash.array[1] = theme.dash;  // Gap length
+		}
+		fRoles[role] = style;
+	}
+
+	// Series - CMYK fill with the axis stroke
+	for (const ChartSeriesColor& color : kChartSeriesColors) {
+		AIFourColorStyle cmyk;
+		cmyk.cyan = color.cyan * kAIRealOne;
+		cmyk.magenta = color.magenta * kAIRealOne;
+		cmyk.yellow = color.yellow * kAIRealOne;
+		cmyk.black = color.black * kAIRealOne;
+		fSeries.push_back(MakeSeries(cmyk));
+		fSeriesLines.push_back(MakeSeriesLine(cmyk));
+	}
+}
+
+/*
+*/
+ASErr ChartStyleTable::BindToDocument(const std::vector<std::string>& seriesNames)
+{
+	ASErr result = kNoErr;
+
+	try {
+		// Components - look up graphic styles left by earlier charts. Styles that do
+		// not exist yet are created from the path style by the first ApplyTo.
+		for (int role = 0; role < kChartStyleRoleCount; role++) {
+			ChartStyle& style = fRoles[role];
+			style.name = ai::UnicodeString(kRoleStyleNames[role]);
+			if (sAIArtStyle->GetArtStyleByName(&style.artStyle, &style.name) != kNoErr) {
+				style.artStyle = nullptr;
+			}
+		}
+
+		if (seriesNames.empty()) {
+			return kNoErr;
+		}
+
+		AISwatchListRef swatches = nullptr;
+		result = sAISwatchList->GetSwatchList(nullptr, &swatches);
+		aisdk::check_ai_error(result);
+
+		// Series - one global process swatch and one graphic style per series name, so
+		// a series keeps its color across charts and across renders. New swatches take
+		// the theme colors in order.
+		std::vector<ChartStyle> bound;
+		std::vector<ChartStyle> boundLines;
+		bound.reserve(seriesNames.size());
+		boundLines.reserve(seriesNames.size());
+		for (size_t seriesIdx = 0; seriesIdx < seriesNames.size(); seriesIdx++) {
+			ChartStyle style = fSeries[seriesIdx % fSeries.size()];
+			style.name = GetSeriesStyleName(seriesNames[seriesIdx]);
+
+			AICustomColorHandle swatchColor = nullptr;
+			if (sAICustomColor->GetCustomColorByName(style.name, &swatchColor) != kNoErr || !swatchColor) {
+				AICustomColor customColor;
+				customColor.kind = kCustomFourColor;
+				customColor.c.f = style.path.fill.color.c.f;
+				customColor.flag = 0;  // Global process color, not a spot color
+				result = sAICustomColor->NewCustomColor(&customColor, style.name, &swatchColor);
+				aisdk::check_ai_error(result);
+			}
+
+			style.path.fill.color.kind = kCustomColor;
+			style.path.fill.color.c.c.color = swatchColor;
+			style.path.fill.color.c.c.tint = 0;
+
+			// Show the color in the Swatches panel
+			if (!sAISwatchList->GetSwatchByName(swatches, style.name)) {
+				AISwatchRef swatch = sAISwatchList->InsertNthSwatch(swatches, -1);
+				if (swatch) {
+					result = sAISwatchList->SetAIColor(swatch, &style.path.fill.color);
+					aisdk::check_ai_error(result);
+				}
+			}
+
+			if (sAIArtStyle->GetArtStyleByName(&style.artStyle, &style.name) != kNoErr) {
+				style.artStyle = nullptr;
+			}
+
+			// The series line strokes with the same swatch under a graphic style of its own
+			ChartStyle line = fSeriesLines[seriesIdx % fSeriesLines.size()];
+			line.name = style.name;
+			line.name.append(ai::UnicodeString(" Line"));
+			line.path.stroke.color = style.path.fill.color;
+			if (sAIArtStyle->GetArtStyleByName(&line.artStyle, &line.name) != kNoErr) {
+				line.artStyle = nullptr;
+			}
+
+			bound.push_back(style);
+			boundLines.push_back(line);
+		}
+
+		fSeries.swap(bound);
+		fSeriesLines.swap(boundLines);
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+
+	return result;
+}
+
+/*
+*/
+ASErr ChartStyle::ApplyTo(AIArtHandle art)
+{
+	ASErr result = kNoErr;
+
+	try {
+		if (artStyle) {
+			result = sAIArtStyle->SetArtStyle(art, artStyle);
+			aisdk::check_ai_error(result);
+			return kNoErr;
+		}
+
+		result = sAIPathStyle->SetPathStyle(art, &path);
+		aisdk::check_ai_error(result);
+
+		if (!name.empty()) {
+			// Register the art's style under the style's name for the rest of the document
+			AIArtStyleHandle unnamed = nullptr;
+			result = sAIArtStyle->GetArtStyle(art, &unnamed);
+			aisdk::check_ai_error(result);
+
+			result = sAIArtStyle->AddNamedStyle(unnamed, name, false, &artStyle);
+			aisdk::check_ai_error(result);
+		}
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+
+	return result;
+}
@@ -0,0 +1,134 @@
+//========================================================================================
+//  
+//  ChartStyleTable.h
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#ifndef __ChartStyleTable_h__
+#define __ChartStyleTable_h__
+
+#include "IllustratorSDK.h"
+#include "ChartDisplayList.h"
+#include "ChartTheme.h"
+#include <string>
+#include <vector>
+
+/** The paint of one chart component or data series.
+
+	Unbound styles are applied as a path style. Once the table is bound to a document
+	each style also names a graphic style, and art is painted by reference to it. The
+	graphic style is created from the path style the first time it is needed, so later
+	art and later charts share it, and editing it in the Graphic Styles panel restyles
+	every chart.
+*/
+struct ChartStyle {
+	/** The paint written when there is no graphic style yet.
+	*/
+	AIPathStyle path;
+
+	/** Name of the document graphic style, or empty when unbound.
+	*/
+	ai::UnicodeString name;
+
+	/** The document graphic style, or null until it exists.
+	*/
+	AIArtStyleHandle artStyle;
+
+	ChartStyle() : artStyle(nullptr) {}
+	ChartStyle(const AIPathStyle& pathStyle) : path(pathStyle), artStyle(nullptr) {}
+
+	/** Paints an art object with this style, creating the named graphic style from it
+		if the style is bound and the graphic style does not exist yet.
+		@param art IN the path or compound path to paint.
+		@return kNoErr on success, other ASErr otherwise.
+	*/
+	ASErr ApplyTo(AIArtHandle art);
+};
+
+/** The styles of a chart, built once per render from the chart theme.
+
+	Styles are complete AIPathStyle values constructed from scratch, so paths are
+	styled with a single write and never read their default style first. Colors,
+	stroke widths and dash patterns come from the theme in ChartTheme.h.
+
+	BindToDocument registers the theme with the current document: each series is
+	filled with a global process swatch named after the series, and every component
+	and series gets a named graphic style. Recoloring a series is then a single swatch
+	edit, and the saved document stores each paint once rather than per object.
+*/
+class ChartStyleTable
+{
+public:
+	/** Builds the table for the default chart theme.
+	*/
+	ChartStyleTable();
+
+	/** Registers the swatches and graphic styles of the chart's series and components
+		in the current document, reusing any that already exist by name.
+		@param seriesNames IN names of the chart's series, in order.
+		@return kNoErr on success, other ASErr otherwise.
+	*/
+	ASErr BindToDocument(const std::vector<std::string>& seriesNames);
+
+	/** Gets the style of a chart component.
+		@param role IN the component.
+		@return the style.
+	*/
+	ChartStyle& Get(ChartStyleRole role) { return fRoles[role]; }
+
+	/** Gets the fill style of a data series. Unbound series colors are reused in order
+		when there are more series than colors.
+		@param seriesIndex IN index of the series in the chart.
+		@return the style.
+	*/
+	ChartStyle& GetSeries(size_t seriesIndex) { return fSeries[seriesIndex % fSeries.size()]; }
+
+	/** Gets the line style of a data series: its color as an unfilled stroke, for line
+		charts. Bound series lines stroke with the series swatch.
+		@param seriesIndex IN index of the series in the chart.
+		@return the style.
+	*/
+	ChartStyle& GetSeriesLine(size_t seriesIndex) { return fSeriesLines[seriesIndex % fSeriesLines.size()]; }
+
+	/** Number of distinct series styles before they repeat.
+	*/
+	size_t GetSeriesCount() const { return fSeries.size(); }
+
+	/** Name of the swatch and graphic style of a series.
+	*/
+	static ai::UnicodeString GetSeriesStyleName(const std::string& seriesName);
+
+	/** A style with neither fill nor stroke, and every other field set to its default.
+	*/
+	static AIPathStyle MakeEmpty();
+
+	/** A stroke-only style in a gray level (0 is white, 1 is black).
+	*/
+	static AIPathStyle MakeStroke(AIReal gray, AIReal width);
+
+	/** A gray fill with a gray stroke.
+	*/
+	static AIPathStyle MakeFilled(AIReal fillGray, AIReal strokeGray, AIReal strokeWidth);
+
+	/** A CMYK fill with the series stroke.
+	*/
+	static AIPathStyle MakeSeries(const AIFourColorStyle& color);
+
+	/** A CMYK stroke with round joins and no fill.
+	*/
+	static AIPathStyle MakeSeriesLine(const AIFourColorStyle& color);
+
+private:
+	ChartStyle fRoles[kChartStyleRoleCount];
+	std::vector<ChartStyle> fSeries;
+	std::vector<ChartStyle> fSeriesLines;
+};
+
+#endif // __ChartStyleTable_h__
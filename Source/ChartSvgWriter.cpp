@@ -0,0 +1,619 @@
+//========================================================================================
+//  
+//  ChartSvgWriter.cpp
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#include "ChartSvgWriter.h"
+#include "ChartArc.h"
+#include "ChartTheme.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Bytes written to the file at a time
+const size_t kBufferSize = 1 << 16;
+
+// Coordinates are written in hundredths of a point
+const double kFixedScale = 100.0;
+
+// Arcs are written in pieces of at most a quarter turn, which SVG arcs draw unambiguously
+const double kArcPieceSweep = 6.283185307179586 / 4;
+
+// The hex digits of an 8-bit color channel, for a level from 0 to 1
+void PutChannel(char* out, double level)
+{
+	static const char kHex[] = "0123456789abcdef";
+	const int value = (int)std::floor(std::max(0.0, std::min(1.0, level)) * 255.0 + 0.5);
+	out[0] = kHex[value >> 4];
+	out[1] = kHex[value & 15];
+}
+
+// "#rrggbb" of a gray level, 0 being white
+void MakeGray(char* out, double gray)
+{
+	out[0] = '#';
+	for (int i = 0; i < 3; i++) {
+		PutChannel(out + 1 + 2 * i, 1.0 - gray);
+	}
+	out[7] = 0;
+}
+
+// "#rrggbb" of a CMYK color
+void MakeColor(char* out, const ChartSeriesColor& color)
+{
+	out[0] = '#';
+	PutChannel(out + 1, (1.0 - color.cyan) * (1.0 - color.black));
+	PutChannel(out + 3, (1.0 - color.magenta) * (1.0 - color.black));
+	PutChannel(out + 5, (1.0 - color.yellow) * (1.0 - color.black));
+	out[7] = 0;
+}
+
+} // namespace
+
+/*
+*/
+ChartSvgWriter::ChartSvgWriter(FILE* file) :
+	fFile(file), fBuffer(kBufferSize), fUsed(0), fFailed(false), fLeft(0), fTop(0),
+	fPenX(0), fPenY(0), fStartX(0), fStartY(0), fCommand(0), fSeparate(false)
+{
+}
+
+/*
+*/
+bool ChartSvgWriter::Write(const ChartDisplayList& list, const ChartRect& viewBox, const std::string& fontName, double fontSize)
+{
+	fLeft = viewBox.left;
+	fTop = viewBox.top;
+
+	const int64_t width = ToX(viewBox.right);
+	const int64_t height = ToY(viewBox.bottom);
+	Put("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"");
+	PutFixed(width);
+	Put("\" height=\"");
+	PutFixed(height);
+	Put("\" viewBox=\"0 0 ");
+	PutFixed(width);
+	Put(' ');
+	PutFixed(height);
+	Put("\">\n");
+	WriteStyles(fontName, fontSize);
+
+	// Groups nest as in the list. A merged group is one path of all its children, as
+	// the emitter makes one compound path of it.
+	std::vector<uint32_t> groupEnds;
+	const std::vector<ChartPrimitive>& primitives = list.GetPrimitives();
+	for (size_t i = 0; i < primitives.size(); i++) {
+		while (!groupEnds.empty() && i >= groupEnds.back()) {
+			Put("</g>\n");
+			groupEnds.pop_back();
+		}
+
+		const ChartPrimitive& primitive = primitives[i];
+		switch (primitive.kind) {
+			case kChartPrimitiveGroup:
+				if (primitive.merge) {
+					if (primitive.end > i + 1) {
+						BeginPath(primitive.role, primitive.series);
+						for (size_t child = i + 1; child < primitive.end; child++) {
+							WritePathData(primitives[child]);
+						}
+						EndPath();
+					}
+					i = primitive.end - 1;
+				}
+				else {
+					Put("<g data-name=\"");
+					PutEscaped(primitive.text);
+					Put("\">\n");
+					groupEnds.push_back(primitive.end);
+				}
+				break;
+			case kChartPrimitiveText:
+				WriteText(primitive);
+				break;
+			default:
+				BeginPath(primitive.role, primitive.series);
+				WritePathData(primitive);
+				EndPath();
+				break;
+		}
+	}
+	while (!groupEnds.empty()) {
+		Put("</g>\n");
+		groupEnds.pop_back();
+	}
+	Put("</svg>\n");
+
+	Flush();
+	return !fFailed;
+}
+
+/*
+*/
+ChartRect ChartSvgWriter::GetViewBox(const ChartLayout& layout)
+{
+	ChartRect box;
+	box.left = std::min(layout.plotArea.left, layout.plotArea.right);
+	box.right = std::max(layout.plotArea.left, layout.plotArea.right);
+	box.bottom = std::min(layout.plotArea.bottom, layout.plotArea.top);
+	box.top = std::max(layout.plotArea.bottom, layout.plotArea.top);
+
+	const std::vector<ChartLabel>* labelSets[3] = {&layout.xLabels, &layout.yLabels, &layout.dataLabels};
+	for (const std::vector<ChartLabel>* labels : labelSets) {
+		for (const ChartLabel& label : *labels) {
+			const double shift = label.justification == kChartJustifyLeft ? 0 : label.justification == kChartJustifyCenter ? 0.5 : 1;
+			const double left = label.anchor.h - shift * label.extent.width;
+			box.left = std::min(box.left, left);
+			box.right = std::max(box.right, left + label.extent.width);
+			box.bottom = std::min(box.bottom, label.anchor.v);
+			box.top = std::max(box.top, label.anchor.v + label.extent.height);
+		}
+	}
+
+	// The margin also holds descenders, which label extents leave out
+	const double margin = layout.fontSize / 2;
+	box.left -= margin;
+	box.right += margin;
+	box.bottom -= margin;
+	box.top += margin;
+	return box;
+}
+
+/*
+*/
+bool ChartSvgWriter::WriteFile(const ChartLayout& layout, const std::string& fontName, const std::string& path)
+{
+	FILE* file = fopen(path.c_str(), "wb");
+	if (!file) {
+		return false;
+	}
+
+	ChartDisplayList list;
+	ChartDisplayList::Build(layout, true, list);
+
+	ChartSvgWriter writer(file);
+	const bool written = writer.Write(list, GetViewBox(layout), fontName, layout.fontSize);
+	return fclose(file) == 0 && written;
+}
+
+/*
+*/
+void ChartSvgWriter::Put(const char* text)
+{
+	while (*text) {
+		Put(*text++);
+	}
+}
+
+/*
+*/
+void ChartSvgWriter::PutEscaped(const std::string& text)
+{
+	for (char c : text) {
+		switch (c) {
+			case '&': Put("&amp;"); break;
+			case '<': Put("&lt;"); break;
+			case '>': Put("&gt;"); break;
+			case '"': Put("&quot;"); break;
+			default: Put(c); break;
+		}
+	}
+}
+
+/*
+*/
+void ChartSvgWriter::PutFixed(int64_t hundredths)
+{
+	// Digits are formed backwards from the integer, with no trailing fraction zeros, so
+	// the text of a value never depends on the C library's formatting
+	char digits[24];
+	size_t count = 0;
+	uint64_t magnitude = hundredths < 0 ? (uint64_t)0 - (uint64_t)hundredths : (uint64_t)hundredths;
+	const unsigned fraction = (unsigned)(magnitude % 100);
+	magnitude /= 100;
+	if (fraction != 0) {
+		if (fraction % 10 != 0) {
+			digits[count++] = (char)('0' + fraction % 10);
+		}
+		digits[count++] = (char)('0' + fraction / 10);
+		digits[count++] = '.';
+	}
+	do {
+		digits[count++] = (char)('0' + magnitude % 10);
+		magnitude /= 10;
+	} while (magnitude != 0);
+	if (hundredths < 0) {
+		digits[count++] = '-';
+	}
+	while (count > 0) {
+		Put(digits[--count]);
+	}
+}
+
+/*
+*/
+void ChartSvgWriter::Flush()
+{
+	if (fUsed > 0 && fwrite(fBuffer.data(), 1, fUsed, fFile) != fUsed) {
+		fFailed = true;
+	}
+	fUsed = 0;
+}
+
+/*
+*/
+int64_t ChartSvgWriter::ToX(double h) const
+{
+	const double x = std::floor((h - fLeft) * kFixedScale + 0.5);
+	return std::fabs(x) < 1e15 ? (int64_t)x : 0;
+}
+
+/*
+*/
+int64_t ChartSvgWriter::ToY(double v) const
+{
+	// SVG's y axis points down the page, the opposite of artwork v
+	const double y = std::floor((fTop - v) * kFixedScale + 0.5);
+	return std::fabs(y) < 1e15 ? (int64_t)y : 0;
+}
+
+/*
+*/
+void ChartSvgWriter::PutNumber(int64_t hundredths)
+{
+	// A minus sign separates numbers on its own
+	if (fSeparate && hundredths >= 0) {
+		Put(' ');
+	}
+	PutFixed(hundredths);
+	fSeparate = true;
+}
+
+/*
+*/
+void ChartSvgWriter::PutCommand(char command)
+{
+	// A command repeats implicitly for the numbers that follow it
+	if (command != fCommand) {
+		Put(command);
+		fCommand = command;
+		fSeparate = false;
+	}
+}
+
+/*
+*/
+void ChartSvgWriter::MoveTo(double h, double v)
+{
+	const int64_t x = ToX(h);
+	const int64_t y = ToY(v);
+	if (fCommand == 0) {
+		PutCommand('M');
+		PutNumber(x);
+		PutNumber(y);
+	}
+	else {
+		// A relative move after a line would be read as a line, so it is always spelled out
+		Put('m');
+		fCommand = 'l';
+		fSeparate = false;
+		PutNumber(x - fPenX);
+		PutNumber(y - fPenY);
+	}
+	fPenX = fStartX = x;
+	fPenY = fStartY = y;
+}
+
+/*
+*/
+void ChartSvgWriter::LineTo(double h, double v)
+{
+	const int64_t dx = ToX(h) - fPenX;
+	const int64_t dy = ToY(v) - fPenY;
+	if (dy == 0) {
+		if (dx == 0) {
+			return;
+		}
+		PutCommand('h');
+		PutNumber(dx);
+	}
+	else if (dx == 0) {
+		PutCommand('v');
+		PutNumber(dy);
+	}
+	else {
+		PutCommand('l');
+		PutNumber(dx);
+		PutNumber(dy);
+	}
+	fPenX += dx;
+	fPenY += dy;
+}
+
+/*
+*/
+void ChartSvgWriter::ArcTo(double radius, double h, double v, bool clockwise)
+{
+	const int64_t dx = ToX(h) - fPenX;
+	const int64_t dy = ToY(v) - fPenY;
+	const int64_t r = (int64_t)std::floor(radius * kFixedScale + 0.5);
+	PutCommand('a');
+	PutNumber(r);
+	PutNumber(r);
+	Put(clockwise ? " 0 0 1" : " 0 0 0");
+	PutNumber(dx);
+	PutNumber(dy);
+	fPenX += dx;
+	fPenY += dy;
+}
+
+/*
+*/
+void ChartSvgWriter::ArcAround(const ChartPoint& center, double radius, double startAngle, double endAngle)
+{
+	// Angles count counterclockwise as the chart is seen, on the page as in artwork; the
+	// page's flipped y axis only changes which way SVG calls positive
+	const double sweep = endAngle - startAngle;
+	const int pieces = std::max(1, (int)std::ceil(std::fabs(sweep) / kArcPieceSweep - 1e-9));
+	for (int piece = 1; piece <= pieces; piece++) {
+		const ChartUnitVector direction = ChartArc::GetUnitVector(startAngle + sweep * piece / pieces);
+		ArcTo(radius, center.h + radius * direction.c, center.v + radius * direction.s, sweep < 0);
+	}
+}
+
+/*
+*/
+void ChartSvgWriter::ClosePath()
+{
+	PutCommand('z');
+	fCommand = 'z';
+	fPenX = fStartX;
+	fPenY = fStartY;
+}
+
+/*
+*/
+void ChartSvgWriter::WriteStyles(const std::string& fontName, double fontSize)
+{
+	// A class per component role, "r", and per theme color for series fills, "f", and
+	// series lines, "l"; series beyond the theme's colors reuse them in order
+	char color[8];
+	Put("<style>\n");
+	for (int role = 0; role < kChartStyleRoleCount; role++) {
+		const ChartRoleTheme& theme = kChartRoleThemes[role];
+		Put(".r");
+		PutInteger(role);
+		Put("{fill:");
+		if (theme.filled) {
+			MakeGray(color, theme.fillGray);
+			Put(color);
+		}
+		else {
+			Put("none");
+		}
+		MakeGray(color, theme.strokeGray);
+		Put(";stroke:");
+		Put(color);
+		Put(";stroke-width:");
+		PutFixed((int64_t)std::floor(theme.strokeWidth * kFixedScale + 0.5));
+		if (theme.dash > 0) {
+			const int64_t dash = (int64_t)std::floor(theme.dash * kFixedScale + 0.5);
+			Put(";stroke-dasharray:");
+			PutFixed(dash);
+			Put(' ');
+			PutFixed(dash);
+		}
+		Put("}\n");
+	}
+	for (size_t i = 0; i < kChartSeriesColorCount; i++) {
+		MakeColor(color, kChartSeriesColors[i]);
+		Put(".f");
+		PutInteger((int64_t)i);
+		Put("{fill:");
+		Put(color);
+		Put(";stroke:");
+		char stroke[8];
+		MakeGray(stroke, kChartSeriesStrokeGray);
+		Put(stroke);
+		Put(";stroke-width:");
+		PutFixed((int64_t)std::floor(kChartSeriesStrokeWidth * kFixedScale + 0.5));
+		Put("}\n.l");
+		PutInteger((int64_t)i);
+		Put("{fill:none;stroke:");
+		Put(color);
+		Put(";stroke-width:");
+		PutFixed((int64_t)std::floor(kChartSeriesLineWidth * kFixedScale + 0.5));
+		Put(";stroke-linecap:round;stroke-linejoin:round}\n");
+	}
+	Put("text{font-family:");
+	if (!fontName.empty()) {
+		Put('\'');
+		for (char c : fontName) {
+			if (c != '\'' && c != '<' && c != '&' && c != '\\') {
+				Put(c);
+			}
+		}
+		Put("',");
+	}
+	Put("sans-serif;font-size:");
+	PutFixed((int64_t)std::floor(fontSize * kFixedScale + 0.5));
+	Put("px;fill:#000}\n</style>\n");
+}
+
+/*
+*/
+void ChartSvgWriter::WritePaint(int32_t role, int32_t series)
+{
+	const int64_t color = (int64_t)((size_t)std::max(0, series) % kChartSeriesColorCount);
+	if (role >= 0 && role < kChartStyleRoleCount) {
+		Put(" class=\"r");
+		PutInteger(role);
+		Put('"');
+	}
+	else if (role == kChartPaintSeries) {
+		Put(" class=\"f");
+		PutInteger(color);
+		Put('"');
+	}
+	else if (role == kChartPaintSeriesLine) {
+		Put(" class=\"l");
+		PutInteger(color);
+		Put('"');
+	}
+}
+
+/*
+*/
+void ChartSvgWriter::BeginPath(int32_t role, int32_t series)
+{
+	Put("<path");
+	WritePaint(role, series);
+	Put(" d=\"");
+	fCommand = 0;
+	fSeparate = false;
+}
+
+/*
+*/
+void ChartSvgWriter::EndPath()
+{
+	Put("\"/>\n");
+}
+
+/*
+*/
+void ChartSvgWriter::WritePathData(const ChartPrimitive& primitive)
+{
+	switch (primitive.kind) {
+		case kChartPrimitiveRect:
+			MoveTo(primitive.rect.left, primitive.rect.top);
+			LineTo(primitive.rect.right, primitive.rect.top);
+			LineTo(primitive.rect.right, primitive.rect.bottom);
+			LineTo(primitive.rect.left, primitive.rect.bottom);
+			ClosePath();
+			break;
+		case kChartPrimitivePolyline:
+			if (primitive.points.empty()) {
+				break;
+			}
+			MoveTo(primitive.points[0].h, primitive.points[0].v);
+			for (size_t i = 1; i < primitive.points.size(); i++) {
+				LineTo(primitive.points[i].h, primitive.points[i].v);
+			}
+			if (primitive.closed) {
+				ClosePath();
+			}
+			break;
+		case kChartPrimitiveArc: {
+			const double kFullTurn = 6.283185307179586;
+			const ChartPoint& center = primitive.origin;
+			const ChartUnitVector start = ChartArc::GetUnitVector(primitive.startAngle);
+			MoveTo(center.h + primitive.radius * start.c, center.v + primitive.radius * start.s);
+			ArcAround(center, primitive.radius, primitive.startAngle, primitive.endAngle);
+			if (primitive.innerRadius > 0) {
+				// Ring sector: back along the inner edge
+				const ChartUnitVector end = ChartArc::GetUnitVector(primitive.endAngle);
+				LineTo(center.h + primitive.innerRadius * end.c, center.v + primitive.innerRadius * end.s);
+				ArcAround(center, primitive.innerRadius, primitive.endAngle, primitive.startAngle);
+			}
+			else if (std::fabs(primitive.endAngle - primitive.startAngle) < kFullTurn - 1e-9) {
+				// Wedge: the two radii meet at the center
+				LineTo(center.h, center.v);
+			}
+			ClosePath();
+			break;
+		}
+		case kChartPrimitiveMarker: {
+			const double h = primitive.origin.h;
+			const double v = primitive.origin.v;
+			const double r = primitive.size / 2;
+			switch (primitive.shape) {
+				case kChartMarkerCircle:
+					MoveTo(h - r, v);
+					ArcTo(r, h + r, v, true);
+					ArcTo(r, h - r, v, true);
+					break;
+				case kChartMarkerDiamond:
+					MoveTo(h - r, v);
+					LineTo(h, v + r);
+					LineTo(h + r, v);
+					LineTo(h, v - r);
+					break;
+				case kChartMarkerTriangle:
+					MoveTo(h - r, v - r);
+					LineTo(h, v + r);
+					LineTo(h + r, v - r);
+					break;
+				case kChartMarkerSquare:
+				default:
+					MoveTo(h - r, v - r);
+					LineTo(h - r, v + r);
+					LineTo(h + r, v + r);
+					LineTo(h + r, v - r);
+					break;
+			}
+			ClosePath();
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+/*
+*/
+void ChartSvgWriter::WriteText(const ChartPrimitive& primitive)
+{
+	static const char* const kAnchors[] = {"start", "middle", "end"};
+
+	// One text element per primitive, as the emitter sets one text object: a span per
+	// cell of each line. Lines are separated by carriage returns, at the leading down
+	// from the first; cells after a tab are centered on their tab stop.
+	Put("<text>");
+	size_t line = 0;
+	size_t cell = 0;
+	size_t begin = 0;
+	const std::string& text = primitive.text;
+	for (size_t i = 0; i <= text.size(); i++) {
+		if (i < text.size() && text[i] != '\t' && text[i] != '\r') {
+			continue;
+		}
+
+		if (i > begin) {
+			const bool tabbed = cell > 0 && cell - 1 < primitive.tabStops.size();
+			const double h = primitive.origin.h + (tabbed ? primitive.tabStops[cell - 1] : 0);
+			const double v = primitive.origin.v - line * primitive.leading;
+			Put("<tspan x=\"");
+			PutFixed(ToX(h));
+			Put("\" y=\"");
+			PutFixed(ToY(v));
+			const int justification = tabbed ? kChartJustifyCenter : primitive.justification;
+			if (justification != kChartJustifyLeft) {
+				Put("\" text-anchor=\"");
+				Put(kAnchors[justification]);
+			}
+			Put("\">");
+			PutEscaped(text.substr(begin, i - begin));
+			Put("</tspan>");
+		}
+
+		if (i < text.size() && text[i] == '\r') {
+			line++;
+			cell = 0;
+		}
+		else {
+			cell++;
+		}
+		begin = i + 1;
+	}
+	Put("</text>\n");
+}
@@ -0,0 +1,91 @@
+//========================================================================================
+//  
+//  ChartSvgWriter.h
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#ifndef __ChartSvgWriter_h__
+#define __ChartSvgWriter_h__
+
+// Charts as SVG without the application: the display list the emitter turns into art,
+// streamed primitive by primitive through a buffer to a file, painted with the default
+// theme. No document tree is built. Coordinates are fixed to hundredths of a point and
+// path data is relative, so files are compact and the same list always writes the same
+// bytes. Free of Illustrator SDK types, like the display list.
+
+#include "ChartDisplayList.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+class ChartSvgWriter {
+public:
+	// Writes to file, which the caller opens and closes
+	explicit ChartSvgWriter(FILE* file);
+
+	// Writes list as a complete SVG document of the artwork rectangle viewBox, with text
+	// set in fontName, or the viewer's sans-serif if it is empty, at fontSize. Returns
+	// false if the file could not be written.
+	bool Write(const ChartDisplayList& list, const ChartRect& viewBox, const std::string& fontName, double fontSize);
+
+	// The artwork rectangle holding a layout's plot area and labels, with a margin of
+	// half the font size
+	static ChartRect GetViewBox(const ChartLayout& layout);
+
+	// Writes the display list of layout, labels combined as the emitter sets them, to a
+	// new file at path. Returns false if the file could not be written.
+	static bool WriteFile(const ChartLayout& layout, const std::string& fontName, const std::string& path);
+
+private:
+	// Output
+	void Put(char c)
+	{
+		if (fUsed == fBuffer.size()) Flush();
+		fBuffer[fUsed++] = c;
+	}
+	void Put(const char* text);
+	void PutEscaped(const std::string& text);
+	void PutFixed(int64_t hundredths);
+	void PutInteger(int64_t value) { PutFixed(value * 100); }
+	void Flush();
+
+	// Path data, in hundredths of a point relative to the view box's top left
+	int64_t ToX(double h) const;
+	int64_t ToY(double v) const;
+	void PutNumber(int64_t hundredths);
+	void PutCommand(char command);
+	void MoveTo(double h, double v);
+	void LineTo(double h, double v);
+	void ArcTo(double radius, double h, double v, bool clockwise);
+	void ArcAround(const ChartPoint& center, double radius, double startAngle, double endAngle);
+	void ClosePath();
+
+	// Elements
+	void WriteStyles(const std::string& fontName, double fontSize);
+	void WritePaint(int32_t role, int32_t series);
+	void WritePathData(const ChartPrimitive& primitive);
+	void WriteText(const ChartPrimitive& primitive);
+	void BeginPath(int32_t role, int32_t series);
+	void EndPath();
+
+	FILE* fFile;
+	std::vector<char> fBuffer;
+	size_t fUsed;
+	bool fFailed;
+
+	double fLeft, fTop;				// View box origin, in artwork coordinates
+	int64_t fPenX, fPenY;			// Current point of the path data
+	int64_t fStartX, fStartY;		// Start of the current subpath
+	char fCommand;					// Last command letter, 0 at the start of the path data
+	bool fSeparate;					// A number follows the last one written
+};
+
+#endif // __ChartSvgWriter_h__
@@ -0,0 +1,131 @@
+//========================================================================================
+//  
+//  ChartTextMetrics.cpp
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#include "ChartTextMetrics.h"
+#include <cstring>
+
+/*
+*/
+ChartTextMetricsCache::ChartTextMetricsCache(ChartTextMeasurer& measurer, size_t capacity) :
+	fMeasurer(measurer), fCapacity(capacity > 0 ? capacity : 1), fHits(0), fMisses(0)
+{
+	fIndex.reserve(fCapacity);
+}
+
+/*
+*/
+std::string ChartTextMetricsCache::MakeKey(const std::string& fontName, double fontSize, const std::string& text)
+{
+	// Font names and labels cannot contain NUL, so the parts cannot run into each other
+	std::string key;
+	key.reserve(fontName.size() + sizeof(fontSize) + text.size() + 2);
+	key.append(fontName);
+	key.push_back('\0');
+	char size[sizeof(fontSize)];
+	memcpy(size, &fontSize, sizeof(fontSize));
+	key.append(size, sizeof(size));
+	key.push_back('\0');
+	key.append(text);
+	return key;
+}
+
+/*
+*/
+ChartTextExtent ChartTextMetricsCache::Measure(const std::string& fontName, double fontSize, const std::string& text)
+{
+	std::string key = MakeKey(fontName, fontSize, text);
+
+	std::lock_guard<std::mutex> lock(fMutex);
+
+	auto found = fIndex.find(key);
+	if (found != fIndex.end()) {
+		fHits++;
+		fEntries.splice(fEntries.begin(), fEntries, found->second);
+		return found->second->second;
+	}
+
+	fMisses++;
+	ChartTextExtent extent = fMeasurer.Measure(fontName, fontSize, text);
+
+	if (fEntries.size() >= fCapacity) {
+		fIndex.erase(fEntries.back().first);
+		fEntries.pop_back();
+	}
+	fEntries.emplace_front(key, extent);
+	fIndex.emplace(std::move(key), fEntries.begin());
+
+	return extent;
+}
+
+/*
+*/
+bool ChartTextMetricsCache::Lookup(const std::string& fontName, double fontSize, const std::string& text, ChartTextExtent& extent)
+{
+	std::string key = MakeKey(fontName, fontSize, text);
+
+	std::lock_guard<std::mutex> lock(fMutex);
+
+	auto found = fIndex.find(key);
+	if (found == fIndex.end()) {
+		return false;
+	}
+
+	fHits++;
+	fEntries.splice(fEntries.begin(), fEntries, found->second);
+	extent = found->second->second;
+	return true;
+}
+
+/*
+*/
+void ChartTextMetricsCache::Clear()
+{
+	std::lock_guard<std::mutex> lock(fMutex);
+	fEntries.clear();
+	fIndex.clear();
+}
+
+/*
+*/
+size_t ChartTextMetricsCache::GetSize() const
+{
+	std::lock_guard<std::mutex> lock(fMutex);
+	return fEntries.size();
+}
+
+/*
+*/
+ChartTextExtent ChartDeferredMeasurer::Measure(const std::string& fontName, double fontSize, const std::string& text)
+{
+	ChartTextExtent extent;
+	if (fCache.Lookup(fontName, fontSize, text, extent)) {
+		return extent;
+	}
+
+	Miss miss;
+	miss.fontName = fontName;
+	miss.fontSize = fontSize;
+	miss.text = text;
+	fMisses.push_back(miss);
+	return ChartTextMeasurer::Measure(fontName, fontSize, text);
+}
+
+/*
+*/
+void ChartDeferredMeasurer::MeasureMisses()
+{
+	for (const Miss& miss : fMisses) {
+		fCache.Measure(miss.fontName, miss.fontSize, miss.text);
+	}
+	fMisses.clear();
+}
@@ -0,0 +1,103 @@
+//========================================================================================
+//  
+//  ChartTextMetrics.h
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#ifndef __ChartTextMetrics_h__
+#define __ChartTextMetrics_h__
+
+// Text extents memoized per font, size and string in front of a slower measurer. Measuring
+// through the text engine means composing a text object, so each distinct label is
+// measured once and repeated renders of the same labels never measure again. The least
+// recently used extents are evicted beyond the capacity. Safe to share between threads;
+// the wrapped measurer is only called with the cache locked.
+
+#include "ChartLayout.h"
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class ChartTextMetricsCache : public ChartTextMeasurer {
+public:
+	static const size_t kDefaultCapacity = 4096;
+
+	explicit ChartTextMetricsCache(ChartTextMeasurer& measurer, size_t capacity = kDefaultCapacity);
+
+	ChartTextExtent Measure(const std::string& fontName, double fontSize, const std::string& text) override;
+	uint64_t GetIdentity() const override { return fMeasurer.GetIdentity(); }
+
+	// Gets an extent already in the cache without measuring. Returns false on a miss.
+	bool Lookup(const std::string& fontName, double fontSize, const std::string& text, ChartTextExtent& extent);
+
+	// Forgets every extent, for example when fonts were added or removed
+	void Clear();
+
+	size_t GetSize() const;
+	size_t GetCapacity() const { return fCapacity; }
+
+	// Hit-rate counters since the last reset
+	uint64_t GetHits() const { return fHits; }
+	uint64_t GetMisses() const { return fMisses; }
+	void ResetCounters() { fHits = 0; fMisses = 0; }
+
+private:
+	typedef std::list<std::pair<std::string, ChartTextExtent> > Entries;
+
+	static std::string MakeKey(const std::string& fontName, double fontSize, const std::string& text);
+
+	ChartTextMeasurer& fMeasurer;
+	size_t fCapacity;
+
+	Entries fEntries;		// Most recently used first
+	std::unordered_map<std::string, Entries::iterator> fIndex;
+	mutable std::mutex fMutex;
+
+	std::atomic<uint64_t> fHits;
+	std::atomic<uint64_t> fMisses;
+};
+
+// Measures from a metrics cache without ever calling through it, for layout on threads
+// that must not use the text engine. Strings the cache does not hold are estimated and
+// remembered; MeasureMisses then measures them through the cache on the thread that
+// may, after which a layout computed again finds every extent cached. One instance per
+// layout; it is not shared between threads.
+class ChartDeferredMeasurer : public ChartTextMeasurer {
+public:
+	explicit ChartDeferredMeasurer(ChartTextMetricsCache& cache) : fCache(cache) {}
+
+	ChartTextExtent Measure(const std::string& fontName, double fontSize, const std::string& text) override;
+
+	// Extents are those of the cache once MeasureMisses has run
+	uint64_t GetIdentity() const override { return fCache.GetIdentity(); }
+
+	// Whether any extent was estimated since the last MeasureMisses
+	bool HasMisses() const { return !fMisses.empty(); }
+
+	// Measures the missed strings through the cache and forgets them
+	void MeasureMisses();
+
+private:
+	struct Miss {
+		std::string fontName;
+		double fontSize;
+		std::string text;
+	};
+
+	ChartTextMetricsCache& fCache;
+	std::vector<Miss> fMisses;
+};
+
+#endif // __ChartTextMetrics_h__
@@ -0,0 +1,61 @@
+//========================================================================================
+//  
+//  ChartTheme.h
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#ifndef __ChartTheme_h__
+#define __ChartTheme_h__
+
+// The default chart theme: the colors, stroke widths and dashes of the chart components
+// and series. The style table builds Illustrator path styles from it, and writers
+// outside the application paint with the same values. Free of Illustrator SDK types,
+// like the display list. Gray levels run from 0, white, to 1, black.
+
+#include "ChartDisplayList.h"
+#include <cstddef>
+
+// The paint of one chart component
+struct ChartRoleTheme {
+	bool filled;
+	double fillGray;
+	double strokeGray;
+	double strokeWidth;
+	double dash;			// Dash and gap length, 0 for a solid stroke
+};
+
+const ChartRoleTheme kChartRoleThemes[kChartStyleRoleCount] = {
+	{true, 0, 0.3, 1.0, 0},			// Background - white fill with light gray stroke
+	{true, 0, 0.5, 0.5, 0},			// Plot area - white fill with medium gray stroke
+	{false, 0, 0.15, 0.25, 2.0},	// Grid lines - thin light gray dashes
+	{false, 0, 0.7, 0.5, 0},		// Ticks - dark gray
+	{false, 0, 0.7, 0.5, 0},		// Axes - dark gray
+	{false, 0, 0.5, 0.25, 0}		// Data label leader lines - hairlines lighter than the ticks
+};
+
+// CMYK series colors, reused in order
+struct ChartSeriesColor {
+	double cyan, magenta, yellow, black;
+};
+
+const ChartSeriesColor kChartSeriesColors[] = {
+	{1.0, 0.5, 0.0, 0.0},	// Blue for series 1
+	{0.0, 0.5, 1.0, 0.0},	// Orange for series 2
+	{0.5, 0.0, 1.0, 0.0}	// Green for series 3
+};
+
+const size_t kChartSeriesColorCount = sizeof(kChartSeriesColors) / sizeof(kChartSeriesColors[0]);
+
+// Series fills are outlined like the axes; series lines are round-joined strokes
+const double kChartSeriesStrokeGray = 0.7;
+const double kChartSeriesStrokeWidth = 0.5;
+const double kChartSeriesLineWidth = 1.5;
+
+#endif // __ChartTheme_h__
@@ -0,0 +1,178 @@
+//========================================================================================
+//  
+//  ChartWorkerPool.cpp
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#include "ChartWorkerPool.h"
+#include <algorithm>
+
+namespace {
+
+// Set on pool workers and on a thread running a loop, so nested loops run inline
+thread_local bool tInLoop = false;
+
+// Marks the calling thread as running a loop until the scope ends, however it ends
+class InLoopScope {
+public:
+	InLoopScope() : fWasInLoop(tInLoop) { tInLoop = true; }
+	~InLoopScope() { tInLoop = fWasInLoop; }
+
+private:
+	bool fWasInLoop;
+};
+
+} // namespace
+
+/*
+*/
+ChartWorkerPool::ChartWorkerPool(size_t threadCount) :
+	fThreadCount(std::max<size_t>(threadCount, 1)), fGeneration(0), fStopping(false), fBody(nullptr), fCount(0), fNext(0), fFinished(0), fActive(0), fFailed(false)
+{
+}
+
+/*
+*/
+ChartWorkerPool::~ChartWorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(fMutex);
+		fStopping = true;
+	}
+	fWake.notify_all();
+	for (std::thread& worker : fWorkers) {
+		worker.join();
+	}
+}
+
+/*
+*/
+size_t ChartWorkerPool::DefaultThreadCount()
+{
+	const unsigned count = std::thread::hardware_concurrency();
+	return count > 0 ? count : 1;
+}
+
+/*
+*/
+void ChartWorkerPool::Start()
+{
+	fWorkers.reserve(fThreadCount - 1);
+	for (size_t i = 1; i < fThreadCount; i++) {
+		fWorkers.emplace_back(&ChartWorkerPool::WorkerMain, this);
+	}
+}
+
+/*
+*/
+void ChartWorkerPool::ParallelFor(size_t count, const std::function<void(size_t)>& body)
+{
+	if (count == 0) {
+		return;
+	}
+
+	// Serial when there is nothing to share, or when already inside a loop
+	if (count == 1 || fThreadCount == 1 || tInLoop) {
+		for (size_t i = 0; i < count; i++) {
+			body(i);
+		}
+		return;
+	}
+
+	std::lock_guard<std::mutex> loopLock(fLoopMutex);
+	if (fWorkers.empty()) {
+		Start();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(fMutex);
+		fBody = &body;
+		fCount = count;
+		fNext = 0;
+		fFinished = 0;
+		fFailed = false;
+		fGeneration++;
+	}
+	fWake.notify_all();
+
+	{
+		InLoopScope scope;
+		RunIndices();
+	}
+
+	// No worker may still be claiming indices when the next loop resets them
+	std::exception_ptr error;
+	{
+		std::unique_lock<std::mutex> lock(fMutex);
+		fDone.wait(lock, [this] { return fFinished == fCount && fActive == 0; });
+		fBody = nullptr;
+		error.swap(fError);
+	}
+	if (error) {
+		std::rethrow_exception(error);
+	}
+}
+
+/*
+*/
+void ChartWorkerPool::RunIndices()
+{
+	size_t ran = 0;
+	for (size_t i = fNext++; i < fCount; i = fNext++) {
+		// Once a call has thrown, the rest of the loop is claimed without being run
+		if (!fFailed) {
+			try {
+				(*fBody)(i);
+			}
+			catch (...) {
+				std::lock_guard<std::mutex> lock(fMutex);
+				if (!fError) {
+					fError = std::current_exception();
+				}
+				fFailed = true;
+			}
+		}
+		ran++;
+	}
+
+	std::lock_guard<std::mutex> lock(fMutex);
+	fFinished += ran;
+	if (fFinished == fCount) {
+		fDone.notify_all();
+	}
+}
+
+/*
+*/
+void ChartWorkerPool::WorkerMain()
+{
+	tInLoop = true;
+
+	uint64_t seen = 0;
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(fMutex);
+			fWake.wait(lock, [&] { return fStopping || (fGeneration != seen && fBody); });
+			if (fStopping) {
+				return;
+			}
+			seen = fGeneration;
+			fActive++;
+		}
+		RunIndices();
+		{
+			std::lock_guard<std::mutex> lock(fMutex);
+			fActive--;
+			if (fActive == 0) {
+				fDone.notify_all();
+			}
+		}
+	}
+}
@@ -0,0 +1,81 @@
+//========================================================================================
+//  
+//  ChartWorkerPool.h
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#ifndef __ChartWorkerPool_h__
+#define __ChartWorkerPool_h__
+
+// Fixed set of worker threads for chart layout. Work is only ever given to the pool as a
+// parallel loop the calling thread takes part in and waits for, so results are back on
+// the caller's thread when the loop returns and only the caller calls Illustrator suites.
+// The threads start on the first loop that can use them.
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ChartWorkerPool {
+public:
+	// threadCount counts the calling thread, so 1 runs every loop on the caller alone
+	explicit ChartWorkerPool(size_t threadCount = DefaultThreadCount());
+	~ChartWorkerPool();
+
+	// Calls body(i) for every i below count, spread over the workers and the calling
+	// thread, and returns once all calls have returned. A loop started from inside a body
+	// runs on the thread that started it. If a call throws, calls not yet started are
+	// skipped, and the first exception is rethrown here once the started calls return.
+	void ParallelFor(size_t count, const std::function<void(size_t)>& body);
+
+	size_t GetThreadCount() const { return fThreadCount; }
+
+	// One thread per hardware thread
+	static size_t DefaultThreadCount();
+
+private:
+	ChartWorkerPool(const ChartWorkerPool&) = delete;
+	ChartWorkerPool& operator=(const ChartWorkerPool&) = delete;
+
+	void Start();
+	void WorkerMain();
+
+	// Claims and runs indices of the current loop until none are left
+	void RunIndices();
+
+	size_t fThreadCount;
+	std::vector<std::thread> fWorkers;
+
+	// Serializes loops started from different threads
+	std::mutex fLoopMutex;
+
+	// The current loop, written under fMutex while no worker is running indices;
+	// fGeneration moves on each new loop to wake the workers
+	std::mutex fMutex;
+	std::condition_variable fWake;
+	std::condition_variable fDone;
+	uint64_t fGeneration;
+	bool fStopping;
+	const std::function<void(size_t)>* fBody;
+	size_t fCount;
+	std::atomic<size_t> fNext;
+	size_t fFinished;		// Indices run to completion
+	size_t fActive;			// Workers inside RunIndices
+	std::atomic<bool> fFailed;		// A call of the current loop threw
+	std::exception_ptr fError;		// The first exception thrown, written under fMutex
+};
+
+#endif // __ChartWorkerPool_h__
@@ -15,6 +15,12 @@
 
 #include "IllustratorSDK.h"
 #include "Charts.h"
+#include "ChartLayoutBatch.h"
+#include "ChartStyleTable.h"
+#include "ChartTheme.h"
+#include <cmath>
+#include <fstream>
+#include <sstream>
 
 /** A light yellow color that we will use as the background for our annotations
 */
@@ -32,9 +38,47 @@ const AIRGBColor PREVIEW_COLOR = {0, 30000, 65000};
 */
 const AIRGBColor TEXT_BACKGROUND = {58000, 58000, 58000};
 
+/** Smallest rectangle side, in view pixels, that the chart preview is drawn in
+*/
+const AIReal PREVIEW_MIN_SIZE = 16;
+
+/** Change in rectangle size, in view pixels, before the chart preview is laid out again
+*/
+const AIReal PREVIEW_LAYOUT_STEP = 4;
+
+/** Opacity of preview series fills, so the artwork under the rectangle shows through
+*/
+const AIReal PREVIEW_FILL_OPACITY = 0.5;
+
+/** Space between small multiples, which holds their axis labels
+*/
+const AIReal SMALL_MULTIPLES_GAP = 24;
+
+/** Annotation color of a theme gray level, from 0 white to 1 black
+*/
+static AIRGBColor GetPreviewGray(double gray)
+{
+	const unsigned short level = (unsigned short)((1 - gray) * 65535);
+	AIRGBColor color = {level, level, level};
+	return color;
+}
+
+/** Annotation color of a series, from its theme CMYK color
+*/
+static AIRGBColor GetPreviewSeriesColor(ai::int32 series)
+{
+	const ChartSeriesColor& cmyk = kChartSeriesColors[(size_t)max(0, series) % kChartSeriesColorCount];
+	AIRGBColor color = {
+		(unsigned short)((1 - cmyk.cyan) * (1 - cmyk.black) * 65535),
+		(unsigned short)((1 - cmyk.magenta) * (1 - cmyk.black) * 65535),
+		(unsigned short)((1 - cmyk.yellow) * (1 - cmyk.black) * 65535)
+	};
+	return color;
+}
+
 /*
 */
-Charts::Charts(): fArtLastHit(NULL), fArtUpdate(false), fCursorUpdate(false), fIsDrawingRect(false), fCurrentChartType(kChartTypeBar), fPluginGroupHandle(NULL)
+Charts::Charts(): fArtLastHit(NULL), fArtUpdate(false), fCursorUpdate(false), fIsDrawingRect(false), fViewZoom(0), fViewDocument(NULL), fCurrentChartType(kChartTypeBar), fPluginGroupHandle(NULL), fTextMetrics(fTextMeasurer)
 {
 	this->Init(fCursorViewPoint);
 	this->Init(fCursorArtPoint);
@@ -44,6 +88,28 @@ Charts::Charts(): fArtLastHit(NULL), fArtUpdate(false), fCursorUpdate(false), fI
 	this->Init(fRectStartPoint);
 	this->Init(fRectEndPoint);
 	this->Init(fSnappedPoint);
+	
+	// Charts render through the layout cache so reopened documents skip layout
+	ChartItem::SetLayoutCache(&fLayoutCache);
+	
+	// Labels are measured once per font, size and string
+	ChartItem::SetTextMeasurer(&fTextMetrics);
+	
+	// Large series are laid out on the workers
+	ChartItem::SetWorkerPool(&fWorkerPool);
+	
+	// Large charts are drawn in slices
+	ChartItem::SetRenderQueue(&fRenderQueue);
+}
+
+/*
+*/
+Charts::~Charts()
+{
+	ChartItem::SetLayoutCache(nullptr);
+	ChartItem::SetTextMeasurer(nullptr);
+	ChartItem::SetWorkerPool(nullptr);
+	ChartItem::SetRenderQueue(nullptr);
 }
 
 /*
@@ -156,6 +222,10 @@ ASErr Charts::MouseDown(AIToolMessage* message)
 		
 		fRectEndPoint = fRectStartPoint;
 		
+		// Sample the chart's data now, so the drag only lays out the sample
+		result = this->BindPreview();
+		aisdk::check_ai_error(result);
+		
 		// Clear any previous art selection
 		if (sAIMatchingArt->IsSomeArtSelected) {
 			result = sAIMatchingArt->DeselectAll();
@@ -195,6 +265,8 @@ ASErr Charts::MouseUp(AIToolMessage* message)
 		// FIRST: Stop drawing immediately to prevent cursor sticking
 		bool wasDrawing = fIsDrawingRect;
 		fIsDrawingRect = false;
+		fPreview.Unbind();
+		ChartATEMeasurer::Pass measurePass(fTextMeasurer);
 		
 		// Get current view
 		AIDocumentViewHandle vh = NULL;
@@ -232,12 +304,30 @@ ASErr Charts::MouseUp(AIToolMessage* message)
 				chartBounds.bottom = min(fRectStartPoint.v, fRectEndPoint.v);
 				
 				// Create a Chart object (custom group with chart properties)
+				// Draw from the document's shared dataset
+				ChartDataSource source;
+				ChartDatasetStore* store = this->GetDatasetStore();
+				if (store) {
+					result = store->Resolve(this->GetNewChartDataRef(), source);
+					aisdk::check_ai_error(result);
+				}
+				
+				// Allocate the ID here to retain the new chart's display list under it
+				const ai::int32 chartID = ChartItem::AllocateChartID();
 				AIArtHandle chartArt = nullptr;
-				result = ChartItem::CreatePluginArt(chartBounds, fCurrentChartType, nullptr, &chartArt);
+				result = ChartItem::CreatePluginArt(chartBounds, fCurrentChartType, nullptr, &chartArt, chartID, store ? &source : nullptr, &fChartOptions, this->GetRetainedArt(chartID));
 				if (result == kNoErr && chartArt) {
+					// Index the new chart
+					ChartRegistry* registry = this->GetChartRegistry();
+					if (registry) {
+						result = registry->Register(chartArt);
+						aisdk::check_ai_error(result);
+					}
+					
 					// Select the new chart
 					result = sAIArt->SetArtUserAttr(chartArt, kArtSelected, kArtSelected);
 					aisdk::check_ai_error(result);
+					fRenderQueue.Resync(chartArt);
 				} else {
 					// Chart creation failed, fall back to simple rectangle
 					AIArtHandle rectangleArt;
@@ -275,6 +365,7 @@ ASErr Charts::MouseUp(AIToolMessage* message)
 		result = ex;
 		// Ensure drawing state is reset even on error
 		fIsDrawingRect = false;
+		fPreview.Unbind();
 	}
 	return result;
 }
@@ -304,6 +395,15 @@ ASErr Charts::CheckForArtHit(AIToolMessage* message)
 			result = sAIHitTest->Release(hitRef);
 			aisdk::check_ai_error(result);
 			
+			// Treat a hit anywhere inside a chart as a hit on the chart itself
+			if (toolHitData.hit && toolHitData.object != NULL) {
+				ChartRegistry* registry = this->GetChartRegistry();
+				const ChartRecord* owner = registry ? registry->FindOwner(toolHitData.object) : nullptr;
+				if (owner) {
+					toolHitData.object = owner->art;
+				}
+			}
+			
 			if (toolHitData.hit && toolHitData.object != NULL && toolHitData.object != fArtLastHit) {
 				// New art item hit, set last art object hit in class to art item hit.
 				fArtLastHit = toolHitData.object;
@@ -381,6 +481,15 @@ ASErr Charts::DrawRectanglePreview(AIAnnotatorMessage* message)
 			previewRect.top = min(startView.v, endView.v);
 			previewRect.bottom = max(startView.v, endView.v);
 			
+			// Draw the chart the drag will create beneath the rectangle
+			AIRealRect chartBounds;
+			chartBounds.left = min(fRectStartPoint.h, fRectEndPoint.h);
+			chartBounds.right = max(fRectStartPoint.h, fRectEndPoint.h);
+			chartBounds.top = max(fRectStartPoint.v, fRectEndPoint.v);
+			chartBounds.bottom = min(fRectStartPoint.v, fRectEndPoint.v);
+			result = this->DrawChartPreview(message, chartBounds);
+			aisdk::check_ai_error(result);
+			
 			// Draw preview rectangle with solid blue lines
 			SDK_ASSERT(sAIAnnotatorDrawer);
 			sAIAnnotatorDrawer->SetColor(message->drawer, PREVIEW_COLOR);
@@ -435,6 +544,131 @@ ASErr Charts::DrawRectanglePreview(AIAnnotatorMessage* message)
 	return result;
 }
 
+/*
+*/
+ASErr Charts::BindPreview()
+{
+	ASErr result = kNoErr;
+	try {
+		// The data MouseUp will create the chart from
+		ChartDataSource source;
+		ChartDatasetStore* store = this->GetDatasetStore();
+		if (store) {
+			result = store->Resolve(this->GetNewChartDataRef(), source);
+			aisdk::check_ai_error(result);
+		}
+		const ChartDataset& dataset = source.dataset ? *source.dataset : ChartDataset::Sample();
+		
+		ChartSeriesView view;
+		if (dataset.Resolve(source.ref, view)) {
+			// The plot area is set as the rectangle is dragged
+			AIRealRect bounds = {0, 0, 0, 0};
+			ChartLayoutParams params;
+			ChartItem::MakeLayoutParams(bounds, fCurrentChartType, fChartOptions, params);
+			fPreview.Bind(view, params);
+		}
+		else {
+			fPreview.Unbind();
+		}
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+	return result;
+}
+
+/*
+*/
+ASErr Charts::DrawChartPreview(AIAnnotatorMessage* message, const AIRealRect& bounds)
+{
+	ASErr result = kNoErr;
+	try {
+		AIReal zoom = 1;
+		SDK_ASSERT(sAIDocumentView);
+		result = sAIDocumentView->GetDocumentViewZoom(NULL, &zoom);
+		aisdk::check_ai_error(result);
+		
+		const AIReal width = bounds.right - bounds.left;
+		const AIReal height = bounds.top - bounds.bottom;
+		if (fPreview.IsBound() && width * zoom >= PREVIEW_MIN_SIZE && height * zoom >= PREVIEW_MIN_SIZE) {
+			// Lay out again only once the size has changed by a few pixels; in between,
+			// the last layout is stretched to the rectangle
+			ChartATEMeasurer::Pass measurePass(fTextMeasurer);
+			fPreview.Update(width, height, PREVIEW_LAYOUT_STEP / zoom, fTextMetrics);
+			
+			// Preview points run from the rectangle's bottom left; map them to the view
+			// through its corners, which follows a rotated view too
+			AIRealPoint corners[3] = {{bounds.left, bounds.bottom}, {bounds.right, bounds.bottom}, {bounds.left, bounds.top}};
+			AIPoint viewCorners[3];
+			for (int i = 0; i < 3; i++) {
+				result = sAIDocumentView->ArtworkPointToViewPoint(NULL, &corners[i], &viewCorners[i]);
+				aisdk::check_ai_error(result);
+			}
+			const AIReal hh = (viewCorners[1].h - viewCorners[0].h) / fPreview.GetWidth();
+			const AIReal hv = (viewCorners[1].v - viewCorners[0].v) / fPreview.GetWidth();
+			const AIReal vh = (viewCorners[2].h - viewCorners[0].h) / fPreview.GetHeight();
+			const AIReal vv = (viewCorners[2].v - viewCorners[0].v) / fPreview.GetHeight();
+			
+			const std::vector<ChartPoint>& points = fPreview.GetPoints();
+			std::vector<AIPoint> viewPoints(points.size());
+			for (size_t i = 0; i < points.size(); i++) {
+				viewPoints[i].h = viewCorners[0].h + (ai::int32)floor(points[i].h * hh + points[i].v * vh + 0.5);
+				viewPoints[i].v = viewCorners[0].v + (ai::int32)floor(points[i].h * hv + points[i].v * vv + 0.5);
+			}
+			
+			SDK_ASSERT(sAIAnnotatorDrawer);
+			ai::uint32 begin = 0;
+			const std::vector<ChartPreviewShape>& shapes = fPreview.GetShapes();
+			for (size_t i = 0; i < shapes.size(); i++) {
+				const ChartPreviewShape& shape = shapes[i];
+				const AIPoint* run = viewPoints.data() + begin;
+				const ai::uint32 count = shape.end - begin;
+				begin = shape.end;
+				
+				if (shape.role == kChartPaintSeries) {
+					sAIAnnotatorDrawer->SetColor(message->drawer, GetPreviewSeriesColor(shape.series));
+					sAIAnnotatorDrawer->SetOpacity(message->drawer, PREVIEW_FILL_OPACITY);
+					result = sAIAnnotatorDrawer->DrawPolygon(message->drawer, run, count, true);
+					aisdk::check_ai_error(result);
+					sAIAnnotatorDrawer->SetOpacity(message->drawer, 1.0);
+					continue;
+				}
+				
+				// Lines in series colors, and the grid, axes and ticks in their theme grays
+				if (shape.role == kChartPaintSeriesLine) {
+					sAIAnnotatorDrawer->SetColor(message->drawer, GetPreviewSeriesColor(shape.series));
+					sAIAnnotatorDrawer->SetLineWidth(message->drawer, 2.0);
+					sAIAnnotatorDrawer->SetLineDashed(message->drawer, false);
+				}
+				else if (shape.role >= 0 && shape.role < kChartStyleRoleCount) {
+					const ChartRoleTheme& theme = kChartRoleThemes[shape.role];
+					sAIAnnotatorDrawer->SetColor(message->drawer, GetPreviewGray(theme.strokeGray));
+					sAIAnnotatorDrawer->SetLineWidth(message->drawer, 1.0);
+					sAIAnnotatorDrawer->SetLineDashed(message->drawer, theme.dash > 0);
+				}
+				else {
+					continue;
+				}
+				if (shape.closed) {
+					result = sAIAnnotatorDrawer->DrawPolygon(message->drawer, run, count, false);
+					aisdk::check_ai_error(result);
+				}
+				else {
+					for (ai::uint32 j = 1; j < count; j++) {
+						result = sAIAnnotatorDrawer->DrawLine(message->drawer, run[j - 1], run[j]);
+						aisdk::check_ai_error(result);
+					}
+				}
+			}
+			sAIAnnotatorDrawer->SetLineDashed(message->drawer, false);
+		}
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+	return result;
+}
+
 /*
 */
 ASErr Charts::DrawArtAnnotation(AIAnnotatorMessage* message)
@@ -675,3 +909,699 @@ void Charts::SetPluginGroupHandle(AIPluginGroupHandle handle)
 {
 	fPluginGroupHandle = handle;
 }
+
+/*
+*/
+ChartRegistry* Charts::GetChartRegistry()
+{
+	AIDocumentHandle document = NULL;
+	if (sAIDocument->GetDocument(&document) != kNoErr || document == NULL) {
+		return nullptr;
+	}
+	return &fRegistries[document];
+}
+
+/*
+*/
+ASErr Charts::RebuildChartRegistry()
+{
+	ASErr result = kNoErr;
+	try {
+		ChartRegistry* registry = this->GetChartRegistry();
+		if (registry) {
+			result = registry->Rebuild();
+			aisdk::check_ai_error(result);
+		}
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+	return result;
+}
+
+/*
+*/
+ASErr Charts::PruneChartRegistries()
+{
+	ASErr result = kNoErr;
+	try {
+		ai::int32 count = 0;
+		result = sAIDocumentList->Count(&count);
+		aisdk::check_ai_error(result);
+
+		std::map<AIDocumentHandle, ChartRegistry> openRegistries;
+		std::map<AIDocumentHandle, ChartDatasetStore> openStores;
+		std::map<AIDocumentHandle, std::string> openNewChartDatasets;
+		std::map<AIDocumentHandle, std::map<ai::int32, ChartRetainedArt>> openRetained;
+		std::vector<AIDocumentHandle> openDocuments;
+		for (ai::int32 i = 0; i < count; i++) {
+			AIDocumentHandle document = NULL;
+			result = sAIDocumentList->GetNthDocument(&document, i);
+			aisdk::check_ai_error(result);
+			openDocuments.push_back(document);
+
+			auto registry = fRegistries.find(document);
+			if (registry != fRegistries.end()) {
+				openRegistries[document] = std::move(registry->second);
+			}
+			auto store = fDatasetStores.find(document);
+			if (store != fDatasetStores.end()) {
+				openStores[document] = std::move(store->second);
+			}
+			auto newChartDataset = fNewChartDatasets.find(document);
+			if (newChartDataset != fNewChartDatasets.end()) {
+				openNewChartDatasets[document] = std::move(newChartDataset->second);
+			}
+			auto retained = fRetainedArt.find(document);
+			if (retained != fRetainedArt.end()) {
+				openRetained[document] = std::move(retained->second);
+			}
+		}
+		fRegistries.swap(openRegistries);
+		fDatasetStores.swap(openStores);
+		fNewChartDatasets.swap(openNewChartDatasets);
+		fRetainedArt.swap(openRetained);
+		fRenderQueue.Prune(openDocuments);
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+	return result;
+}
+
+/*
+*/
+ASErr Charts::SyncChartRegistry(AIBoolean selectionChanged)
+{
+	ASErr result = kNoErr;
+	try {
+		ChartRegistry* registry = this->GetChartRegistry();
+		if (registry) {
+			result = registry->Validate();
+			aisdk::check_ai_error(result);
+
+			if (selectionChanged) {
+				result = registry->RegisterSelection();
+				aisdk::check_ai_error(result);
+			}
+		}
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+	return result;
+}
+
+/** Tells the user how many of the charts being refreshed could not be redrawn.
+*/
+static void AlertRefreshFailures(size_t failed, size_t total)
+{
+	const std::string message = std::to_string(failed) + " of " + std::to_string(total) + " charts could not be refreshed. They keep their previous artwork.";
+	sAIUser->ErrorAlert(ai::UnicodeString(message));
+}
+
+/*
+*/
+ASErr Charts::RefreshAllCharts()
+{
+	ASErr result = kNoErr;
+	try {
+		ChartRegistry* registry = this->GetChartRegistry();
+		if (!registry) {
+			return kNoErr;
+		}
+
+		result = registry->Validate();
+		aisdk::check_ai_error(result);
+
+		// Copy the records; refreshing rewrites each chart's registry entry
+		std::vector<ChartRecord> records;
+		records.reserve(registry->Size());
+		for (const auto& entry : registry->GetRecords()) {
+			records.push_back(entry.second);
+		}
+
+		// Failures are reported together once every chart has been tried
+		std::vector<ai::int32> failed;
+		this->RefreshCharts(*registry, records, &failed);
+		if (!failed.empty()) {
+			AlertRefreshFailures(failed.size(), records.size());
+		}
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+	return result;
+}
+
+/*
+*/
+ASErr Charts::RefreshChart(ChartRegistry& registry, const ChartRecord& record, const ChartLayout* layout)
+{
+	ASErr result = kNoErr;
+	try {
+		ChartATEMeasurer::Pass measurePass(fTextMeasurer);
+		ChartDataSource source;
+		ChartDatasetStore* store = this->GetDatasetStore();
+		if (store) {
+			result = store->Resolve(record.dataRef, source);
+			aisdk::check_ai_error(result);
+		}
+
+		// Rewrite the chart's art in place; it keeps its handle and stacking order
+		result = ChartItem::UpdatePluginArt(record.art, record.plotBounds, record.chartType, record.chartID, store ? &source : nullptr, &record.options, this->GetRetainedArt(record.chartID), layout);
+		aisdk::check_ai_error(result);
+
+		result = registry.Register(record.art);
+		aisdk::check_ai_error(result);
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+	return result;
+}
+
+/*
+*/
+ASErr Charts::RefreshCharts(ChartRegistry& registry, const std::vector<ChartRecord>& records, std::vector<ai::int32>* failed)
+{
+	ASErr result = kNoErr;
+	try {
+		// Labels measured for any of the charts share one scratch text
+		ChartATEMeasurer::Pass measurePass(fTextMeasurer);
+		ChartDatasetStore* store = this->GetDatasetStore();
+
+		// Resolve every chart's data and parameters here, where the suites may be called.
+		// A chart whose data can't be resolved is left to RefreshChart, which reports it.
+		std::vector<ChartDataSource> sources(records.size());
+		std::vector<ChartLayoutJob> jobs;
+		std::vector<size_t> jobCharts;
+		jobs.reserve(records.size());
+		jobCharts.reserve(records.size());
+		for (size_t i = 0; i < records.size(); i++) {
+			const ChartRecord& record = records[i];
+			if (store && store->Resolve(record.dataRef, sources[i]) != kNoErr) {
+				continue;
+			}
+
+			jobs.emplace_back();
+			jobCharts.push_back(i);
+			ChartLayoutJob& job = jobs.back();
+			job.dataset = sources[i].dataset ? sources[i].dataset.get() : &ChartDataset::Sample();
+			if (sources[i].dataset) {
+				job.ref = sources[i].ref;
+			}
+			job.ref.datasetID = job.dataset->GetID();
+			ChartItem::MakeLayoutParams(record.plotBounds, record.chartType, record.options, job.params);
+		}
+
+		// Lay out on the workers, then draw one chart at a time on this thread
+		ChartLayoutBatch::Compute(jobs, fWorkerPool, fTextMetrics, &fLayoutCache);
+
+		std::vector<const ChartLayout*> layouts(records.size(), nullptr);
+		for (size_t j = 0; j < jobs.size(); j++) {
+			if (jobs[j].computed) {
+				layouts[jobCharts[j]] = &jobs[j].layout;
+			}
+		}
+
+		// One chart failing leaves the others to be drawn
+		for (size_t i = 0; i < records.size(); i++) {
+			ASErr chartResult = this->RefreshChart(registry, records[i], layouts[i]);
+			if (chartResult != kNoErr) {
+				if (result == kNoErr) {
+					result = chartResult;
+				}
+				if (failed) {
+					failed->push_back(records[i].chartID);
+				}
+			}
+		}
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+	return result;
+}
+
+/*
+*/
+ASErr Charts::CreateSmallMultiples(AIArtHandle templateArt, const std::string& facetColumn, ai::int32 columns, AIReal gap)
+{
+	ASErr result = kNoErr;
+	try {
+		ChartDatasetStore* store = this->GetDatasetStore();
+		ChartRegistry* registry = this->GetChartRegistry();
+		if (!store || !registry || columns < 0) {
+			return kBadParameterErr;
+		}
+		ChartATEMeasurer::Pass measurePass(fTextMeasurer);
+
+		result = registry->Validate();
+		aisdk::check_ai_error(result);
+
+		const ChartRecord* owner = registry->FindOwner(templateArt);
+		if (!owner) {
+			return kBadParameterErr;
+		}
+		const ChartRecord pattern = *owner;
+
+		ChartDataSource source;
+		result = store->Resolve(pattern.dataRef, source);
+		aisdk::check_ai_error(result);
+
+		std::vector<ChartDataset> facets;
+		if (!source.dataset || !source.dataset->Facet(facetColumn, facets) || facets.empty()) {
+			return kBadParameterErr;
+		}
+
+		if (columns == 0) {
+			columns = (ai::int32)std::ceil(std::sqrt((double)facets.size()));
+		}
+
+		// Each facet is stored like an imported dataset, so its chart refreshes from it.
+		// Cells are the chart's size, in rows of columns below it.
+		const AIReal width = pattern.plotBounds.right - pattern.plotBounds.left;
+		const AIReal height = pattern.plotBounds.top - pattern.plotBounds.bottom;
+		std::vector<AIRealRect> cells(facets.size());
+		std::vector<ChartDataSource> sources(facets.size());
+		std::vector<ChartLayoutJob> jobs(facets.size());
+		for (size_t i = 0; i < facets.size(); i++) {
+			result = store->Put(facets[i]);
+			aisdk::check_ai_error(result);
+
+			ChartDataRef ref = pattern.dataRef;
+			ref.datasetID = facets[i].GetID();
+			result = store->Resolve(ref, sources[i]);
+			aisdk::check_ai_error(result);
+
+			const size_t row = i / columns;
+			const size_t column = i % columns;
+			AIRealRect& cell = cells[i];
+			cell.left = pattern.plotBounds.left + column * (width + gap);
+			cell.right = cell.left + width;
+			cell.top = pattern.plotBounds.bottom - gap - row * (height + gap);
+			cell.bottom = cell.top - height;
+
+			ChartLayoutJob& job = jobs[i];
+			job.dataset = sources[i].dataset ? sources[i].dataset.get() : &ChartDataset::Sample();
+			if (sources[i].dataset) {
+				job.ref = sources[i].ref;
+			}
+			job.ref.datasetID = job.dataset->GetID();
+			ChartItem::MakeLayoutParams(cell, pattern.chartType, pattern.options, job.params);
+		}
+
+		// Lay out on the workers, then draw one chart at a time on this thread
+		ChartLayoutBatch::Compute(jobs, fWorkerPool, fTextMetrics, &fLayoutCache);
+
+		// Charts with the same series share one style table, bound again only when the
+		// series change, as they do between the facets of a pie chart
+		ChartStyleTable styles;
+		std::vector<std::string> boundNames;
+		AIBoolean bound = false;
+		for (size_t i = 0; i < facets.size(); i++) {
+			if (!jobs[i].computed) {
+				continue;
+			}
+
+			const std::vector<std::string>& seriesNames = jobs[i].layout.seriesNames;
+			if (!bound || seriesNames != boundNames) {
+				result = styles.BindToDocument(seriesNames);
+				aisdk::check_ai_error(result);
+				boundNames = seriesNames;
+				bound = true;
+			}
+
+			const ai::int32 chartID = ChartItem::AllocateChartID();
+			AIArtHandle chartArt = nullptr;
+			result = ChartItem::CreatePluginArt(cells[i], pattern.chartType, nullptr, &chartArt, chartID, &sources[i], &pattern.options, this->GetRetainedArt(chartID),
+				&jobs[i].layout, &styles);
+			aisdk::check_ai_error(result);
+
+			result = registry->Register(chartArt);
+			aisdk::check_ai_error(result);
+			fRenderQueue.Resync(chartArt);
+		}
+
+		// Everything above happens in this one call, which Illustrator undoes as one step
+		result = sAIUndo->SetUndoTextUS(ai::UnicodeString("Undo Small Multiples"), ai::UnicodeString("Redo Small Multiples"));
+		aisdk::check_ai_error(result);
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+	return result;
+}
+
+/** Accepts the names of the dataset's columns
+*/
+static AIBoolean IsFacetColumn(const ai::UnicodeString& input, void* userData)
+{
+	const ChartDataset* dataset = (const ChartDataset*)userData;
+	return dataset->FindColumn(input.as_UTF8()) != nullptr;
+}
+
+/*
+*/
+ASErr Charts::CreateSmallMultiplesOfSelection()
+{
+	ASErr result = kNoErr;
+	try {
+		ChartDatasetStore* store = this->GetDatasetStore();
+		ChartRegistry* registry = this->GetChartRegistry();
+		if (!store || !registry) {
+			return kNoErr;
+		}
+		result = registry->Validate();
+		aisdk::check_ai_error(result);
+
+		const ChartRecord* selected = registry->FindSelected();
+		if (!selected) {
+			return kNoErr;
+		}
+		const AIArtHandle chartArt = selected->art;
+
+		ChartDataSource source;
+		result = store->Resolve(selected->dataRef, source);
+		aisdk::check_ai_error(result);
+		if (!source.dataset) {
+			return kNoErr;
+		}
+
+		// Offer the first text column the chart does not already use for its categories
+		ChartSeriesView view;
+		source.dataset->Resolve(source.ref, view);
+		std::string facetColumn;
+		for (size_t i = 0; i < source.dataset->GetColumnCount() && facetColumn.empty(); i++) {
+			const ChartColumn& column = source.dataset->GetColumn(i);
+			if (column.kind == ChartColumn::kText && &column != view.categories) {
+				facetColumn = column.name;
+			}
+		}
+
+		ai::UnicodeString input = ai::UnicodeString::FromUTF8(facetColumn);
+		result = sAIUser->GetInputFromUser(ai::UnicodeString("Create Small Multiples"), nullptr, ai::UnicodeString("Facet column:"), input,
+			IsFacetColumn, (void*)source.dataset.get(), 0);
+		if (result == kCanceledErr) {
+			return kNoErr;
+		}
+		aisdk::check_ai_error(result);
+
+		result = this->CreateSmallMultiples(chartArt, input.as_UTF8(), 0, SMALL_MULTIPLES_GAP);
+		aisdk::check_ai_error(result);
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+	return result;
+}
+
+/*
+*/
+AIBoolean Charts::IsChartSelected()
+{
+	ChartRegistry* registry = this->GetChartRegistry();
+	return registry && registry->Validate() == kNoErr && registry->FindSelected() != nullptr;
+}
+
+/*
+*/
+void Charts::SetRenderTimer(AITimerHandle timer)
+{
+	fRenderQueue.SetTimer(timer);
+}
+
+/*
+*/
+ASErr Charts::RunRenderSlice()
+{
+	ASErr result = kNoErr;
+	try {
+		std::vector<ai::int32> edited;
+		result = fRenderQueue.RunSlice(edited);
+		aisdk::check_ai_error(result);
+
+		// A chart edited mid render is drawn again from its record, if it still exists
+		ChartRegistry* registry = this->GetChartRegistry();
+		if (edited.empty() || !registry) {
+			return kNoErr;
+		}
+
+		result = registry->Validate();
+		aisdk::check_ai_error(result);
+
+		for (ai::int32 chartID : edited) {
+			const ChartRecord* record = registry->Find(chartID);
+			if (record) {
+				const ChartRecord copy = *record;
+				result = this->RefreshChart(*registry, copy);
+				aisdk::check_ai_error(result);
+			}
+		}
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+	return result;
+}
+
+/*
+*/
+ASErr Charts::ViewChanged()
+{
+	ASErr result = kNoErr;
+	try {
+		AIDocumentHandle document = NULL;
+		result = sAIDocument->GetDocument(&document);
+		if (result != kNoErr || document == NULL) {
+			return kNoErr;
+		}
+
+		AIReal zoom = 0;
+		result = sAIDocumentView->GetDocumentViewZoom(NULL, &zoom);
+		aisdk::check_ai_error(result);
+
+		// Panning leaves the zoom as it was
+		if (zoom == fViewZoom && document == fViewDocument) {
+			return kNoErr;
+		}
+		fViewZoom = zoom;
+		fViewDocument = document;
+
+		// Charts drawn from now on follow the current view
+		ChartItem::SetDetailLevel(ChartLayout::GetDetailLevel(zoom));
+
+		ChartRegistry* registry = this->GetChartRegistry();
+		if (!registry) {
+			return kNoErr;
+		}
+
+		result = registry->Validate();
+		aisdk::check_ai_error(result);
+
+		std::vector<ChartRecord> stale;
+		for (const auto& entry : registry->GetRecords()) {
+			const ChartRecord& record = entry.second;
+			if (record.options.adaptiveDetail && ChartLayout::IsDetailStale(record.detailLevel, zoom)) {
+				stale.push_back(record);
+			}
+		}
+
+		if (!stale.empty()) {
+			// A chart that fails keeps its detail level, so it is tried again on the next zoom
+			this->RefreshCharts(*registry, stale);
+
+			// Redrawing for the zoom is not an edit: no undo step, and the document stays clean
+			sAIUndo->SetSilent(true);
+		}
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+	return result;
+}
+
+/*
+*/
+ChartRetainedArt* Charts::GetRetainedArt(ai::int32 chartID)
+{
+	AIDocumentHandle document = NULL;
+	if (sAIDocument->GetDocument(&document) != kNoErr || document == NULL) {
+		return nullptr;
+	}
+	return &fRetainedArt[document][chartID];
+}
+
+/*
+*/
+ChartDataRef Charts::GetNewChartDataRef()
+{
+	ChartDataRef ref;
+	AIDocumentHandle document = NULL;
+	if (sAIDocument->GetDocument(&document) != kNoErr || document == NULL) {
+		return ref;
+	}
+	auto imported = fNewChartDatasets.find(document);
+	if (imported != fNewChartDatasets.end()) {
+		ref.datasetID = imported->second;
+	}
+	return ref;
+}
+
+/*
+*/
+ChartDatasetStore* Charts::GetDatasetStore()
+{
+	AIDocumentHandle document = NULL;
+	if (sAIDocument->GetDocument(&document) != kNoErr || document == NULL) {
+		return nullptr;
+	}
+	return &fDatasetStores[document];
+}
+
+/** Makes a dataset ID from a name that no dataset of a store has yet.
+*/
+static std::string MakeDatasetID(ChartDatasetStore& store, const std::string& name)
+{
+	const std::string base = name.empty() ? "Imported" : name;
+	std::string datasetID = base;
+	for (int copy = 2; store.Get(datasetID); copy++) {
+		datasetID = base + " " + std::to_string(copy);
+	}
+	return datasetID;
+}
+
+/*
+*/
+ASErr Charts::ImportDatasetFromFile()
+{
+	ASErr result = kNoErr;
+	try {
+		ChartDatasetStore* store = this->GetDatasetStore();
+		ChartRegistry* registry = this->GetChartRegistry();
+		if (!store || !registry) {
+			return kNoErr;
+		}
+		result = registry->Validate();
+		aisdk::check_ai_error(result);
+
+		// Copy the selection; the dialog may let the document change under the registry
+		const ChartRecord* found = registry->FindSelected();
+		const AIBoolean hasSelection = found != nullptr;
+		const ChartRecord selected = found ? *found : ChartRecord();
+
+		AIFileDialogFilters filters;
+		filters.AddFilter(ai::UnicodeString("CSV Files (*.csv)"), ai::UnicodeString("*.csv"));
+		filters.AddFilter(ai::UnicodeString("All Files (*.*)"), ai::UnicodeString("*.*"));
+		ai::FilePath path;
+		result = sAIUser->GetFileDialog(ai::UnicodeString("Import Chart Data"), &filters, path);
+		if (result == kCanceledErr || path.IsEmpty()) {
+			return kNoErr;
+		}
+		aisdk::check_ai_error(result);
+
+		std::ifstream file(path.GetFullPath().as_Platform(), std::ios::binary);
+		std::ostringstream text;
+		text << file.rdbuf();
+
+		ChartDataset dataset(MakeDatasetID(*store, path.GetFileNameNoExt().as_UTF8()));
+		if (!file || !ChartDataset::ParseCSV(text.str(), dataset)) {
+			sAIUser->ErrorAlert(ai::UnicodeString("The file could not be read as CSV with a header row."));
+			return kNoErr;
+		}
+
+		if (hasSelection) {
+			result = registry->Validate();
+			aisdk::check_ai_error(result);
+
+			// The selected chart's dataset is replaced in place only if no other chart
+			// draws from it, or if the user wants every chart sharing it to follow
+			const std::string& currentID = selected.dataRef.datasetID;
+			size_t sharing = 0;
+			for (const auto& entry : registry->GetRecords()) {
+				if (entry.second.chartID != selected.chartID && entry.second.dataRef.datasetID == currentID) {
+					sharing++;
+				}
+			}
+			AIBoolean replace = false;
+			if (sharing > 0) {
+				const std::string question = "The selected chart shares its data with " + std::to_string(sharing) + " other charts. Replace the data of all of them?";
+				replace = sAIUser->YesNoAlert(ai::UnicodeString(question));
+			} else {
+				replace = !currentID.empty() && currentID != ChartDataset::Sample().GetID();
+			}
+			if (replace) {
+				dataset.SetID(currentID);
+				result = this->ImportDataset(dataset);
+				aisdk::check_ai_error(result);
+				return kNoErr;
+			}
+
+			// Otherwise only the selected chart is bound to the new dataset, from its
+			// first text column and every numeric one
+			result = store->Put(dataset);
+			aisdk::check_ai_error(result);
+
+			ChartRecord rebound = selected;
+			rebound.dataRef = ChartDataRef();
+			rebound.dataRef.datasetID = dataset.GetID();
+			result = this->RefreshChart(*registry, rebound);
+			aisdk::check_ai_error(result);
+		} else {
+			// Charts already drawn keep their data; charts drawn from now on use the file's
+			result = store->Put(dataset);
+			aisdk::check_ai_error(result);
+
+			AIDocumentHandle document = NULL;
+			result = sAIDocument->GetDocument(&document);
+			aisdk::check_ai_error(result);
+			fNewChartDatasets[document] = dataset.GetID();
+		}
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+	return result;
+}
+
+/*
+*/
+ASErr Charts::ImportDataset(const ChartDataset& dataset)
+{
+	ASErr result = kNoErr;
+	try {
+		ChartDatasetStore* store = this->GetDatasetStore();
+		ChartRegistry* registry = this->GetChartRegistry();
+		if (!store || !registry) {
+			return kNoErr;
+		}
+
+		AIBoolean changed = false;
+		result = store->Put(dataset, &changed);
+		aisdk::check_ai_error(result);
+		if (!changed) {
+			return kNoErr;
+		}
+
+		result = registry->Validate();
+		aisdk::check_ai_error(result);
+
+		// Every chart referencing the dataset is redrawn from the one shared copy
+		std::vector<ChartRecord> dependents;
+		for (const auto& entry : registry->GetRecords()) {
+			if (entry.second.dataRef.datasetID == dataset.GetID()) {
+				dependents.push_back(entry.second);
+			}
+		}
+		std::vector<ai::int32> failed;
+		this->RefreshCharts(*registry, dependents, &failed);
+		if (!failed.empty()) {
+			AlertRefreshFailures(failed.size(), dependents.size());
+		}
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+	return result;
+}
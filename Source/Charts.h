@@ -20,8 +20,18 @@
 #include "SDKErrors.h"
 #include "ChartsSuites.h"
 #include "ChartItem.h"
+#include "ChartDisplayEmitter.h"
+#include "ChartRegistry.h"
+#include "ChartDatasetStore.h"
+#include "ChartLayoutCache.h"
+#include "ChartATEMeasurer.h"
+#include "ChartTextMetrics.h"
+#include "ChartWorkerPool.h"
+#include "ChartRenderQueue.h"
+#include "ChartPreview.h"
 #include <vector>
 #include <memory>
+#include <map>
 
 /** This class provides a very basic demonstration of the use of the 
 	AIAnnotatorSuite and AIAnnotatorDrawerSuite to add your own annotations 
@@ -82,14 +92,59 @@ private:
 	*/
 	AIRealPoint fSnappedPoint;
 	
-	/** Collection of chart items created in the document
+	/** Chart registry for each open document
 	*/
-	std::vector<std::unique_ptr<ChartItem>> fChartItems;
+	std::map<AIDocumentHandle, ChartRegistry> fRegistries;
+
+	/** Shared chart datasets for each open document
+	*/
+	std::map<AIDocumentHandle, ChartDatasetStore> fDatasetStores;
+
+	/** Dataset charts drawn with the tool are bound to in each open document, by ID
+	*/
+	std::map<AIDocumentHandle, std::string> fNewChartDatasets;
+
+	/** Display lists the charts of each open document were last emitted from, by chart ID
+	*/
+	std::map<AIDocumentHandle, std::map<ai::int32, ChartRetainedArt>> fRetainedArt;
+
+	/** On-disk cache of chart layouts, shared by all documents
+	*/
+	ChartLayoutCache fLayoutCache;
+	
+	/** Measures chart labels through the text engine
+	*/
+	ChartATEMeasurer fTextMeasurer;
+	
+	/** Label extents already measured, in front of fTextMeasurer
+	*/
+	ChartTextMetricsCache fTextMetrics;
+	
+	/** Workers that lay out charts off the main thread
+	*/
+	ChartWorkerPool fWorkerPool;
+	
+	/** Jobs drawing large charts a slice at a time
+	*/
+	ChartRenderQueue fRenderQueue;
+	
+	/** The view zoom charts were last checked against, and its document
+	*/
+	AIReal fViewZoom;
+	AIDocumentHandle fViewDocument;
 	
 	/** Current chart type being created
 	*/
 	ChartType fCurrentChartType;
 	
+	/** Options given to charts drawn with the tool
+	*/
+	ChartOptions fChartOptions;
+	
+	/** Sampled outline of the chart being dragged out, laid out at the rectangle's size
+	*/
+	ChartPreview fPreview;
+	
 	/** Handle to the chart plugin group for creating custom art objects
 	*/
 	AIPluginGroupHandle fPluginGroupHandle;
@@ -103,7 +158,7 @@ public:
 
 	/**	Destructor.
 	*/
-	virtual ~Charts(){}
+	virtual ~Charts();
 
 	/** Initialise both coordinates in an AIPoint struct to 0.
 		@param point IN the point to initialise.
@@ -221,6 +276,163 @@ public:
 		@param handle IN the plugin group handle.
 	*/
 	void SetPluginGroupHandle(AIPluginGroupHandle handle);
+
+	/**	Gets the chart registry of the current document, creating an empty one if needed.
+		@return the registry, or nullptr if there is no current document.
+	*/
+	ChartRegistry* GetChartRegistry();
+
+	/**	Rebuilds the current document's chart registry with one scan of its artwork.
+		@return kNoErr on success, other ASErr otherwise.
+	*/
+	ASErr RebuildChartRegistry();
+
+	/**	Drops registries of documents that are no longer open.
+		@return kNoErr on success, other ASErr otherwise.
+	*/
+	ASErr PruneChartRegistries();
+
+	/**	Brings the current document's chart registry up to date after an edit.
+		@param selectionChanged IN true if the selection changed, in which case newly
+			selected charts not yet in the registry are added.
+		@return kNoErr on success, other ASErr otherwise.
+	*/
+	ASErr SyncChartRegistry(AIBoolean selectionChanged);
+
+	/**	Recreates the artwork of every chart in the current document, using the
+		chart registry to find them.
+		@return kNoErr on success, other ASErr otherwise.
+	*/
+	ASErr RefreshAllCharts();
+
+	/**	Gets the dataset store of the current document.
+		@return the store, or nullptr if there is no current document.
+	*/
+	ChartDatasetStore* GetDatasetStore();
+
+	/**	Stores a dataset in the current document and, if its content changed,
+		refreshes every chart drawn from it.
+		@param dataset IN the imported dataset.
+		@return kNoErr on success, other ASErr otherwise.
+	*/
+	ASErr ImportDataset(const ChartDataset& dataset);
+
+	/**	Asks for a CSV file and imports it as a new dataset, named after the file. The
+		selected chart is redrawn from it; without a selection, charts drawn from then on
+		are. A dataset the selected chart shares with others is replaced in all of them
+		only if the user agrees.
+		@return kNoErr on success or if the user cancels, other ASErr otherwise.
+	*/
+	ASErr ImportDatasetFromFile();
+
+	/**	Creates a grid of small multiples of a chart, one per value of a facet column of
+		its dataset, in rows below it. Each facet is stored as a dataset of its own, the
+		charts are laid out together on the worker pool and drawn with shared styles, and
+		the grid is one undo step.
+		@param templateArt IN the chart, or art inside it, whose type, size, options and
+			columns the grid repeats.
+		@param facetColumn IN the column of the chart's dataset whose values split its rows.
+		@param columns IN charts per row of the grid, or 0 for a grid about as many
+			charts wide as tall.
+		@param gap IN space between cells of the grid, and between the chart and the grid,
+			which holds the charts' axis labels.
+		@return kNoErr on success, kBadParameterErr if the art is not a chart or its
+			dataset has no such column, other ASErr otherwise.
+	*/
+	ASErr CreateSmallMultiples(AIArtHandle templateArt, const std::string& facetColumn, ai::int32 columns, AIReal gap);
+
+	/**	Asks for a facet column of the selected chart's dataset, offering its first text
+		column other than the categories, and creates small multiples of the chart on it.
+		@return kNoErr on success or if the user cancels, other ASErr otherwise.
+	*/
+	ASErr CreateSmallMultiplesOfSelection();
+
+	/**	Reports whether a chart, or art inside one, is selected.
+		@return true if a chart is selected.
+	*/
+	AIBoolean IsChartSelected();
+
+	/**	Gets the layout cache charts are rendered through, for its hit-rate counters.
+		@return the cache.
+	*/
+	ChartLayoutCache& GetLayoutCache() { return fLayoutCache; }
+
+	/**	Gets the text metrics cache labels are measured through, for its hit-rate counters.
+		@return the cache.
+	*/
+	ChartTextMetricsCache& GetTextMetrics() { return fTextMetrics; }
+
+	/**	Sets the options given to charts drawn from now on.
+		@param options IN the options.
+	*/
+	void SetChartOptions(const ChartOptions& options) { fChartOptions = options; }
+
+	/**	Gets the options given to new charts.
+		@return the options.
+	*/
+	const ChartOptions& GetChartOptions() const { return fChartOptions; }
+
+	/**	Sets the idle timer that runs slices of progressive chart renders. The render
+		queue activates it only while it has charts to draw.
+		@param timer IN the timer.
+	*/
+	void SetRenderTimer(AITimerHandle timer);
+
+	/**	Draws the next slice of the charts being rendered progressively in the current
+		document. A chart edited before its render completed is drawn again.
+		@return kNoErr on success, other ASErr otherwise.
+	*/
+	ASErr RunRenderSlice();
+
+	/**	Redraws the data marks of adaptive charts in the current document whose level
+		of detail the current view's zoom has left. Panning, and zooms within an octave of
+		a chart's level, leave charts as they are.
+		@return kNoErr on success, other ASErr otherwise.
+	*/
+	ASErr ViewChanged();
+
+private:
+	/**	Gets the retained display list of a chart in the current document, creating an
+		empty one if needed.
+		@param chartID IN the chart's ID.
+		@return the retained list, or nullptr if there is no current document.
+	*/
+	ChartRetainedArt* GetRetainedArt(ai::int32 chartID);
+
+	/**	Gets the data a chart drawn with the tool in the current document is bound to.
+		@return the last dataset imported with no chart selected, or an empty reference
+			for the sample dataset.
+	*/
+	ChartDataRef GetNewChartDataRef();
+
+	/**	Recreates one chart's artwork in place from its registry record.
+		@param registry IN the registry holding the record; it is updated with the new art.
+		@param record IN a copy of the chart's record.
+		@param layout IN the chart's layout if already computed, or nullptr to compute it.
+		@return kNoErr on success, other ASErr otherwise.
+	*/
+	ASErr RefreshChart(ChartRegistry& registry, const ChartRecord& record, const ChartLayout* layout = nullptr);
+
+	/**	Recreates the artwork of several charts, laying them all out on the worker pool
+		before drawing each on the main thread. Each chart is refreshed even if others fail.
+		@param registry IN the registry holding the records.
+		@param records IN copies of the charts' records.
+		@param failed OUT if not nullptr, receives the IDs of the charts that failed.
+		@return kNoErr if every chart was refreshed, otherwise the first chart's error.
+	*/
+	ASErr RefreshCharts(ChartRegistry& registry, const std::vector<ChartRecord>& records, std::vector<ai::int32>* failed = nullptr);
+
+	/**	Samples the data the chart being dragged out will draw from into the preview.
+		@return kNoErr on success, other ASErr otherwise.
+	*/
+	ASErr BindPreview();
+
+	/**	Draws the preview's columns, grid and axes stretched to the rectangle being dragged.
+		@param message IN message data.
+		@param bounds IN the rectangle in artwork coordinates.
+		@return kNoErr on success, other ASErr otherwise.
+	*/
+	ASErr DrawChartPreview(AIAnnotatorMessage* message, const AIRealRect& bounds);
 };
 
 #endif // __CHARTS_H__
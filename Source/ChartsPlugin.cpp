@@ -43,10 +43,20 @@ ASErr ChartsPlugin::SetGlobal(Plugin* plugin)
 */
 ChartsPlugin::ChartsPlugin(SPPluginRef pluginRef) :
 	Plugin(pluginRef), fToolHandle(NULL), fAboutPluginMenu(NULL), 
+	fChartsMenu(NULL), fRefreshChartsMenu(NULL), fImportDataMenu(NULL), fSmallMultiplesMenu(NULL),
+	fChartOptionsMenu(NULL), fDataLabelsMenu(NULL), fAdaptiveDetailMenu(NULL), fBridgeGapsMenu(NULL),
+	fNormalizeStackMenu(NULL), fLogValueScaleMenu(NULL), fLogXScaleMenu(NULL),
 	fAnnotatorHandle(NULL), fNotifySelectionChanged(NULL),
 	fAnnotator(NULL),
     fResourceManagerHandle(NULL),
 	fShutdownApplicationNotifier(NULL),
+	fDocumentOpenedNotifier(NULL),
+	fDocumentClosedNotifier(NULL),
+	fDocumentChangedNotifier(NULL),
+	fArtPropertiesChangedNotifier(NULL),
+	fViewVisibleAreaChangedNotifier(NULL),
+	fViewActivatedNotifier(NULL),
+	fRenderTimer(NULL),
 	fChartPluginGroupHandle(NULL)
 {	
 	strncpy(fPluginName, kChartsPluginName, kMaxStringLength);
@@ -70,6 +80,10 @@ ASErr ChartsPlugin::StartupPlugin(SPInterfaceMessage* message)
 					&fAboutPluginMenu);
 		aisdk::check_ai_error(result);
 
+		// Add the chart commands.
+		result = this->AddMenus(message);
+		aisdk::check_ai_error(result);
+
 		// Add tool.
 		result = this->AddTool(message);
 		aisdk::check_ai_error(result);
@@ -82,6 +96,10 @@ ASErr ChartsPlugin::StartupPlugin(SPInterfaceMessage* message)
 		result = this->AddNotifier(message);
 		aisdk::check_ai_error(result);
 
+		// Add render timer.
+		result = this->AddTimer(message);
+		aisdk::check_ai_error(result);
+
 		// Register plugin group for custom chart art objects (following LiveDropShadow pattern)
 		AIAddPluginGroupData pluginGroupData;
 		pluginGroupData.major = 1;
@@ -128,6 +146,7 @@ ASErr ChartsPlugin::PostStartupPlugin()
 			SDK_ASSERT(fAnnotator);
 			// Set the plugin group handle so Charts can create custom art objects
 			fAnnotator->SetPluginGroupHandle(fChartPluginGroupHandle);
+			fAnnotator->SetRenderTimer(fRenderTimer);
 		}
         result = sAIUser->CreateCursorResourceMgr(fPluginRef,&fResourceManagerHandle);
         aisdk::check_ai_error(result);
@@ -213,6 +232,23 @@ ASErr ChartsPlugin::GoMenuItem(AIMenuMessage* message)
 			SDKAboutPluginsHelper aboutPluginsHelper;
 			aboutPluginsHelper.PopAboutBox(message, "About Charts", kSDKDefAboutSDKCompanyPluginsAlertString);
 		}
+		else if (message->menuItem == fRefreshChartsMenu && fAnnotator) {
+			result = fAnnotator->RefreshAllCharts();
+			aisdk::check_ai_error(result);
+		}
+		else if (message->menuItem == fImportDataMenu && fAnnotator) {
+			result = fAnnotator->ImportDatasetFromFile();
+			aisdk::check_ai_error(result);
+		}
+		else if (message->menuItem == fSmallMultiplesMenu && fAnnotator) {
+			result = fAnnotator->CreateSmallMultiplesOfSelection();
+			aisdk::check_ai_error(result);
+		}
+		else if (fAnnotator && this->IsChartOptionMenu(message->menuItem)) {
+			ChartOptions options = fAnnotator->GetChartOptions();
+			this->ToggleChartOption(message->menuItem, options);
+			fAnnotator->SetChartOptions(options);
+		}
 	}
 	catch (ai::Error& ex) {
 		result = ex;
@@ -232,6 +268,20 @@ ASErr ChartsPlugin::UpdateMenuItem(AIMenuMessage* message)
 	ASErr result = kNoErr;
 	try 
 	{
+		// Small multiples repeat a chart, so one must be selected
+		if (message->menuItem == fSmallMultiplesMenu) {
+			if (fAnnotator && fAnnotator->IsChartSelected()) {
+				result = sAIMenu->EnableItem(message->menuItem);
+			}
+			else {
+				result = sAIMenu->DisableItem(message->menuItem);
+			}
+			aisdk::check_ai_error(result);
+		}
+		else if (fAnnotator && this->IsChartOptionMenu(message->menuItem)) {
+			result = sAIMenu->CheckItem(message->menuItem, this->GetChartOption(message->menuItem, fAnnotator->GetChartOptions()));
+			aisdk::check_ai_error(result);
+		}
 	}
 	catch (ai::Error& ex) {
 		result = ex;
@@ -259,6 +309,25 @@ ASErr ChartsPlugin::Notify(AINotifierMessage* message)
 			// Invalidate the entire document view bounds.
 			result = fAnnotator->InvalidateRect(viewBounds);
 			aisdk::check_ai_error(result);
+			// Pick up charts that arrived by paste or duplicate.
+			result = fAnnotator->SyncChartRegistry(true);
+			aisdk::check_ai_error(result);
+		}
+		if (message->notifier == fDocumentOpenedNotifier) {
+			result = fAnnotator->RebuildChartRegistry();
+			aisdk::check_ai_error(result);
+		}
+		if (message->notifier == fDocumentClosedNotifier) {
+			result = fAnnotator->PruneChartRegistries();
+			aisdk::check_ai_error(result);
+		}
+		if (message->notifier == fDocumentChangedNotifier || message->notifier == fArtPropertiesChangedNotifier) {
+			result = fAnnotator->SyncChartRegistry(false);
+			aisdk::check_ai_error(result);
+		}
+		if (message->notifier == fViewVisibleAreaChangedNotifier || message->notifier == fViewActivatedNotifier) {
+			result = fAnnotator->ViewChanged();
+			aisdk::check_ai_error(result);
 		}
 		if (message->notifier == fShutdownApplicationNotifier)
 		{
@@ -280,6 +349,27 @@ ASErr ChartsPlugin::Notify(AINotifierMessage* message)
 	return result;
 }
 
+/*
+*/
+ASErr ChartsPlugin::GoTimer(AITimerMessage* message)
+{
+	ASErr result = kNoErr;
+	try {
+		if (message->timer == fRenderTimer && fAnnotator) {
+			result = fAnnotator->RunRenderSlice();
+			aisdk::check_ai_error(result);
+		}
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+	catch(...)
+	{
+		result = kCantHappenErr;
+	}
+	return result;
+}
+
 /*
 */
 ASErr ChartsPlugin::TrackToolCursor(AIToolMessage* message)
@@ -478,7 +568,41 @@ ASErr ChartsPlugin::AddNotifier(SPInterfaceMessage *message)
 		aisdk::check_ai_error(result);
 		result = sAINotifier->AddNotifier(fPluginRef, "ChartsPlugin", kAIApplicationShutdownNotifier, &fShutdownApplicationNotifier);
 		aisdk::check_ai_error(result);
+		result = sAINotifier->AddNotifier(fPluginRef, "ChartsPlugin", kAIDocumentOpenedNotifier, &fDocumentOpenedNotifier);
+		aisdk::check_ai_error(result);
+		result = sAINotifier->AddNotifier(fPluginRef, "ChartsPlugin", kAIDocumentClosedNotifier, &fDocumentClosedNotifier);
+		aisdk::check_ai_error(result);
+		result = sAINotifier->AddNotifier(fPluginRef, "ChartsPlugin", kAIDocumentChangedNotifier, &fDocumentChangedNotifier);
+		aisdk::check_ai_error(result);
+		result = sAINotifier->AddNotifier(fPluginRef, "ChartsPlugin", kAIArtPropertiesChangedNotifier, &fArtPropertiesChangedNotifier);
+		aisdk::check_ai_error(result);
+		result = sAINotifier->AddNotifier(fPluginRef, "ChartsPlugin", kAIDocumentViewVisibleAreaChangedNotifier, &fViewVisibleAreaChangedNotifier);
+		aisdk::check_ai_error(result);
+		result = sAINotifier->AddNotifier(fPluginRef, "ChartsPlugin", kAIDocumentViewActivatedNotifier, &fViewActivatedNotifier);
+		aisdk::check_ai_error(result);
+
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+	catch(...)
+	{
+		result = kCantHappenErr;
+	}
+	return result;
+}
 
+/*
+*/
+ASErr ChartsPlugin::AddTimer(SPInterfaceMessage *message)
+{
+	ASErr result = kNoErr;
+	try {
+		// Every tick while active; each slice takes only a few milliseconds of it
+		result = sAITimer->AddTimer(fPluginRef, "Charts Progressive Render", 1, &fRenderTimer);
+		aisdk::check_ai_error(result);
+		result = sAITimer->SetTimerActive(fRenderTimer, false);
+		aisdk::check_ai_error(result);
 	}
 	catch (ai::Error& ex) {
 		result = ex;
@@ -490,6 +614,114 @@ ASErr ChartsPlugin::AddNotifier(SPInterfaceMessage *message)
 	return result;
 }
 
+/*
+*/
+ASErr ChartsPlugin::AddMenus(SPInterfaceMessage *message)
+{
+	ASErr result = kNoErr;
+	try {
+		// Object > Charts, holding the commands that work on the document's charts
+		AIMenuGroup chartsGroup = NULL;
+		result = sAIMenu->AddMenuItemZString(fPluginRef, "Charts", kObjectUtilsMenuGroup, ZREF("Charts"), kMenuItemNoOptions, &fChartsMenu);
+		aisdk::check_ai_error(result);
+		result = sAIMenu->AddMenuGroupAsSubMenu("Charts Commands", kMenuGroupNoOptions, fChartsMenu, &chartsGroup);
+		aisdk::check_ai_error(result);
+
+		result = sAIMenu->AddMenuItemZString(fPluginRef, "Refresh All Charts", "Charts Commands", ZREF("Refresh All Charts"), kMenuItemNoOptions, &fRefreshChartsMenu);
+		aisdk::check_ai_error(result);
+		result = sAIMenu->AddMenuItemZString(fPluginRef, "Import Chart Data", "Charts Commands", ZREF("Import Chart Data..."), kMenuItemNoOptions, &fImportDataMenu);
+		aisdk::check_ai_error(result);
+		result = sAIMenu->AddMenuItemZString(fPluginRef, "Create Small Multiples", "Charts Commands", ZREF("Create Small Multiples..."), kMenuItemWantsUpdateOption, &fSmallMultiplesMenu);
+		aisdk::check_ai_error(result);
+
+		// Object > Charts > Options for New Charts, each item checked while its option is on
+		AIMenuGroup optionsGroup = NULL;
+		result = sAIMenu->AddMenuItemZString(fPluginRef, "Options for New Charts", "Charts Commands", ZREF("Options for New Charts"), kMenuItemNoOptions, &fChartOptionsMenu);
+		aisdk::check_ai_error(result);
+		result = sAIMenu->AddMenuGroupAsSubMenu("Chart Options", kMenuGroupNoOptions, fChartOptionsMenu, &optionsGroup);
+		aisdk::check_ai_error(result);
+
+		result = sAIMenu->AddMenuItemZString(fPluginRef, "Show Data Labels", "Chart Options", ZREF("Show Data Labels"), kMenuItemWantsUpdateOption, &fDataLabelsMenu);
+		aisdk::check_ai_error(result);
+		result = sAIMenu->AddMenuItemZString(fPluginRef, "Adaptive Detail", "Chart Options", ZREF("Adapt Detail to Zoom"), kMenuItemWantsUpdateOption, &fAdaptiveDetailMenu);
+		aisdk::check_ai_error(result);
+		result = sAIMenu->AddMenuItemZString(fPluginRef, "Bridge Gaps", "Chart Options", ZREF("Bridge Gaps in Lines"), kMenuItemWantsUpdateOption, &fBridgeGapsMenu);
+		aisdk::check_ai_error(result);
+		result = sAIMenu->AddMenuItemZString(fPluginRef, "Normalize Stacked Areas", "Chart Options", ZREF("Normalize Stacked Areas"), kMenuItemWantsUpdateOption, &fNormalizeStackMenu);
+		aisdk::check_ai_error(result);
+		result = sAIMenu->AddMenuItemZString(fPluginRef, "Logarithmic Value Axis", "Chart Options", ZREF("Logarithmic Value Axis"), kMenuItemWantsUpdateOption, &fLogValueScaleMenu);
+		aisdk::check_ai_error(result);
+		result = sAIMenu->AddMenuItemZString(fPluginRef, "Logarithmic X Axis", "Chart Options", ZREF("Logarithmic X Axis"), kMenuItemWantsUpdateOption, &fLogXScaleMenu);
+		aisdk::check_ai_error(result);
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+	catch(...)
+	{
+		result = kCantHappenErr;
+	}
+	return result;
+}
+
+/*
+*/
+AIBoolean ChartsPlugin::IsChartOptionMenu(AIMenuItemHandle menuItem) const
+{
+	return menuItem && (menuItem == fDataLabelsMenu || menuItem == fAdaptiveDetailMenu || menuItem == fBridgeGapsMenu ||
+		menuItem == fNormalizeStackMenu || menuItem == fLogValueScaleMenu || menuItem == fLogXScaleMenu);
+}
+
+/*
+*/
+AIBoolean ChartsPlugin::GetChartOption(AIMenuItemHandle menuItem, const ChartOptions& options) const
+{
+	if (menuItem == fDataLabelsMenu) {
+		return options.showDataLabels;
+	}
+	if (menuItem == fAdaptiveDetailMenu) {
+		return options.adaptiveDetail;
+	}
+	if (menuItem == fBridgeGapsMenu) {
+		return options.bridgeGaps;
+	}
+	if (menuItem == fNormalizeStackMenu) {
+		return options.normalizeStack;
+	}
+	if (menuItem == fLogValueScaleMenu) {
+		return options.valueScale == kChartScaleLog;
+	}
+	if (menuItem == fLogXScaleMenu) {
+		return options.xScale == kChartScaleLog;
+	}
+	return false;
+}
+
+/*
+*/
+void ChartsPlugin::ToggleChartOption(AIMenuItemHandle menuItem, ChartOptions& options) const
+{
+	const AIBoolean on = !this->GetChartOption(menuItem, options);
+	if (menuItem == fDataLabelsMenu) {
+		options.showDataLabels = on;
+	}
+	else if (menuItem == fAdaptiveDetailMenu) {
+		options.adaptiveDetail = on;
+	}
+	else if (menuItem == fBridgeGapsMenu) {
+		options.bridgeGaps = on;
+	}
+	else if (menuItem == fNormalizeStackMenu) {
+		options.normalizeStack = on;
+	}
+	else if (menuItem == fLogValueScaleMenu) {
+		options.valueScale = on ? kChartScaleLog : kChartScaleLinear;
+	}
+	else if (menuItem == fLogXScaleMenu) {
+		options.xScale = on ? kChartScaleLog : kChartScaleLinear;
+	}
+}
+
 /*
 */
 ASErr ChartsPlugin::DrawAnnotation(AIAnnotatorMessage* message)
@@ -547,22 +779,6 @@ ASErr ChartsPlugin::PluginGroupUpdate(AIPluginGroupMessage* message)
 		result = sAIPluginGroup->GetPluginArtResultArt(pluginArt, &resultArt);
 		aisdk::check_ai_error(result);
 		
-		// Clear all children from the result group
-		AIArtHandle child = nullptr;
-		result = sAIArt->GetArtFirstChild(resultArt, &child);
-		aisdk::check_ai_error(result);
-
-		while (child != nullptr) {
-			AIArtHandle nextChild = nullptr;
-			result = sAIArt->GetArtSibling(child, &nextChild);
-			aisdk::check_ai_error(result);
-			
-			result = sAIArt->DisposeArt(child);
-			aisdk::check_ai_error(result);
-			
-			child = nextChild;
-		}
-		
 		// Load custom chart data
 		ChartItem chartData;
 		size_t dataSize = sizeof(ChartItem);
@@ -571,8 +787,8 @@ ASErr ChartsPlugin::PluginGroupUpdate(AIPluginGroupMessage* message)
 			// Set the result group as the parent for chart rendering
 			chartData.SetChartGroup(resultArt);
 			
-			// Recreate the chart content in the result group
-			result = chartData.CreateChartArt();
+			// Rewrite the chart content already in the result group
+			result = chartData.UpdateChartArt();
 			aisdk::check_ai_error(result);
 		}
 	}
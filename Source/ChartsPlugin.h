@@ -52,6 +52,23 @@ private:
 	*/
 	AIMenuItemHandle	fAboutPluginMenu;
 
+	/** Handles for the Object > Charts submenu and its items.
+	*/
+	AIMenuItemHandle	fChartsMenu;
+	AIMenuItemHandle	fRefreshChartsMenu;
+	AIMenuItemHandle	fImportDataMenu;
+	AIMenuItemHandle	fSmallMultiplesMenu;
+
+	/** Handles for the submenu of the options new charts are drawn with, and its items.
+	*/
+	AIMenuItemHandle	fChartOptionsMenu;
+	AIMenuItemHandle	fDataLabelsMenu;
+	AIMenuItemHandle	fAdaptiveDetailMenu;
+	AIMenuItemHandle	fBridgeGapsMenu;
+	AIMenuItemHandle	fNormalizeStackMenu;
+	AIMenuItemHandle	fLogValueScaleMenu;
+	AIMenuItemHandle	fLogXScaleMenu;
+
 	/** Handle for the annotator added by this plug-in.
 	*/
 	AIAnnotatorHandle	fAnnotatorHandle;
@@ -64,6 +81,31 @@ private:
 	*/
 	AINotifierHandle	fShutdownApplicationNotifier;
 
+	/** Handle for the document opened notifier, used to build the chart registry.
+	*/
+	AINotifierHandle	fDocumentOpenedNotifier;
+
+	/** Handle for the document closed notifier, used to drop the chart registry.
+	*/
+	AINotifierHandle	fDocumentClosedNotifier;
+
+	/** Handle for the document changed notifier, used to keep the chart registry current.
+	*/
+	AINotifierHandle	fDocumentChangedNotifier;
+
+	/** Handle for the art properties changed notifier, used to keep the chart registry current.
+	*/
+	AINotifierHandle	fArtPropertiesChangedNotifier;
+
+	/** Handles for the view notifiers, used to follow the zoom with charts' level of detail.
+	*/
+	AINotifierHandle	fViewVisibleAreaChangedNotifier;
+	AINotifierHandle	fViewActivatedNotifier;
+
+	/** Handle for the idle timer that draws large charts a slice at a time.
+	*/
+	AITimerHandle		fRenderTimer;
+
 	/** Pointer to Charts object.
 	*/
 	Charts*			fAnnotator;	
@@ -142,6 +184,12 @@ protected:
 	*/
 	virtual ASErr Notify(AINotifierMessage* message);
 
+	/**	Draws the next slice of the charts being rendered progressively.
+		@param message IN message data.
+		@return kNoErr on success, other ASErr otherwise.
+	*/
+	virtual ASErr GoTimer(AITimerMessage* message);
+
 	/**	As the cursor moves checks whether any art is 'hit'.
 		@param message IN message data.
 		@return kNoErr on success, other ASErr otherwise.
@@ -191,13 +239,47 @@ protected:
 	*/
 	ASErr AddAnnotator(SPInterfaceMessage* message);
 
-	/**	Registers this plug-in to receive the selection changed
-		notifier.
+	/**	Registers this plug-in to receive the selection changed, view,
+		document and art changed notifiers.
 		@param message IN message data.
 		@return kNoErr on success, other ASErr otherwise.
 	*/
 	ASErr AddNotifier(SPInterfaceMessage* message);
 
+	/**	Adds the idle timer that runs progressive chart renders, inactive until a
+		chart needs it.
+		@param message IN message data.
+		@return kNoErr on success, other ASErr otherwise.
+	*/
+	ASErr AddTimer(SPInterfaceMessage* message);
+
+	/**	Adds the Charts submenu of the Object menu, holding the chart commands.
+		@param message IN message data.
+		@return kNoErr on success, other ASErr otherwise.
+	*/
+	ASErr AddMenus(SPInterfaceMessage* message);
+
+	/**	Reports whether a menu item is one of the new chart options.
+		@param menuItem IN the menu item.
+		@return true if the item toggles a chart option.
+	*/
+	AIBoolean IsChartOptionMenu(AIMenuItemHandle menuItem) const;
+
+	/**	Gets whether the chart option of a menu item is on. A scale option is on when
+		the axis is logarithmic.
+		@param menuItem IN an item of the chart options submenu.
+		@param options IN the options.
+		@return true if the option is on.
+	*/
+	AIBoolean GetChartOption(AIMenuItemHandle menuItem, const ChartOptions& options) const;
+
+	/**	Turns the chart option of a menu item on if it is off, and off if it is on. A
+		scale option switches its axis between linear and logarithmic.
+		@param menuItem IN an item of the chart options submenu.
+		@param options IN/OUT the options.
+	*/
+	void ToggleChartOption(AIMenuItemHandle menuItem, ChartOptions& options) const;
+
 	/**	Draws/redraws the annotations when prompted by the application.
 		@param message IN message data.
 		@return kNoErr on success, other ASErr otherwise.
@@ -39,6 +39,16 @@ extern "C"
 	AITextFrameSuite*			sAITextFrame = NULL;
 	AIRealMathSuite*			sAIRealMath = NULL;
 	AIATETextUtilSuite*			sAIATETextUtil = NULL;
+	AIMdMemorySuite*			sAIMdMemory = NULL;
+	AIDocumentListSuite*		sAIDocumentList = NULL;
+	AICustomColorSuite*			sAICustomColor = NULL;
+	AISwatchListSuite*			sAISwatchList = NULL;
+	AIArtStyleSuite*			sAIArtStyle = NULL;
+	AISymbolSuite*				sAISymbol = NULL;
+	AIFontSuite*				sAIFont = NULL;
+	AITimerSuite*				sAITimer = NULL;
+	AIUndoSuite*				sAIUndo = NULL;
+	AIMenuSuite*				sAIMenu = NULL;
 	EXTERN_TEXT_SUITES
 }
 
@@ -64,6 +74,16 @@ ImportSuite gImportSuites[] =
 	kAITextFrameSuite, kAITextFrameSuiteVersion, &sAITextFrame,
 	kAIRealMathSuite, kAIRealMathSuiteVersion, &sAIRealMath,
 	kAIATETextUtilSuite, kAIATETextUtilSuiteVersion, &sAIATETextUtil,
+	kAIMdMemorySuite, kAIMdMemorySuiteVersion, &sAIMdMemory,
+	kAIDocumentListSuite, kAIDocumentListSuiteVersion, &sAIDocumentList,
+	kAICustomColorSuite, kAICustomColorSuiteVersion, &sAICustomColor,
+	kAISwatchListSuite, kAISwatchListSuiteVersion, &sAISwatchList,
+	kAIArtStyleSuite, kAIArtStyleSuiteVersion, &sAIArtStyle,
+	kAISymbolSuite, kAISymbolSuiteVersion, &sAISymbol,
+	kAIFontSuite, kAIFontSuiteVersion, &sAIFont,
+	kAITimerSuite, kAITimerSuiteVersion, &sAITimer,
+	kAIUndoSuite, kAIUndoSuiteVersion, &sAIUndo,
+	kAIMenuSuite, kAIMenuSuiteVersion, &sAIMenu,
 	IMPORT_TEXT_SUITES
 	nullptr, 0, nullptr
 };
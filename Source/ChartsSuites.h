@@ -31,6 +31,17 @@
 #include "AITextFrame.h"
 #include "AIATETextUtil.h"
 #include "ATETextSuitesImportHelper.h"
+#include "AIMdMemory.h"
+#include "AIDocumentList.h"
+#include "AICustomColor.h"
+#include "AISwatchList.h"
+#include "AIArtStyle.h"
+#include "AISymbol.h"
+#include "AIFont.h"
+#include "AITimer.h"
+#include "AIUndo.h"
+#include "AIMenu.h"
+#include "AIMenuGroups.h"
 
 extern  "C" AIUnicodeStringSuite*		sAIUnicodeString;
 extern  "C" SPBlocksSuite*				sSPBlocks;
@@ -52,6 +63,16 @@ extern	"C" AIPluginGroupSuite*			sAIPluginGroup;
 extern	"C" AITextFrameSuite*			sAITextFrame;
 extern	"C" AIRealMathSuite*			sAIRealMath;
 extern	"C" AIATETextUtilSuite*		sAIATETextUtil;
+extern	"C" AIMdMemorySuite*			sAIMdMemory;
+extern	"C" AIDocumentListSuite*		sAIDocumentList;
+extern	"C" AICustomColorSuite*			sAICustomColor;
+extern	"C" AISwatchListSuite*			sAISwatchList;
+extern	"C" AIArtStyleSuite*			sAIArtStyle;
+extern	"C" AISymbolSuite*				sAISymbol;
+extern	"C" AIFontSuite*				sAIFont;
+extern	"C" AITimerSuite*				sAITimer;
+extern	"C" AIUndoSuite*				sAIUndo;
+extern	"C" AIMenuSuite*				sAIMenu;
 
 #endif // __CHARTSSUITES_H__
 
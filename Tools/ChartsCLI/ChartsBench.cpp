@@ -0,0 +1,591 @@
+//========================================================================================
+//  
+//  ChartsBench.cpp
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+// Benchmarks of the plug-in's portable layout code, run without Illustrator. Each
+// benchmark builds the same data on every run, so runs on one machine compare, and
+// prints one line per measurement on standard output.
+//
+// Usage: charts-bench [benchmark ...]
+//
+// With no arguments every benchmark runs. Text is measured by estimate, as there is no
+// text engine outside the application. Art is emitted through the plug-in's own emitter
+// into MockSDK's in-memory document, which counts the suite calls the emitter makes.
+
+#include "ChartDataset.h"
+#include "ChartDisplayEmitter.h"
+#include "ChartDisplayList.h"
+#include "ChartLabelPlacement.h"
+#include "ChartLayout.h"
+#include "ChartLayoutBatch.h"
+#include "ChartLayoutCache.h"
+#include "ChartScale.h"
+#include "ChartSvgWriter.h"
+#include "ChartTextMetrics.h"
+#include "ChartsSuites.h"
+#include "ChartWorkerPool.h"
+#include "MockSDK.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+/*
+*/
+double MillisecondsSince(const Clock::time_point& start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/*
+*/
+double HitRate(uint64_t hits, uint64_t misses)
+{
+	return hits + misses > 0 ? 100.0 * hits / (hits + misses) : 0.0;
+}
+
+// A dataset of categories by series of a smooth, deterministic curve
+ChartDataset MakeDataset(const std::string& datasetID, size_t categories, size_t series)
+{
+	ChartDataset dataset(datasetID);
+	ChartColumn labels;
+	labels.name = "Category";
+	labels.kind = ChartColumn::kText;
+	for (size_t i = 0; i < categories; i++) {
+		labels.texts.push_back("C" + std::to_string(i));
+	}
+	dataset.AddColumn(labels);
+
+	for (size_t s = 0; s < series; s++) {
+		ChartColumn values;
+		values.name = "Series " + std::to_string(s + 1);
+		for (size_t i = 0; i < categories; i++) {
+			values.numbers.push_back(50 + 40 * std::sin(i * 0.37 + s * 1.3));
+		}
+		dataset.AddColumn(values);
+	}
+	return dataset;
+}
+
+// Emits a display list into a chart group as ChartItem does, with a style table bound to
+// the mock document
+ASErr EmitChart(const ChartDisplayList& list, const std::vector<std::string>& seriesNames, ChartEmitMode emitMode, AIArtHandle chart)
+{
+	ChartStyleTable styles;
+	ASErr result = styles.BindToDocument(seriesNames);
+	if (result != kNoErr) {
+		return result;
+	}
+
+	ChartArtCursor components(chart);
+	ChartDisplayEmitter emitter(styles, emitMode, kChartMarkersAuto);
+	result = emitter.Emit(list, components);
+	if (result != kNoErr) {
+		return result;
+	}
+	return components.Finish();
+}
+
+// Writes the paths of a display list as the chart renderers did before the path builder:
+// each path created on top of the chart, every segment written by a SetPathSegments call
+// of its own, and the path's style read and written back. Text is left out.
+ASErr EmitPerSegment(const ChartDisplayList& list, AIArtHandle chart)
+{
+	ASErr result = kNoErr;
+
+	try {
+		ChartPathBuilder builder;
+		for (size_t i = 0; i < list.GetSize(); i++) {
+			const ChartPrimitive& primitive = list[i];
+			builder.Clear();
+			if (primitive.kind == kChartPrimitiveRect) {
+				builder.AddSegments(ChartRectPath(primitive.rect).GetSegments(), 4);
+			}
+			else if (primitive.kind == kChartPrimitivePolyline) {
+				for (const ChartPoint& point : primitive.points) {
+					builder.AddPoint(point);
+				}
+			}
+			else {
+				continue;
+			}
+
+			AIArtHandle path = nullptr;
+			result = sAIArt->NewArt(kPathArt, kPlaceInsideOnTop, chart, &path);
+			aisdk::check_ai_error(result);
+			result = sAIPath->SetPathSegmentCount(path, (ai::int16)builder.GetCount());
+			aisdk::check_ai_error(result);
+			for (size_t segment = 0; segment < builder.GetCount(); segment++) {
+				result = sAIPath->SetPathSegments(path, (ai::int16)segment, 1, builder.GetSegments() + segment);
+				aisdk::check_ai_error(result);
+			}
+			if (primitive.kind == kChartPrimitiveRect || primitive.closed) {
+				result = sAIPath->SetPathClosed(path, true);
+				aisdk::check_ai_error(result);
+			}
+
+			AIPathStyle style;
+			result = sAIPathStyle->GetPathStyle(path, &style, nullptr);
+			aisdk::check_ai_error(result);
+			result = sAIPathStyle->SetPathStyle(path, &style);
+			aisdk::check_ai_error(result);
+		}
+	}
+	catch (ai::Error& ex) {
+		result = ex;
+	}
+
+	return result;
+}
+
+// Hit counts of the layout, text metrics and scale caches over a document refresh that
+// is repeated, as when a document is reopened: the first pass fills the caches and the
+// second should be served from them
+void BenchCaches()
+{
+	const size_t kCharts = 200;
+	const ChartType kTypes[] = {kChartTypeColumn, kChartTypeLine, kChartTypeArea, kChartTypePie};
+
+	std::vector<ChartDataset> datasets;
+	for (size_t i = 0; i < kCharts; i++) {
+		datasets.push_back(MakeDataset("Bench " + std::to_string(i), 12 + i % 13, 1 + i % 4));
+	}
+
+	const fs::path directory = fs::temp_directory_path() / "charts-bench-layouts";
+	std::error_code failure;
+	fs::remove_all(directory, failure);
+
+	ChartWorkerPool pool(ChartWorkerPool::DefaultThreadCount());
+	ChartTextMeasurer estimate;
+	ChartTextMetricsCache metrics(estimate);
+	ChartLayoutCache layouts(directory.string());
+	ChartScaleCache& scales = ChartScaleCache::GetShared();
+
+	for (int pass = 1; pass <= 2; pass++) {
+		std::vector<ChartLayoutJob> jobs(kCharts);
+		for (size_t i = 0; i < kCharts; i++) {
+			jobs[i].dataset = &datasets[i];
+			jobs[i].ref.datasetID = datasets[i].GetID();
+			jobs[i].params.chartType = kTypes[i % 4];
+			jobs[i].params.plotArea.right = 300;
+			jobs[i].params.plotArea.top = 200;
+		}
+
+		layouts.ResetCounters();
+		metrics.ResetCounters();
+		scales.ResetCounters();
+		const Clock::time_point start = Clock::now();
+		ChartLayoutBatch::Compute(jobs, pool, metrics, &layouts);
+		const double milliseconds = MillisecondsSince(start);
+
+		printf("caches pass %d: %zu charts in %.1f ms\n", pass, kCharts, milliseconds);
+		printf("  layout cache   %8llu hits %8llu misses  %5.1f%%\n", (unsigned long long)layouts.GetHits(), (unsigned long long)layouts.GetMisses(),
+			HitRate(layouts.GetHits(), layouts.GetMisses()));
+		printf("  text metrics   %8llu hits %8llu misses  %5.1f%%\n", (unsigned long long)metrics.GetHits(), (unsigned long long)metrics.GetMisses(),
+			HitRate(metrics.GetHits(), metrics.GetMisses()));
+		printf("  scale cache    %8llu hits %8llu misses  %5.1f%%\n", (unsigned long long)scales.GetHits(), (unsigned long long)scales.GetMisses(),
+			HitRate(scales.GetHits(), scales.GetMisses()));
+	}
+
+	fs::remove_all(directory, failure);
+}
+
+// Places data labels for random marks scattered densely over a wide plot, and checks that
+// no two placed labels overlap
+void BenchLabels()
+{
+	const ChartTextExtent kExtent = {20, 8};
+	const size_t kCounts[] = {1000, 10000, 50000};
+
+	for (size_t count : kCounts) {
+		std::mt19937 random(1);
+		std::uniform_real_distribution<double> unit(0, 1);
+		ChartRect plot;
+		plot.left = 0;
+		plot.bottom = 0;
+		plot.right = 4000;
+		plot.top = 2000;
+
+		std::vector<ChartLabelRequest> requests(count);
+		for (ChartLabelRequest& request : requests) {
+			const double h = unit(random) * plot.right;
+			const double v = unit(random) * plot.top;
+			request.mark.left = h - 2;
+			request.mark.right = h + 2;
+			request.mark.bottom = v - 2;
+			request.mark.top = v + 2;
+			request.text = "12.5";
+			request.extent = kExtent;
+			request.priority = unit(random);
+		}
+
+		const Clock::time_point start = Clock::now();
+		ChartLabelPlacer placer(plot, 2 * kExtent.height, 2);
+		std::vector<ChartLabel> labels;
+		std::vector<ChartSegment> leaders;
+		placer.Place(requests, labels, leaders);
+		const double milliseconds = MillisecondsSince(start);
+
+		// Every label has the same extent, so two overlap when their anchors are closer
+		// than one extent on both axes
+		std::sort(labels.begin(), labels.end(), [](const ChartLabel& a, const ChartLabel& b) { return a.anchor.h < b.anchor.h; });
+		size_t overlaps = 0;
+		for (size_t i = 0; i < labels.size(); i++) {
+			for (size_t j = i + 1; j < labels.size() && labels[j].anchor.h - labels[i].anchor.h < kExtent.width; j++) {
+				overlaps += std::fabs(labels[j].anchor.v - labels[i].anchor.v) < kExtent.height ? 1 : 0;
+			}
+		}
+
+		printf("labels %6zu: %6zu placed %6zu leaders %6zu dropped %3zu overlaps in %7.1f ms\n", count, labels.size(), leaders.size(), placer.GetDroppedCount(), overlaps, milliseconds);
+	}
+}
+
+// Lays out and builds the display list of a two-series line chart of up to a million
+// points, in full detail and at the coarsest detail level
+void BenchLines()
+{
+	const size_t kCounts[] = {1000, 10000, 100000, 1000000};
+
+	ChartWorkerPool pool(ChartWorkerPool::DefaultThreadCount());
+	ChartTextMeasurer estimate;
+	for (size_t count : kCounts) {
+		const ChartDataset dataset = MakeDataset("Lines", count, 2);
+		ChartSeriesView view;
+		dataset.Resolve(ChartDataRef(), view);
+
+		ChartLayoutParams params;
+		params.chartType = kChartTypeLine;
+		params.plotArea.right = 800;
+		params.plotArea.top = 300;
+
+		Clock::time_point start = Clock::now();
+		ChartLayout layout;
+		ChartLayout::Compute(view, params, estimate, layout, &pool);
+		const double layoutMilliseconds = MillisecondsSince(start);
+
+		start = Clock::now();
+		ChartDisplayList list;
+		ChartDisplayList::Build(layout, true, list);
+		const double buildMilliseconds = MillisecondsSince(start);
+
+		params.resolution = ChartLayout::GetDetailResolution(0);
+		ChartLayout coarse;
+		ChartLayout::Compute(view, params, estimate, coarse, &pool);
+
+		printf("lines %7zu points: layout %7.1f ms, display list %7.1f ms, %7zu points per series at detail level 0\n", count, layoutMilliseconds, buildMilliseconds,
+			coarse.lines.empty() ? (size_t)0 : coarse.lines[0].points.size());
+	}
+}
+
+// Emits two-series line charts of up to a million points and a ten-layer stacked area
+// chart of 100000 categories in full detail into a new document, then again over their
+// own art as a refresh does, which reads every path back and rewrites none. Lines and
+// layers are split where a 16 bit segment index runs out, so the longest path holds at
+// most kChartMaxPathPoints anchors.
+void BenchEmit()
+{
+	struct Case {
+		ChartType type;
+		const char* name;
+		size_t categories;
+		size_t series;
+	};
+	const Case kCases[] = {
+		{kChartTypeLine, "line", 1000, 2},
+		{kChartTypeLine, "line", 10000, 2},
+		{kChartTypeLine, "line", 100000, 2},
+		{kChartTypeLine, "line", 1000000, 2},
+		{kChartTypeArea, "area", 100000, 10},
+	};
+
+	ChartWorkerPool pool(ChartWorkerPool::DefaultThreadCount());
+	ChartTextMeasurer estimate;
+	for (const Case& test : kCases) {
+		const ChartDataset dataset = MakeDataset("Emit", test.categories, test.series);
+		ChartSeriesView view;
+		dataset.Resolve(ChartDataRef(), view);
+
+		ChartLayoutParams params;
+		params.chartType = test.type;
+		params.plotArea.right = 800;
+		params.plotArea.top = 300;
+
+		ChartLayout layout;
+		ChartLayout::Compute(view, params, estimate, layout, &pool);
+		ChartDisplayList list;
+		ChartDisplayList::Build(layout, true, list);
+
+		AIArtHandle chart = MockSDK::NewDocument();
+		double milliseconds[2];
+		uint64_t calls[2];
+		ASErr result = kNoErr;
+		for (int pass = 0; pass < 2 && result == kNoErr; pass++) {
+			MockSDK::ResetCallCounts();
+			const Clock::time_point start = Clock::now();
+			result = EmitChart(list, layout.seriesNames, kChartEmitCompoundPaths, chart);
+			milliseconds[pass] = MillisecondsSince(start);
+			calls[pass] = MockSDK::GetTotalCallCount();
+		}
+		if (result != kNoErr) {
+			printf("emit %s %2zu x %7zu: failed with error %d\n", test.name, test.series, test.categories, (int)result);
+			continue;
+		}
+
+		const MockSDK::ArtCounts art = MockSDK::CountArt(chart);
+		printf("emit %s %2zu x %7zu: %4zu paths of %7zu anchors, longest %5zu; new %7.1f ms %5llu calls, refresh %7.1f ms %5llu calls\n", test.name, test.series,
+			test.categories, art.paths, art.anchors, art.largestPath, milliseconds[0], (unsigned long long)calls[0], milliseconds[1], (unsigned long long)calls[1]);
+	}
+}
+
+// Writes two-series line charts of up to a million points to SVG, timing the writer
+// alone, then writes each again and checks that the two files are byte-identical
+void BenchSvg()
+{
+	const size_t kCounts[] = {1000, 100000, 1000000};
+
+	const fs::path directory = fs::temp_directory_path() / "charts-bench-svg";
+	std::error_code failure;
+	fs::create_directories(directory, failure);
+
+	ChartWorkerPool pool(ChartWorkerPool::DefaultThreadCount());
+	ChartTextMeasurer estimate;
+	for (size_t count : kCounts) {
+		const ChartDataset dataset = MakeDataset("Svg", count, 2);
+		ChartSeriesView view;
+		dataset.Resolve(ChartDataRef(), view);
+
+		ChartLayoutParams params;
+		params.chartType = kChartTypeLine;
+		params.plotArea.right = 800;
+		params.plotArea.top = 300;
+
+		ChartLayout layout;
+		ChartLayout::Compute(view, params, estimate, layout, &pool);
+		ChartDisplayList list;
+		ChartDisplayList::Build(layout, true, list);
+		const ChartRect viewBox = ChartSvgWriter::GetViewBox(layout);
+
+		double milliseconds = 0;
+		bool written = true;
+		std::string contents[2];
+		for (int pass = 0; pass < 2 && written; pass++) {
+			const fs::path path = directory / ("lines-" + std::to_string(pass) + ".svg");
+			FILE* file = fopen(path.string().c_str(), "wb");
+			written = file != nullptr;
+			if (written) {
+				const Clock::time_point start = Clock::now();
+				ChartSvgWriter writer(file);
+				written = writer.Write(list, viewBox, "", layout.fontSize);
+				written = fclose(file) == 0 && written;
+				if (pass == 0) {
+					milliseconds = MillisecondsSince(start);
+				}
+			}
+
+			std::ifstream input(path, std::ios::binary);
+			contents[pass].assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+		}
+		if (!written) {
+			printf("svg lines %7zu points: failed to write\n", count);
+			continue;
+		}
+
+		const double megabytes = contents[0].size() / 1e6;
+		printf("svg lines %7zu points: %8.2f MB in %7.1f ms, %6.1f MB/s, rewrite %s\n", count, megabytes, milliseconds,
+			milliseconds > 0 ? megabytes * 1000 / milliseconds : 0.0, contents[0] == contents[1] ? "identical" : "DIFFERS");
+	}
+
+	fs::remove_all(directory, failure);
+}
+
+// Counts the suite calls that draw the paths of a column chart: written a segment at a
+// time as before the path builder, through the emitter as one path per mark, and through
+// the emitter with each component's marks merged into one compound path
+void BenchCalls()
+{
+	const size_t kCategories[] = {12, 200};
+	const char* const kModeNames[] = {"per-segment writes", "separate paths", "compound paths"};
+	const char* const kPathCalls[] = {"NewArt", "SetPathSegmentCount", "SetPathSegments", "SetPathClosed"};
+	const char* const kStyleCalls[] = {"GetPathStyle", "SetPathStyle", "GetArtStyle", "SetArtStyle", "AddNamedStyle"};
+
+	ChartTextMeasurer estimate;
+	for (size_t categories : kCategories) {
+		const ChartDataset dataset = MakeDataset("Calls", categories, 4);
+		ChartSeriesView view;
+		dataset.Resolve(ChartDataRef(), view);
+
+		ChartLayoutParams params;
+		params.chartType = kChartTypeColumn;
+		params.plotArea.right = 600;
+		params.plotArea.top = 300;
+
+		ChartLayout layout;
+		ChartLayout::Compute(view, params, estimate, layout);
+		ChartDisplayList list;
+		ChartDisplayList::Build(layout, true, list);
+
+		for (int mode = 0; mode < 3; mode++) {
+			AIArtHandle chart = MockSDK::NewDocument();
+			MockSDK::ResetCallCounts();
+			const ASErr result = mode == 0 ? EmitPerSegment(list, chart) :
+				EmitChart(list, layout.seriesNames, mode == 1 ? kChartEmitSeparatePaths : kChartEmitCompoundPaths, chart);
+			if (result != kNoErr) {
+				printf("calls column 4 x %3zu, %-18s: failed with error %d\n", categories, kModeNames[mode], (int)result);
+				continue;
+			}
+
+			uint64_t pathCalls = 0;
+			uint64_t styleCalls = 0;
+			for (const char* function : kPathCalls) {
+				pathCalls += MockSDK::GetCallCount(function);
+			}
+			for (const char* function : kStyleCalls) {
+				styleCalls += MockSDK::GetCallCount(function);
+			}
+			printf("calls column 4 x %3zu, %-18s: %4zu paths, %5llu SetPathSegments, %5llu path calls, %4llu style calls\n", categories, kModeNames[mode],
+				MockSDK::CountArt(chart).paths, (unsigned long long)MockSDK::GetCallCount("SetPathSegments"), (unsigned long long)pathCalls, (unsigned long long)styleCalls);
+		}
+	}
+}
+
+// Lays out the small multiples of a dataset split into 400 facets of 24 categories by 3
+// series, as CreateSmallMultiples does, on one thread and on every core
+void BenchFacets()
+{
+	const size_t kFacets = 400;
+	const size_t kCategories = 24;
+	const int kRepeats = 10;
+	const ChartType kTypes[] = {kChartTypeColumn, kChartTypeLine, kChartTypeArea, kChartTypePie};
+	const char* const kTypeNames[] = {"column", "line", "area", "pie"};
+
+	ChartDataset dataset("Facets");
+	ChartColumn region, month;
+	region.name = "Region";
+	region.kind = month.kind = ChartColumn::kText;
+	month.name = "Month";
+	ChartColumn series[3];
+	for (size_t s = 0; s < 3; s++) {
+		series[s].name = "Series " + std::to_string(s + 1);
+	}
+	for (size_t f = 0; f < kFacets; f++) {
+		for (size_t c = 0; c < kCategories; c++) {
+			region.texts.push_back("R" + std::to_string(f));
+			month.texts.push_back("M" + std::to_string(c));
+			for (size_t s = 0; s < 3; s++) {
+				series[s].numbers.push_back((double)((f * (7 - 2 * s) + c * (3 + 4 * s)) % 50));
+			}
+		}
+	}
+	dataset.AddColumn(region);
+	dataset.AddColumn(month);
+	for (size_t s = 0; s < 3; s++) {
+		dataset.AddColumn(series[s]);
+	}
+
+	const Clock::time_point start = Clock::now();
+	std::vector<ChartDataset> facets;
+	dataset.Facet("Region", facets);
+	printf("facets: split %zu rows into %zu datasets in %.1f ms\n", dataset.GetRowCount(), facets.size(), MillisecondsSince(start));
+
+	std::vector<size_t> threadCounts(1, 1);
+	if (ChartWorkerPool::DefaultThreadCount() > 1) {
+		threadCounts.push_back(ChartWorkerPool::DefaultThreadCount());
+	}
+	for (size_t t = 0; t < 4; t++) {
+		for (size_t threads : threadCounts) {
+			ChartWorkerPool pool(threads);
+			ChartTextMeasurer estimate;
+			ChartTextMetricsCache metrics(estimate);
+			std::vector<ChartLayoutJob> jobs(facets.size());
+			for (size_t i = 0; i < facets.size(); i++) {
+				jobs[i].dataset = &facets[i];
+				jobs[i].ref.datasetID = facets[i].GetID();
+				jobs[i].params.chartType = kTypes[t];
+				jobs[i].params.plotArea.right = 200;
+				jobs[i].params.plotArea.top = 150;
+			}
+
+			// The first batch measures the labels; the timed ones find them cached, as
+			// charts after the first of a grid do
+			ChartLayoutBatch::Compute(jobs, pool, metrics, nullptr);
+			const Clock::time_point batchStart = Clock::now();
+			for (int repeat = 0; repeat < kRepeats; repeat++) {
+				ChartLayoutBatch::Compute(jobs, pool, metrics, nullptr);
+			}
+			const double seconds = MillisecondsSince(batchStart) / 1000;
+
+			printf("facets %-6s on %2zu threads: %8.0f charts/s\n", kTypeNames[t], pool.GetThreadCount(), seconds > 0 ? kRepeats * facets.size() / seconds : 0.0);
+		}
+	}
+}
+
+struct Benchmark {
+	const char* name;
+	void (*run)();
+};
+
+const Benchmark kBenchmarks[] = {
+	{"caches", BenchCaches},
+	{"labels", BenchLabels},
+	{"lines", BenchLines},
+	{"emit", BenchEmit},
+	{"svg", BenchSvg},
+	{"calls", BenchCalls},
+	{"facets", BenchFacets},
+};
+
+} // namespace
+
+/*
+*/
+int main(int argc, char** argv)
+{
+	const size_t count = sizeof(kBenchmarks) / sizeof(kBenchmarks[0]);
+	for (int i = 1; i < argc; i++) {
+		bool known = false;
+		for (size_t b = 0; b < count; b++) {
+			known = known || strcmp(argv[i], kBenchmarks[b].name) == 0;
+		}
+		if (!known) {
+			fprintf(stderr, "usage: charts-bench [benchmark ...]\nbenchmarks:");
+			for (size_t b = 0; b < count; b++) {
+				fprintf(stderr, " %s", kBenchmarks[b].name);
+			}
+			fprintf(stderr, "\n");
+			return 2;
+		}
+	}
+
+	for (size_t b = 0; b < count; b++) {
+		bool selected = argc == 1;
+		for (int i = 1; i < argc; i++) {
+			selected = selected || strcmp(argv[i], kBenchmarks[b].name) == 0;
+		}
+		if (selected) {
+			kBenchmarks[b].run();
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,377 @@
+//========================================================================================
+//  
+//  ChartsCLI.cpp
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+// Renders a directory of chart specs to SVG without Illustrator, through the plug-in's own
+// dataset, layout and display list. Specs are rendered in parallel on the worker pool, an
+// idle thread taking the next spec as soon as it finishes one, and each spec's time is
+// reported so outliers stand out in nightly runs.
+//
+// Usage: charts-cli [-j threads] [-o output directory] spec directory
+//
+// A spec is a text file named *.chart of "key = value" lines; # starts a comment.
+//   type        bar, line, pie, area, scatter, column (the default), donut or radar
+//   data        CSV file, relative to the spec; its header row names the columns
+//   category    Category column; the first text column by default
+//   values      Comma separated value columns; every numeric column by default
+//   width       Plot area width in points, 400 by default
+//   height      Plot area height in points, 300 by default
+//   font        Label font; the viewer's sans-serif by default
+//   fontSize    Label size in points, 12 by default
+//   valueScale  linear (the default), log, symlog or time
+//   xScale      As valueScale, for the X series of scatter charts
+//   dataLabels, bridgeGaps, normalizeStack   true or false
+// Each spec writes an SVG file of the same name to the output directory, which is the
+// spec directory by default.
+
+#include "ChartDataset.h"
+#include "ChartLayout.h"
+#include "ChartScale.h"
+#include "ChartSvgWriter.h"
+#include "ChartWorkerPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// Slowest specs listed after a run
+const size_t kOutlierCount = 10;
+
+const char* const kChartTypeNames[kChartTypeUnknown] = {"bar", "line", "pie", "area", "scatter", "column", "donut", "radar"};
+const char* const kScaleNames[kChartScaleTypeCount] = {"linear", "log", "symlog", "time"};
+
+// One spec and how rendering it went
+struct SpecResult {
+	fs::path spec;
+	double milliseconds;
+	std::string error;		// Empty on success
+};
+
+// CSV files decoded once however many specs draw from them
+class DatasetCache {
+public:
+	std::shared_ptr<const ChartDataset> Get(const fs::path& path, std::string& error);
+
+private:
+	struct Entry {
+		std::once_flag loaded;
+		std::shared_ptr<const ChartDataset> dataset;
+		std::string error;
+	};
+
+	std::mutex fMutex;
+	std::map<std::string, std::shared_ptr<Entry> > fEntries;
+};
+
+/*
+*/
+bool ReadFile(const fs::path& path, std::string& text)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file) {
+		return false;
+	}
+	std::ostringstream contents;
+	contents << file.rdbuf();
+	text = contents.str();
+	return true;
+}
+
+/*
+*/
+std::string Trim(const std::string& text)
+{
+	const size_t begin = text.find_first_not_of(" \t\r\n");
+	if (begin == std::string::npos) {
+		return std::string();
+	}
+	const size_t end = text.find_last_not_of(" \t\r\n");
+	return text.substr(begin, end - begin + 1);
+}
+
+/*
+*/
+int FindName(const std::string& name, const char* const* names, int count)
+{
+	for (int i = 0; i < count; i++) {
+		if (name == names[i]) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+/*
+*/
+std::shared_ptr<const ChartDataset> DatasetCache::Get(const fs::path& path, std::string& error)
+{
+	std::shared_ptr<Entry> entry;
+	{
+		std::lock_guard<std::mutex> lock(fMutex);
+		std::shared_ptr<Entry>& slot = fEntries[path.lexically_normal().string()];
+		if (!slot) {
+			slot = std::make_shared<Entry>();
+		}
+		entry = slot;
+	}
+
+	// Other specs of the same file wait here for the first to decode it
+	std::call_once(entry->loaded, [&]() {
+		std::string text;
+		std::shared_ptr<ChartDataset> dataset = std::make_shared<ChartDataset>(path.filename().string());
+		if (!ReadFile(path, text)) {
+			entry->error = "cannot read " + path.string();
+		}
+		else if (!ChartDataset::ParseCSV(text, *dataset)) {
+			entry->error = "cannot parse " + path.string();
+		}
+		else {
+			entry->dataset = dataset;
+		}
+	});
+
+	error = entry->error;
+	return entry->dataset;
+}
+
+// Reads a spec into the parameters ChartItem::MakeLayoutParams would give the chart,
+// with the plot area at the origin. Returns false with error set if the spec is invalid.
+bool ReadSpec(const fs::path& spec, ChartLayoutParams& params, ChartDataRef& ref, fs::path& data, std::string& error)
+{
+	std::string text;
+	if (!ReadFile(spec, text)) {
+		error = "cannot read spec";
+		return false;
+	}
+
+	params = ChartLayoutParams();
+	params.chartType = kChartTypeColumn;
+	double width = 400, height = 300;
+
+	std::istringstream lines(text);
+	std::string line;
+	size_t lineNumber = 0;
+	while (std::getline(lines, line)) {
+		lineNumber++;
+		const size_t comment = line.find('#');
+		if (comment != std::string::npos) {
+			line.erase(comment);
+		}
+		line = Trim(line);
+		if (line.empty()) {
+			continue;
+		}
+
+		const size_t equals = line.find('=');
+		if (equals == std::string::npos) {
+			error = "line " + std::to_string(lineNumber) + ": expected key = value";
+			return false;
+		}
+		const std::string key = Trim(line.substr(0, equals));
+		const std::string value = Trim(line.substr(equals + 1));
+
+		bool valid = true;
+		if (key == "type") {
+			params.chartType = FindName(value, kChartTypeNames, kChartTypeUnknown);
+			valid = params.chartType >= 0;
+		}
+		else if (key == "data") {
+			data = spec.parent_path() / value;
+		}
+		else if (key == "category") {
+			ref.categoryColumn = value;
+		}
+		else if (key == "values") {
+			std::istringstream columns(value);
+			std::string column;
+			while (std::getline(columns, column, ',')) {
+				ref.valueColumns.push_back(Trim(column));
+			}
+		}
+		else if (key == "width" || key == "height" || key == "fontSize") {
+			char* end = nullptr;
+			const double number = strtod(value.c_str(), &end);
+			valid = end != value.c_str() && *end == 0 && number > 0;
+			(key == "width" ? width : key == "height" ? height : params.fontSize) = number;
+		}
+		else if (key == "font") {
+			params.fontName = value;
+		}
+		else if (key == "valueScale" || key == "xScale") {
+			const int scale = FindName(value, kScaleNames, kChartScaleTypeCount);
+			valid = scale >= 0;
+			(key == "valueScale" ? params.valueScale : params.xScale) = scale;
+		}
+		else if (key == "dataLabels" || key == "bridgeGaps" || key == "normalizeStack") {
+			valid = value == "true" || value == "false";
+			(key == "dataLabels" ? params.showDataLabels : key == "bridgeGaps" ? params.bridgeGaps : params.normalizeStack) = value == "true";
+		}
+		else {
+			valid = false;
+		}
+
+		if (!valid) {
+			error = "line " + std::to_string(lineNumber) + ": invalid " + key;
+			return false;
+		}
+	}
+
+	if (data.empty()) {
+		error = "no data";
+		return false;
+	}
+
+	// The plot area IS the chart's rectangle, as for charts drawn with the tool
+	params.plotArea.left = 0;
+	params.plotArea.bottom = 0;
+	params.plotArea.right = width;
+	params.plotArea.top = height;
+	return true;
+}
+
+/*
+*/
+void RenderSpec(SpecResult& result, const fs::path& outputDirectory, DatasetCache& datasets, ChartTextMeasurer& measurer)
+{
+	const Clock::time_point start = Clock::now();
+
+	ChartLayoutParams params;
+	ChartDataRef ref;
+	fs::path data;
+	if (ReadSpec(result.spec, params, ref, data, result.error)) {
+		std::shared_ptr<const ChartDataset> dataset = datasets.Get(data, result.error);
+		ChartSeriesView view;
+		ChartLayout layout;
+		if (!dataset) {
+			// The cache's error stands
+		}
+		else if (!dataset->Resolve(ref, view) || !ChartLayout::Compute(view, params, measurer, layout)) {
+			result.error = "nothing to chart";
+		}
+		else {
+			// Specs are laid out in parallel with each other, so each lays out on its own thread
+			const fs::path output = outputDirectory / result.spec.filename().replace_extension(".svg");
+			if (!ChartSvgWriter::WriteFile(layout, params.fontName, output.string())) {
+				result.error = "cannot write " + output.string();
+			}
+		}
+	}
+
+	result.milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/*
+*/
+int Usage()
+{
+	fprintf(stderr, "usage: charts-cli [-j threads] [-o output directory] spec directory\n");
+	return 2;
+}
+
+} // namespace
+
+/*
+*/
+int main(int argc, char** argv)
+{
+	size_t threads = ChartWorkerPool::DefaultThreadCount();
+	fs::path outputDirectory;
+	fs::path specDirectory;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+			threads = (size_t)std::max(1, atoi(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+			outputDirectory = argv[++i];
+		}
+		else if (argv[i][0] != '-' && specDirectory.empty()) {
+			specDirectory = argv[i];
+		}
+		else {
+			return Usage();
+		}
+	}
+	if (specDirectory.empty()) {
+		return Usage();
+	}
+	if (outputDirectory.empty()) {
+		outputDirectory = specDirectory;
+	}
+
+	std::error_code failure;
+	fs::create_directories(outputDirectory, failure);
+
+	// Specs in name order, so reports of the same directory line up between runs
+	std::vector<SpecResult> results;
+	for (const fs::directory_entry& entry : fs::directory_iterator(specDirectory, failure)) {
+		if (entry.is_regular_file() && entry.path().extension() == ".chart") {
+			SpecResult result;
+			result.spec = entry.path();
+			result.milliseconds = 0;
+			results.push_back(result);
+		}
+	}
+	if (failure) {
+		fprintf(stderr, "charts-cli: cannot read %s: %s\n", specDirectory.string().c_str(), failure.message().c_str());
+		return 1;
+	}
+	std::sort(results.begin(), results.end(), [](const SpecResult& a, const SpecResult& b) { return a.spec < b.spec; });
+
+	// Label extents are estimated, as there is no text engine outside the application
+	ChartTextMeasurer measurer;
+	DatasetCache datasets;
+	ChartWorkerPool pool(threads);
+
+	const Clock::time_point start = Clock::now();
+	pool.ParallelFor(results.size(), [&](size_t i) {
+		RenderSpec(results[i], outputDirectory, datasets, measurer);
+	});
+	const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+	// One line per spec on standard output: milliseconds, status and spec
+	size_t failed = 0;
+	for (const SpecResult& result : results) {
+		printf("%.3f\t%s\t%s\n", result.milliseconds, result.error.empty() ? "ok" : result.error.c_str(), result.spec.filename().string().c_str());
+		failed += result.error.empty() ? 0 : 1;
+	}
+
+	std::vector<const SpecResult*> slowest;
+	for (const SpecResult& result : results) {
+		slowest.push_back(&result);
+	}
+	const size_t outliers = std::min(kOutlierCount, slowest.size());
+	std::partial_sort(slowest.begin(), slowest.begin() + outliers, slowest.end(),
+		[](const SpecResult* a, const SpecResult* b) { return a->milliseconds > b->milliseconds; });
+
+	fprintf(stderr, "%zu charts, %zu failed, in %.2f s on %zu threads (%.0f charts/s)\n",
+		results.size(), failed, seconds, pool.GetThreadCount(), seconds > 0 ? results.size() / seconds : 0.0);
+	for (size_t i = 0; i < outliers; i++) {
+		fprintf(stderr, "  %10.3f ms  %s\n", slowest[i]->milliseconds, slowest[i]->spec.filename().string().c_str());
+	}
+
+	return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,295 @@
+//========================================================================================
+//  
+//  IllustratorSDK.h
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+// The part of the Illustrator SDK that the plug-in's art emission uses, declared for
+// charts-bench. Types and suites keep the SDK's names and signatures, so the emitter,
+// path builder and style table compile unchanged against them; the suites are
+// implemented in memory by MockSDK.cpp, which counts every call. The Makefile generates
+// the other SDK headers the sources include, each of which includes this one.
+
+#ifndef __IllustratorSDK_h__
+#define __IllustratorSDK_h__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+typedef int32_t ASErr;
+typedef ASErr AIErr;
+typedef unsigned char ASBoolean;
+typedef ASBoolean AIBoolean;
+typedef double AIReal;
+typedef uint16_t ASUnicode;
+typedef int32_t ASInt32;
+
+#define AIAPI
+
+namespace ai {
+
+typedef int16_t int16;
+typedef int32_t int32;
+
+// UTF-8 text; only what the emitter and style table use
+class UnicodeString {
+public:
+	UnicodeString() {}
+	explicit UnicodeString(const char* string) : fUTF8(string) {}
+
+	static UnicodeString FromUTF8(const std::string& string) { return UnicodeString(string.c_str()); }
+
+	UnicodeString& append(const UnicodeString& string) { fUTF8 += string.fUTF8; return *this; }
+	bool empty() const { return fUTF8.empty(); }
+	std::string as_UTF8() const { return fUTF8; }
+
+	// Each byte as a code unit, which holds for the ASCII names the charts use
+	std::basic_string<ASUnicode> as_ASUnicode() const { return std::basic_string<ASUnicode>(fUTF8.begin(), fUTF8.end()); }
+
+	bool operator==(const UnicodeString& other) const { return fUTF8 == other.fUTF8; }
+	bool operator!=(const UnicodeString& other) const { return fUTF8 != other.fUTF8; }
+	bool operator<(const UnicodeString& other) const { return fUTF8 < other.fUTF8; }
+
+private:
+	std::string fUTF8;
+};
+
+class Error {
+public:
+	Error(ASErr error) : fError(error) {}
+	operator ASErr() const { return fError; }
+
+private:
+	ASErr fError;
+};
+
+} // namespace ai
+
+namespace aisdk {
+
+inline void check_ai_error(ASErr error)
+{
+	if (error) {
+		throw ai::Error(error);
+	}
+}
+
+} // namespace aisdk
+
+#define kNoErr 0
+#define kBadParameterErr ((ASErr)0x5041524D)	// 'PARM'
+#define kCantHappenErr ((ASErr)0x43414E54)		// 'CANT'
+#define kAIRealOne ((AIReal)1.0)
+#define kMaxDashComponent 6
+
+struct AIRealPoint { AIReal h, v; };
+struct AIRealRect { AIReal left, top, right, bottom; };
+struct AIRealMatrix { AIReal a, b, c, d, tx, ty; };
+
+typedef struct _t_AIArtOpaque* AIArtHandle;
+typedef struct _t_AIArtStyle* AIArtStyleHandle;
+typedef struct _t_AICustomColorOpaque* AICustomColorHandle;
+typedef struct _t_AIPatternOpaque* AIPatternHandle;
+typedef struct _t_AISwatchOpaque* AISwatchRef;
+typedef struct _t_AISwatchListOpaque* AISwatchListRef;
+typedef struct _t_AIDocumentOpaque* AIDocumentHandle;
+typedef struct _t_TextRange* TextRangeRef;
+
+enum AIArtType {
+	kUnknownArt = 0,
+	kGroupArt,
+	kPathArt,
+	kCompoundPathArt,
+	kTextArtUnsupported,
+	kTextPathArtUnsupported,
+	kTextRunArtUnsupported,
+	kPlacedArt,
+	kMysteryPathArt,
+	kRasterArt,
+	kPluginArt,
+	kMeshArt,
+	kTextFrameArt,
+	kSymbolArt
+};
+
+enum AIPaintOrder {
+	kPlaceAbove = 1,
+	kPlaceBelow,
+	kPlaceInsideOnTop,
+	kPlaceInsideOnBottom,
+	kPlaceAboveAll,
+	kPlaceBelowAll
+};
+
+enum AIArtTimeStampOptions {
+	kAITimeStampOfArt = 0,
+	kAITimeStampMaxFromArtAndChildren
+};
+
+enum AITextOrientation {
+	kHorizontalTextOrientation = 0,
+	kVerticalTextOrientation
+};
+
+enum AIColorTag { kGrayColor = 0, kFourColor, kPattern, kCustomColor, kGradient, kThreeColor, kNoneColor };
+enum AICustomColorTag { kCustomFourColor = 0, kCustomThreeColor };
+enum AILineCap { kAIButtCap = 0, kAIRoundCap, kAIProjectingCap };
+enum AILineJoin { kAIMiterJoin = 0, kAIRoundJoin, kAIBevelJoin };
+
+struct AIGrayColorStyle { AIReal gray; };
+struct AIFourColorStyle { AIReal cyan, magenta, yellow, black; };
+struct AIThreeColorStyle { AIReal red, green, blue; };
+struct AICustomColorStyle { AICustomColorHandle color; AIReal tint; };
+union AIColorUnion { AIGrayColorStyle g; AIFourColorStyle f; AIThreeColorStyle rgb; AICustomColorStyle c; };
+struct AIColor { AIColorTag kind; AIColorUnion c; };
+
+struct AIFillStyle { AIColor color; AIBoolean overprint; };
+struct AIDashStyle { ai::int16 length; AIReal offset; AIReal array[kMaxDashComponent]; };
+struct AIStrokeStyle { AIColor color; AIBoolean overprint; AIReal width; AIDashStyle dash; AILineCap cap; AILineJoin join; AIReal miterLimit; };
+struct AIPathStyle { AIBoolean fillPaint; AIBoolean strokePaint; AIFillStyle fill; AIStrokeStyle stroke; AIBoolean clip; AIBoolean lockClip; AIBoolean evenodd; AIReal resolution; };
+
+struct AICustomColor { AICustomColorTag kind; union { AIFourColorStyle f; AIThreeColorStyle rgb; } c; ai::int32 flag; };
+
+struct AIPathSegment { AIRealPoint p, in, out; AIBoolean corner; };
+
+struct AIArtSuite {
+	AIAPI AIErr (*NewArt)(short type, short paintOrder, AIArtHandle prep, AIArtHandle* newArt);
+	AIAPI AIErr (*DisposeArt)(AIArtHandle art);
+	AIAPI AIErr (*GetArtType)(AIArtHandle art, short* type);
+	AIAPI AIErr (*GetArtName)(AIArtHandle art, ai::UnicodeString& name, AIBoolean* isDefaultName);
+	AIAPI AIErr (*SetArtName)(AIArtHandle art, const ai::UnicodeString& name);
+	AIAPI AIErr (*GetArtLastChild)(AIArtHandle art, AIArtHandle* child);
+	AIAPI AIErr (*GetArtPriorSibling)(AIArtHandle art, AIArtHandle* sibling);
+	AIAPI AIErr (*GetArtBounds)(AIArtHandle art, AIRealRect* bounds);
+	AIAPI AIErr (*GetArtTimeStamp)(AIArtHandle art, AIArtTimeStampOptions options, size_t* timeStamp);
+};
+
+struct AIPathSuite {
+	AIAPI AIErr (*GetPathSegmentCount)(AIArtHandle path, ai::int16* count);
+	AIAPI AIErr (*SetPathSegmentCount)(AIArtHandle path, ai::int16 count);
+	AIAPI AIErr (*GetPathSegments)(AIArtHandle path, ai::int16 segNumber, ai::int16 count, AIPathSegment segments[]);
+	AIAPI AIErr (*SetPathSegments)(AIArtHandle path, ai::int16 segNumber, ai::int16 count, const AIPathSegment segments[]);
+	AIAPI AIErr (*GetPathClosed)(AIArtHandle path, AIBoolean* closed);
+	AIAPI AIErr (*SetPathClosed)(AIArtHandle path, AIBoolean closed);
+};
+
+struct AIPathStyleSuite {
+	AIAPI AIErr (*GetPathStyle)(AIArtHandle path, AIPathStyle* style, AIBoolean* hasAdvFill);
+	AIAPI AIErr (*SetPathStyle)(AIArtHandle path, const AIPathStyle* style);
+};
+
+struct AIArtStyleSuite {
+	AIAPI AIErr (*GetArtStyle)(AIArtHandle art, AIArtStyleHandle* artStyle);
+	AIAPI AIErr (*SetArtStyle)(AIArtHandle art, AIArtStyleHandle artStyle);
+	AIAPI AIErr (*GetArtStyleByName)(AIArtStyleHandle* artStyle, ai::UnicodeString* name);
+	AIAPI AIErr (*AddNamedStyle)(AIArtStyleHandle artStyle, const ai::UnicodeString& name, AIBoolean copyAttrs, AIArtStyleHandle* namedStyle);
+};
+
+struct AICustomColorSuite {
+	AIAPI AIErr (*NewCustomColor)(AICustomColor* color, const ai::UnicodeString& name, AICustomColorHandle* customColor);
+	AIAPI AIErr (*GetCustomColorByName)(const ai::UnicodeString& name, AICustomColorHandle* customColor);
+};
+
+struct AISwatchListSuite {
+	AIAPI AIErr (*GetSwatchList)(AIDocumentHandle document, AISwatchListRef* list);
+	AIAPI AISwatchRef (*InsertNthSwatch)(AISwatchListRef list, int index);
+	AIAPI AIErr (*SetAIColor)(AISwatchRef swatch, AIColor* color);
+	AIAPI AISwatchRef (*GetSwatchByName)(AISwatchListRef list, const ai::UnicodeString& name);
+};
+
+struct AISymbolSuite {
+	AIAPI AIErr (*NewSymbolPattern)(AIPatternHandle* symbolPattern, AIArtHandle definitionArt, AIBoolean unused);
+	AIAPI AIErr (*SetSymbolPatternBaseName)(AIPatternHandle symbolPattern, const ai::UnicodeString& name);
+	AIAPI AIErr (*GetSymbolByName)(const ai::UnicodeString& name, AIPatternHandle* symbolPattern);
+	AIAPI AIErr (*NewInstanceAtLocation)(AIPatternHandle symbolPattern, AIRealPoint center, short paintOrder, AIArtHandle prep, AIArtHandle* newArt);
+	AIAPI AIErr (*GetSymbolPatternOfSymbolArt)(AIArtHandle symbolArt, AIPatternHandle* symbolPattern);
+};
+
+struct AITextFrameSuite {
+	AIAPI AIErr (*NewPointText)(short paintOrder, AIArtHandle prep, AITextOrientation orient, AIRealPoint anchor, AIArtHandle* newTextFrame);
+	AIAPI AIErr (*GetATETextRange)(AIArtHandle textFrame, TextRangeRef* range);
+	AIAPI AIErr (*GetTextFrameMatrix)(AIArtHandle textFrame, AIRealMatrix* matrix);
+	AIAPI AIErr (*SetTextFrameMatrix)(AIArtHandle textFrame, const AIRealMatrix* matrix);
+};
+
+// Suites the plug-in acquires that art emission does not call
+struct AIUnicodeStringSuite;
+struct SPBlocksSuite;
+struct AIAnnotatorSuite;
+struct AIAnnotatorDrawerSuite;
+struct AIToolSuite;
+struct AIArtSetSuite;
+struct AIHitTestSuite;
+struct AIDocumentViewSuite;
+struct AIDocumentSuite;
+struct AIMatchingArtSuite;
+struct AIStringFormatUtilsSuite;
+struct AICursorSnapSuite;
+struct AIDictionarySuite;
+struct AIPluginGroupSuite;
+struct AIRealMathSuite;
+struct AIATETextUtilSuite;
+struct AIMdMemorySuite;
+struct AIDocumentListSuite;
+struct AIFontSuite;
+struct AITimerSuite;
+struct AIUndoSuite;
+struct AIMenuSuite;
+
+// The text engine calls of point text emission. Text ranges hold their contents; the
+// paragraph and character features are accepted and dropped.
+namespace ATE {
+
+enum ParagraphJustification { kLeftJustify = 0, kRightJustify, kCenterJustify };
+enum TabType { kLeftTabType = 0, kCenterTabType, kRightTabType, kDecimalTabType };
+
+class ITabStop {
+public:
+	void SetTabType(TabType) {}
+	void SetPosition(AIReal) {}
+};
+
+class ITabStops {
+public:
+	void ReplaceOrAdd(const ITabStop&) {}
+};
+
+class IParaFeatures {
+public:
+	void SetJustification(ParagraphJustification) {}
+	void SetTabStops(const ITabStops&) {}
+};
+
+class ICharFeatures {
+public:
+	void SetAutoLeading(bool) {}
+	void SetLeading(AIReal) {}
+};
+
+class ITextRange {
+public:
+	explicit ITextRange(TextRangeRef range) : fRange(range) {}
+
+	ASInt32 GetSize() const;
+	ASInt32 GetContents(ASUnicode* text, ASInt32 maxLength) const;
+	void InsertAfter(const ASUnicode* text);
+	void Remove();
+	void SetLocalParaFeatures(const IParaFeatures&) {}
+	void SetLocalCharFeatures(const ICharFeatures&) {}
+
+private:
+	TextRangeRef fRange;
+};
+
+} // namespace ATE
+
+#endif // __IllustratorSDK_h__
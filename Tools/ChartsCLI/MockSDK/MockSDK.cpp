@@ -0,0 +1,669 @@
+//========================================================================================
+//  
+//  MockSDK.cpp
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#include "MockSDK.h"
+#include "ChartsSuites.h"
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <vector>
+
+// Art, styles, swatches and symbols of the mock document. Handles are pointers to these.
+struct _t_AIArtOpaque {
+	short type;
+	_t_AIArtOpaque* parent;
+	_t_AIArtOpaque* firstChild;		// Top of the stacking order
+	_t_AIArtOpaque* lastChild;		// Bottom of the stacking order
+	_t_AIArtOpaque* prior;			// The sibling above
+	_t_AIArtOpaque* next;			// The sibling below
+	size_t timeStamp;
+	std::string name;
+	std::vector<AIPathSegment> segments;
+	AIBoolean closed;
+	AIPathStyle pathStyle;
+	AIArtStyleHandle artStyle;
+	AIRealMatrix matrix;			// Text frames
+	std::basic_string<ASUnicode> text;
+	AIPatternHandle symbol;			// Symbol instances
+
+	explicit _t_AIArtOpaque(short artType) : type(artType), parent(nullptr), firstChild(nullptr), lastChild(nullptr), prior(nullptr), next(nullptr),
+		timeStamp(0), closed(false), pathStyle(), artStyle(nullptr), matrix(), symbol(nullptr) {}
+};
+
+struct _t_AIArtStyle {
+	AIPathStyle pathStyle;
+	std::string name;
+};
+
+struct _t_AICustomColorOpaque {
+	AICustomColor color;
+};
+
+struct _t_AIPatternOpaque {
+	AIRealRect bounds;				// Of the definition, centered on the origin
+	std::string name;
+};
+
+struct _t_AISwatchOpaque {
+	AIColor color;
+};
+
+namespace {
+
+// Not an SDK error code; returned where the application reports a missing name
+const ASErr kNotFoundErr = 0x4E464E44;	// 'NFND'
+
+struct Document {
+	std::unique_ptr<_t_AIArtOpaque> root;
+	std::deque<_t_AIArtStyle> artStyles;
+	std::map<std::string, AIArtStyleHandle> namedStyles;
+	std::deque<_t_AICustomColorOpaque> customColors;
+	std::map<std::string, AICustomColorHandle> namedColors;
+	std::deque<_t_AISwatchOpaque> swatches;
+	std::map<std::string, AISwatchRef> namedSwatches;
+	std::deque<_t_AIPatternOpaque> symbols;
+	std::map<std::string, AIPatternHandle> namedSymbols;
+};
+
+Document gDocument;
+size_t gClock = 0;
+std::map<std::string, uint64_t> gCallCounts;
+
+void Count(const char* function)
+{
+	gCallCounts[function]++;
+}
+
+// Stamps art and its ancestors, so a group's stamp is the latest of its contents
+void Touch(AIArtHandle art)
+{
+	gClock++;
+	for (; art; art = art->parent) {
+		art->timeStamp = gClock;
+	}
+}
+
+void Unlink(AIArtHandle art)
+{
+	AIArtHandle parent = art->parent;
+	(art->prior ? art->prior->next : parent->firstChild) = art->next;
+	(art->next ? art->next->prior : parent->lastChild) = art->prior;
+	art->parent = art->prior = art->next = nullptr;
+}
+
+void Delete(AIArtHandle art)
+{
+	for (AIArtHandle child = art->firstChild; child;) {
+		AIArtHandle next = child->next;
+		Delete(child);
+		child = next;
+	}
+	delete art;
+}
+
+// Places art relative to prep as the application does for a paint order
+ASErr Insert(AIArtHandle art, short paintOrder, AIArtHandle prep)
+{
+	if (!prep) {
+		return kBadParameterErr;
+	}
+
+	switch (paintOrder) {
+		case kPlaceInsideOnTop:
+			art->parent = prep;
+			art->next = prep->firstChild;
+			break;
+		case kPlaceInsideOnBottom:
+			art->parent = prep;
+			art->prior = prep->lastChild;
+			break;
+		case kPlaceAbove:
+			art->parent = prep->parent;
+			art->prior = prep->prior;
+			art->next = prep;
+			break;
+		case kPlaceBelow:
+			art->parent = prep->parent;
+			art->prior = prep;
+			art->next = prep->next;
+			break;
+		default:
+			return kBadParameterErr;
+	}
+	if (!art->parent) {
+		return kBadParameterErr;
+	}
+
+	(art->prior ? art->prior->next : art->parent->firstChild) = art;
+	(art->next ? art->next->prior : art->parent->lastChild) = art;
+	Touch(art);
+	return kNoErr;
+}
+
+// Path segment indices and counts are 16 bit
+AIBoolean IsSegmentRange(AIArtHandle path, ai::int16 segNumber, ai::int16 count)
+{
+	return path && path->type == kPathArt && segNumber >= 0 && count >= 0 && (size_t)segNumber + count <= path->segments.size();
+}
+
+// Anchors only; the emitted marks have no handles outside their anchors' box
+ASErr GetBounds(AIArtHandle art, AIRealRect* bounds)
+{
+	if (art->type == kSymbolArt && art->symbol) {
+		bounds->left = art->matrix.tx + art->symbol->bounds.left;
+		bounds->right = art->matrix.tx + art->symbol->bounds.right;
+		bounds->bottom = art->matrix.ty + art->symbol->bounds.bottom;
+		bounds->top = art->matrix.ty + art->symbol->bounds.top;
+		return kNoErr;
+	}
+	if (art->type != kPathArt || art->segments.empty()) {
+		return kBadParameterErr;
+	}
+
+	bounds->left = bounds->right = art->segments[0].p.h;
+	bounds->bottom = bounds->top = art->segments[0].p.v;
+	for (const AIPathSegment& segment : art->segments) {
+		bounds->left = std::min(bounds->left, segment.p.h);
+		bounds->right = std::max(bounds->right, segment.p.h);
+		bounds->bottom = std::min(bounds->bottom, segment.p.v);
+		bounds->top = std::max(bounds->top, segment.p.v);
+	}
+	return kNoErr;
+}
+
+// AIArtSuite
+
+AIAPI AIErr NewArt(short type, short paintOrder, AIArtHandle prep, AIArtHandle* newArt)
+{
+	Count("NewArt");
+	std::unique_ptr<_t_AIArtOpaque> art(new _t_AIArtOpaque(type));
+	ASErr result = Insert(art.get(), paintOrder, prep);
+	*newArt = result == kNoErr ? art.release() : nullptr;
+	return result;
+}
+
+AIAPI AIErr DisposeArt(AIArtHandle art)
+{
+	Count("DisposeArt");
+	if (!art || !art->parent) {
+		return kBadParameterErr;
+	}
+	AIArtHandle parent = art->parent;
+	Unlink(art);
+	Delete(art);
+	Touch(parent);
+	return kNoErr;
+}
+
+AIAPI AIErr GetArtType(AIArtHandle art, short* type)
+{
+	Count("GetArtType");
+	*type = art->type;
+	return kNoErr;
+}
+
+AIAPI AIErr GetArtName(AIArtHandle art, ai::UnicodeString& name, AIBoolean* isDefaultName)
+{
+	Count("GetArtName");
+	name = ai::UnicodeString::FromUTF8(art->name);
+	if (isDefaultName) {
+		*isDefaultName = art->name.empty();
+	}
+	return kNoErr;
+}
+
+AIAPI AIErr SetArtName(AIArtHandle art, const ai::UnicodeString& name)
+{
+	Count("SetArtName");
+	art->name = name.as_UTF8();
+	Touch(art);
+	return kNoErr;
+}
+
+AIAPI AIErr GetArtLastChild(AIArtHandle art, AIArtHandle* child)
+{
+	Count("GetArtLastChild");
+	*child = art->lastChild;
+	return kNoErr;
+}
+
+AIAPI AIErr GetArtPriorSibling(AIArtHandle art, AIArtHandle* sibling)
+{
+	Count("GetArtPriorSibling");
+	*sibling = art->prior;
+	return kNoErr;
+}
+
+AIAPI AIErr GetArtBounds(AIArtHandle art, AIRealRect* bounds)
+{
+	Count("GetArtBounds");
+	return GetBounds(art, bounds);
+}
+
+AIAPI AIErr GetArtTimeStamp(AIArtHandle art, AIArtTimeStampOptions, size_t* timeStamp)
+{
+	Count("GetArtTimeStamp");
+	*timeStamp = art->timeStamp;
+	return kNoErr;
+}
+
+// AIPathSuite
+
+AIAPI AIErr GetPathSegmentCount(AIArtHandle path, ai::int16* count)
+{
+	Count("GetPathSegmentCount");
+	*count = (ai::int16)path->segments.size();
+	return kNoErr;
+}
+
+AIAPI AIErr SetPathSegmentCount(AIArtHandle path, ai::int16 count)
+{
+	Count("SetPathSegmentCount");
+	if (path->type != kPathArt || count <= 0) {
+		return kBadParameterErr;
+	}
+	path->segments.resize(count);
+	Touch(path);
+	return kNoErr;
+}
+
+AIAPI AIErr GetPathSegments(AIArtHandle path, ai::int16 segNumber, ai::int16 count, AIPathSegment segments[])
+{
+	Count("GetPathSegments");
+	if (!IsSegmentRange(path, segNumber, count)) {
+		return kBadParameterErr;
+	}
+	std::copy(path->segments.begin() + segNumber, path->segments.begin() + segNumber + count, segments);
+	return kNoErr;
+}
+
+AIAPI AIErr SetPathSegments(AIArtHandle path, ai::int16 segNumber, ai::int16 count, const AIPathSegment segments[])
+{
+	Count("SetPathSegments");
+	if (!IsSegmentRange(path, segNumber, count)) {
+		return kBadParameterErr;
+	}
+	std::copy(segments, segments + count, path->segments.begin() + segNumber);
+	Touch(path);
+	return kNoErr;
+}
+
+AIAPI AIErr GetPathClosed(AIArtHandle path, AIBoolean* closed)
+{
+	Count("GetPathClosed");
+	*closed = path->closed;
+	return kNoErr;
+}
+
+AIAPI AIErr SetPathClosed(AIArtHandle path, AIBoolean closed)
+{
+	Count("SetPathClosed");
+	path->closed = closed;
+	Touch(path);
+	return kNoErr;
+}
+
+// AIPathStyleSuite
+
+AIAPI AIErr GetPathStyle(AIArtHandle path, AIPathStyle* style, AIBoolean* hasAdvFill)
+{
+	Count("GetPathStyle");
+	*style = path->artStyle ? path->artStyle->pathStyle : path->pathStyle;
+	if (hasAdvFill) {
+		*hasAdvFill = false;
+	}
+	return kNoErr;
+}
+
+AIAPI AIErr SetPathStyle(AIArtHandle path, const AIPathStyle* style)
+{
+	Count("SetPathStyle");
+	path->pathStyle = *style;
+	path->artStyle = nullptr;
+	Touch(path);
+	return kNoErr;
+}
+
+// AIArtStyleSuite
+
+AIAPI AIErr GetArtStyle(AIArtHandle art, AIArtStyleHandle* artStyle)
+{
+	Count("GetArtStyle");
+	if (art->artStyle) {
+		*artStyle = art->artStyle;
+		return kNoErr;
+	}
+	gDocument.artStyles.push_back(_t_AIArtStyle());
+	gDocument.artStyles.back().pathStyle = art->pathStyle;
+	*artStyle = &gDocument.artStyles.back();
+	return kNoErr;
+}
+
+AIAPI AIErr SetArtStyle(AIArtHandle art, AIArtStyleHandle artStyle)
+{
+	Count("SetArtStyle");
+	art->artStyle = artStyle;
+	Touch(art);
+	return kNoErr;
+}
+
+AIAPI AIErr GetArtStyleByName(AIArtStyleHandle* artStyle, ai::UnicodeString* name)
+{
+	Count("GetArtStyleByName");
+	const auto found = gDocument.namedStyles.find(name->as_UTF8());
+	*artStyle = found != gDocument.namedStyles.end() ? found->second : nullptr;
+	return *artStyle ? kNoErr : kNotFoundErr;
+}
+
+AIAPI AIErr AddNamedStyle(AIArtStyleHandle artStyle, const ai::UnicodeString& name, AIBoolean, AIArtStyleHandle* namedStyle)
+{
+	Count("AddNamedStyle");
+	gDocument.artStyles.push_back(*artStyle);
+	gDocument.artStyles.back().name = name.as_UTF8();
+	*namedStyle = &gDocument.artStyles.back();
+	gDocument.namedStyles[name.as_UTF8()] = *namedStyle;
+	return kNoErr;
+}
+
+// AICustomColorSuite
+
+AIAPI AIErr NewCustomColor(AICustomColor* color, const ai::UnicodeString& name, AICustomColorHandle* customColor)
+{
+	Count("NewCustomColor");
+	gDocument.customColors.push_back(_t_AICustomColorOpaque());
+	gDocument.customColors.back().color = *color;
+	*customColor = &gDocument.customColors.back();
+	gDocument.namedColors[name.as_UTF8()] = *customColor;
+	return kNoErr;
+}
+
+AIAPI AIErr GetCustomColorByName(const ai::UnicodeString& name, AICustomColorHandle* customColor)
+{
+	Count("GetCustomColorByName");
+	const auto found = gDocument.namedColors.find(name.as_UTF8());
+	*customColor = found != gDocument.namedColors.end() ? found->second : nullptr;
+	return *customColor ? kNoErr : kNotFoundErr;
+}
+
+// AISwatchListSuite. A swatch takes its name from its custom color, as a global process
+// swatch does, so the list finds it by the name of the last color set.
+
+AIAPI AIErr GetSwatchList(AIDocumentHandle, AISwatchListRef* list)
+{
+	Count("GetSwatchList");
+	*list = reinterpret_cast<AISwatchListRef>(&gDocument);
+	return kNoErr;
+}
+
+AIAPI AISwatchRef InsertNthSwatch(AISwatchListRef, int)
+{
+	Count("InsertNthSwatch");
+	gDocument.swatches.push_back(_t_AISwatchOpaque());
+	return &gDocument.swatches.back();
+}
+
+AIAPI AIErr SetAIColor(AISwatchRef swatch, AIColor* color)
+{
+	Count("SetAIColor");
+	swatch->color = *color;
+	if (color->kind == kCustomColor) {
+		for (const auto& named : gDocument.namedColors) {
+			if (named.second == color->c.c.color) {
+				gDocument.namedSwatches[named.first] = swatch;
+			}
+		}
+	}
+	return kNoErr;
+}
+
+AIAPI AISwatchRef GetSwatchByName(AISwatchListRef, const ai::UnicodeString& name)
+{
+	Count("GetSwatchByName");
+	const auto found = gDocument.namedSwatches.find(name.as_UTF8());
+	return found != gDocument.namedSwatches.end() ? found->second : nullptr;
+}
+
+// AISymbolSuite
+
+AIAPI AIErr NewSymbolPattern(AIPatternHandle* symbolPattern, AIArtHandle definitionArt, AIBoolean)
+{
+	Count("NewSymbolPattern");
+	AIRealRect bounds;
+	if (GetBounds(definitionArt, &bounds) != kNoErr) {
+		return kBadParameterErr;
+	}
+
+	// Instances are placed by their center, so the definition is kept centered
+	const AIReal h = (bounds.left + bounds.right) / 2;
+	const AIReal v = (bounds.bottom + bounds.top) / 2;
+	gDocument.symbols.push_back(_t_AIPatternOpaque());
+	_t_AIPatternOpaque& symbol = gDocument.symbols.back();
+	symbol.bounds.left = bounds.left - h;
+	symbol.bounds.right = bounds.right - h;
+	symbol.bounds.bottom = bounds.bottom - v;
+	symbol.bounds.top = bounds.top - v;
+	*symbolPattern = &symbol;
+	return kNoErr;
+}
+
+AIAPI AIErr SetSymbolPatternBaseName(AIPatternHandle symbolPattern, const ai::UnicodeString& name)
+{
+	Count("SetSymbolPatternBaseName");
+	symbolPattern->name = name.as_UTF8();
+	gDocument.namedSymbols[symbolPattern->name] = symbolPattern;
+	return kNoErr;
+}
+
+AIAPI AIErr GetSymbolByName(const ai::UnicodeString& name, AIPatternHandle* symbolPattern)
+{
+	Count("GetSymbolByName");
+	const auto found = gDocument.namedSymbols.find(name.as_UTF8());
+	*symbolPattern = found != gDocument.namedSymbols.end() ? found->second : nullptr;
+	return *symbolPattern ? kNoErr : kNotFoundErr;
+}
+
+AIAPI AIErr NewInstanceAtLocation(AIPatternHandle symbolPattern, AIRealPoint center, short paintOrder, AIArtHandle prep, AIArtHandle* newArt)
+{
+	Count("NewInstanceAtLocation");
+	std::unique_ptr<_t_AIArtOpaque> art(new _t_AIArtOpaque(kSymbolArt));
+	art->symbol = symbolPattern;
+	art->matrix.a = art->matrix.d = 1;
+	art->matrix.tx = center.h;
+	art->matrix.ty = center.v;
+	ASErr result = Insert(art.get(), paintOrder, prep);
+	*newArt = result == kNoErr ? art.release() : nullptr;
+	return result;
+}
+
+AIAPI AIErr GetSymbolPatternOfSymbolArt(AIArtHandle symbolArt, AIPatternHandle* symbolPattern)
+{
+	Count("GetSymbolPatternOfSymbolArt");
+	*symbolPattern = symbolArt->symbol;
+	return symbolArt->type == kSymbolArt ? kNoErr : kBadParameterErr;
+}
+
+// AITextFrameSuite. A text frame is its own text range.
+
+AIAPI AIErr NewPointText(short paintOrder, AIArtHandle prep, AITextOrientation, AIRealPoint anchor, AIArtHandle* newTextFrame)
+{
+	Count("NewPointText");
+	std::unique_ptr<_t_AIArtOpaque> art(new _t_AIArtOpaque(kTextFrameArt));
+	art->matrix.a = art->matrix.d = 1;
+	art->matrix.tx = anchor.h;
+	art->matrix.ty = anchor.v;
+	ASErr result = Insert(art.get(), paintOrder, prep);
+	*newTextFrame = result == kNoErr ? art.release() : nullptr;
+	return result;
+}
+
+AIAPI AIErr GetATETextRange(AIArtHandle textFrame, TextRangeRef* range)
+{
+	Count("GetATETextRange");
+	*range = reinterpret_cast<TextRangeRef>(textFrame);
+	return textFrame->type == kTextFrameArt ? kNoErr : kBadParameterErr;
+}
+
+AIAPI AIErr GetTextFrameMatrix(AIArtHandle textFrame, AIRealMatrix* matrix)
+{
+	Count("GetTextFrameMatrix");
+	*matrix = textFrame->matrix;
+	return kNoErr;
+}
+
+AIAPI AIErr SetTextFrameMatrix(AIArtHandle textFrame, const AIRealMatrix* matrix)
+{
+	Count("SetTextFrameMatrix");
+	textFrame->matrix = *matrix;
+	Touch(textFrame);
+	return kNoErr;
+}
+
+AIArtSuite gArtSuite = {NewArt, DisposeArt, GetArtType, GetArtName, SetArtName, GetArtLastChild, GetArtPriorSibling, GetArtBounds, GetArtTimeStamp};
+AIPathSuite gPathSuite = {GetPathSegmentCount, SetPathSegmentCount, GetPathSegments, SetPathSegments, GetPathClosed, SetPathClosed};
+AIPathStyleSuite gPathStyleSuite = {GetPathStyle, SetPathStyle};
+AIArtStyleSuite gArtStyleSuite = {GetArtStyle, SetArtStyle, GetArtStyleByName, AddNamedStyle};
+AICustomColorSuite gCustomColorSuite = {NewCustomColor, GetCustomColorByName};
+AISwatchListSuite gSwatchListSuite = {GetSwatchList, InsertNthSwatch, SetAIColor, GetSwatchByName};
+AISymbolSuite gSymbolSuite = {NewSymbolPattern, SetSymbolPatternBaseName, GetSymbolByName, NewInstanceAtLocation, GetSymbolPatternOfSymbolArt};
+AITextFrameSuite gTextFrameSuite = {NewPointText, GetATETextRange, GetTextFrameMatrix, SetTextFrameMatrix};
+
+void CountArt(AIArtHandle group, MockSDK::ArtCounts& counts)
+{
+	for (AIArtHandle art = group->firstChild; art; art = art->next) {
+		switch (art->type) {
+			case kGroupArt:
+				counts.groups++;
+				break;
+			case kPathArt:
+				counts.paths++;
+				counts.anchors += art->segments.size();
+				counts.largestPath = std::max(counts.largestPath, art->segments.size());
+				break;
+			case kCompoundPathArt:
+				counts.compoundPaths++;
+				break;
+			case kTextFrameArt:
+				counts.texts++;
+				break;
+			case kSymbolArt:
+				counts.symbols++;
+				break;
+			default:
+				break;
+		}
+		CountArt(art, counts);
+	}
+}
+
+} // namespace
+
+extern "C"
+{
+	AIArtSuite*					sAIArt = &gArtSuite;
+	AIPathSuite*				sAIPath = &gPathSuite;
+	AIPathStyleSuite*			sAIPathStyle = &gPathStyleSuite;
+	AIArtStyleSuite*			sAIArtStyle = &gArtStyleSuite;
+	AICustomColorSuite*			sAICustomColor = &gCustomColorSuite;
+	AISwatchListSuite*			sAISwatchList = &gSwatchListSuite;
+	AISymbolSuite*				sAISymbol = &gSymbolSuite;
+	AITextFrameSuite*			sAITextFrame = &gTextFrameSuite;
+}
+
+/*
+*/
+ASInt32 ATE::ITextRange::GetSize() const
+{
+	return (ASInt32)reinterpret_cast<AIArtHandle>(fRange)->text.size();
+}
+
+/*
+*/
+ASInt32 ATE::ITextRange::GetContents(ASUnicode* text, ASInt32 maxLength) const
+{
+	const std::basic_string<ASUnicode>& contents = reinterpret_cast<AIArtHandle>(fRange)->text;
+	const ASInt32 length = std::min((ASInt32)contents.size(), maxLength);
+	std::copy(contents.begin(), contents.begin() + length, text);
+	return length;
+}
+
+/*
+*/
+void ATE::ITextRange::InsertAfter(const ASUnicode* text)
+{
+	AIArtHandle art = reinterpret_cast<AIArtHandle>(fRange);
+	art->text.append(text);
+	Touch(art);
+}
+
+/*
+*/
+void ATE::ITextRange::Remove()
+{
+	AIArtHandle art = reinterpret_cast<AIArtHandle>(fRange);
+	art->text.clear();
+	Touch(art);
+}
+
+/*
+*/
+AIArtHandle MockSDK::NewDocument()
+{
+	if (gDocument.root) {
+		Delete(gDocument.root.release());
+	}
+	gDocument = Document();
+	gDocument.root.reset(new _t_AIArtOpaque(kGroupArt));
+	return gDocument.root.get();
+}
+
+/*
+*/
+MockSDK::ArtCounts MockSDK::CountArt(AIArtHandle group)
+{
+	ArtCounts counts;
+	::CountArt(group, counts);
+	return counts;
+}
+
+/*
+*/
+const std::map<std::string, uint64_t>& MockSDK::GetCallCounts()
+{
+	return gCallCounts;
+}
+
+/*
+*/
+uint64_t MockSDK::GetCallCount(const char* function)
+{
+	const auto found = gCallCounts.find(function);
+	return found != gCallCounts.end() ? found->second : 0;
+}
+
+/*
+*/
+uint64_t MockSDK::GetTotalCallCount()
+{
+	uint64_t total = 0;
+	for (const auto& count : gCallCounts) {
+		total += count.second;
+	}
+	return total;
+}
+
+/*
+*/
+void MockSDK::ResetCallCounts()
+{
+	gCallCounts.clear();
+}
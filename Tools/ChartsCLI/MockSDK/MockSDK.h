@@ -0,0 +1,56 @@
+//========================================================================================
+//  
+//  MockSDK.h
+//  
+//  Copyright 2024 Adobe Systems Incorporated. All rights reserved.
+//  
+//  NOTICE:  Adobe permits you to use, modify, and distribute this file in accordance
+//  with the terms of the Adobe license agreement accompanying it.  If you have received
+//  this file from a source other than Adobe, then your use, modification, or
+//  distribution of it requires the prior written permission of Adobe.
+//  
+//========================================================================================
+
+#ifndef __MockSDK_h__
+#define __MockSDK_h__
+
+#include "IllustratorSDK.h"
+#include <cstdint>
+#include <map>
+#include <string>
+
+// An in-memory document behind the mock suites, for benchmarks of art emission. Art is
+// a tree of nodes that keep what the suites write; every suite call is counted by name.
+// Like the application, the suites reject a path of more segments than a 16 bit index
+// holds, so emission that overflows fails here as it would in Illustrator.
+namespace MockSDK {
+
+// Art of a document, by type
+struct ArtCounts {
+	size_t groups;
+	size_t paths;
+	size_t compoundPaths;
+	size_t texts;
+	size_t symbols;
+	size_t anchors;			// Segments of every path
+	size_t largestPath;		// Segments of the longest path
+
+	ArtCounts() : groups(0), paths(0), compoundPaths(0), texts(0), symbols(0), anchors(0), largestPath(0) {}
+};
+
+// Discards the current document, its styles, swatches and symbols included, and returns
+// the group of a new one for art to be emitted into
+AIArtHandle NewDocument();
+
+// Counts the art inside a group, the group itself excluded
+ArtCounts CountArt(AIArtHandle group);
+
+// Calls made to each suite function since the last reset, by function name
+const std::map<std::string, uint64_t>& GetCallCounts();
+uint64_t GetCallCount(const char* function);
+uint64_t GetTotalCallCount();
+void ResetCallCounts();
+
+} // namespace MockSDK
+
+#endif // __MockSDK_h__